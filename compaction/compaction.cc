@@ -143,16 +143,27 @@ std::ostream& operator<<(std::ostream& os, compaction_type_options::scrub::quara
     return os << to_string(quarantine_mode);
 }
 
-static api::timestamp_type get_max_purgeable_timestamp(const table_state& table_s, sstable_set::incremental_selector& selector,
-        const std::unordered_set<shared_sstable>& compacting_set, const dht::decorated_key& dk, uint64_t& bloom_filter_checks) {
+// Tombstones of the compacted sstables are never more recent than max_compacting_timestamp,
+// so data which is more recent than it can't be shadowed by them, and isn't looked up.
+static max_purgeable get_max_purgeable_timestamp(const table_state& table_s, sstable_set::incremental_selector& selector,
+        const std::unordered_set<shared_sstable>& compacting_set, const dht::decorated_key& dk, uint64_t& bloom_filter_checks,
+        api::timestamp_type max_compacting_timestamp) {
     if (!table_s.tombstone_gc_enabled()) [[unlikely]] {
-        return api::min_timestamp;
+        return max_purgeable(api::min_timestamp, max_purgeable::source::tombstone_gc_disabled);
     }
 
-    auto timestamp = table_s.min_memtable_timestamp();
+    auto timestamp = api::max_timestamp;
+    auto source = max_purgeable::source::none;
+    if (table_s.min_memtable_timestamp() <= max_compacting_timestamp) {
+        timestamp = table_s.min_memtable_timestamp_for_key(dk);
+        if (timestamp != api::max_timestamp) {
+            source = max_purgeable::source::memtable;
+        }
+    }
     std::optional<utils::hashed_key> hk;
     for (auto&& sst : boost::range::join(selector.select(dk).sstables, table_s.compacted_undeleted_sstables())) {
-        if (compacting_set.contains(sst)) {
+        auto sst_min_timestamp = sst->get_stats_metadata().min_timestamp;
+        if (sst_min_timestamp > max_compacting_timestamp || sst_min_timestamp >= timestamp || compacting_set.contains(sst)) {
             continue;
         }
         if (!hk) {
@@ -160,10 +171,11 @@ static api::timestamp_type get_max_purgeable_timestamp(const table_state& table_
         }
         if (sst->filter_has_key(*hk)) {
             bloom_filter_checks++;
-            timestamp = std::min(timestamp, sst->get_stats_metadata().min_timestamp);
+            timestamp = sst_min_timestamp;
+            source = max_purgeable::source::other_sstables;
         }
     }
-    return timestamp;
+    return max_purgeable(timestamp, source);
 }
 
 static std::vector<shared_sstable> get_uncompacting_sstables(const table_state& table_s, std::vector<shared_sstable> sstables) {
@@ -351,6 +363,10 @@ struct compaction_read_monitor_generator final : public read_monitor_generator {
             return _last_position_seen;
         }
 
+        virtual bool counts_reads() const noexcept override {
+            return false;
+        }
+
         void remove_sstable() {
             if (_sst) {
                 _table_s.get_backlog_tracker().revert_charges(_sst);
@@ -441,6 +457,8 @@ class compaction {
     uint64_t _end_size = 0;
     uint64_t _estimated_partitions = 0;
     uint64_t _bloom_filter_checks = 0;
+    // The most recent timestamp of the compacted data.
+    api::timestamp_type _max_compacting_timestamp = api::min_timestamp;
     db::replay_position _rp;
     encoding_stats_collector _stats_collector;
     const bool _can_split_large_partition = false;
@@ -457,6 +475,7 @@ class compaction {
     const owned_ranges_ptr _owned_ranges = {};
     // required for reshard compaction.
     const dht::sharder* _sharder = nullptr;
+    const std::optional<data_dictionary::storage_options::s3> _remote_data;
     const std::optional<dht::incremental_owned_ranges_checker> _owned_ranges_checker;
     // Garbage collected sstables that are sealed but were not added to SSTable set yet.
     std::vector<shared_sstable> _unused_garbage_collected_sstables;
@@ -487,10 +506,12 @@ class compaction {
         , _compacting_for_max_purgeable_func(std::unordered_set<shared_sstable>(_sstables.begin(), _sstables.end()))
         , _owned_ranges(std::move(descriptor.owned_ranges))
         , _sharder(descriptor.sharder)
+        , _remote_data(std::move(descriptor.remote_data))
         , _owned_ranges_checker(_owned_ranges ? std::optional<dht::incremental_owned_ranges_checker>(*_owned_ranges) : std::nullopt)
     {
         for (auto& sst : _sstables) {
             _stats_collector.update(sst->get_encoding_stats_for_compaction());
+            _max_compacting_timestamp = std::max(_max_compacting_timestamp, sst->get_stats_metadata().max_timestamp);
         }
         std::unordered_set<run_id> ssts_run_ids;
         _contains_multi_fragment_runs = std::any_of(_sstables.begin(), _sstables.end(), [&ssts_run_ids] (shared_sstable& sst) {
@@ -533,6 +554,7 @@ class compaction {
         cfg.run_identifier = _run_identifier;
         cfg.replay_position = _rp;
         cfg.sstable_level = _sstable_level;
+        cfg.remote_data = _remote_data;
         return cfg;
     }
 
@@ -831,14 +853,15 @@ class compaction {
     virtual std::string_view report_start_desc() const = 0;
     virtual std::string_view report_finish_desc() const = 0;
 
-    std::function<api::timestamp_type(const dht::decorated_key&)> max_purgeable_func() {
+    std::function<max_purgeable(const dht::decorated_key&)> max_purgeable_func() {
         if (!tombstone_expiration_enabled()) {
             return [] (const dht::decorated_key& dk) {
-                return api::min_timestamp;
+                return max_purgeable(api::min_timestamp);
             };
         }
         return [this] (const dht::decorated_key& dk) {
-            return get_max_purgeable_timestamp(_table_s, *_selector, _compacting_for_max_purgeable_func, dk, _bloom_filter_checks);
+            return get_max_purgeable_timestamp(_table_s, *_selector, _compacting_for_max_purgeable_func, dk, _bloom_filter_checks,
+                    _max_compacting_timestamp);
         };
     }
 
@@ -1139,6 +1162,10 @@ class regular_compaction : public compaction {
     }
 
     void replace_remaining_exhausted_sstables() {
+        // Without a replacer, the caller replaces the input with the output on its own.
+        if (!_replacer) {
+            return;
+        }
         if (!_sstables.empty() || !used_garbage_collected_sstables().empty()) {
             std::vector<shared_sstable> old_sstables;
             std::move(_sstables.begin(), _sstables.end(), std::back_inserter(old_sstables));
@@ -1208,7 +1235,7 @@ class reshape_compaction : public regular_compaction {
                 std::move(trace),
                 sm_fwd,
                 mr_fwd,
-                default_read_monitor_generator());
+                uncounted_read_monitor_generator());
     }
 
     std::string_view report_start_desc() const override {
@@ -1526,7 +1553,7 @@ class scrub_compaction final : public regular_compaction {
         if (!range.is_full()) {
             on_internal_error(clogger, fmt::format("Scrub compaction in mode {} expected full partition range, but got {} instead", _options.operation_mode, range));
         }
-        auto crawling_reader = _compacting->make_crawling_reader(std::move(s), std::move(permit), nullptr);
+        auto crawling_reader = _compacting->make_crawling_reader(std::move(s), std::move(permit), nullptr, uncounted_read_monitor_generator());
         return make_flat_mutation_reader_v2<reader>(std::move(crawling_reader), _options.operation_mode, _validation_errors);
     }
 
@@ -1630,7 +1657,8 @@ class resharding_compaction final : public compaction {
                 slice,
                 nullptr,
                 sm_fwd,
-                mr_fwd);
+                mr_fwd,
+                uncounted_read_monitor_generator());
 
     }
 
@@ -1782,6 +1810,65 @@ compact_sstables(sstables::compaction_descriptor descriptor, compaction_data& cd
     return compaction::run(make_compaction(table_s, std::move(descriptor), cdata));
 }
 
+future<dht::token_range_vector>
+split_for_parallel_compaction(const std::vector<shared_sstable>& sstables, unsigned count) {
+    // Summary entries sample the partitions of the sstable at roughly equal
+    // intervals of data, so each of them stands for the same share of its data.
+    struct sample {
+        dht::token token;
+        double weight;
+    };
+    std::vector<sample> samples;
+    double total_weight = 0;
+    for (auto& sst : sstables) {
+        auto& entries = sst->get_summary().entries;
+        double size = sst->data_size();
+        if (entries.empty()) {
+            // No summary (e.g. sstables with a trie index), only the bounds are known.
+            samples.push_back(sample{sst->get_first_decorated_key().token(), size / 2});
+            samples.push_back(sample{sst->get_last_decorated_key().token(), size / 2});
+        } else {
+            for (auto& e : entries) {
+                samples.push_back(sample{e.get_token(), size / entries.size()});
+                co_await coroutine::maybe_yield();
+            }
+        }
+        total_weight += size;
+    }
+    std::sort(samples.begin(), samples.end(), [] (const sample& a, const sample& b) {
+        return a.token < b.token;
+    });
+
+    // Split at the samples before which the accumulated weight crosses each
+    // multiple of total_weight / count. The last sample is never a split point,
+    // so that the last range isn't empty.
+    std::vector<dht::token> split_points;
+    double weight = 0;
+    unsigned next = 1;
+    for (size_t i = 1; i + 1 < samples.size() && next < count; ++i) {
+        weight += samples[i - 1].weight;
+        if (weight < total_weight * next / count) {
+            continue;
+        }
+        if (split_points.empty() || split_points.back() < samples[i].token) {
+            split_points.push_back(samples[i].token);
+        }
+        while (next < count && weight >= total_weight * next / count) {
+            ++next;
+        }
+    }
+
+    dht::token_range_vector ranges;
+    ranges.reserve(split_points.size() + 1);
+    std::optional<dht::token_range::bound> start;
+    for (auto& t : split_points) {
+        ranges.emplace_back(start, dht::token_range::bound(t, true));
+        start = dht::token_range::bound(t, false);
+    }
+    ranges.emplace_back(start, std::nullopt);
+    co_return ranges;
+}
+
 std::unordered_set<sstables::shared_sstable>
 get_fully_expired_sstables(const table_state& table_s, const std::vector<sstables::shared_sstable>& compacting, gc_clock::time_point compaction_time) {
     clogger.debug("Checking droppable sstables in {}.{}", table_s.schema()->ks_name(), table_s.schema()->cf_name());
@@ -107,6 +107,12 @@ struct compaction_result {
 // compaction behavior through its available member fields.
 future<compaction_result> compact_sstables(sstables::compaction_descriptor descriptor, compaction_data& cdata, table_state& table_s);
 
+// Splits the token ring into at most count ranges holding a similar amount of the data
+// of the given sstables, as estimated from their summaries. The ranges are sorted,
+// disjoint and cover the whole ring, so compacting the sstables once for each of them
+// produces a run of disjoint sstables.
+future<dht::token_range_vector> split_for_parallel_compaction(const std::vector<shared_sstable>& sstables, unsigned count);
+
 // Return list of expired sstables for column family cf.
 // A sstable is fully expired *iff* its max_local_deletion_time precedes gc_before and its
 // max timestamp is lower than any other relevant sstable.
@@ -18,6 +18,7 @@
 #include "sstables/sstable_set.hh"
 #include "utils/UUID.hh"
 #include "dht/i_partitioner.hh"
+#include "data_dictionary/storage_options.hh"
 #include "compaction_fwd.hh"
 
 namespace sstables {
@@ -170,6 +171,10 @@ struct compaction_descriptor {
     // Denotes if this compaction task is comprised solely of completely expired SSTables
     sstables::has_only_fully_expired has_only_fully_expired = has_only_fully_expired::no;
 
+    // If engaged, the data of the output sstables is written to the given object
+    // storage bucket, see sstables::sstable::has_remote_data().
+    std::optional<data_dictionary::storage_options::s3> remote_data;
+
     compaction_descriptor() = default;
 
     static constexpr int default_level = 0;
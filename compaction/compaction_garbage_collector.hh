@@ -9,6 +9,7 @@
 #pragma once
 
 #include "schema/schema_fwd.hh"
+#include "timestamp.hh"
 
 class atomic_cell;
 class row_marker;
@@ -21,3 +22,51 @@ class compaction_garbage_collector {
     virtual void collect(column_id id, collection_mutation_description) = 0;
     virtual void collect(row_marker) = 0;
 };
+
+// The timestamp below which expired tombstones of a partition can be purged by
+// sstable compaction, and what holds back the more recent ones: data they may
+// shadow, which isn't being compacted along with them.
+class max_purgeable {
+public:
+    enum class source {
+        // Not accounted, e.g. when tombstones aren't meant to be purged.
+        none,
+        memtable,
+        other_sstables,
+        tombstone_gc_disabled,
+    };
+private:
+    api::timestamp_type _timestamp;
+    source _source;
+public:
+    // Implicit, so that functions which return a plain timestamp can be used.
+    max_purgeable(api::timestamp_type timestamp, source s = source::none) noexcept
+        : _timestamp(timestamp)
+        , _source(s)
+    { }
+
+    api::timestamp_type timestamp() const noexcept { return _timestamp; }
+    source get_source() const noexcept { return _source; }
+};
+
+// Expired tombstones which sstable compaction couldn't purge, by what held them back.
+struct tombstone_purge_stats {
+    uint64_t kept_for_memtable = 0;
+    uint64_t kept_for_other_sstables = 0;
+    uint64_t kept_for_tombstone_gc_disabled = 0;
+
+    void on_tombstone_kept(max_purgeable::source s) noexcept {
+        switch (s) {
+        case max_purgeable::source::none: break;
+        case max_purgeable::source::memtable: ++kept_for_memtable; break;
+        case max_purgeable::source::other_sstables: ++kept_for_other_sstables; break;
+        case max_purgeable::source::tombstone_gc_disabled: ++kept_for_tombstone_gc_disabled; break;
+        }
+    }
+
+    // Of all compactions running on this shard.
+    static tombstone_purge_stats& local() noexcept {
+        static thread_local tombstone_purge_stats stats;
+        return stats;
+    }
+};
@@ -11,11 +11,13 @@
 #include "compaction_strategy.hh"
 #include "compaction_backlog_manager.hh"
 #include "compaction_weight_registration.hh"
+#include "compaction_garbage_collector.hh"
 #include "sstables/sstables.hh"
 #include "sstables/sstables_manager.hh"
 #include <memory>
 #include <seastar/core/metrics.hh>
 #include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/coroutine/switch_to.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/coroutine/maybe_yield.hh>
@@ -412,24 +414,28 @@ future<sstables::compaction_result> compaction_task_executor::compact_sstables(s
 
     // retrieve owned_ranges if_required
     if (!descriptor.owned_ranges) {
-        std::vector<sstables::shared_sstable> sstables_requiring_cleanup;
-        const auto& cs = _cm.get_compaction_state(_compacting_table);
-        for (const auto& sst : descriptor.sstables) {
-            if (cs.sstables_requiring_cleanup.contains(sst)) {
-                sstables_requiring_cleanup.emplace_back(sst);
-            }
-        }
-        if (!sstables_requiring_cleanup.empty()) {
-            cmlog.info("The following SSTables require cleanup in this compaction: {}", sstables_requiring_cleanup);
-            if (!cs.owned_ranges_ptr) {
-                on_internal_error_noexcept(cmlog, "SSTables require cleanup but compaction state has null owned ranges");
-            }
-            descriptor.owned_ranges = cs.owned_ranges_ptr;
-        }
+        descriptor.owned_ranges = get_owned_ranges_for_cleanup(descriptor.sstables);
     }
 
     co_return co_await sstables::compact_sstables(std::move(descriptor), cdata, t);
 }
+owned_ranges_ptr compaction_task_executor::get_owned_ranges_for_cleanup(const std::vector<sstables::shared_sstable>& sstables) const {
+    std::vector<sstables::shared_sstable> sstables_requiring_cleanup;
+    const auto& cs = _cm.get_compaction_state(_compacting_table);
+    for (const auto& sst : sstables) {
+        if (cs.sstables_requiring_cleanup.contains(sst)) {
+            sstables_requiring_cleanup.emplace_back(sst);
+        }
+    }
+    if (sstables_requiring_cleanup.empty()) {
+        return nullptr;
+    }
+    cmlog.info("The following SSTables require cleanup in this compaction: {}", sstables_requiring_cleanup);
+    if (!cs.owned_ranges_ptr) {
+        on_internal_error_noexcept(cmlog, "SSTables require cleanup but compaction state has null owned ranges");
+    }
+    return cs.owned_ranges_ptr;
+}
 future<> compaction_task_executor::update_history(table_state& t, const sstables::compaction_result& res, const sstables::compaction_data& cdata) {
     auto ended_at = std::chrono::duration_cast<std::chrono::milliseconds>(res.stats.ended_at.time_since_epoch());
 
@@ -485,7 +491,66 @@ class sstables_task_executor : public compaction_task_executor, public sstables_
     }
 };
 
+// Compacts the input of a parallel major compaction (see major_compaction_task_executor)
+// which falls into a single token range.
+class major_compaction_subrange_task_impl : public major_compaction_task_impl {
+    table_state& _table;
+    sstables::compaction_descriptor _descriptor;
+    sstables::compaction_data _compaction_data;
+    uint64_t _estimated_partitions;
+    sstables::compaction_result _result;
+public:
+    major_compaction_subrange_task_impl(tasks::task_manager::module_ptr module,
+            tasks::task_id parent_id,
+            table_state& t,
+            const dht::token_range& range,
+            sstables::compaction_descriptor descriptor,
+            uint64_t estimated_partitions)
+        : major_compaction_task_impl(module, tasks::task_id::create_random_id(), 0, "token range", t.schema()->ks_name(), t.schema()->cf_name(), format("{}", range), parent_id)
+        , _table(t)
+        , _descriptor(std::move(descriptor))
+        , _compaction_data(compaction_manager::create_compaction_data())
+        , _estimated_partitions(estimated_partitions)
+    {
+        _status.progress_units = "partitions";
+    }
+
+    virtual tasks::is_internal is_internal() const noexcept override {
+        return tasks::is_internal::yes;
+    }
+
+    virtual future<tasks::task_manager::task::progress> get_progress() const override {
+        auto total = double(std::max(_estimated_partitions, _compaction_data.total_keys_written));
+        co_return tasks::task_manager::task::progress{
+            .completed = is_complete() ? total : double(_compaction_data.total_keys_written),
+            .total = total,
+        };
+    }
+
+    future<> compact() {
+        _result = co_await sstables::compact_sstables(std::move(_descriptor), _compaction_data, _table);
+    }
+
+    sstables::compaction_result release_result() noexcept {
+        return std::exchange(_result, {});
+    }
+
+    void stop(sstring reason) noexcept {
+        _compaction_data.stop(std::move(reason));
+    }
+
+    void add_pending_replacement(const std::vector<sstables::shared_sstable>& removed, const std::vector<sstables::shared_sstable>& added) {
+        _compaction_data.pending_replacements.push_back({ removed, added });
+    }
+protected:
+    virtual future<> run() override {
+        return compact();
+    }
+};
+
 class major_compaction_task_executor : public compaction_task_executor, public major_compaction_task_impl {
+    std::vector<shared_ptr<major_compaction_subrange_task_impl>> _subranges;
+    std::optional<double> _expected_subranges;
 public:
     major_compaction_task_executor(compaction_manager& mgr,
             throw_if_stopping do_throw_if_stopping,
@@ -498,11 +563,22 @@ class major_compaction_task_executor : public compaction_task_executor, public m
     virtual tasks::is_internal is_internal() const noexcept override {
         return tasks::is_internal::yes;
     }
+
+    virtual void add_pending_replacement(const std::vector<sstables::shared_sstable>& removed, const std::vector<sstables::shared_sstable>& added) override {
+        compaction_task_executor::add_pending_replacement(removed, added);
+        for (auto& subrange : _subranges) {
+            subrange->add_pending_replacement(removed, added);
+        }
+    }
 protected:
     virtual future<> run() override {
         return perform();
     }
 
+    virtual std::optional<double> expected_children_number() const override {
+        return _expected_subranges;
+    }
+
     // first take major compaction semaphore, then exclusely take compaction lock for table.
     // it cannot be the other way around, or minor compaction for this table would be
     // prevented while an ongoing major compaction doesn't release the semaphore.
@@ -532,12 +608,130 @@ class major_compaction_task_executor : public compaction_task_executor, public m
         // the exclusive lock can be freed to let regular compaction run in parallel to major
         lock_holder.return_all();
 
-        co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, on_replace);
+        auto parallelism = _cm.major_compaction_parallelism();
+        if (parallelism > 1 && !descriptor.sstables.empty() && !descriptor.has_only_fully_expired) {
+            co_await compact_sstables_in_parallel(std::move(descriptor), parallelism, on_replace);
+        } else {
+            co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, on_replace);
+        }
 
         finish_compaction();
 
         co_return std::nullopt;
     }
+
+private:
+    // Share of the shard's memory the concurrent ranges of a parallel major compaction may use.
+    static constexpr double parallel_compaction_memory_fraction = 0.1;
+
+    // Number of ranges of a parallel major compaction which may be compacted at once. Every
+    // range reads all the input sstables, with read-ahead, along with their index, and writes
+    // its own output, so its memory grows with the number of input sstables.
+    size_t max_concurrent_subranges(const sstables::compaction_descriptor& descriptor, unsigned parallelism) const {
+        auto subrange_memory = (descriptor.sstables.size() * 4 + 4) * sstables::default_sstable_buffer_size;
+        auto budget = size_t(_cm.available_memory() * parallel_compaction_memory_fraction);
+        return std::clamp<size_t>(budget / subrange_memory, 1, parallelism);
+    }
+
+    // Splits the compaction into token ranges holding a similar amount of data, and compacts
+    // them concurrently, so that it is bound by the throughput of the disk rather than by the
+    // latency of reading and writing a single stream of data. All ranges write to the same run,
+    // which replaces the input at once when all of them are done. Reported as child tasks.
+    // No more ranges are compacted at once than the memory allows, see max_concurrent_subranges().
+    future<> compact_sstables_in_parallel(sstables::compaction_descriptor descriptor, unsigned parallelism, on_replacement& on_replace) {
+        table_state& t = *_compacting_table;
+        auto ranges = co_await sstables::split_for_parallel_compaction(descriptor.sstables, parallelism);
+        auto cleanup_ranges = descriptor.owned_ranges ? descriptor.owned_ranges : get_owned_ranges_for_cleanup(descriptor.sstables);
+        auto max_concurrent = max_concurrent_subranges(descriptor, parallelism);
+        cmlog.info("{}: compacting {} token ranges, {} at a time", *this, ranges.size(), max_concurrent);
+
+        for (auto& range : ranges) {
+            dht::token_range_vector owned_ranges;
+            if (cleanup_ranges) {
+                for (auto& r : *cleanup_ranges) {
+                    if (auto i = r.intersection(range, dht::token_comparator())) {
+                        owned_ranges.push_back(std::move(*i));
+                    }
+                }
+            } else {
+                owned_ranges.push_back(range);
+            }
+            if (owned_ranges.empty()) {
+                continue;
+            }
+            uint64_t estimated_partitions = 0;
+            for (auto& sst : descriptor.sstables) {
+                estimated_partitions += sst->estimated_keys_for_range(range);
+            }
+            auto d = sstables::compaction_descriptor(descriptor.sstables, descriptor.level, descriptor.max_sstable_bytes, descriptor.run_identifier,
+                    descriptor.options, compaction::make_owned_ranges_ptr(std::move(owned_ranges)));
+            d.enable_garbage_collection(t.main_sstable_set());
+            d.creator = [&t] (shard_id dummy) {
+                return t.make_sstable();
+            };
+            // The input is replaced only when all ranges are compacted, so the compaction of
+            // a single range mustn't have a replacer, which would release the input early.
+            _subranges.push_back(seastar::make_shared<major_compaction_subrange_task_impl>(_cm._task_manager_module, _status.id, t, range, std::move(d), estimated_partitions));
+        }
+        _expected_subranges = _subranges.size();
+
+        auto stop_subranges = _compaction_data.abort.subscribe([this] () noexcept {
+            for (auto& subrange : _subranges) {
+                subrange->stop(_compaction_data.stop_requested);
+            }
+        });
+        if (!stop_subranges) {
+            _subranges.clear();
+            throw make_compaction_stopped_exception();
+        }
+
+        std::exception_ptr ex;
+        try {
+            co_await max_concurrent_for_each(_subranges, max_concurrent, [this] (shared_ptr<major_compaction_subrange_task_impl>& subrange) -> future<> {
+                // Only an executor started by the task manager is registered in it and can have children.
+                if (!_parent_id) {
+                    co_await subrange->compact();
+                    co_return;
+                }
+                auto task = co_await _cm.get_task_manager_module().make_task(subrange, tasks::task_info{_status.id, _status.shard});
+                task->start();
+                co_await task->done();
+            });
+        } catch (...) {
+            ex = std::current_exception();
+        }
+
+        sstables::compaction_result res;
+        for (auto& subrange : _subranges) {
+            auto r = subrange->release_result();
+            std::move(r.new_sstables.begin(), r.new_sstables.end(), std::back_inserter(res.new_sstables));
+            res.stats.ended_at = std::max(res.stats.ended_at, r.stats.ended_at);
+            res.stats.end_size += r.stats.end_size;
+            res.stats.validation_errors += r.stats.validation_errors;
+            res.stats.bloom_filter_checks += r.stats.bloom_filter_checks;
+        }
+        _subranges.clear();
+        if (ex) {
+            // The output of the ranges which were compacted is useless without the rest.
+            for (auto& sst : res.new_sstables) {
+                sst->mark_for_deletion();
+            }
+            co_await coroutine::return_exception_ptr(std::move(ex));
+        }
+        for (auto& sst : descriptor.sstables) {
+            res.stats.start_size += sst->bytes_on_disk();
+        }
+
+        t.get_compaction_strategy().notify_completion(t, descriptor.sstables, res.new_sstables);
+        _cm.propagate_replacement(t, descriptor.sstables, res.new_sstables);
+        on_replace.on_addition(res.new_sstables);
+        co_await _cm.on_compaction_completion(t, sstables::compaction_completion_desc{descriptor.sstables, res.new_sstables}, sstables::offstrategy::no);
+        on_replace.on_removal(descriptor.sstables);
+
+        if (should_update_history(descriptor.options.type())) {
+            co_await update_history(t, res, _compaction_data);
+        }
+    }
 };
 
 }
@@ -832,6 +1026,10 @@ void compaction_task_executor::finish_compaction(state finish_state) noexcept {
     _compaction_state.compaction_done.signal();
 }
 
+void compaction_task_executor::add_pending_replacement(const std::vector<sstables::shared_sstable>& removed, const std::vector<sstables::shared_sstable>& added) {
+    _compaction_data.pending_replacements.push_back({ removed, added });
+}
+
 void compaction_task_executor::stop_compaction(sstring reason) noexcept {
     _compaction_data.stop(std::move(reason));
 }
@@ -917,6 +1115,7 @@ future<> compaction_manager::update_throughput(uint32_t value_mbs) {
 void compaction_manager::register_metrics() {
     namespace sm = seastar::metrics;
 
+    auto reason_label = sm::label("reason");
     _metrics.add_group("compaction_manager", {
         sm::make_gauge("compactions", [this] { return _stats.active_tasks; },
                        sm::description("Holds the number of currently active compactions.")),
@@ -934,6 +1133,12 @@ void compaction_manager::register_metrics() {
                        sm::description("Holds the sum of normalized compaction backlog for all tables in the system. Backlog is normalized by dividing backlog by shard's available memory.")),
         sm::make_counter("validation_errors", [this] { return _validation_errors; },
                        sm::description("Holds the number of encountered validation errors.")),
+        sm::make_counter("tombstones_not_purged", [] { return tombstone_purge_stats::local().kept_for_memtable; },
+                       sm::description("Holds the number of expired tombstones which compaction kept, because they may shadow data in a memtable."), {reason_label("memtable")}),
+        sm::make_counter("tombstones_not_purged", [] { return tombstone_purge_stats::local().kept_for_other_sstables; },
+                       sm::description("Holds the number of expired tombstones which compaction kept, because they may shadow data in sstables which weren't compacted."), {reason_label("other_sstables")}),
+        sm::make_counter("tombstones_not_purged", [] { return tombstone_purge_stats::local().kept_for_tombstone_gc_disabled; },
+                       sm::description("Holds the number of expired tombstones which compaction kept, because tombstone GC is disabled for the table."), {reason_label("tombstone_gc_disabled")}),
     });
 }
 
@@ -942,6 +1147,10 @@ void compaction_manager::enable() {
     _state = state::enabled;
     _compaction_submission_timer.arm_periodic(periodic_compaction_submission_interval());
     _waiting_reevalution = postponed_compactions_reevaluation();
+    // The loop of a previous enable() may still be waking up to notice it was disabled.
+    _tombstone_purge_done = std::exchange(_tombstone_purge_done, make_ready_future<>()).then([this] {
+        return tombstone_purge_loop();
+    });
 }
 
 std::function<void()> compaction_manager::compaction_submission_callback() {
@@ -1037,6 +1246,7 @@ future<> compaction_manager::drain() {
     cmlog.info("Asked to drain");
     if (*_early_abort_subscription) {
         _state = state::disabled;
+        _tombstone_purge_cv.broadcast();
         co_await stop_ongoing_compactions("drain");
     }
     cmlog.info("Drained");
@@ -1064,6 +1274,8 @@ future<> compaction_manager::really_do_stop() {
     });
     reevaluate_postponed_compactions();
     co_await std::move(_waiting_reevalution);
+    _tombstone_purge_cv.broadcast();
+    co_await std::move(_tombstone_purge_done);
     _weight_tracker.clear();
     _compaction_submission_timer.cancel();
     co_await _compaction_controller.shutdown();
@@ -1228,6 +1440,105 @@ class regular_compaction_task_executor : public compaction_task_executor, public
 
 }
 
+namespace compaction {
+
+class tombstone_purge_compaction_task_executor : public compaction_task_executor, public tombstone_purge_compaction_task_impl {
+public:
+    tombstone_purge_compaction_task_executor(compaction_manager& mgr, throw_if_stopping do_throw_if_stopping, table_state& t)
+        : compaction_task_executor(mgr, do_throw_if_stopping, &t, sstables::compaction_type::Compaction, "Tombstone purge compaction")
+        , tombstone_purge_compaction_task_impl(mgr._task_manager_module, tasks::task_id::create_random_id(), mgr._task_manager_module->new_sequence_number(), t.schema()->ks_name(), t.schema()->cf_name(), "", tasks::task_id::create_null_id())
+    {}
+protected:
+    virtual future<> run() override {
+        return perform();
+    }
+
+    virtual future<compaction_manager::compaction_stats_opt> do_run() override {
+        co_await coroutine::switch_to(_cm.tombstone_purge_sg());
+
+        switch_state(state::pending);
+        // take read lock for table, so major and tombstone purge compaction can't proceed in parallel.
+        auto lock_holder = co_await _compaction_state.lock.hold_read_lock();
+        table_state& t = *_compacting_table;
+        if (!can_proceed() || t.is_auto_compaction_disabled_by_user()) {
+            co_return std::nullopt;
+        }
+
+        sstables::compaction_strategy cs = t.get_compaction_strategy();
+        sstables::compaction_descriptor descriptor = cs.get_tombstone_purge_job(t, _cm.get_candidates(t));
+        if (descriptor.sstables.empty()) {
+            co_return std::nullopt;
+        }
+        auto compacting = compacting_sstable_registration(_cm, _cm.get_compaction_state(&t), descriptor.sstables);
+        auto on_replace = compacting.update_on_sstable_replacement();
+        cmlog.debug("{}: compacting {} to purge tombstones", *this, descriptor.sstables);
+
+        setup_new_compaction(descriptor.run_identifier);
+        std::exception_ptr ex;
+        try {
+            co_await compact_sstables_and_update_history(std::move(descriptor), _compaction_data, on_replace);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        finish_compaction(ex ? state::failed : state::done);
+        if (ex) {
+            co_await coroutine::return_exception_ptr(std::move(ex));
+        }
+        co_return std::nullopt;
+    }
+};
+
+}
+
+future<> compaction_manager::perform_tombstone_purge(table_state& t) {
+    auto gh = start_compaction(t);
+    if (!gh) {
+        co_return;
+    }
+
+    co_await perform_compaction<tombstone_purge_compaction_task_executor>(throw_if_stopping::no, tasks::task_info{}, t).discard_result();
+}
+
+future<> compaction_manager::tombstone_purge_loop() {
+    // Checks for a change of the interval at least this often.
+    constexpr auto max_sleep = std::chrono::seconds(60);
+    auto last_purge = lowres_clock::now();
+    while (_state == state::enabled) {
+        auto interval = std::chrono::seconds(_cfg.tombstone_purge_interval_in_s());
+        auto now = lowres_clock::now();
+        if (interval.count() && now >= last_purge + interval) {
+            // Tables may be removed while others are compacted.
+            auto tables = boost::copy_range<std::vector<table_state*>>(_compaction_state | boost::adaptors::map_keys);
+            for (auto* t : tables) {
+                if (_state != state::enabled) {
+                    co_return;
+                }
+                if (!_compaction_state.contains(t)) {
+                    continue;
+                }
+                try {
+                    co_await perform_tombstone_purge(*t);
+                } catch (...) {
+                    cmlog.warn("Failed to purge tombstones of {}: {}", *t, std::current_exception());
+                }
+                if (_compaction_state.contains(t)) {
+                    // Halve the reads every interval, so that they reflect the recent workload.
+                    t->main_sstable_set().for_each_sstable([] (const sstables::shared_sstable& sst) {
+                        sst->get_stats().decay_reads();
+                    });
+                }
+            }
+            last_purge = now;
+            continue;
+        }
+        auto delay = interval.count() ? std::min<lowres_clock::duration>(last_purge + interval - now, max_sleep) : max_sleep;
+        try {
+            co_await _tombstone_purge_cv.wait(delay);
+        } catch (seastar::condition_variable_timed_out&) {
+        }
+    }
+}
+
 void compaction_manager::submit(table_state& t) {
     if (t.is_auto_compaction_disabled_by_user()) {
         return;
@@ -2022,7 +2333,7 @@ void compaction_manager::propagate_replacement(table_state& t,
         const std::vector<sstables::shared_sstable>& removed, const std::vector<sstables::shared_sstable>& added) {
     for (auto& task : _tasks) {
         if (task->compacting_table() == &t && task->compaction_running()) {
-            task->compaction_data().pending_replacements.push_back({ removed, added });
+            task->add_pending_replacement(removed, added);
         }
     }
 }
@@ -63,6 +63,7 @@ class offstrategy_compaction_task_executor;
 class rewrite_sstables_compaction_task_executor;
 class cleanup_sstables_compaction_task_executor;
 class validate_sstables_compaction_task_executor;
+class tombstone_purge_compaction_task_executor;
 }
 // Compaction manager provides facilities to submit and track compaction jobs on
 // behalf of existing tables.
@@ -82,6 +83,11 @@ class compaction_manager {
         size_t available_memory = 0;
         utils::updateable_value<float> static_shares = utils::updateable_value<float>(0);
         utils::updateable_value<uint32_t> throughput_mb_per_sec = utils::updateable_value<uint32_t>(0);
+        // Number of token sub-ranges a major compaction is split into and compacted in parallel.
+        utils::updateable_value<uint32_t> major_compaction_parallelism = utils::updateable_value<uint32_t>(1);
+        scheduling_group tombstone_purge_sched_group;
+        // How often tables are checked for sstables worth compacting to purge tombstones, 0 to disable.
+        utils::updateable_value<uint32_t> tombstone_purge_interval_in_s = utils::updateable_value<uint32_t>(0);
     };
 
 public:
@@ -122,6 +128,8 @@ class compaction_manager {
     condition_variable _postponed_reevaluation;
     // tables that wait for compaction but had its submission postponed due to ongoing compaction.
     std::unordered_set<compaction::table_state*> _postponed;
+    future<> _tombstone_purge_done = make_ready_future<>();
+    condition_variable _tombstone_purge_cv;
     // tracks taken weights of ongoing compactions, only one compaction per weight is allowed.
     // weight is value assigned to a compaction job that is log base N of total size of all input sstables.
     std::unordered_set<int> _weight_tracker;
@@ -223,6 +231,9 @@ class compaction_manager {
     // similar-sized compaction.
     void postpone_compaction_for_table(compaction::table_state* t);
 
+    // Periodically compacts, table by table, the sstables whose tombstones are worth purging.
+    future<> tombstone_purge_loop();
+
     future<compaction_stats_opt> perform_sstable_scrub_validate_mode(compaction::table_state& t, std::optional<tasks::task_info> info);
     future<> update_static_shares(float shares);
 
@@ -278,6 +289,14 @@ class compaction_manager {
         return _cfg.throughput_mb_per_sec.get();
     }
 
+    const scheduling_group& tombstone_purge_sg() const noexcept {
+        return _cfg.tombstone_purge_sched_group;
+    }
+
+    uint32_t major_compaction_parallelism() const noexcept {
+        return _cfg.major_compaction_parallelism.get();
+    }
+
     void register_metrics();
 
     // enable the compaction manager.
@@ -334,6 +353,10 @@ class compaction_manager {
     // Submit a table for major compaction.
     future<> perform_major_compaction(compaction::table_state& t, std::optional<tasks::task_info> info = std::nullopt);
 
+    // Compacts the sstable of the table whose tombstones are worth purging the most, if any
+    // (see compaction_strategy::get_tombstone_purge_job), and wait for its termination.
+    future<> perform_tombstone_purge(compaction::table_state& t);
+
 
     // Run a custom job for a given table, defined by a function
     // it completes when future returned by job is ready or returns immediately
@@ -445,6 +468,7 @@ class compaction_manager {
     friend class compaction::rewrite_sstables_compaction_task_executor;
     friend class compaction::cleanup_sstables_compaction_task_executor;
     friend class compaction::validate_sstables_compaction_task_executor;
+    friend class compaction::tombstone_purge_compaction_task_executor;
 };
 
 namespace compaction {
@@ -528,6 +552,8 @@ class compaction_task_executor : public enable_shared_from_this<compaction_task_
                                 compaction_manager::can_purge_tombstones can_purge = compaction_manager::can_purge_tombstones::yes,
                                 sstables::offstrategy offstrategy = sstables::offstrategy::no);
     future<> update_history(::compaction::table_state& t, const sstables::compaction_result& res, const sstables::compaction_data& cdata);
+    // Returns the owned ranges of the table if any of the sstables requires cleanup, or null otherwise.
+    owned_ranges_ptr get_owned_ranges_for_cleanup(const std::vector<sstables::shared_sstable>& sstables) const;
     bool should_update_history(sstables::compaction_type ct) {
         return ct == sstables::compaction_type::Compaction;
     }
@@ -558,6 +584,9 @@ class compaction_task_executor : public enable_shared_from_this<compaction_task_
         return _compaction_data;
     }
 
+    // Called when sstables of the compacted table are replaced by another compaction while this one is running.
+    virtual void add_pending_replacement(const std::vector<sstables::shared_sstable>& removed, const std::vector<sstables::shared_sstable>& added);
+
     bool generating_output_run() const noexcept {
         return compaction_running() && _output_run_identifier;
     }
@@ -28,6 +28,7 @@
 #include "size_tiered_compaction_strategy.hh"
 #include "leveled_compaction_strategy.hh"
 #include "time_window_compaction_strategy.hh"
+#include "incremental_compaction_strategy.hh"
 #include "backlog_controller.hh"
 #include "compaction_backlog_manager.hh"
 #include "size_tiered_backlog_tracker.hh"
@@ -66,6 +67,49 @@ bool compaction_strategy_impl::worth_dropping_tombstones(const shared_sstable& s
     return sst->estimate_droppable_tombstone_ratio(gc_before) >= _tombstone_threshold;
 }
 
+// The ratio of tombstones read from an sstable isn't trusted before this many reads.
+static constexpr uint64_t min_reads_for_tombstone_read_ratio = 1000;
+
+shared_sstable compaction_strategy_impl::get_tombstone_purge_candidate(table_state& table_s, const std::vector<shared_sstable>& candidates) const {
+    if (_disable_tombstone_compaction || !table_s.tombstone_gc_enabled()) {
+        return nullptr;
+    }
+    auto compaction_time = gc_clock::now();
+    shared_sstable candidate;
+    std::pair<uint64_t, double> candidate_score;
+    for (auto& sst : candidates) {
+        // See worth_dropping_tombstones().
+        if (db_clock::now() - _tombstone_compaction_interval < sst->data_file_write_time()) {
+            continue;
+        }
+        auto gc_before = sst->get_gc_before_for_drop_estimation(compaction_time, table_s.get_tombstone_gc_state());
+        auto droppable_ratio = sst->estimate_droppable_tombstone_ratio(gc_before);
+        auto& stats = sst->get_stats();
+        bool tombstones_slow_down_reads = droppable_ratio > 0
+                && stats.rows_read() + stats.tombstones_read() >= min_reads_for_tombstone_read_ratio
+                && double(stats.tombstones_read()) / std::max<uint64_t>(stats.rows_read(), 1) >= _tombstone_threshold;
+        if (droppable_ratio < _tombstone_threshold && !tombstones_slow_down_reads) {
+            continue;
+        }
+        // Prefer the sstable whose tombstones are read the most, as purging them speeds up reads the most.
+        auto score = std::make_pair(stats.tombstones_read(), droppable_ratio);
+        if (!candidate || score > candidate_score) {
+            candidate = sst;
+            candidate_score = score;
+        }
+    }
+    return candidate;
+}
+
+compaction_descriptor compaction_strategy_impl::get_tombstone_purge_job(table_state& table_s, std::vector<shared_sstable> candidates) {
+    auto sst = get_tombstone_purge_candidate(table_s, candidates);
+    if (!sst) {
+        return compaction_descriptor();
+    }
+    // The output covers the token range of the input, so it can keep its level and run.
+    return compaction_descriptor({ sst }, sst->get_sstable_level(), compaction_descriptor::default_max_sstable_bytes, sst->run_identifier());
+}
+
 uint64_t compaction_strategy_impl::adjust_partition_estimate(const mutation_source_metadata& ms_meta, uint64_t partition_estimate) const {
     return partition_estimate;
 }
@@ -150,6 +194,9 @@ void compaction_strategy_impl::validate_options_for_strategy_type(const std::map
         case compaction_strategy_type::time_window:
             time_window_compaction_strategy::validate_options(options, unchecked_options);
             break;
+        case compaction_strategy_type::incremental:
+            incremental_compaction_strategy::validate_options(options, unchecked_options);
+            break;
         default:
             break;
     }
@@ -679,6 +726,10 @@ std::vector<compaction_descriptor> compaction_strategy::get_cleanup_compaction_j
     return _compaction_strategy_impl->get_cleanup_compaction_jobs(table_s, std::move(candidates));
 }
 
+compaction_descriptor compaction_strategy::get_tombstone_purge_job(table_state& table_s, std::vector<shared_sstable> candidates) {
+    return _compaction_strategy_impl->get_tombstone_purge_job(table_s, std::move(candidates));
+}
+
 void compaction_strategy::notify_completion(table_state& table_s, const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) {
     _compaction_strategy_impl->notify_completion(table_s, removed, added);
 }
@@ -732,6 +783,9 @@ compaction_strategy make_compaction_strategy(compaction_strategy_type strategy,
     case compaction_strategy_type::time_window:
         impl = ::make_shared<time_window_compaction_strategy>(options);
         break;
+    case compaction_strategy_type::incremental:
+        impl = ::make_shared<incremental_compaction_strategy>(options);
+        break;
     default:
         throw std::runtime_error("strategy not supported");
     }
@@ -747,6 +801,7 @@ compaction_strategy_state compaction_strategy_state::make(const compaction_strat
     switch (cs.type()) {
         case compaction_strategy_type::null:
         case compaction_strategy_type::size_tiered:
+        case compaction_strategy_type::incremental:
             return compaction_strategy_state(default_empty_state{});
         case compaction_strategy_type::leveled:
             return compaction_strategy_state(leveled_compaction_strategy_state{});
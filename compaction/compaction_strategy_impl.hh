@@ -43,6 +43,9 @@ class compaction_strategy_impl {
     static compaction_descriptor make_major_compaction_job(std::vector<sstables::shared_sstable> candidates,
             int level = compaction_descriptor::default_level,
             uint64_t max_sstable_bytes = compaction_descriptor::default_max_sstable_bytes);
+    // Returns the candidate whose tombstones are worth purging and are read the most, or null.
+    // See get_tombstone_purge_job().
+    shared_sstable get_tombstone_purge_candidate(table_state& table_s, const std::vector<shared_sstable>& candidates) const;
 public:
     virtual ~compaction_strategy_impl() {}
     virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) = 0;
@@ -50,6 +53,11 @@ class compaction_strategy_impl {
         return make_major_compaction_job(std::move(candidates));
     }
     virtual std::vector<compaction_descriptor> get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const;
+    // Returns a job compacting an sstable to purge its tombstones, or an empty one. An sstable is
+    // worth it when its droppable tombstone ratio reaches the tombstone threshold, or when the ratio
+    // of tombstones among the rows read from it does, and it has droppable tombstones. Used by the
+    // compaction manager regardless of the compaction jobs the strategy picks on its own.
+    virtual compaction_descriptor get_tombstone_purge_job(table_state& table_s, std::vector<shared_sstable> candidates);
     virtual void notify_completion(table_state& table_s, const std::vector<shared_sstable>& removed, const std::vector<shared_sstable>& added) { }
     virtual compaction_strategy_type type() const = 0;
     virtual bool parallel_compaction() const {
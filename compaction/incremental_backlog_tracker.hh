@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+#include "compaction_backlog_manager.hh"
+#include "incremental_compaction_strategy.hh"
+#include <cmath>
+
+// Backlog for incremental compaction strategy.
+//
+// It's the backlog of size_tiered_backlog_tracker (see size_tiered_backlog_tracker.hh),
+// with runs in place of SSTables, as those are the units bucketed by size. For a run of
+// size Sr, of which Cr bytes were already compacted:
+//
+//   Br = (Sr - Cr) * log4 (T / Sr),
+//
+// so each fragment of the run contributes its effective size times log4 (T / Sr), and
+// the backlog of the Table is, as for STCS:
+//
+//   A = T * log4(T) - C * log4(T) - (Sum(r) { Sr * log4(Sr) } - Sum(r) { Cr * log4(Sr) }).
+//
+// Only runs which belong to buckets which are eligible for compaction contribute.
+class incremental_backlog_tracker final : public compaction_backlog_tracker::impl {
+    struct runs_backlog_contribution {
+        // Sum of Sr * log4(Sr) for the contributing runs.
+        double value = 0.0f;
+        // The size of the run of each fragment of the contributing runs.
+        std::unordered_map<sstables::shared_sstable, uint64_t> run_size;
+    };
+
+    sstables::size_tiered_compaction_strategy_options _stcs_options;
+    int64_t _total_bytes = 0;
+    runs_backlog_contribution _contrib;
+    std::unordered_set<sstables::shared_sstable> _all;
+
+    struct inflight_component {
+        uint64_t total_bytes = 0;
+        double contribution = 0;
+    };
+
+    inflight_component compacted_backlog(const compaction_backlog_tracker::ongoing_compactions& ongoing_compactions) const;
+
+    static double log4(double x) {
+        double inv_log_4 = 1.0f / std::log(4);
+        return log(x) * inv_log_4;
+    }
+
+    static runs_backlog_contribution calculate_runs_backlog_contribution(const std::vector<sstables::shared_sstable>& all, const sstables::size_tiered_compaction_strategy_options& stcs_options);
+public:
+    incremental_backlog_tracker(sstables::size_tiered_compaction_strategy_options stcs_options) : _stcs_options(stcs_options) {}
+
+    virtual double backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const override;
+
+    // Provides strong exception safety guarantees.
+    virtual void replace_sstables(const std::vector<sstables::shared_sstable>& old_ssts, const std::vector<sstables::shared_sstable>& new_ssts) override;
+
+    int64_t total_bytes() const {
+        return _total_bytes;
+    }
+};
@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "sstables/sstables.hh"
+#include "incremental_compaction_strategy.hh"
+#include "incremental_backlog_tracker.hh"
+#include "table_state.hh"
+#include "exceptions/exceptions.hh"
+
+#include <boost/range/adaptors.hpp>
+#include <boost/range/numeric.hpp>
+
+namespace sstables {
+
+extern logging::logger clogger;
+
+static int64_t validate_sstable_size_in_mb(const std::map<sstring, sstring>& options) {
+    auto tmp_value = compaction_strategy_impl::get_value(options, incremental_compaction_strategy::SSTABLE_SIZE_OPTION);
+    auto size = cql3::statements::property_definitions::to_long(incremental_compaction_strategy::SSTABLE_SIZE_OPTION, tmp_value, incremental_compaction_strategy::DEFAULT_MAX_SSTABLE_SIZE_IN_MB);
+    if (size <= 0) {
+        throw exceptions::configuration_exception(fmt::format("{} value ({}) must be positive", incremental_compaction_strategy::SSTABLE_SIZE_OPTION, size));
+    }
+    return size;
+}
+
+static std::optional<double> validate_space_amplification_goal(const std::map<sstring, sstring>& options) {
+    auto tmp_value = compaction_strategy_impl::get_value(options, incremental_compaction_strategy::SPACE_AMPLIFICATION_GOAL_OPTION);
+    if (!tmp_value) {
+        return std::nullopt;
+    }
+    auto goal = cql3::statements::property_definitions::to_double(incremental_compaction_strategy::SPACE_AMPLIFICATION_GOAL_OPTION, tmp_value, 0.0);
+    if (goal <= 1.0) {
+        throw exceptions::configuration_exception(fmt::format("{} value ({}) must be greater than 1.0", incremental_compaction_strategy::SPACE_AMPLIFICATION_GOAL_OPTION, goal));
+    }
+    return goal;
+}
+
+incremental_compaction_strategy::incremental_compaction_strategy(const std::map<sstring, sstring>& options)
+    : compaction_strategy_impl(options)
+    , _options(options)
+    , _fragment_size(uint64_t(validate_sstable_size_in_mb(options)) * 1024 * 1024)
+    , _space_amplification_goal(validate_space_amplification_goal(options))
+{
+}
+
+// options is a map of compaction strategy options and their values.
+// unchecked_options is an analogical map from which already checked options are deleted.
+// This helps making sure that only allowed options are being set.
+void incremental_compaction_strategy::validate_options(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options) {
+    size_tiered_compaction_strategy_options::validate(options, unchecked_options);
+
+    validate_sstable_size_in_mb(options);
+    unchecked_options.erase(SSTABLE_SIZE_OPTION);
+    validate_space_amplification_goal(options);
+    unchecked_options.erase(SPACE_AMPLIFICATION_GOAL_OPTION);
+}
+
+std::vector<sstable_run> incremental_compaction_strategy::make_runs(const std::vector<shared_sstable>& sstables) {
+    std::unordered_map<run_id, sstable_run> runs;
+    std::vector<sstable_run> ret;
+    for (auto& sst : sstables) {
+        if (!runs[sst->run_identifier()].insert(sst)) {
+            sstable_run run;
+            run.insert(sst);
+            ret.push_back(std::move(run));
+        }
+    }
+    ret.reserve(ret.size() + runs.size());
+    for (auto& [_, run] : runs) {
+        ret.push_back(std::move(run));
+    }
+    return ret;
+}
+
+std::vector<std::vector<sstable_run>>
+incremental_compaction_strategy::get_buckets(std::vector<sstable_run> runs, const size_tiered_compaction_strategy_options& options) {
+    std::vector<std::pair<sstable_run, uint64_t>> sorted_runs;
+    sorted_runs.reserve(runs.size());
+    for (auto& run : runs) {
+        auto size = run.data_size();
+        sorted_runs.emplace_back(std::move(run), size);
+    }
+    std::sort(sorted_runs.begin(), sorted_runs.end(), [] (auto& i, auto& j) {
+        return i.second < j.second;
+    });
+
+    std::vector<std::vector<sstable_run>> bucket_list;
+    std::vector<double> bucket_average_size_list;
+    std::vector<uint64_t> bucket_smallest_size_list;
+
+    for (auto& [run, size] : sorted_runs) {
+        // Same as size_tiered_compaction_strategy::get_buckets(): group in the same bucket if the
+        // run is w/in (bucket_low, bucket_high) of the average for this bucket, or this run and
+        // the bucket are all considered "small" (less than min_sstable_size).
+        if (!bucket_list.empty()) {
+            auto& bucket_average_size = bucket_average_size_list.back();
+
+            if ((size > (bucket_average_size * options.bucket_low) && size < (bucket_average_size * options.bucket_high)) ||
+                    (size < options.min_sstable_size && bucket_average_size < options.min_sstable_size)) {
+                auto& bucket = bucket_list.back();
+                auto total_size = bucket.size() * bucket_average_size;
+                auto new_average_size = (total_size + size) / (bucket.size() + 1);
+
+                // Don't let the average drift so high that the smallest run falls out of range.
+                if (size < options.min_sstable_size || bucket_smallest_size_list.back() > new_average_size * options.bucket_low) {
+                    bucket.push_back(std::move(run));
+                    bucket_average_size = new_average_size;
+                    continue;
+                }
+            }
+        }
+
+        bucket_list.push_back({std::move(run)});
+        bucket_average_size_list.push_back(size);
+        bucket_smallest_size_list.push_back(size);
+    }
+
+    return bucket_list;
+}
+
+std::vector<sstable_run>
+incremental_compaction_strategy::most_interesting_bucket(const std::vector<std::vector<sstable_run>>& buckets, unsigned min_threshold, unsigned max_threshold) {
+    // Pick the bucket with more runs, as efficiency of same-tier compactions increases with their number.
+    const std::vector<sstable_run>* most_interesting = nullptr;
+    size_t most_interesting_size = 0;
+    for (auto& bucket : buckets) {
+        if (bucket.size() < min_threshold) {
+            continue;
+        }
+        auto size = std::min(bucket.size(), size_t(max_threshold));
+        if (size > most_interesting_size) {
+            most_interesting = &bucket;
+            most_interesting_size = size;
+        }
+    }
+    if (!most_interesting) {
+        return {};
+    }
+    return std::vector<sstable_run>(most_interesting->begin(), most_interesting->begin() + most_interesting_size);
+}
+
+compaction_descriptor incremental_compaction_strategy::make_job(const std::vector<sstable_run>& runs) const {
+    std::vector<shared_sstable> sstables;
+    for (auto& run : runs) {
+        sstables.insert(sstables.end(), run.all().begin(), run.all().end());
+    }
+    return compaction_descriptor(std::move(sstables), compaction_descriptor::default_level, _fragment_size);
+}
+
+compaction_descriptor incremental_compaction_strategy::get_space_amplification_job(const std::vector<std::vector<sstable_run>>& buckets) const {
+    if (!_space_amplification_goal || buckets.size() < 2) {
+        return compaction_descriptor();
+    }
+    // Most of the live data is in the largest run, so the rest of the table
+    // is an estimate of the space taken by data which was overwritten or deleted.
+    uint64_t total_size = 0;
+    uint64_t largest_run_size = 0;
+    for (auto& bucket : buckets) {
+        for (auto& run : bucket) {
+            auto size = run.data_size();
+            total_size += size;
+            largest_run_size = std::max(largest_run_size, size);
+        }
+    }
+    if (!largest_run_size || double(total_size) / largest_run_size <= *_space_amplification_goal) {
+        return compaction_descriptor();
+    }
+    // Buckets are ordered by size, so the last two are the largest tiers.
+    auto runs = buckets.back();
+    auto& next = buckets[buckets.size() - 2];
+    runs.insert(runs.end(), next.begin(), next.end());
+    clogger.debug("Space amplification {} exceeds the goal of {}, compacting the two largest tiers ({} runs)",
+            double(total_size) / largest_run_size, *_space_amplification_goal, runs.size());
+    return make_job(runs);
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) {
+    int min_threshold = table_s.min_compaction_threshold();
+    int max_threshold = table_s.schema()->max_compaction_threshold();
+    auto compaction_time = gc_clock::now();
+
+    auto buckets = get_buckets(make_runs(candidates), _options);
+
+    if (auto runs = most_interesting_bucket(buckets, min_threshold, max_threshold); !runs.empty()) {
+        return make_job(runs);
+    }
+
+    // If we are not enforcing min_threshold explicitly, try any pair of runs in the same tier.
+    if (!table_s.compaction_enforce_min_threshold()) {
+        if (auto runs = most_interesting_bucket(buckets, 2, max_threshold); !runs.empty()) {
+            return make_job(runs);
+        }
+    }
+
+    if (auto desc = get_space_amplification_job(buckets); !desc.sstables.empty()) {
+        return desc;
+    }
+
+    if (!table_s.tombstone_gc_enabled()) {
+        return compaction_descriptor();
+    }
+
+    // If there is nothing to compact in the standard way, try compacting the single fragment whose
+    // droppable tombstone ratio is greater than the threshold, preferring the oldest fragments
+    // of the biggest tiers like STCS does. Its output covers the same token range, so it replaces
+    // the fragment in its run.
+    for (auto& bucket : buckets | boost::adaptors::reversed) {
+        std::vector<shared_sstable> fragments;
+        for (auto& run : bucket) {
+            for (auto& sst : run.all()) {
+                if (worth_dropping_tombstones(sst, compaction_time, table_s.get_tombstone_gc_state())) {
+                    fragments.push_back(sst);
+                }
+            }
+        }
+        if (fragments.empty()) {
+            continue;
+        }
+        auto it = std::min_element(fragments.begin(), fragments.end(), [] (auto& i, auto& j) {
+            return i->get_stats_metadata().min_timestamp < j->get_stats_metadata().min_timestamp;
+        });
+        auto run_identifier = (*it)->run_identifier();
+        return compaction_descriptor({ *it }, compaction_descriptor::default_level, _fragment_size, run_identifier);
+    }
+    return compaction_descriptor();
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) {
+    return make_major_compaction_job(std::move(candidates), compaction_descriptor::default_level, _fragment_size);
+}
+
+std::vector<compaction_descriptor>
+incremental_compaction_strategy::get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const {
+    std::vector<compaction_descriptor> ret;
+    size_t max_threshold = table_s.schema()->max_compaction_threshold();
+
+    // Runs of the same tier are cleaned up together, up to max_threshold at a time.
+    // Cleanup is incremental, so the size of the runs doesn't matter.
+    for (auto& bucket : get_buckets(make_runs(candidates), _options)) {
+        for (auto it = bucket.begin(); it != bucket.end();) {
+            auto end = it + std::min<size_t>(std::distance(it, bucket.end()), max_threshold);
+            ret.push_back(make_job(std::vector<sstable_run>(it, end)));
+            it = end;
+        }
+    }
+    return ret;
+}
+
+int64_t incremental_compaction_strategy::estimated_pending_compactions(table_state& table_s) const {
+    int min_threshold = table_s.min_compaction_threshold();
+    int max_threshold = table_s.schema()->max_compaction_threshold();
+    auto all_sstables = table_s.main_sstable_set().all();
+    auto sstables = std::vector<shared_sstable>(all_sstables->begin(), all_sstables->end());
+
+    int64_t n = 0;
+    for (auto& bucket : get_buckets(make_runs(sstables), _options)) {
+        if (bucket.size() >= size_t(min_threshold)) {
+            n += std::ceil(double(bucket.size()) / max_threshold);
+        }
+    }
+    return n;
+}
+
+compaction_descriptor
+incremental_compaction_strategy::get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, reshape_mode mode) const {
+    size_t offstrategy_threshold = std::max(schema->min_compaction_threshold(), 4);
+    size_t max_runs = std::max(schema->max_compaction_threshold(), int(offstrategy_threshold));
+
+    if (mode == reshape_mode::relaxed) {
+        offstrategy_threshold = max_runs;
+    }
+
+    // Like size_tiered_compaction_strategy::get_reshaping_job(), but with runs, so that the
+    // fragments of a run, which are of similar size, aren't reshaped among themselves.
+    for (auto& bucket : get_buckets(make_runs(input), _options)) {
+        if (bucket.size() >= offstrategy_threshold) {
+            bucket.erase(bucket.begin() + std::min(bucket.size(), max_runs), bucket.end());
+            auto desc = make_job(bucket);
+            desc.options = compaction_type_options::make_reshape();
+            return desc;
+        }
+    }
+
+    return compaction_descriptor();
+}
+
+std::unique_ptr<compaction_backlog_tracker::impl> incremental_compaction_strategy::make_backlog_tracker() const {
+    return std::make_unique<incremental_backlog_tracker>(_options);
+}
+
+}
+
+incremental_backlog_tracker::inflight_component
+incremental_backlog_tracker::compacted_backlog(const compaction_backlog_tracker::ongoing_compactions& ongoing_compactions) const {
+    inflight_component in;
+    for (auto const& crp : ongoing_compactions) {
+        auto it = _contrib.run_size.find(crp.first);
+        if (it == _contrib.run_size.end()) {
+            continue;
+        }
+        auto compacted = crp.second->compacted();
+        in.total_bytes += compacted;
+        in.contribution += compacted * log4(it->second);
+    }
+    return in;
+}
+
+// Provides strong exception safety guarantees.
+incremental_backlog_tracker::runs_backlog_contribution
+incremental_backlog_tracker::calculate_runs_backlog_contribution(const std::vector<sstables::shared_sstable>& all, const sstables::size_tiered_compaction_strategy_options& stcs_options) {
+    runs_backlog_contribution contrib;
+    if (all.empty()) {
+        return contrib;
+    }
+    using namespace sstables;
+
+    // Deduce threshold from the last SSTable added to the set, as size_tiered_backlog_tracker does.
+    const auto& newest_sst = std::ranges::max(all, std::less<generation_type>(), std::mem_fn(&sstable::generation));
+    size_t threshold = newest_sst->get_schema()->min_compaction_threshold();
+
+    auto buckets = incremental_compaction_strategy::get_buckets(incremental_compaction_strategy::make_runs(all), stcs_options);
+    for (auto& bucket : buckets) {
+        if (bucket.size() < threshold) {
+            continue;
+        }
+        for (auto& run : bucket) {
+            auto size = run.data_size();
+            contrib.value += size * log4(size);
+            for (auto& sst : run.all()) {
+                contrib.run_size.emplace(sst, size);
+            }
+        }
+    }
+
+    return contrib;
+}
+
+double incremental_backlog_tracker::backlog(const compaction_backlog_tracker::ongoing_writes& ow, const compaction_backlog_tracker::ongoing_compactions& oc) const {
+    inflight_component compacted = compacted_backlog(oc);
+
+    auto total_backlog_bytes = boost::accumulate(_contrib.run_size | boost::adaptors::map_keys | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::data_size)), uint64_t(0));
+
+    // Bail out if effective backlog is zero, which happens in a small window where ongoing compaction exhausted
+    // input files but is still sealing output files or doing managerial stuff like updating history table
+    if (total_backlog_bytes <= compacted.total_bytes) {
+        return 0;
+    }
+
+    // For the meaning of each variable, please refer to the doc in incremental_backlog_tracker.hh
+    auto effective_backlog_bytes = total_backlog_bytes - compacted.total_bytes;
+    auto runs_contribution = _contrib.value - compacted.contribution;
+    auto b = (effective_backlog_bytes * log4(_total_bytes)) - runs_contribution;
+    return b > 0 ? b : 0;
+}
+
+// Provides strong exception safety guarantees.
+void incremental_backlog_tracker::replace_sstables(const std::vector<sstables::shared_sstable>& old_ssts, const std::vector<sstables::shared_sstable>& new_ssts) {
+    auto tmp_all = _all;
+    auto tmp_total_bytes = _total_bytes;
+    tmp_all.reserve(_all.size() + new_ssts.size());
+
+    for (auto& sst : old_ssts) {
+        if (sst->data_size() > 0) {
+            auto erased = tmp_all.erase(sst);
+            if (erased) {
+                tmp_total_bytes -= sst->data_size();
+            }
+        }
+    }
+    for (auto& sst : new_ssts) {
+        if (sst->data_size() > 0) {
+            auto [_, inserted] = tmp_all.insert(sst);
+            if (inserted) {
+                tmp_total_bytes += sst->data_size();
+            }
+        }
+    }
+    auto tmp_contrib = calculate_runs_backlog_contribution(boost::copy_range<std::vector<sstables::shared_sstable>>(tmp_all), _stcs_options);
+
+    std::invoke([&] () noexcept {
+        _all = std::move(tmp_all);
+        _total_bytes = tmp_total_bytes;
+        _contrib = std::move(tmp_contrib);
+    });
+}
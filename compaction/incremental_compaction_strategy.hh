@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "compaction_strategy_impl.hh"
+#include "compaction.hh"
+#include "size_tiered_compaction_strategy.hh"
+#include "sstables/sstable_set.hh"
+#include "sstables/shared_sstable.hh"
+
+class incremental_backlog_tracker;
+
+namespace sstables {
+
+// Size-tiered compaction of sstable runs.
+//
+// Runs of similar size are bucketed and compacted together, like sstables are by
+// size_tiered_compaction_strategy, and compaction writes its output as a run of
+// fragments of at most sstable_size_in_mb. As every input is a run of such fragments,
+// compaction releases each input fragment as soon as all of its data was written to
+// sealed output fragments (see regular_compaction), so the temporary space needed by a
+// compaction is a few fragments per input run rather than the size of its whole input.
+//
+// Optionally, when the total size of the table exceeds space_amplification_goal times
+// the size of its largest run, the two largest tiers are compacted together even if
+// they are not of similar size, to get rid of the obsolete data in the largest tier.
+class incremental_compaction_strategy : public compaction_strategy_impl {
+public:
+    static constexpr int32_t DEFAULT_MAX_SSTABLE_SIZE_IN_MB = 1000;
+    static constexpr auto SSTABLE_SIZE_OPTION = "sstable_size_in_mb";
+    static constexpr auto SPACE_AMPLIFICATION_GOAL_OPTION = "space_amplification_goal";
+private:
+    size_tiered_compaction_strategy_options _options;
+    uint64_t _fragment_size = uint64_t(DEFAULT_MAX_SSTABLE_SIZE_IN_MB) * 1024 * 1024;
+    std::optional<double> _space_amplification_goal;
+
+    compaction_descriptor make_job(const std::vector<sstable_run>& runs) const;
+
+    static std::vector<sstable_run>
+    most_interesting_bucket(const std::vector<std::vector<sstable_run>>& buckets, unsigned min_threshold, unsigned max_threshold);
+
+    compaction_descriptor get_space_amplification_job(const std::vector<std::vector<sstable_run>>& buckets) const;
+public:
+    incremental_compaction_strategy(const std::map<sstring, sstring>& options);
+    static void validate_options(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options);
+
+    // Groups the sstables by run. Fragments which don't fit in their run, because they
+    // overlap with another fragment of it, are put in runs of their own.
+    static std::vector<sstable_run> make_runs(const std::vector<shared_sstable>& sstables);
+
+    // Groups runs of similar size into buckets, ordered by size, as
+    // size_tiered_compaction_strategy does with sstables.
+    static std::vector<std::vector<sstable_run>> get_buckets(std::vector<sstable_run> runs, const size_tiered_compaction_strategy_options& options);
+
+    uint64_t fragment_size() const noexcept {
+        return _fragment_size;
+    }
+
+    virtual compaction_descriptor get_sstables_for_compaction(table_state& table_s, strategy_control& control, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual compaction_descriptor get_major_compaction_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) override;
+
+    virtual std::vector<compaction_descriptor> get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const override;
+
+    virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
+
+    virtual compaction_strategy_type type() const override {
+        return compaction_strategy_type::incremental;
+    }
+
+    virtual std::unique_ptr<compaction_backlog_tracker::impl> make_backlog_tracker() const override;
+
+    virtual compaction_descriptor get_reshaping_job(std::vector<shared_sstable> input, schema_ptr schema, reshape_mode mode) const override;
+
+    friend class ::incremental_backlog_tracker;
+};
+
+}
@@ -257,6 +257,41 @@ size_tiered_compaction_strategy::get_sstables_for_compaction(table_state& table_
     return sstables::compaction_descriptor();
 }
 
+compaction_descriptor
+size_tiered_compaction_strategy::get_tombstone_purge_job(table_state& table_s, std::vector<sstables::shared_sstable> candidates) {
+    auto sst = get_tombstone_purge_candidate(table_s, candidates);
+    if (!sst) {
+        return compaction_descriptor();
+    }
+    // Tombstones which shadow data in overlapping sstables can't be purged without that data,
+    // so compact the overlapping sstables along, as long as they are small compared to the
+    // sstable, to purge more for a small amount of extra writes.
+    auto& s = *table_s.schema();
+    auto overlaps = [&s, &sst] (const shared_sstable& other) {
+        return other->get_first_decorated_key().tri_compare(s, sst->get_last_decorated_key()) <= 0
+                && sst->get_first_decorated_key().tri_compare(s, other->get_last_decorated_key()) <= 0;
+    };
+    std::vector<shared_sstable> overlapping;
+    for (auto& other : candidates) {
+        if (other != sst && overlaps(other)) {
+            overlapping.push_back(other);
+        }
+    }
+    std::ranges::sort(overlapping, std::less<>(), std::mem_fn(&sstable::data_size));
+
+    std::vector<shared_sstable> sstables{sst};
+    uint64_t overlapping_size = 0;
+    size_t max_sstables = table_s.schema()->max_compaction_threshold();
+    for (auto& other : overlapping) {
+        if (sstables.size() >= max_sstables || overlapping_size + other->data_size() > sst->data_size()) {
+            break;
+        }
+        overlapping_size += other->data_size();
+        sstables.push_back(other);
+    }
+    return compaction_descriptor(std::move(sstables));
+}
+
 int64_t size_tiered_compaction_strategy::estimated_pending_compactions(const std::vector<sstables::shared_sstable>& sstables,
         int min_threshold, int max_threshold, size_tiered_compaction_strategy_options options) {
     int64_t n = 0;
@@ -44,6 +44,7 @@ class size_tiered_compaction_strategy_options {
     static void validate(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options);
 
     friend class size_tiered_compaction_strategy;
+    friend class incremental_compaction_strategy;
 };
 
 class size_tiered_compaction_strategy : public compaction_strategy_impl {
@@ -81,6 +82,8 @@ class size_tiered_compaction_strategy : public compaction_strategy_impl {
 
     virtual std::vector<compaction_descriptor> get_cleanup_compaction_jobs(table_state& table_s, std::vector<shared_sstable> candidates) const override;
 
+    virtual compaction_descriptor get_tombstone_purge_job(table_state& table_s, std::vector<shared_sstable> candidates) override;
+
     static int64_t estimated_pending_compactions(const std::vector<sstables::shared_sstable>& sstables,
         int min_threshold, int max_threshold, size_tiered_compaction_strategy_options options);
     virtual int64_t estimated_pending_compactions(table_state& table_s) const override;
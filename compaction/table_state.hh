@@ -48,6 +48,8 @@ class table_state {
     virtual sstables::shared_sstable make_sstable() const = 0;
     virtual sstables::sstable_writer_config configure_writer(sstring origin) const = 0;
     virtual api::timestamp_type min_memtable_timestamp() const = 0;
+    // Like min_memtable_timestamp(), but only of the memtables which contain the partition.
+    virtual api::timestamp_type min_memtable_timestamp_for_key(const dht::decorated_key& dk) const = 0;
     virtual future<> on_compaction_completion(sstables::compaction_completion_desc desc, sstables::offstrategy offstrategy) = 0;
     virtual bool is_auto_compaction_disabled_by_user() const noexcept = 0;
     virtual bool tombstone_gc_enabled() const noexcept = 0;
@@ -688,4 +688,25 @@ class regular_compaction_task_impl : public compaction_task_impl {
     virtual future<> run() override = 0;
 };
 
+class tombstone_purge_compaction_task_impl : public compaction_task_impl {
+public:
+    tombstone_purge_compaction_task_impl(tasks::task_manager::module_ptr module,
+            tasks::task_id id,
+            unsigned sequence_number,
+            std::string keyspace,
+            std::string table,
+            std::string entity,
+            tasks::task_id parent_id) noexcept
+        : compaction_task_impl(module, id, sequence_number, "compaction group", std::move(keyspace), std::move(table), std::move(entity), parent_id)
+    {
+        // FIXME: add progress units
+    }
+
+    virtual std::string type() const override {
+        return "tombstone purge compaction";
+    }
+protected:
+    virtual future<> run() override = 0;
+};
+
 }
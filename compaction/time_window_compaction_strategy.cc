@@ -11,6 +11,7 @@
 #include "mutation_writer/timestamp_based_splitting_writer.hh"
 #include "mutation/mutation_source_metadata.hh"
 #include "compaction_strategy_state.hh"
+#include "sstables/sstables_manager.hh"
 
 #include <boost/range/algorithm/find.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
@@ -115,6 +116,42 @@ static time_window_compaction_strategy_options::timestamp_resolutions validate_t
     return timestamp_resolution;
 }
 
+static std::optional<data_dictionary::storage_options::s3> validate_cold_storage(const std::map<sstring, sstring>& options) {
+    auto endpoint = compaction_strategy_impl::get_value(options, time_window_compaction_strategy_options::COLD_STORAGE_ENDPOINT_KEY);
+    auto bucket = compaction_strategy_impl::get_value(options, time_window_compaction_strategy_options::COLD_STORAGE_BUCKET_KEY);
+    if (!endpoint && !bucket) {
+        return std::nullopt;
+    }
+    if (!endpoint || endpoint->empty() || !bucket || bucket->empty()) {
+        throw exceptions::configuration_exception(fmt::format("{} and {} must be set together", time_window_compaction_strategy_options::COLD_STORAGE_ENDPOINT_KEY,
+                time_window_compaction_strategy_options::COLD_STORAGE_BUCKET_KEY));
+    }
+    return data_dictionary::storage_options::s3{.bucket = *bucket, .endpoint = *endpoint};
+}
+
+static std::optional<data_dictionary::storage_options::s3> validate_cold_storage(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options) {
+    auto cold_storage = validate_cold_storage(options);
+    unchecked_options.erase(time_window_compaction_strategy_options::COLD_STORAGE_ENDPOINT_KEY);
+    unchecked_options.erase(time_window_compaction_strategy_options::COLD_STORAGE_BUCKET_KEY);
+    return cold_storage;
+}
+
+static std::chrono::seconds validate_cold_storage_after_seconds(const std::map<sstring, sstring>& options) {
+    auto tmp_value = compaction_strategy_impl::get_value(options, time_window_compaction_strategy_options::COLD_STORAGE_AFTER_SECONDS_KEY);
+    auto cold_storage_after = cql3::statements::property_definitions::to_long(time_window_compaction_strategy_options::COLD_STORAGE_AFTER_SECONDS_KEY, tmp_value,
+            time_window_compaction_strategy_options::DEFAULT_COLD_STORAGE_AFTER_SECONDS().count());
+    if (cold_storage_after <= 0) {
+        throw exceptions::configuration_exception(fmt::format("{} value ({}) must be positive", time_window_compaction_strategy_options::COLD_STORAGE_AFTER_SECONDS_KEY, cold_storage_after));
+    }
+    return std::chrono::seconds(cold_storage_after);
+}
+
+static std::chrono::seconds validate_cold_storage_after_seconds(const std::map<sstring, sstring>& options, std::map<sstring, sstring>& unchecked_options) {
+    auto cold_storage_after = validate_cold_storage_after_seconds(options);
+    unchecked_options.erase(time_window_compaction_strategy_options::COLD_STORAGE_AFTER_SECONDS_KEY);
+    return cold_storage_after;
+}
+
 time_window_compaction_strategy_options::time_window_compaction_strategy_options(const std::map<sstring, sstring>& options) {
     auto window_unit = validate_compaction_window_unit(options);
     int window_size = validate_compaction_window_size(options);
@@ -122,6 +159,8 @@ time_window_compaction_strategy_options::time_window_compaction_strategy_options
     sstable_window_size = window_size * window_unit;
     expired_sstable_check_frequency = validate_expired_sstable_check_frequency_seconds(options);
     timestamp_resolution = validate_timestamp_resolution(options);
+    cold_storage = validate_cold_storage(options);
+    cold_storage_after = validate_cold_storage_after_seconds(options);
 
     auto it = options.find("enable_optimized_twcs_queries");
     if (it != options.end() && it->second == "false") {
@@ -141,6 +180,8 @@ void time_window_compaction_strategy_options::validate(const std::map<sstring, s
     validate_compaction_window_size(options, unchecked_options);
     validate_expired_sstable_check_frequency_seconds(options, unchecked_options);
     validate_timestamp_resolution(options, unchecked_options);
+    validate_cold_storage(options, unchecked_options);
+    validate_cold_storage_after_seconds(options, unchecked_options);
     compaction_strategy_impl::validate_min_max_threshold(options, unchecked_options);
 
     auto it = options.find("enable_optimized_twcs_queries");
@@ -328,11 +369,51 @@ time_window_compaction_strategy::get_sstables_for_compaction(table_state& table_
         clogger.debug("[{}] TWCS skipping check for fully expired SSTables", fmt::ptr(this));
     }
 
-    auto compaction_candidates = get_next_non_expired_sstables(table_s, control, std::move(candidates), compaction_time);
+    auto compaction_candidates = get_next_non_expired_sstables(table_s, control, candidates, compaction_time);
+    if (compaction_candidates.empty() && _options.cold_storage && !table_s.get_sstables_manager().is_known_endpoint(_options.cold_storage->endpoint)) {
+        // The endpoint was validated on the node which altered the table, but it
+        // may be missing from the configuration of this one.
+        if (!std::exchange(state.unknown_cold_storage_endpoint_reported, true)) {
+            clogger.warn("[{}] Not moving the data of {}.{} to cold storage: endpoint {} is not among the configured object-storage endpoints",
+                    fmt::ptr(this), table_s.schema()->ks_name(), table_s.schema()->cf_name(), _options.cold_storage->endpoint);
+        }
+    } else if (compaction_candidates.empty() && _options.cold_storage) {
+        state.unknown_cold_storage_endpoint_reported = false;
+        // The data of an old window is moved to cold storage by rewriting its sstable,
+        // once there is nothing else to compact.
+        if (auto sst = get_next_cold_window_sstable(state, std::move(candidates), api::new_timestamp())) {
+            clogger.debug("[{}] Going to move the data of {} to cold storage", fmt::ptr(this), sst->get_filename());
+            compaction_descriptor desc({ std::move(sst) });
+            desc.remote_data = _options.cold_storage;
+            return desc;
+        }
+    }
     clogger.debug("[{}] Going to compact {} non-expired sstables", fmt::ptr(this), compaction_candidates.size());
     return compaction_descriptor(std::move(compaction_candidates));
 }
 
+shared_sstable
+time_window_compaction_strategy::get_next_cold_window_sstable(const time_window_compaction_strategy_state& state,
+        std::vector<shared_sstable> candidates, timestamp_type now) const {
+    auto cold_before = now - std::chrono::duration_cast<std::chrono::microseconds>(_options.cold_storage_after).count();
+    auto window_size = get_window_size(_options);
+    // Buckets are ordered from the oldest window.
+    for (auto& [key, bucket] : get_buckets(std::move(candidates), _options).first) {
+        if (key + window_size > cold_before) {
+            break;
+        }
+        if (bucket.size() != 1 || state.recent_active_windows.contains(key)) {
+            continue;
+        }
+        auto& sst = bucket.front();
+        if (sst->has_remote_data() || get_window_for(_options, sst->get_stats_metadata().min_timestamp) != key) {
+            continue;
+        }
+        return sst;
+    }
+    return nullptr;
+}
+
 time_window_compaction_strategy::bucket_compaction_mode
 time_window_compaction_strategy::compaction_mode(const time_window_compaction_strategy_state& state,
         const bucket_t& bucket, timestamp_type bucket_key,
@@ -14,6 +14,7 @@
 #include "size_tiered_compaction_strategy.hh"
 #include "timestamp.hh"
 #include "sstables/shared_sstable.hh"
+#include "data_dictionary/storage_options.hh"
 
 namespace sstables {
 
@@ -28,11 +29,15 @@ class time_window_compaction_strategy_options {
     static constexpr std::chrono::seconds DEFAULT_COMPACTION_WINDOW_UNIT = 86400s;
     static constexpr int DEFAULT_COMPACTION_WINDOW_SIZE = 1;
     static constexpr std::chrono::seconds DEFAULT_EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS() { return 600s; }
+    static constexpr std::chrono::seconds DEFAULT_COLD_STORAGE_AFTER_SECONDS() { return 7 * 86400s; }
 
     static constexpr auto TIMESTAMP_RESOLUTION_KEY = "timestamp_resolution";
     static constexpr auto COMPACTION_WINDOW_UNIT_KEY = "compaction_window_unit";
     static constexpr auto COMPACTION_WINDOW_SIZE_KEY = "compaction_window_size";
     static constexpr auto EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS_KEY = "expired_sstable_check_frequency_seconds";
+    static constexpr auto COLD_STORAGE_ENDPOINT_KEY = "cold_storage_endpoint";
+    static constexpr auto COLD_STORAGE_BUCKET_KEY = "cold_storage_bucket";
+    static constexpr auto COLD_STORAGE_AFTER_SECONDS_KEY = "cold_storage_after_seconds";
 
     static const std::unordered_map<sstring, std::chrono::seconds> valid_window_units;
 
@@ -46,6 +51,9 @@ class time_window_compaction_strategy_options {
     db_clock::duration expired_sstable_check_frequency = DEFAULT_EXPIRED_SSTABLE_CHECK_FREQUENCY_SECONDS();
     timestamp_resolutions timestamp_resolution = timestamp_resolutions::microsecond;
     bool enable_optimized_twcs_queries{true};
+    // Where the data of windows older than cold_storage_after is moved to, if engaged.
+    std::optional<data_dictionary::storage_options::s3> cold_storage;
+    std::chrono::seconds cold_storage_after = DEFAULT_COLD_STORAGE_AFTER_SECONDS();
 public:
     time_window_compaction_strategy_options(const time_window_compaction_strategy_options&);
     time_window_compaction_strategy_options(time_window_compaction_strategy_options&&);
@@ -68,6 +76,8 @@ struct time_window_compaction_strategy_state {
     timestamp_type highest_window_seen = 0;
     // Keep track of all recent active windows that still need to be compacted into a single SSTable
     std::unordered_set<timestamp_type> recent_active_windows;
+    // Set once the move to an unknown cold storage endpoint was reported, to log it only once.
+    bool unknown_cold_storage_endpoint_reported = false;
 };
 
 class time_window_compaction_strategy : public compaction_strategy_impl {
@@ -116,6 +126,12 @@ class time_window_compaction_strategy : public compaction_strategy_impl {
     get_next_non_expired_sstables(table_state& table_s, strategy_control& control, std::vector<shared_sstable> non_expiring_sstables, gc_clock::time_point compaction_time);
 
     std::vector<shared_sstable> get_compaction_candidates(table_state& table_s, strategy_control& control, std::vector<shared_sstable> candidate_sstables);
+
+    // Returns the sstable of the oldest window which is older than cold_storage_after,
+    // was compacted into a single sstable, and whose data wasn't moved to cold storage
+    // yet, or nullptr if there is no such window.
+    shared_sstable get_next_cold_window_sstable(const time_window_compaction_strategy_state& state,
+        std::vector<shared_sstable> candidates, timestamp_type now) const;
 public:
     // Find the lowest timestamp for window of given size
     static timestamp_type
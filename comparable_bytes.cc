@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/byteorder.hh>
+#include "comparable_bytes.hh"
+#include "bytes_ostream.hh"
+#include "dht/i_partitioner.hh"
+#include "schema/schema.hh"
+#include "utils/fragment_range.hh"
+
+namespace comparable_bytes {
+
+thread_local utils::updateable_value<bool> global_byte_comparable_keys(false);
+
+namespace {
+
+enum class value_class {
+    unsupported,
+    signed_fixed,
+    unsigned_fixed,
+    unsigned_variable,
+};
+
+struct value_encoding {
+    value_class cls;
+    size_t fixed_size = 0;
+};
+
+value_encoding classify(const abstract_type& t) {
+    using kind = abstract_type::kind;
+    switch (t.without_reversed().get_kind()) {
+    case kind::byte: return {value_class::signed_fixed, 1};
+    case kind::short_kind: return {value_class::signed_fixed, 2};
+    case kind::int32: return {value_class::signed_fixed, 4};
+    case kind::long_kind:
+    case kind::timestamp:
+    case kind::time:
+        return {value_class::signed_fixed, 8};
+    case kind::boolean: return {value_class::unsigned_fixed, 1};
+    case kind::simple_date: return {value_class::unsigned_fixed, 4};
+    case kind::ascii:
+    case kind::utf8:
+    case kind::bytes:
+    case kind::inet:
+    case kind::duration:
+    case kind::date:
+        return {value_class::unsigned_variable};
+    default:
+        return {value_class::unsupported};
+    }
+}
+
+// Writes bytes into out, inverting them if `invert`.
+class sink {
+    bytes_ostream& _out;
+    const uint8_t _mask;
+public:
+    sink(bytes_ostream& out, bool invert) : _out(out), _mask(invert ? 0xff : 0) {}
+
+    void put(uint8_t b) {
+        auto v = int8_t(b ^ _mask);
+        _out.write(bytes_view(&v, 1));
+    }
+};
+
+void encode_value(const abstract_type& t, managed_bytes_view v, sink out) {
+    auto enc = classify(t);
+    switch (enc.cls) {
+    case value_class::signed_fixed:
+    case value_class::unsigned_fixed: {
+        if (v.size_bytes() != enc.fixed_size) {
+            throw marshal_exception(format("comparable_bytes: expected {} bytes for a value of type {}, got {}",
+                    enc.fixed_size, t.name(), v.size_bytes()));
+        }
+        bool first = true;
+        for (bytes_view frag : fragment_range(v)) {
+            for (auto b : frag) {
+                auto u = uint8_t(b);
+                if (first) {
+                    if (enc.cls == value_class::signed_fixed) {
+                        u ^= 0x80;
+                    } else if (t.without_reversed().get_kind() == abstract_type::kind::boolean) {
+                        u = u != 0;
+                    }
+                    first = false;
+                }
+                out.put(u);
+            }
+        }
+        break;
+    }
+    case value_class::unsigned_variable:
+        for (bytes_view frag : fragment_range(v)) {
+            for (auto b : frag) {
+                out.put(uint8_t(b));
+                if (b == 0) {
+                    out.put(0xff);
+                }
+            }
+        }
+        out.put(0);
+        break;
+    case value_class::unsupported:
+        throw std::invalid_argument(format("comparable_bytes: type {} is not byte-comparable", t.name()));
+    }
+}
+
+void encode_clustering_components(const schema& s, const clustering_key_prefix& prefix, bytes_ostream& out) {
+    auto types = s.clustering_key_prefix_type()->types().begin();
+    for (managed_bytes_view c : prefix.components(s)) {
+        const abstract_type& t = **types++;
+        if (c.empty() && classify(t).cls != value_class::unsigned_variable) {
+            // Empty values sort before all other values of their type.
+            auto header = t.is_reversed() ? internal::empty_value_reversed : internal::empty_value;
+            out.write(bytes_view(&header, 1));
+            continue;
+        }
+        out.write(bytes_view(&internal::component_header, 1));
+        encode_value(t, c, sink(out, t.is_reversed()));
+    }
+}
+
+int8_t terminator(bound_weight w) {
+    switch (w) {
+    case bound_weight::before_all_prefixed: return internal::terminator_before;
+    case bound_weight::equal: return internal::terminator_equal;
+    case bound_weight::after_all_prefixed: return internal::terminator_after;
+    }
+    abort();
+}
+
+bytes to_bytes(bytes_ostream&& out) {
+    auto v = out.linearize();
+    return bytes(v.begin(), v.end());
+}
+
+}
+
+bool is_byte_comparable(const abstract_type& t) {
+    return classify(t).cls != value_class::unsupported;
+}
+
+bool clustering_key_is_byte_comparable(const schema& s) {
+    return std::ranges::all_of(s.clustering_key_prefix_type()->types(), [] (const data_type& t) {
+        return is_byte_comparable(*t);
+    });
+}
+
+void encode_value(const abstract_type& t, managed_bytes_view v, bytes_ostream& out) {
+    encode_value(t, v, sink(out, t.is_reversed()));
+}
+
+bytes encode_clustering_prefix(const schema& s, const clustering_key_prefix& prefix, bound_weight w) {
+    bytes_ostream out;
+    encode_clustering_components(s, prefix, out);
+    auto t = terminator(w);
+    out.write(bytes_view(&t, 1));
+    return to_bytes(std::move(out));
+}
+
+bytes encode_position(const schema& s, position_in_partition_view pos) {
+    bytes_ostream out;
+    auto region = int8_t(pos.region());
+    out.write(bytes_view(&region, 1));
+    if (pos.region() == partition_region::clustered) {
+        if (pos.has_key()) {
+            encode_clustering_components(s, pos.key(), out);
+        }
+        auto t = terminator(pos.get_bound_weight());
+        out.write(bytes_view(&t, 1));
+    }
+    return to_bytes(std::move(out));
+}
+
+bytes encode_token(const dht::token& t) {
+    bytes b(bytes::initialized_later(), sizeof(uint64_t));
+    write_be<uint64_t>(reinterpret_cast<char*>(b.begin()), dht::unbias(t));
+    return b;
+}
+
+bytes encode_decorated_key(const schema& s, const dht::decorated_key& dk) {
+    bytes_ostream out;
+    out.write(encode_token(dk.token()));
+    // Legacy forms are compared lexicographically, which holds for the escaped form too.
+    sink dst(out, false);
+    for (auto b : dk.key().legacy_form(s)) {
+        dst.put(uint8_t(b));
+        if (b == 0) {
+            dst.put(0xff);
+        }
+    }
+    dst.put(0);
+    return to_bytes(std::move(out));
+}
+
+}
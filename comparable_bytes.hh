@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "bytes.hh"
+#include "types/types.hh"
+#include "dht/i_partitioner_fwd.hh"
+#include "mutation/position_in_partition.hh"
+#include "utils/updateable_value.hh"
+
+// Byte-comparable (memcmp-orderable) encoding of keys.
+//
+// The encoding of a key is built once, after which keys can be ordered with
+// a single compare_unsigned() of their encodings, with the same result as the
+// schema-aware comparators (position_in_partition::tri_compare,
+// clustering_key_prefix::less_compare, dht::ring_position_comparator), which
+// dispatch on the type of every component on every comparison.
+//
+// Clustering positions are encoded as:
+//
+//   region byte, then for clustered positions:
+//     for every component: a header byte followed by the encoded value
+//     a terminator byte reflecting the bound weight
+//
+// The header byte is component_header (or one of the empty_value_* markers,
+// for empty values of fixed-size types) and sorts after the "before" and
+// "equal" terminators but before the "after" one, so that a prefix compares
+// with its extensions the way bound_view::tri_compare does.
+//
+// Values are encoded depending on their type:
+//
+//   - fixed-size signed integers (tinyint, smallint, int, bigint, timestamp, time):
+//     big-endian with the sign bit flipped
+//   - fixed-size unsigned values (boolean, date): big-endian as serialized
+//   - values ordered by compare_unsigned (blob, ascii, text, inet, duration, legacy date):
+//     zero bytes escaped as {0x00, 0xff}, followed by a 0x00 terminator
+//   - reversed types: the encoding of the underlying type with all bits inverted
+//
+// Other types (floating point, uuids, varint, decimal, collections, tuples...)
+// are not supported. Callers are expected to check is_byte_comparable()
+// for the schema and fall back to the regular comparators otherwise.
+//
+// Tokens are stored encoded in the partition trie index (sstables/trie_index.hh),
+// so encode_token() must stay stable. The other encodings are an in-memory
+// representation only, they are not stable across versions and must never be
+// persisted. The combined reader orders the fragments it merges by their
+// encode_position(), when global_byte_comparable_keys is set.
+
+namespace comparable_bytes {
+
+// Whether the combined reader orders the fragments it merges by their encoded
+// positions (for schemas where clustering_key_is_byte_comparable()).
+// Set from the enable_byte_comparable_keys configuration option.
+extern thread_local utils::updateable_value<bool> global_byte_comparable_keys;
+
+namespace internal {
+
+constexpr int8_t terminator_before = 0x20;
+constexpr int8_t terminator_equal = 0x38;
+constexpr int8_t empty_value = 0x3f;
+constexpr int8_t component_header = 0x40;
+constexpr int8_t empty_value_reversed = 0x41;
+constexpr int8_t terminator_after = 0x60;
+
+}
+
+// Returns true iff values of the type can be encoded.
+bool is_byte_comparable(const abstract_type& t);
+
+// Returns true iff all clustering key components of the schema can be encoded,
+// i.e. whether encode_position() and encode_clustering_prefix() can be used.
+bool clustering_key_is_byte_comparable(const schema& s);
+
+// Appends the encoding of a single value of type t.
+// Precondition: is_byte_comparable(t).
+void encode_value(const abstract_type& t, managed_bytes_view v, bytes_ostream& out);
+
+// Encodes a clustering key prefix, ordered like bound_view::tri_compare() given the weight,
+// and like clustering_key_prefix::less_compare for bound_weight::equal.
+// Precondition: clustering_key_is_byte_comparable(s).
+bytes encode_clustering_prefix(const schema& s, const clustering_key_prefix& prefix, bound_weight w = bound_weight::equal);
+
+// Encodes a position, ordered like position_in_partition::tri_compare.
+// Precondition: clustering_key_is_byte_comparable(s).
+bytes encode_position(const schema& s, position_in_partition_view pos);
+
+// Encodes a token, ordered like dht::token's operator<=>.
+bytes encode_token(const dht::token& t);
+
+// Encodes a decorated key, ordered like dht::decorated_key::tri_compare.
+// Any partition key can be encoded, since keys with equal tokens are ordered
+// by their legacy (serialized) form.
+bytes encode_decorated_key(const schema& s, const dht::decorated_key& dk);
+
+// Orders encodings.
+inline std::strong_ordering tri_compare(bytes_view a, bytes_view b) {
+    return compare_unsigned(a, b);
+}
+
+}
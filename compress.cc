@@ -52,6 +52,17 @@ compressor::compressor(sstring name)
     : _name(std::move(name))
 {}
 
+shared_ptr<compressor> compressor::dictionary_compressor(table_id) const {
+    return {};
+}
+
+size_t compressor::dictionary_sample_size(table_id) const {
+    return 0;
+}
+
+void compressor::train_dictionary(table_id, std::vector<temporary_buffer<char>>) const {
+}
+
 std::set<sstring> compressor::option_names() const {
     return {};
 }
@@ -10,12 +10,15 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <seastar/core/future.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
 
 #include "exceptions/exceptions.hh"
+#include "schema/schema_fwd.hh"
 
 
 class compressor {
@@ -42,6 +45,27 @@ class compressor {
      */
     virtual size_t compress_max_size(size_t input_len) const = 0;
 
+    /**
+     * Dictionary compression.
+     *
+     * A compressor may compress the chunks of an sstable with a dictionary,
+     * trained on the data of the table. The compressor configured for the
+     * table is then only a template: dictionary_compressor() returns the
+     * compressor, bound to the last dictionary trained for the table, to
+     * write a new sstable with, or null if there is none yet.
+     *
+     * Dictionaries are trained in the background, off the reactor. When
+     * dictionary_sample_size() is not 0, that many bytes of the data of the
+     * sstable being written should be passed to train_dictionary(). The
+     * dictionary is then used by the sstables written after it is trained.
+     *
+     * The options() of a compressor bound to a dictionary include the
+     * dictionary, so that it can be recreated by create() for reading.
+     */
+    virtual shared_ptr<compressor> dictionary_compressor(table_id) const;
+    virtual size_t dictionary_sample_size(table_id) const;
+    virtual void train_dictionary(table_id, std::vector<temporary_buffer<char>> samples) const;
+
     /**
      * Returns accepted option names for this compressor
      */
@@ -462,9 +462,11 @@ scylla_tests = set([
     'test/boost/auth_test',
     'test/boost/batchlog_manager_test',
     'test/boost/big_decimal_test',
+    'test/boost/bloom_filter_test',
     'test/boost/broken_sstable_test',
     'test/boost/bytes_ostream_test',
     'test/boost/cache_algorithm_test',
+    'test/boost/cache_warmer_test',
     'test/boost/cache_flat_mutation_reader_test',
     'test/boost/cached_file_test',
     'test/boost/caching_options_test',
@@ -479,6 +481,7 @@ scylla_tests = set([
     'test/boost/clustering_ranges_walker_test',
     'test/boost/column_mapping_test',
     'test/boost/commitlog_test',
+    'test/boost/comparable_bytes_test',
     'test/boost/compound_test',
     'test/boost/compress_test',
     'test/boost/config_test',
@@ -505,6 +508,7 @@ scylla_tests = set([
     'test/boost/flat_mutation_reader_test',
     'test/boost/flush_queue_test',
     'test/boost/fragmented_temporary_buffer_test',
+    'test/boost/frequency_sketch_test',
     'test/boost/frozen_mutation_test',
     'test/boost/gossiping_property_file_snitch_test',
     'test/boost/hash_test',
@@ -570,6 +574,7 @@ scylla_tests = set([
     'test/boost/sstable_generation_test',
     'test/boost/sstable_mutation_test',
     'test/boost/sstable_partition_index_cache_test',
+    'test/boost/sstable_partition_trie_test',
     'test/boost/schema_changes_test',
     'test/boost/sstable_conforms_to_mutation_source_test',
     'test/boost/sstable_compaction_test',
@@ -659,6 +664,7 @@ perf_tests = set([
     'test/perf/perf_idl',
     'test/perf/perf_vint',
     'test/perf/perf_big_decimal',
+    'test/perf/perf_comparable_bytes',
 ])
 
 raft_tests = set([
@@ -798,6 +804,7 @@ scylla_core = (['message/messaging_service.cc',
                 'replica/mutation_dump.cc',
                 'mutation/atomic_cell.cc',
                 'mutation/canonical_mutation.cc',
+                'mutation/columnar_rows.cc',
                 'mutation/frozen_mutation.cc',
                 'mutation/mutation.cc',
                 'mutation/mutation_fragment.cc',
@@ -842,6 +849,7 @@ scylla_core = (['message/messaging_service.cc',
                 'readers/mutation_readers.cc',
                 'mutation_query.cc',
                 'keys.cc',
+                'comparable_bytes.cc',
                 'counters.cc',
                 'compress.cc',
                 'zstd.cc',
@@ -854,12 +862,14 @@ scylla_core = (['message/messaging_service.cc',
                 'sstables/mx/writer.cc',
                 'sstables/kl/reader.cc',
                 'sstables/sstable_version.cc',
+                'sstables/trie_index.cc',
                 'sstables/compress.cc',
                 'sstables/sstable_mutation_reader.cc',
                 'compaction/compaction.cc',
                 'compaction/compaction_strategy.cc',
                 'compaction/size_tiered_compaction_strategy.cc',
                 'compaction/leveled_compaction_strategy.cc',
+                'compaction/incremental_compaction_strategy.cc',
                 'compaction/task_manager_module.cc',
                 'compaction/time_window_compaction_strategy.cc',
                 'compaction/compaction_manager.cc',
@@ -874,6 +884,7 @@ scylla_core = (['message/messaging_service.cc',
                 'transport/event.cc',
                 'transport/event_notifier.cc',
                 'transport/server.cc',
+                'transport/segment.cc',
                 'transport/controller.cc',
                 'transport/messages/result_message.cc',
                 'cdc/cdc_partitioner.cc',
@@ -895,6 +906,7 @@ scylla_core = (['message/messaging_service.cc',
                 'cql3/expr/expression.cc',
                 'cql3/expr/restrictions.cc',
                 'cql3/expr/prepare_expr.cc',
+                'cql3/expr/column_filter.cc',
                 'cql3/functions/user_function.cc',
                 'cql3/functions/functions.cc',
                 'cql3/functions/aggregate_fcts.cc',
@@ -1014,6 +1026,7 @@ scylla_core = (['message/messaging_service.cc',
                 'db/hints/resource_manager.cc',
                 'db/hints/host_filter.cc',
                 'db/hints/sync_point.cc',
+                'db/cache_warmer.cc',
                 'db/config.cc',
                 'db/extensions.cc',
                 'db/heat_load_balance.cc',
@@ -1028,11 +1041,15 @@ scylla_core = (['message/messaging_service.cc',
                 'db/snapshot-ctl.cc',
                 'db/rate_limiter.cc',
                 'db/per_partition_rate_limit_options.cc',
+                'db/sstable_filter_options.cc',
                 'index/secondary_index_manager.cc',
                 'index/secondary_index.cc',
                 'utils/UUID_gen.cc',
                 'utils/i_filter.cc',
                 'utils/bloom_filter.cc',
+                'utils/blocked_bloom_filter.cc',
+                'utils/binary_fuse_filter.cc',
+                'utils/frequency_sketch.cc',
                 'utils/bloom_calculations.cc',
                 'utils/rate_limiter.cc',
                 'utils/file_lock.cc',
@@ -1357,6 +1374,7 @@ pure_boost_tests = set([
     'test/boost/dynamic_bitset_test',
     'test/boost/enum_option_test',
     'test/boost/enum_set_test',
+    'test/boost/frequency_sketch_test',
     'test/boost/idl_test',
     'test/boost/json_test',
     'test/boost/keys_test',
@@ -1455,6 +1473,7 @@ deps['test/boost/linearizing_input_stream_test'] = [
 ]
 deps['test/boost/expr_test'] = ['test/boost/expr_test.cc', 'test/lib/expr_test_utils.cc'] + scylla_core
 deps['test/boost/rate_limiter_test'] = ['test/boost/rate_limiter_test.cc', 'db/rate_limiter.cc']
+deps['test/boost/frequency_sketch_test'] = ['test/boost/frequency_sketch_test.cc', 'utils/frequency_sketch.cc']
 deps['test/boost/exceptions_optimized_test'] = ['test/boost/exceptions_optimized_test.cc', 'utils/exceptions.cc']
 deps['test/boost/exceptions_fallback_test'] = ['test/boost/exceptions_fallback_test.cc', 'utils/exceptions.cc']
 
@@ -0,0 +1,130 @@
+// Copyright (C) 2023-present ScyllaDB
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#include "column_filter.hh"
+
+#include <bit>
+
+#include "evaluate.hh"
+#include "cql3/query_options.hh"
+#include "utils/fragment_range.hh"
+
+namespace cql3::expr {
+
+std::optional<column_filter> column_filter::compile(const column_definition& col, const expression& restr, const query_options& options) {
+    const auto kind = col.type->without_reversed().get_kind();
+    switch (kind) {
+    case abstract_type::kind::int32:
+    case abstract_type::kind::long_kind:
+    case abstract_type::kind::timestamp:
+    case abstract_type::kind::double_kind:
+        break;
+    default:
+        return std::nullopt;
+    }
+    column_filter filter(kind);
+    if (!filter.add(restr, col, options)) {
+        return std::nullopt;
+    }
+    return filter;
+}
+
+bool column_filter::add(const expression& restr, const column_definition& col, const query_options& options) {
+    if (auto conj = as_if<conjunction>(&restr)) {
+        return std::all_of(conj->children.begin(), conj->children.end(), [&] (const expression& child) {
+            return add(child, col, options);
+        });
+    }
+    auto binop = as_if<binary_operator>(&restr);
+    if (!binop || binop->order != comparison_order::cql || binop->null_handling != null_handling_style::sql) {
+        return false;
+    }
+    auto lhs = as_if<column_value>(&binop->lhs);
+    if (!lhs || lhs->col != &col) {
+        return false;
+    }
+    // Only values which are the same for all rows can be evaluated upfront.
+    if (!is<constant>(binop->rhs) && !is<bind_variable>(binop->rhs)) {
+        return false;
+    }
+    if (type_of(binop->rhs)->without_reversed().get_kind() != _kind) {
+        return false;
+    }
+    auto rhs = evaluate(binop->rhs, options);
+    if (rhs.is_null()) {
+        // A comparison with NULL is never true.
+        make_unsatisfiable();
+        return true;
+    }
+    auto rhs_bytes = std::move(rhs).to_managed_bytes();
+    if (rhs_bytes.empty()) {
+        return false;
+    }
+    const auto key = to_key(managed_bytes_view(rhs_bytes));
+    if (_kind == abstract_type::kind::double_kind && key == std::numeric_limits<int64_t>::max()) {
+        // All NaNs share the same key, but = and != compare their bytes.
+        return false;
+    }
+    switch (binop->op) {
+    case oper_t::EQ:
+        _min = std::max(_min, key);
+        _max = std::min(_max, key);
+        _accepts_empty = false;
+        break;
+    case oper_t::NEQ:
+        _excluded.push_back(key);
+        break;
+    case oper_t::LT:
+        if (key == std::numeric_limits<int64_t>::min()) {
+            make_unsatisfiable();
+        } else {
+            _max = std::min(_max, key - 1);
+        }
+        break;
+    case oper_t::LTE:
+        _max = std::min(_max, key);
+        break;
+    case oper_t::GT:
+        if (key == std::numeric_limits<int64_t>::max()) {
+            make_unsatisfiable();
+        } else {
+            _min = std::max(_min, key + 1);
+        }
+        _accepts_empty = false;
+        break;
+    case oper_t::GTE:
+        _min = std::max(_min, key);
+        _accepts_empty = false;
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+void column_filter::make_unsatisfiable() {
+    _min = std::numeric_limits<int64_t>::max();
+    _max = std::numeric_limits<int64_t>::min();
+    _accepts_empty = false;
+}
+
+int64_t column_filter::to_key(managed_bytes_view value) const {
+    switch (_kind) {
+    case abstract_type::kind::int32:
+        return read_simple_exactly<int32_t>(value);
+    case abstract_type::kind::double_kind: {
+        const auto bits = read_simple_exactly<int64_t>(value);
+        if ((bits & std::numeric_limits<int64_t>::max()) > std::bit_cast<int64_t>(std::numeric_limits<double>::infinity())) {
+            // NaN is greater than anything else.
+            return std::numeric_limits<int64_t>::max();
+        }
+        // Flip the magnitude of negative numbers, so that the keys are ordered
+        // like the doubles, with -0 < 0.
+        return bits ^ ((bits >> 63) & std::numeric_limits<int64_t>::max());
+    }
+    default:
+        return read_simple_exactly<int64_t>(value);
+    }
+}
+
+} // namespace cql3::expr
@@ -0,0 +1,73 @@
+// Copyright (C) 2023-present ScyllaDB
+// SPDX-License-Identifier: AGPL-3.0-or-later
+
+#pragma once
+
+#include <algorithm>
+
+#include "expression.hh"
+
+#include "bytes.hh"
+#include "types/types.hh"
+#include "utils/managed_bytes.hh"
+
+namespace cql3 {
+
+class query_options;
+
+} // namespace cql3
+
+namespace cql3::expr {
+
+/// A single column restriction compiled for filtering many rows.
+///
+/// is_satisfied_by() walks the whole expression for every row: it evaluates
+/// both sides of each comparison, looks the column up among the selected ones
+/// and serializes the boolean result. When filtering a scan this dominates
+/// the cost of the query.
+///
+/// A column_filter is made once per query from a conjunction of comparisons
+/// (=, !=, <, <=, >, >=) of a fixed-width column (int, bigint, timestamp or
+/// double) with constants or bind variables. The right-hand sides are evaluated
+/// upfront and folded into a range of the column values, which are mapped to
+/// integers ordered the same way as by the column type, so matching a row
+/// takes a couple of integer comparisons.
+class column_filter {
+    abstract_type::kind _kind;
+    // The range of keys satisfying the restriction, empty if _min > _max.
+    int64_t _min = std::numeric_limits<int64_t>::min();
+    int64_t _max = std::numeric_limits<int64_t>::max();
+    // Keys excluded from the range by != restrictions.
+    std::vector<int64_t> _excluded;
+    // Empty values sort before all others.
+    bool _accepts_empty = true;
+public:
+    /// Compiles restr, a restriction on col, using the bind variable values
+    /// from options. Returns std::nullopt if restr is not of the supported form,
+    /// in which case it has to be evaluated with is_satisfied_by().
+    static std::optional<column_filter> compile(const column_definition& col, const expression& restr, const query_options& options);
+
+    /// Same as is_satisfied_by(restr) when the value of the column is value.
+    bool operator()(const managed_bytes_opt& value) const {
+        return value && matches(managed_bytes_view(*value));
+    }
+    bool operator()(bytes_view value) const {
+        return matches(managed_bytes_view(value));
+    }
+private:
+    explicit column_filter(abstract_type::kind kind) : _kind(kind) {}
+
+    bool add(const expression& restr, const column_definition& col, const query_options& options);
+    void make_unsatisfiable();
+    int64_t to_key(managed_bytes_view value) const;
+
+    bool matches(managed_bytes_view value) const {
+        if (value.empty()) {
+            return _accepts_empty;
+        }
+        const auto key = to_key(value);
+        return key >= _min && key <= _max && std::find(_excluded.begin(), _excluded.end(), key) == _excluded.end();
+    }
+};
+
+} // namespace cql3::expr
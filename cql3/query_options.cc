@@ -119,6 +119,19 @@ query_options::query_options(std::unique_ptr<query_options> qo, lw_shared_ptr<se
 
 }
 
+query_options::query_options(const cql_config& cfg, const query_options& o)
+        : query_options(cfg,
+        o._consistency,
+        std::nullopt,
+        {},
+        o._value_views,
+        o._unset,
+        o._skip_metadata,
+        query_options::specific_options{o._options.page_size,
+                o._options.state ? make_lw_shared<service::pager::paging_state>(*o._options.state) : nullptr,
+                o._options.serial_consistency, o._options.timestamp}) {
+}
+
 query_options::query_options(cql3::raw_value_vector_with_unset values)
     : query_options(
           db::consistency_level::ONE, std::move(values))
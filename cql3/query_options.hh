@@ -163,6 +163,9 @@ class query_options {
     explicit query_options(db::consistency_level, raw_value_vector_with_unset values, specific_options options = specific_options::DEFAULT);
     explicit query_options(std::unique_ptr<query_options>, lw_shared_ptr<service::pager::paging_state> paging_state);
     explicit query_options(std::unique_ptr<query_options>, lw_shared_ptr<service::pager::paging_state> paging_state, int32_t page_size);
+    // Copies prepared options, possibly owned by another shard, for executing the statement
+    // on the current shard. The values are referenced, not copied, so o must outlive the copy.
+    explicit query_options(const cql_config& cfg, const query_options& o);
 
     db::consistency_level get_consistency() const {
         return _consistency;
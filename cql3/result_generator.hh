@@ -9,6 +9,7 @@
 #pragma once
 
 #include "selection/selection.hh"
+#include "result_set.hh"
 #include "stats.hh"
 #include "utils/buffer_view-to-managed_bytes_view.hh"
 
@@ -35,10 +36,10 @@ class result_generator {
     private:
         void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
             if (def.is_multi_cell()) {
-                _visitor.accept_value(utils::buffer_view_to_managed_bytes_view(i.next_collection_cell()));
+                accept_owned_value(_visitor, utils::buffer_view_to_managed_bytes_view(i.next_collection_cell()));
             } else {
                 auto cell = i.next_atomic_cell();
-                _visitor.accept_value(cell ? utils::buffer_view_to_managed_bytes_view(cell->value()) : managed_bytes_view_opt());
+                accept_owned_value(_visitor, cell ? utils::buffer_view_to_managed_bytes_view(cell->value()) : managed_bytes_view_opt());
             }
         }
     public:
@@ -28,12 +28,14 @@ class metadata {
         GLOBAL_TABLES_SPEC = 0,
         HAS_MORE_PAGES = 1,
         NO_METADATA = 2,
+        METADATA_CHANGED = 3,
     };
 
     using flag_enum = super_enum<flag,
         flag::GLOBAL_TABLES_SPEC,
         flag::HAS_MORE_PAGES,
-        flag::NO_METADATA>;
+        flag::NO_METADATA,
+        flag::METADATA_CHANGED>;
 
     using flag_enum_set = enum_set<flag_enum>;
 
@@ -135,6 +137,18 @@ concept ResultVisitor = requires(Visitor& visitor, managed_bytes_view_opt val) {
     visitor.end_row();
 };
 
+// Passes the visitor a value which belongs to the result being visited, and
+// so lives as long as it. Visitors which can make use of that, e.g. to reference
+// the value rather than copy it, implement accept_owned_value().
+template<typename Visitor>
+void accept_owned_value(Visitor& visitor, managed_bytes_view_opt val) {
+    if constexpr (requires { visitor.accept_owned_value(val); }) {
+        visitor.accept_owned_value(std::move(val));
+    } else {
+        visitor.accept_value(std::move(val));
+    }
+}
+
 class result_set {
     using col_type = managed_bytes_opt;
     using row_type = std::vector<col_type>;
@@ -189,7 +203,7 @@ class result_set {
             visitor.start_row();
             for (auto i = 0u; i < column_count; i++) {
                 auto& cell = row[i];
-                visitor.accept_value(cell ? managed_bytes_view_opt(*cell) : managed_bytes_view_opt());
+                accept_owned_value(visitor, cell ? managed_bytes_view_opt(*cell) : managed_bytes_view_opt());
             }
             visitor.end_row();
         }
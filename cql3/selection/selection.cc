@@ -617,7 +617,22 @@ result_set_builder::restrictions_filter::restrictions_filter(::shared_ptr<const
     , _per_partition_remaining(_per_partition_limit)
     , _rows_fetched_for_last_partition(rows_fetched_for_last_partition)
     , _last_pkey(std::move(last_pkey))
-{ }
+{
+    auto compile = [&] (const expr::single_column_restrictions_map& restrictions_map) {
+        for (auto&& [cdef, restr] : restrictions_map) {
+            if (auto filter = expr::column_filter::compile(*cdef, restr, _options)) {
+                _column_filters.emplace(cdef, std::move(*filter));
+            }
+        }
+    };
+    compile(_restrictions->get_non_pk_restriction());
+    if (!_skip_pk_restrictions) {
+        compile(_restrictions->get_single_column_partition_key_restrictions());
+    }
+    if (!_skip_ck_restrictions) {
+        compile(_restrictions->get_single_column_clustering_key_restrictions());
+    }
+}
 
 bool result_set_builder::restrictions_filter::do_filter(const selection& selection,
                                                          const std::vector<bytes>& partition_key,
@@ -630,17 +645,25 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
         return false;
     }
 
+    // Values of the static and regular columns, extracted once per row
+    // when first needed.
+    std::optional<std::vector<managed_bytes_opt>> static_and_regular_columns;
+    auto get_static_and_regular_columns = [&] () -> const std::vector<managed_bytes_opt>& {
+        if (!static_and_regular_columns) {
+            static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
+        }
+        return *static_and_regular_columns;
+    };
+
     const expr::expression& clustering_columns_restrictions = _restrictions->get_clustering_columns_restrictions();
     if (expr::contains_multi_column_restriction(clustering_columns_restrictions)) {
         clustering_key_prefix ckey = clustering_key_prefix::from_exploded(clustering_key);
-        // FIXME: push to upper layer so it happens once per row
-        auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
         bool multi_col_clustering_satisfied = expr::is_satisfied_by(
                 clustering_columns_restrictions,
                 expr::evaluation_inputs{
                     .partition_key = partition_key,
                     .clustering_key = clustering_key,
-                    .static_and_regular_columns = static_and_regular_columns,
+                    .static_and_regular_columns = get_static_and_regular_columns(),
                     .selection = &selection,
                     .options = &_options,
                 });
@@ -652,7 +675,9 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
     auto static_row_iterator = static_row.iterator();
     auto row_iterator = row ? std::optional<query::result_row_view::iterator_type>(row->iterator()) : std::nullopt;
     const expr::single_column_restrictions_map& non_pk_restrictions_map = _restrictions->get_non_pk_restriction();
-    for (auto&& cdef : selection.get_columns()) {
+    const auto& columns = selection.get_columns();
+    for (size_t column_index = 0; column_index < columns.size(); ++column_index) {
+        const column_definition* cdef = columns[column_index];
         switch (cdef->kind) {
         case column_kind::static_column:
             // fallthrough
@@ -664,18 +689,19 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
             if (restr_it == non_pk_restrictions_map.end()) {
                 continue;
             }
-            const expr::expression& single_col_restriction = restr_it->second;
-            // FIXME: push to upper layer so it happens once per row
-            auto static_and_regular_columns = expr::get_non_pk_values(selection, static_row, row);
-            bool regular_restriction_matches = expr::is_satisfied_by(
-                    single_col_restriction,
-                    expr::evaluation_inputs{
-                        .partition_key = partition_key,
-                        .clustering_key = clustering_key,
-                        .static_and_regular_columns = static_and_regular_columns,
-                        .selection = &selection,
-                        .options = &_options,
-                    });
+            const auto& values = get_static_and_regular_columns();
+            auto filter_it = _column_filters.find(cdef);
+            bool regular_restriction_matches = filter_it != _column_filters.end()
+                    ? filter_it->second(values[column_index])
+                    : expr::is_satisfied_by(
+                        restr_it->second,
+                        expr::evaluation_inputs{
+                            .partition_key = partition_key,
+                            .clustering_key = clustering_key,
+                            .static_and_regular_columns = values,
+                            .selection = &selection,
+                            .options = &_options,
+                        });
             if (!regular_restriction_matches) {
                 _current_static_row_does_not_match = (cdef->kind == column_kind::static_column);
                 return false;
@@ -686,21 +712,25 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
             if (_skip_pk_restrictions) {
                 continue;
             }
-            auto partition_key_restrictions_map = _restrictions->get_single_column_partition_key_restrictions();
+            const expr::single_column_restrictions_map& partition_key_restrictions_map =
+                _restrictions->get_single_column_partition_key_restrictions();
             auto restr_it = partition_key_restrictions_map.find(cdef);
             if (restr_it == partition_key_restrictions_map.end()) {
                 continue;
             }
-            const expr::expression& single_col_restriction = restr_it->second;
-            if (!expr::is_satisfied_by(
-                        single_col_restriction,
+            auto filter_it = _column_filters.find(cdef);
+            bool partition_key_restriction_matches = filter_it != _column_filters.end()
+                    ? filter_it->second(bytes_view(partition_key[cdef->id]))
+                    : expr::is_satisfied_by(
+                        restr_it->second,
                         expr::evaluation_inputs{
                             .partition_key = partition_key,
                             .clustering_key = clustering_key,
                             .static_and_regular_columns = {}, // partition key filtering only
                             .selection = &selection,
                             .options = &_options,
-                        })) {
+                        });
+            if (!partition_key_restriction_matches) {
                 _current_partition_key_does_not_match = true;
                 return false;
             }
@@ -719,6 +749,13 @@ bool result_set_builder::restrictions_filter::do_filter(const selection& selecti
             if (clustering_key.empty()) {
                 return false;
             }
+            if (auto filter_it = _column_filters.find(cdef); filter_it != _column_filters.end()) {
+                // A missing component of a partial clustering key is null.
+                if (cdef->id >= clustering_key.size() || !filter_it->second(bytes_view(clustering_key[cdef->id]))) {
+                    return false;
+                }
+                continue;
+            }
             const expr::expression& single_col_restriction = restr_it->second;
             if (!expr::is_satisfied_by(
                         single_col_restriction,
@@ -16,6 +16,7 @@
 #include "selector.hh"
 #include "cql3/column_specification.hh"
 #include "cql3/functions/function.hh"
+#include "cql3/expr/column_filter.hh"
 #include "exceptions/exceptions.hh"
 #include "unimplemented.hh"
 #include <seastar/core/thread.hh>
@@ -217,6 +218,9 @@ class result_set_builder {
         mutable uint64_t _rows_fetched_for_last_partition;
         mutable std::optional<partition_key> _last_pkey;
         mutable bool _is_first_partition_on_page = true;
+        // Single column restrictions which could be compiled, the rest is
+        // evaluated with expr::is_satisfied_by().
+        std::unordered_map<const column_definition*, expr::column_filter> _column_filters;
     public:
         explicit restrictions_filter(::shared_ptr<const restrictions::statement_restrictions> restrictions,
                 const query_options& options,
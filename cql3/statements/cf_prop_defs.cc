@@ -10,16 +10,19 @@
 
 #include "cql3/statements/cf_prop_defs.hh"
 #include "data_dictionary/data_dictionary.hh"
+#include "db/config.hh"
 #include "db/extensions.hh"
 #include "db/tags/extension.hh"
 #include "cdc/log.hh"
 #include "cdc/cdc_extension.hh"
 #include "gms/feature.hh"
 #include "gms/feature_service.hh"
+#include "compaction/time_window_compaction_strategy.hh"
 #include "tombstone_gc_extension.hh"
 #include "tombstone_gc.hh"
 #include "db/per_partition_rate_limit_extension.hh"
 #include "db/per_partition_rate_limit_options.hh"
+#include "db/sstable_filter_extension.hh"
 #include "utils/bloom_calculations.hh"
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -109,6 +112,14 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
         _compaction_strategy_class = sstables::compaction_strategy::type(strategy->second);
         remove_from_map_if_exists(KW_COMPACTION, COMPACTION_STRATEGY_CLASS_KEY);
 
+        // Compaction would fail moving data to an endpoint this node doesn't know.
+        auto cold_storage_endpoint = compaction_type_options.find(sstables::time_window_compaction_strategy_options::COLD_STORAGE_ENDPOINT_KEY);
+        if (cold_storage_endpoint != compaction_type_options.end() && !cold_storage_endpoint->second.empty()
+                && !db.get_config().object_storage_config().contains(cold_storage_endpoint->second)) {
+            throw exceptions::configuration_exception(format("Unknown {} '{}', it is not among the configured object-storage endpoints",
+                    sstables::time_window_compaction_strategy_options::COLD_STORAGE_ENDPOINT_KEY, cold_storage_endpoint->second));
+        }
+
 #if 0
        CFMetaData.validateCompactionOptions(compactionStrategyClass, compactionOptions);
 #endif
@@ -122,11 +133,21 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
         }
         compression_parameters cp(*compression_options);
         cp.validate();
+        // Older nodes would not be able to read the dictionary back from CompressionInfo.db.
+        if (cp.get_compressor() && cp.get_compressor()->dictionary_sample_size() && !db.features().zstd_dictionary_compression) {
+            throw exceptions::configuration_exception("ZSTD dictionary compression is not supported yet by the whole cluster");
+        }
     }
 
     if (auto caching_options = get_caching_options(); caching_options && !caching_options->enabled() && !db.features().per_table_caching) {
         throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'enabled':false\" unless whole cluster supports it");
     }
+    if (auto caching_options = get_caching_options(); caching_options && caching_options->frequency_based_admission() && !db.features().cache_admission_policy) {
+        throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'admission'\" unless whole cluster supports it");
+    }
+    if (auto caching_options = get_caching_options(); caching_options && caching_options->index_pinned() && !db.features().cache_index_pinning) {
+        throw exceptions::configuration_exception(KW_CACHING + " can't contain \"'index'\" unless whole cluster supports it");
+    }
 
     auto cdc_options = get_cdc_options(schema_extensions);
     if (cdc_options && cdc_options->enabled() && !db.features().cdc) {
@@ -138,6 +159,11 @@ void cf_prop_defs::validate(const data_dictionary::database db, sstring ks_name,
         throw exceptions::configuration_exception("Per-partition rate limit is not supported yet by the whole cluster");
     }
 
+    auto sstable_filter_options = get_sstable_filter_options(schema_extensions);
+    if (sstable_filter_options && !db.features().sstable_filter_types) {
+        throw exceptions::configuration_exception("SSTable filter types are not supported yet by the whole cluster");
+    }
+
     auto tombstone_gc_options = get_tombstone_gc_options(schema_extensions);
     validate_tombstone_gc_options(tombstone_gc_options, db, ks_name);
 
@@ -254,6 +280,16 @@ const db::per_partition_rate_limit_options* cf_prop_defs::get_per_partition_rate
     return &ext->get_options();
 }
 
+const db::sstable_filter_options* cf_prop_defs::get_sstable_filter_options(const schema::extensions_map& schema_exts) const {
+    auto it = schema_exts.find(db::sstable_filter_extension::NAME);
+    if (it == schema_exts.end()) {
+        return nullptr;
+    }
+
+    auto ext = dynamic_pointer_cast<db::sstable_filter_extension>(it->second);
+    return &ext->get_options();
+}
+
 void cf_prop_defs::apply_to_builder(schema_builder& builder, schema::extensions_map schema_extensions) const {
     if (has_property(KW_COMMENT)) {
         builder.set_comment(get_string(KW_COMMENT, ""));
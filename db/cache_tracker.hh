@@ -14,11 +14,16 @@
 #include "mutation/partition_version.hh"
 #include "mutation/mutation_cleaner.hh"
 #include "utils/cached_file_stats.hh"
+#include "utils/frequency_sketch.hh"
 #include "sstables/partition_index_cache_stats.hh"
+#include "sstables/index_cache_table.hh"
 
 #include <seastar/core/metrics_registration.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
 
 #include <stdint.h>
+#include <unordered_map>
 
 class cache_entry;
 
@@ -39,6 +44,7 @@ class cache_tracker final {
     friend class cache::read_context;
     friend class cache::autoupdating_underlying_reader;
     friend class cache::cache_flat_mutation_reader;
+    friend class sstables::index_cache_table;
     struct stats {
         uint64_t partition_hits;
         uint64_t partition_misses;
@@ -73,6 +79,12 @@ class cache_tracker final {
         uint64_t row_tombstone_reads;
         uint64_t rows_compacted;
         uint64_t rows_compacted_away;
+        uint64_t columnar_runs_packed;
+        uint64_t columnar_runs_unpacked;
+        uint64_t columnar_runs_dropped;
+        uint64_t columnar_runs;
+        uint64_t columnar_bytes;
+        uint64_t partition_admission_rejections;
 
         uint64_t active_reads() const {
             return reads - reads_done;
@@ -81,6 +93,8 @@ class cache_tracker final {
 private:
     stats _stats{};
     cached_file_stats _index_cached_file_stats{};
+    // Pages of sstable data kept in object storage, see sstable::has_remote_data().
+    cached_file_stats _remote_data_cached_file_stats{};
     partition_index_cache_stats _partition_index_cache_stats{};
     seastar::metrics::metric_groups _metrics;
     logalloc::region _region;
@@ -89,8 +103,22 @@ class cache_tracker final {
     mutation_cleaner _memtable_cleaner;
     mutation_application_stats& _app_stats;
     utils::updateable_value<double> _index_cache_fraction;
+    // Maximum fraction of cache memory which pinned index pages can take.
+    utils::updateable_value<double> _index_cache_pinned_fraction;
+    std::unordered_map<table_id, sstables::index_cache_table*> _index_cache_tables;
+    // Partitions with at least that many rows are packed into columnar_rows
+    // when they get cold. 0 disables packing.
+    utils::updateable_value<uint32_t> _columnar_min_rows;
+    seastar::timer<seastar::lowres_clock> _packing_timer;
+    logalloc::allocating_section _packing_section;
+    uint64_t _row_evictions_at_last_packing = 0;
+    // Access frequencies of partitions, for the admission policy.
+    utils::frequency_sketch _frequencies;
+    uint64_t _row_evictions_at_sketch_reset = 0;
+    bool _evicted_before_sketch_reset = false;
 private:
     void setup_metrics();
+    void on_packing_timer();
 public:
     using register_metrics = bool_class<class register_metrics_tag>;
     cache_tracker(utils::updateable_value<double> index_cache_fraction, mutation_application_stats&, register_metrics);
@@ -138,8 +166,34 @@ class cache_tracker final {
     void set_compaction_scheduling_group(seastar::scheduling_group);
     lru& get_lru() { return _lru; }
     cached_file_stats& get_index_cached_file_stats() { return _index_cached_file_stats; }
+    cached_file_stats& get_remote_data_cached_file_stats() { return _remote_data_cached_file_stats; }
     partition_index_cache_stats& get_partition_index_cache_stats() { return _partition_index_cache_stats; }
+    // Returns the index cache state of the given table, creating it if needed.
+    lw_shared_ptr<sstables::index_cache_table> get_index_cache_table(table_id);
+    void set_index_cache_pinned_fraction(utils::updateable_value<double>);
     seastar::memory::reclaiming_result evict_from_lru_shallow() noexcept;
+
+    // Starts packing cold partitions in the background, see _columnar_min_rows.
+    void set_columnar_min_rows(utils::updateable_value<uint32_t>);
+    // Packs partitions with at least min_rows rows which have entries among the
+    // max_entries least recently used ones, until need_preempt(). Returns the number
+    // of runs of rows packed.
+    size_t pack_cold_partitions(uint32_t min_rows, size_t max_entries);
+    void on_row_packed(rows_entry&) noexcept;
+    void on_row_unpacked(rows_entry&) noexcept;
+    void on_columnar_run_packed(size_t bytes) noexcept;
+    void on_columnar_run_unpacked(size_t bytes) noexcept;
+    void on_columnar_run_dropped(size_t bytes) noexcept;
+
+    // Records an access to the partition with the given hash (see cache_entry::admission_hash()).
+    void record_access(uint64_t partition_hash) noexcept;
+    // TinyLFU admission: when the cache is evicting, admits the partition with the given hash
+    // only if it was accessed more often than the partition which would be evicted next.
+    bool admit(uint64_t partition_hash) noexcept;
+    // Estimated number of recent accesses to the partition with the given hash.
+    unsigned estimate_frequency(uint64_t partition_hash) const noexcept {
+        return _frequencies.estimate(partition_hash);
+    }
 };
 
 inline
@@ -165,6 +219,41 @@ void cache_tracker::insert(rows_entry& more_recent, rows_entry& entry) noexcept
     _lru.add_before(more_recent, entry);
 }
 
+inline
+void cache_tracker::on_row_packed(rows_entry& entry) noexcept {
+    --_stats.rows;
+    if (entry.is_linked()) {
+        _lru.remove(entry);
+    }
+}
+
+inline
+void cache_tracker::on_row_unpacked(rows_entry& entry) noexcept {
+    ++_stats.rows;
+    _lru.add(entry);
+}
+
+inline
+void cache_tracker::on_columnar_run_packed(size_t bytes) noexcept {
+    ++_stats.columnar_runs_packed;
+    ++_stats.columnar_runs;
+    _stats.columnar_bytes += bytes;
+}
+
+inline
+void cache_tracker::on_columnar_run_unpacked(size_t bytes) noexcept {
+    ++_stats.columnar_runs_unpacked;
+    --_stats.columnar_runs;
+    _stats.columnar_bytes -= bytes;
+}
+
+inline
+void cache_tracker::on_columnar_run_dropped(size_t bytes) noexcept {
+    ++_stats.columnar_runs_dropped;
+    --_stats.columnar_runs;
+    _stats.columnar_bytes -= bytes;
+}
+
 inline
 void cache_tracker::insert(partition_version& pv) noexcept {
     insert(pv.partition());
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/coroutine/exception.hh>
+#include <seastar/coroutine/maybe_yield.hh>
+#include <seastar/util/closeable.hh>
+#include <seastar/util/file.hh>
+
+#include "db/cache_warmer.hh"
+#include "replica/database.hh"
+#include "row_cache.hh"
+#include "bytes_ostream.hh"
+#include "checked-file-impl.hh"
+#include "utils/fragment_range.hh"
+#include "utils/lister.hh"
+#include "log.hh"
+
+static logging::logger cwlogger("cache_warmer");
+
+namespace db {
+
+static constexpr uint32_t saved_keys_magic = 0x52434b53; // "RCKS"
+static constexpr uint32_t saved_keys_version = 1;
+static constexpr std::string_view saved_keys_prefix = "row_cache-";
+static constexpr std::string_view saved_keys_suffix = ".keys";
+
+namespace {
+
+template <typename T>
+void write_be(bytes_ostream& out, T v) {
+    v = net::hton(v);
+    out.write(bytes_view(reinterpret_cast<const bytes::value_type*>(&v), sizeof(v)));
+}
+
+}
+
+std::vector<cache_warmer::saved_key> cache_warmer::parse_saved_keys(const temporary_buffer<char>& buf) {
+    auto in = single_fragmented_view(bytes_view(reinterpret_cast<const bytes::value_type*>(buf.get()), buf.size()));
+    if (read_simple<uint32_t>(in) != saved_keys_magic) {
+        throw std::runtime_error("bad magic");
+    }
+    if (auto version = read_simple<uint32_t>(in); version != saved_keys_version) {
+        throw std::runtime_error(format("unsupported version {}", version));
+    }
+    std::vector<saved_key> keys;
+    auto table_count = read_simple<uint32_t>(in);
+    for (uint32_t i = 0; i < table_count; ++i) {
+        auto msb = read_simple<uint64_t>(in);
+        auto lsb = read_simple<uint64_t>(in);
+        auto id = table_id(utils::UUID(msb, lsb));
+        auto key_count = read_simple<uint32_t>(in);
+        for (uint32_t j = 0; j < key_count; ++j) {
+            auto frequency = read_simple<uint8_t>(in);
+            auto size = read_simple<uint32_t>(in);
+            if (size > in.size_bytes()) {
+                throw std::runtime_error("truncated key");
+            }
+            keys.push_back(saved_key{id, partition_key::from_bytes(in.prefix(size).current_fragment()), frequency});
+            in.remove_prefix(size);
+        }
+    }
+    if (in.size_bytes()) {
+        throw std::runtime_error(format("{} trailing bytes", in.size_bytes()));
+    }
+    return keys;
+}
+
+cache_warmer::cache_warmer(sharded<replica::database>& db, config cfg)
+    : _db(db)
+    , _cfg(std::move(cfg))
+{
+    namespace sm = seastar::metrics;
+    _metrics.add_group("cache", {
+        sm::make_counter("warmup_partitions", _stats.partitions_warmed_up,
+                       sm::description("total number of partitions read into the cache when warming it up on startup")),
+        sm::make_counter("warmup_bytes", _stats.bytes_warmed_up,
+                       sm::description("total size of the partitions read into the cache when warming it up on startup")),
+        sm::make_counter("saved_partitions", _stats.partitions_saved,
+                       sm::description("total number of partition keys saved for warming up the cache on restart")),
+    });
+}
+
+sstring cache_warmer::file_name(shard_id shard) const {
+    return format("{}/{}{}{}", _cfg.directory, saved_keys_prefix, shard, saved_keys_suffix);
+}
+
+future<> cache_warmer::start() {
+    _warmup = with_scheduling_group(_cfg.sched_group, [this] {
+        return warm_up();
+    }).handle_exception([] (std::exception_ptr ep) {
+        cwlogger.warn("Failed to warm up the cache: {}", ep);
+    });
+    _saver = save_loop();
+    return make_ready_future<>();
+}
+
+future<> cache_warmer::stop() {
+    _as.request_abort();
+    co_await std::move(_warmup);
+    co_await std::move(_saver);
+}
+
+future<> cache_warmer::save_loop() {
+    // Checks for a change of the period at least this often.
+    constexpr auto max_sleep = std::chrono::seconds(60);
+    auto last_save = lowres_clock::now();
+    while (!_as.abort_requested()) {
+        auto period = std::chrono::seconds(_cfg.save_period_in_s());
+        auto now = lowres_clock::now();
+        if (period.count() && now >= last_save + period) {
+            try {
+                co_await save();
+                if (this_shard_id() == 0) {
+                    co_await remove_stale_files();
+                }
+            } catch (...) {
+                cwlogger.warn("Failed to save the keys of hot partitions: {}", std::current_exception());
+            }
+            last_save = now;
+            continue;
+        }
+        auto delay = period.count() ? std::min<lowres_clock::duration>(last_save + period - now, max_sleep) : max_sleep;
+        try {
+            co_await sleep_abortable(delay, _as);
+        } catch (sleep_aborted&) {
+            co_return;
+        }
+    }
+}
+
+future<> cache_warmer::save() {
+    std::vector<lw_shared_ptr<replica::table>> tables;
+    _db.local().get_tables_metadata().for_each_table([&tables] (table_id, lw_shared_ptr<replica::table> t) {
+        if (t->cache_enabled()) {
+            tables.push_back(std::move(t));
+        }
+    });
+
+    bytes_ostream body;
+    uint32_t table_count = 0;
+    uint64_t key_count = 0;
+    for (auto& t : tables) {
+        auto hot = co_await t->get_row_cache().get_hot_partitions(_cfg.keys_to_save());
+        if (hot.empty()) {
+            continue;
+        }
+        ++table_count;
+        write_be<uint64_t>(body, t->schema()->id().uuid().get_most_significant_bits());
+        write_be<uint64_t>(body, t->schema()->id().uuid().get_least_significant_bits());
+        write_be<uint32_t>(body, hot.size());
+        for (auto& p : hot) {
+            managed_bytes_view key = p.key.key().representation();
+            write_be<uint8_t>(body, p.frequency);
+            write_be<uint32_t>(body, key.size_bytes());
+            for (bytes_view frag : fragment_range(key)) {
+                body.write(frag);
+            }
+            co_await coroutine::maybe_yield();
+        }
+        key_count += hot.size();
+    }
+
+    bytes_ostream header;
+    write_be<uint32_t>(header, saved_keys_magic);
+    write_be<uint32_t>(header, saved_keys_version);
+    write_be<uint32_t>(header, table_count);
+
+    // Replace the previous file atomically, so that a crash doesn't leave a truncated one.
+    auto name = file_name(this_shard_id());
+    auto tmp_name = name + ".tmp";
+    auto f = co_await open_checked_file_dma(general_disk_error_handler, tmp_name, open_flags::wo | open_flags::create | open_flags::truncate);
+    auto out = co_await make_file_output_stream(std::move(f));
+    std::exception_ptr ex;
+    try {
+        for (auto* part : {&header, &body}) {
+            for (bytes_view frag : part->fragments()) {
+                co_await out.write(reinterpret_cast<const char*>(frag.data()), frag.size());
+            }
+        }
+        co_await out.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await out.close();
+
+    if (ex) {
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+
+    co_await io_check(rename_file, tmp_name, name);
+    co_await io_check(sync_directory, _cfg.directory);
+    _stats.partitions_saved += key_count;
+    cwlogger.debug("Saved {} keys of {} tables to {}", key_count, table_count, name);
+}
+
+future<> cache_warmer::remove_stale_files() {
+    // Left by a previous run with more shards, which would be warmed up again on every restart.
+    std::vector<sstring> stale;
+    co_await lister::scan_dir(fs::path(_cfg.directory), lister::dir_entry_types::of<directory_entry_type::regular>(),
+            [this, &stale] (fs::path dir, directory_entry de) {
+        for (shard_id shard = 0; shard < smp::count; ++shard) {
+            if ((dir / de.name.c_str()).native() == file_name(shard)) {
+                return make_ready_future<>();
+            }
+        }
+        if (de.name.starts_with(saved_keys_prefix) && de.name.ends_with(saved_keys_suffix)) {
+            stale.push_back((dir / de.name.c_str()).native());
+        }
+        return make_ready_future<>();
+    });
+    for (auto& name : stale) {
+        cwlogger.debug("Removing {}", name);
+        co_await io_check(remove_file, name);
+    }
+}
+
+future<> cache_warmer::warm_up() {
+    if (!_cfg.throughput_mb_per_sec()) {
+        co_return;
+    }
+    auto& db = _db.local();
+
+    std::vector<sstring> files;
+    co_await lister::scan_dir(fs::path(_cfg.directory), lister::dir_entry_types::of<directory_entry_type::regular>(),
+            [&files] (fs::path dir, directory_entry de) {
+        if (de.name.starts_with(saved_keys_prefix) && de.name.ends_with(saved_keys_suffix)) {
+            files.push_back((dir / de.name.c_str()).native());
+        }
+        return make_ready_future<>();
+    });
+
+    struct key_to_warm_up {
+        table_id table;
+        dht::decorated_key key;
+        unsigned frequency;
+    };
+    std::vector<key_to_warm_up> keys;
+    for (auto& name : files) {
+        try {
+            auto buf = co_await seastar::util::read_entire_file_contiguous(fs::path(name));
+            for (auto& k : parse_saved_keys(buf)) {
+                auto t = db.get_tables_metadata().get_table_if_exists(k.table);
+                if (!t || !t->cache_enabled()) {
+                    continue;
+                }
+                auto dk = dht::decorate_key(*t->schema(), std::move(k.key));
+                if (t->shard_of(dk.token()) == this_shard_id()) {
+                    keys.push_back(key_to_warm_up{k.table, std::move(dk), k.frequency});
+                }
+                co_await coroutine::maybe_yield();
+            }
+        } catch (...) {
+            cwlogger.warn("Ignoring saved keys in {}: {}", name, std::current_exception());
+        }
+    }
+    if (keys.empty()) {
+        co_return;
+    }
+    // The files of all shards are merged, so the order within each of them is lost.
+    std::stable_sort(keys.begin(), keys.end(), [] (const key_to_warm_up& a, const key_to_warm_up& b) {
+        return a.frequency > b.frequency;
+    });
+
+    cwlogger.info("Warming up the row cache with {} partitions", keys.size());
+    auto start = lowres_clock::now();
+    uint64_t partitions = 0;
+    uint64_t bytes = 0;
+    for (auto& k : keys) {
+        uint64_t throughput = uint64_t(_cfg.throughput_mb_per_sec()) << 20;
+        if (_as.abort_requested() || !throughput) {
+            break;
+        }
+        auto t = db.get_tables_metadata().get_table_if_exists(k.table);
+        if (!t || !t->cache_enabled()) {
+            continue;
+        }
+        // Reading through the cache populates it.
+        size_t size = 0;
+        try {
+            auto s = t->schema();
+            auto permit = co_await db.obtain_reader_permit(*t, "cache_warmup", no_timeout, {});
+            auto range = dht::partition_range::make_singular(k.key);
+            co_await with_closeable(t->make_reader_v2(s, std::move(permit), range, s->full_slice()), [&size] (flat_mutation_reader_v2& rd) {
+                return rd.consume_pausable([&size] (mutation_fragment_v2 mf) {
+                    size += mf.memory_usage();
+                    return stop_iteration::no;
+                });
+            });
+        } catch (...) {
+            cwlogger.debug("Failed to warm up {} of table {}: {}", k.key, k.table, std::current_exception());
+            continue;
+        }
+        ++partitions;
+        bytes += size;
+        ++_stats.partitions_warmed_up;
+        _stats.bytes_warmed_up += size;
+
+        auto due = start + std::chrono::duration_cast<lowres_clock::duration>(std::chrono::duration<double>(double(bytes) / throughput));
+        auto now = lowres_clock::now();
+        if (due > now) {
+            try {
+                co_await sleep_abortable(due - now, _as);
+            } catch (sleep_aborted&) {
+                break;
+            }
+        }
+    }
+    cwlogger.info("Warmed up the row cache with {} partitions ({} bytes) in {} seconds", partitions, bytes,
+            std::chrono::duration_cast<std::chrono::seconds>(lowres_clock::now() - start).count());
+}
+
+}
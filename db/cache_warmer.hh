@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/sharded.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/metrics_registration.hh>
+
+#include "replica/database_fwd.hh"
+#include "keys.hh"
+#include "schema/schema_fwd.hh"
+#include "utils/updateable_value.hh"
+
+using namespace seastar;
+
+namespace db {
+
+// Keeps the row cache warm across restarts.
+//
+// Every shard periodically saves the keys (not the data) of the most frequently
+// read partitions in its row cache, per table, to saved_caches_directory.
+// On startup, every shard reads the partitions it owns among the keys saved by all
+// shards of the previous run (so that a change of the shard count doesn't lose them)
+// into its cache, hottest first, in the background and with limited throughput.
+//
+// Each shard saves to its own file, row_cache-<shard>.keys. Integers are big-endian:
+//
+//   u32        magic
+//   u32        format version
+//   u32        number of tables
+//   for each table:
+//     2 x u64  table id
+//     u32      number of keys
+//     for each key:
+//       u8     estimated read frequency
+//       u32    length of the partition key
+//              partition key
+class cache_warmer : public peering_sharded_service<cache_warmer> {
+public:
+    struct config {
+        sstring directory;
+        // Seconds between saves, 0 disables saving.
+        utils::updateable_value<uint32_t> save_period_in_s;
+        // Keys to save per table, 0 means all.
+        utils::updateable_value<uint32_t> keys_to_save;
+        // 0 disables warming up.
+        utils::updateable_value<uint32_t> throughput_mb_per_sec;
+        scheduling_group sched_group;
+    };
+
+    struct stats {
+        uint64_t partitions_saved = 0;
+        uint64_t partitions_warmed_up = 0;
+        uint64_t bytes_warmed_up = 0;
+    };
+
+    struct saved_key {
+        table_id table;
+        partition_key key;
+        unsigned frequency;
+    };
+private:
+    sharded<replica::database>& _db;
+    config _cfg;
+    stats _stats;
+    abort_source _as;
+    future<> _saver = make_ready_future<>();
+    future<> _warmup = make_ready_future<>();
+    seastar::metrics::metric_groups _metrics;
+public:
+    cache_warmer(sharded<replica::database>& db, config cfg);
+
+    // Starts warming up the cache in the background, and saving the hot keys periodically.
+    // Must be called after the tables are loaded.
+    future<> start();
+    future<> stop();
+
+    // Saves the keys of the hottest partitions of every table on this shard.
+    future<> save();
+    // Reads the partitions of this shard among the saved ones into the cache.
+    // Resolves when done, or when stopped.
+    future<> warm_up();
+
+    const stats& get_stats() const noexcept { return _stats; }
+
+    // The file the given shard saves its keys to.
+    sstring file_name(shard_id) const;
+    // Parses the contents of a file written by save(), in the order they were saved.
+    // Throws if they are truncated or otherwise malformed.
+    static std::vector<saved_key> parse_saved_keys(const temporary_buffer<char>& buf);
+private:
+    future<> save_loop();
+    future<> remove_stale_files();
+};
+
+}
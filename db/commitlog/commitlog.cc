@@ -36,6 +36,7 @@
 #include <seastar/core/coroutine.hh>
 #include <seastar/coroutine/parallel_for_each.hh>
 #include <seastar/coroutine/switch_to.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/net/byteorder.hh>
 #include <seastar/util/defer.hh>
 
@@ -49,6 +50,8 @@
 #include "utils/crc.hh"
 #include "utils/runtime.hh"
 #include "utils/flush_queue.hh"
+#include "utils/estimated_histogram.hh"
+#include "utils/histogram_metrics_helper.hh"
 #include "log.hh"
 #include "commitlog_entry.hh"
 #include "commitlog_extensions.hh"
@@ -58,6 +61,8 @@
 #include <boost/range/adaptor/transformed.hpp>
 
 #include "checked-file-impl.hh"
+#include "compress.hh"
+#include "bytes_ostream.hh"
 #include "utils/disk-error-handler.hh"
 
 static logging::logger clogger("commitlog");
@@ -105,7 +110,13 @@ db::commitlog::config db::commitlog::config::from_db_config(const db::config& cf
     c.commitlog_total_space_in_mb = cfg.commitlog_total_space_in_mb() >= 0 ? cfg.commitlog_total_space_in_mb() : (shard_available_memory * smp::count) >> 20;
     c.commitlog_segment_size_in_mb = cfg.commitlog_segment_size_in_mb();
     c.commitlog_sync_period_in_ms = cfg.commitlog_sync_period_in_ms();
-    c.mode = cfg.commitlog_sync() == "batch" ? sync_mode::BATCH : sync_mode::PERIODIC;
+    c.mode = cfg.commitlog_sync() == "batch" ? sync_mode::BATCH
+            : cfg.commitlog_sync() == "group" ? sync_mode::GROUP
+            : sync_mode::PERIODIC;
+    c.commitlog_sync_group_window_max_in_us = cfg.commitlog_sync_group_window_max_in_us();
+    c.chunk_compression = cfg.commitlog_compression() == "lz4" ? compression::LZ4
+            : cfg.commitlog_compression() == "zstd" ? compression::ZSTD
+            : compression::NONE;
     c.extensions = &cfg.extensions();
     c.use_o_dsync = cfg.commitlog_use_o_dsync();
     c.allow_going_over_size_limit = !cfg.commitlog_use_hard_size_limit();
@@ -230,6 +241,8 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     // we distribute stuff more or less equally across shards.
     const uint64_t max_disk_size; // per-shard
     const uint64_t disk_usage_threshold;
+    // Compresses the chunks of new segments, if set.
+    const compressor_ptr chunk_compressor;
 
     bool _shutdown = false;
     std::optional<shared_promise<>> _shutdown_promise = {};
@@ -363,8 +376,10 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
     struct stats : public byte_flow<uint64_t> {
         uint64_t cycle_count = 0;
         uint64_t flush_count = 0;
+        uint64_t group_commits = 0;
         uint64_t allocation_count = 0;
         uint64_t bytes_slack = 0;
+        uint64_t bytes_saved_by_compression = 0;
         uint64_t segments_created = 0;
         uint64_t segments_destroyed = 0;
         uint64_t pending_flushes = 0;
@@ -378,6 +393,9 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         uint64_t requests_blocked_memory = 0;
         uint64_t blocked_on_new_segment = 0;
         uint64_t active_allocations = 0;
+        // Allocations which hold their memory units and don't wait for a sync
+        // or a new segment, so may still be added to the current buffer.
+        uint64_t joinable_allocations = 0;
     };
 
     class scope_increment_counter {
@@ -393,8 +411,38 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         }
     };
 
+    // Like scope_increment_counter, but can stop and resume counting.
+    class scope_toggle_counter {
+        uint64_t& _dst;
+        bool _counted = false;
+    public:
+        explicit scope_toggle_counter(uint64_t& dst) noexcept
+            : _dst(dst)
+        { }
+        ~scope_toggle_counter() {
+            stop();
+        }
+        void start() noexcept {
+            if (!std::exchange(_counted, true)) {
+                ++_dst;
+            }
+        }
+        void stop() noexcept {
+            if (std::exchange(_counted, false)) {
+                --_dst;
+            }
+        }
+    };
+
     stats totals;
     byte_flow<uint64_t> last_bytes;
+
+    // Number of allocations persisted by each GROUP mode sync.
+    utils::approx_exponential_histogram<2, 4096, 2> group_commit_size;
+    // Latency of GROUP mode syncs, in microseconds.
+    utils::approx_exponential_histogram<16, 16777216, 4> group_commit_latency;
+    // Moving average of the latency of GROUP mode syncs, in microseconds.
+    double group_commit_avg_latency_us = 0;
     byte_flow<double> bytes_rate;
 
     typename std::chrono::high_resolution_clock::time_point last_time;
@@ -415,6 +463,33 @@ class db::commitlog::segment_manager : public ::enable_shared_from_this<segment_
         _flush_semaphore.signal();
         --totals.pending_flushes;
     }
+
+    // How long a GROUP mode sync of a buffer should wait for more allocations.
+    //
+    // The joinable allocations are about to be added to the buffer, and each will need a
+    // sync of its own if it misses this one. So the more of them, the longer we wait, up to
+    // about the latency of a sync, which is what waiting for the next one would cost.
+    // Allocations waiting for memory, or for an earlier sync, can't make it into this
+    // buffer, so they don't count. No wait when nobody else is writing, so a lone writer
+    // gets batch mode latency.
+    std::chrono::microseconds group_commit_window() const {
+        auto joining = totals.joinable_allocations;
+        if (!joining) {
+            return std::chrono::microseconds(0);
+        }
+        auto window = group_commit_avg_latency_us * joining / (joining + 1);
+        return std::min(std::chrono::microseconds(uint64_t(window)),
+                std::chrono::microseconds(cfg.commitlog_sync_group_window_max_in_us));
+    }
+    void account_group_commit(uint64_t batched, std::chrono::steady_clock::duration latency) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+        ++totals.group_commits;
+        group_commit_size.add(batched);
+        group_commit_latency.add(us);
+        // Weigh the recent syncs most, so that the window follows the load of the disk.
+        constexpr double alpha = 0.2;
+        group_commit_avg_latency_us = group_commit_avg_latency_us ? (1 - alpha) * group_commit_avg_latency_us + alpha * us : us;
+    }
     segment_manager(config c);
     ~segment_manager() {
         clogger.trace("Commitlog {} disposed", cfg.commit_log_location);
@@ -619,6 +694,18 @@ std::enable_if_t<std::is_fundamental<T>::value, T> read(Input& in) {
     return net::ntoh(in.template read<T>());
 }
 
+static compressor_ptr make_chunk_compressor(db::commitlog::compression c) {
+    switch (c) {
+    case db::commitlog::compression::NONE:
+        return nullptr;
+    case db::commitlog::compression::LZ4:
+        return compressor::lz4;
+    case db::commitlog::compression::ZSTD:
+        return compressor::create("ZstdCompressor", [] (const sstring&) { return compressor::opt_string(); });
+    }
+    throw std::invalid_argument(format("unknown commitlog compression {}", uint32_t(c)));
+}
+
 /*
  * A single commit log file on disk. Manages creation of the file and writing mutations to disk,
  * as well as tracking the last mutation position of any "dirty" CFs covered by the segment file. Segment
@@ -675,6 +762,16 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     uint64_t _file_pos = 0;
     uint64_t _flush_pos = 0;
     uint64_t _waste = 0;
+    // The position of the end of the written data in the replay positions of the entries.
+    // Equal to _file_pos unless the chunks are compressed, in which case the replay
+    // positions are offsets in the uncompressed data.
+    uint64_t _logical_pos = 0;
+    compressor_ptr _compressor;
+    // Buffers are compressed one at a time, in the order they were cycled, since the file
+    // position of each depends on the compressed size of the previous ones.
+    semaphore _compression_order{1};
+    // Upper bound of the size of the buffers being compressed, not yet in _file_pos.
+    uint64_t _compressing_size = 0;
 
     size_t _alignment;
 
@@ -696,6 +793,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
 
     std::unordered_set<table_schema_version> _known_schema_versions;
 
+    // The GROUP mode sync which allocations added to the current buffer wait for,
+    // if one is pending (see group_cycle).
+    lw_shared_ptr<shared_promise<>> _group_commit;
+
     friend std::ostream& operator<<(std::ostream&, const segment&);
     friend class segment_manager;
 
@@ -737,11 +838,22 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     // TODO : tune initial / default size
     static constexpr size_t default_size = 128 * 1024;
 
+    // A compressed chunk follows the chunk header with (int: logical position of its first
+    // entry + int: uncompressed size + int: compression), then blocks of
+    // (int: stored size + int: uncompressed size + data), and finally an int checksum of all
+    // the above. A block whose stored size equals its uncompressed size is not compressed.
+    static constexpr size_t compressed_chunk_header_size = 3 * sizeof(uint32_t);
+    static constexpr size_t compressed_block_header_size = 2 * sizeof(uint32_t);
+    static constexpr size_t compression_block_size = 64 * 1024;
+
     segment(::shared_ptr<segment_manager> m, descriptor&& d, named_file&& f, size_t alignment)
             : _segment_manager(std::move(m)), _desc(std::move(d)), _file(std::move(f)),
         _alignment(alignment),
         _sync_time(clock_type::now()), _pending_ops(true) // want exception propagation
     {
+        if (_desc.ver >= descriptor::segment_version_3) {
+            _compressor = _segment_manager->chunk_compressor;
+        }
         ++_segment_manager->totals.segments_created;
         clogger.debug("Created new segment {}", *this);
     }
@@ -788,7 +900,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     }
 
     bool must_sync() {
-        if (_segment_manager->cfg.mode == sync_mode::BATCH) {
+        if (_segment_manager->cfg.mode != sync_mode::PERIODIC) {
             return false;
         }
         auto now = clock_type::now();
@@ -852,6 +964,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     future<sseg_ptr> flush() {
         auto me = shared_from_this();
         assert(me.use_count() > 1);
+        if (_compressor) {
+            // Wait for the buffers cycled so far to get their file position.
+            co_await get_units(_compression_order, 1);
+        }
         uint64_t pos = _file_pos;
 
         clogger.trace("Syncing {} {} -> {}", *this, _flush_pos, pos);
@@ -928,7 +1044,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         assert(_buffer.empty());
 
         auto overhead = segment_overhead_size;
-        if (_file_pos == 0) {
+        if (_logical_pos == 0) {
             overhead += descriptor_header_size;
         }
 
@@ -944,7 +1060,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
 
     bool buffer_is_empty() const {
         return buffer_position() <= segment_overhead_size
-                        || (_file_pos == 0 && buffer_position() <= (segment_overhead_size + descriptor_header_size));
+                        || (_logical_pos == 0 && buffer_position() <= (segment_overhead_size + descriptor_header_size));
     }
     /**
      * Send any buffer contents to disk and get a new tmp buffer
@@ -960,16 +1076,49 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             co_return me;
         }
 
+        auto data_size = buffer_position();
         auto size = clear_buffer_slack();
         auto buf = std::exchange(_buffer, { });
-        auto off = _file_pos;
-        auto top = off + size;
         auto num = _num_allocs;
+        auto buf_memory = size;
+        auto buf_bytes = buf.size_bytes();
+        auto logical_off = _logical_pos;
 
-        _file_pos = top;
+        _logical_pos += size;
         _buffer_ostream = { };
         _num_allocs = 0;
 
+        std::optional<semaphore_units<>> compression_units;
+        if (_compressor) {
+            auto bound = compressed_size_bound(data_size, logical_off);
+            _compressing_size += bound;
+            auto finally = defer([&] () noexcept {
+                _compressing_size -= bound;
+            });
+            // The raw buffer stays accounted until the write below is done.
+            auto unaccount = defer([&] () noexcept {
+                _segment_manager->notify_memory_written(buf_memory);
+                _segment_manager->totals.buffer_list_bytes -= buf_bytes;
+            });
+            compression_units = co_await get_units(_compression_order, 1);
+            if (!termination) {
+                auto raw_size = size;
+                std::tie(buf, size) = co_await compress_buffer(std::move(buf), data_size, logical_off);
+                // So is the compressed one.
+                buf_memory += buf.size_bytes();
+                buf_bytes += buf.size_bytes();
+                if (size < raw_size) {
+                    _segment_manager->totals.bytes_saved_by_compression += raw_size - size;
+                }
+            }
+            unaccount.cancel();
+        }
+
+        auto off = _file_pos;
+        auto top = off + size;
+        _file_pos = top;
+        compression_units.reset();
+
         assert(me.use_count() > 1);
 
         auto out = buf.get_ostream();
@@ -1023,8 +1172,8 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
             }
 
             auto finally = defer([&] () noexcept {
-                _segment_manager->notify_memory_written(size);
-                _segment_manager->totals.buffer_list_bytes -= buf.size_bytes();
+                _segment_manager->notify_memory_written(buf_memory);
+                _segment_manager->totals.buffer_list_bytes -= buf_bytes;
                 if (_file.known_size() < _file_pos) {
                     _segment_manager->totals.total_size_on_disk += (_file_pos - _file.known_size());
                 }
@@ -1066,6 +1215,81 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         co_return me;
     }
 
+    /**
+     * Returns the largest size compress_buffer() can return for a buffer
+     * with data_size bytes, written at logical_off.
+     */
+    size_t compressed_size_bound(size_t data_size, uint64_t logical_off) const {
+        size_t overhead = segment_overhead_size + (logical_off == 0 ? descriptor_header_size : 0);
+        auto raw_size = data_size - overhead;
+        auto blocks = (raw_size + compression_block_size - 1) / compression_block_size;
+        // Blocks which do not shrink are stored as is, so the chunk is never much larger than the raw one.
+        return align_up(overhead + compressed_chunk_header_size + blocks * compressed_block_header_size + raw_size + sizeof(uint32_t), _alignment);
+    }
+
+    /**
+     * Compresses the entries of a buffer, which start after its headers and end at
+     * data_size, into a new buffer with room for the same headers, and returns it
+     * along with the size to write, aligned.
+     * Yields between blocks, so that big buffers don't stall the reactor.
+     * The new buffer is accounted in buffer_list_bytes and in the request controller,
+     * and must be released by the caller like the one it replaces.
+     */
+    future<std::tuple<buffer_type, size_t>> compress_buffer(buffer_type buf, size_t data_size, uint64_t logical_off) {
+        size_t overhead = segment_overhead_size + (logical_off == 0 ? descriptor_header_size : 0);
+        auto raw_size = data_size - overhead;
+
+        auto cbuf = _segment_manager->acquire_buffer(compressed_size_bound(data_size, logical_off), _alignment);
+        _segment_manager->totals.buffer_list_bytes += cbuf.size_bytes();
+        _segment_manager->account_memory_usage(cbuf.size_bytes());
+        auto release = defer([&] () noexcept {
+            _segment_manager->totals.buffer_list_bytes -= cbuf.size_bytes();
+            _segment_manager->notify_memory_written(cbuf.size_bytes());
+        });
+
+        auto out = cbuf.get_ostream();
+        out.fill('\0', overhead);
+
+        crc32_nbo crc;
+        auto write_int = [&] (uint32_t v) {
+            write<uint32_t>(out, v);
+            crc.process(v);
+        };
+        write_int(logical_off + overhead);
+        write_int(raw_size);
+        write_int(uint32_t(_segment_manager->cfg.chunk_compression));
+
+        auto in = fragmented_temporary_buffer::view(buf);
+        in.remove_suffix(buf.size_bytes() - data_size);
+        in.remove_prefix(overhead);
+        temporary_buffer<char> raw(std::min(raw_size, compression_block_size));
+        temporary_buffer<char> compressed(_compressor->compress_max_size(raw.size()));
+        while (!in.empty()) {
+            auto n = std::min(in.size_bytes(), compression_block_size);
+            auto dst = raw.get_write();
+            for (bytes_view frag : in.prefix(n)) {
+                dst = std::copy(frag.begin(), frag.end(), dst);
+            }
+            in.remove_prefix(n);
+
+            auto c = _compressor->compress(raw.get(), n, compressed.get_write(), compressed.size());
+            auto data = c < n ? compressed.get() : raw.get();
+            auto stored = std::min(c, n);
+            write_int(stored);
+            write_int(n);
+            out.write(data, stored);
+            crc.process_bytes(data, stored);
+            co_await coroutine::maybe_yield();
+        }
+        write<uint32_t>(out, crc.checksum());
+
+        auto used = cbuf.size_bytes() - out.size();
+        auto size = align_up(used, _alignment);
+        out.fill('\0', size - used);
+        release.cancel();
+        co_return std::make_tuple(std::move(cbuf), size);
+    }
+
     future<sseg_ptr> batch_cycle(timeout_clock::time_point timeout) {
         /**
          * For batch mode we force a write "immediately".
@@ -1076,6 +1300,10 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
          * queue up in a single buffer.
          */
         auto me = shared_from_this();
+        if (_compressor) {
+            // Let buffers being compressed reach _pending_ops first.
+            co_await get_units(_compression_order, 1);
+        }
         auto fp = _file_pos;
         try {
             co_await _pending_ops.wait_for_pending(timeout);
@@ -1110,6 +1338,55 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         co_return me;
     }
 
+    future<sseg_ptr> group_cycle(timeout_clock::time_point timeout) {
+        /**
+         * For group mode, the first allocation added to a buffer leads the
+         * sync of it, and the following ones just wait for that sync.
+         *
+         * The leader first waits for the writes/flushes in progress, like
+         * batch mode does, then, if other allocations are under way, for a
+         * short while more (see segment_manager::group_commit_window), so
+         * that they can join the buffer before it is written and synced.
+         */
+        auto me = shared_from_this();
+        if (_group_commit) {
+            auto group = _group_commit;
+            co_await with_timeout(timeout, group->get_shared_future());
+            co_return me;
+        }
+
+        auto group = make_lw_shared<shared_promise<>>();
+        _group_commit = group;
+        std::exception_ptr ex;
+        try {
+            co_await _pending_ops.wait_for_pending(timeout);
+            auto window = _segment_manager->group_commit_window();
+            if (window.count()) {
+                co_await seastar::sleep(window);
+            }
+            // Allocations from now on go to the next buffer, and the next group.
+            _group_commit = nullptr;
+            auto batched = _num_allocs;
+            auto start = std::chrono::steady_clock::now();
+            // It is ok to leave the sync behind on timeout, as in batch_cycle().
+            co_await with_timeout(timeout, sync());
+            _segment_manager->account_group_commit(batched, std::chrono::steady_clock::now() - start);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+        if (_group_commit == group) {
+            _group_commit = nullptr;
+        }
+        if (ex) {
+            group->set_exception(ex);
+            // As in batch_cycle(), assume an IO error and stop writing to the segment.
+            _closed = true;
+            co_return coroutine::exception(std::move(ex));
+        }
+        group->set_value();
+        co_return me;
+    }
+
     void background_cycle() {
         //FIXME: discarded future
         (void)cycle().discard_result().handle_exception([] (auto ex) {
@@ -1139,10 +1416,11 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
 
         _segment_manager->sanity_check_size(s);
 
-        if (!is_still_allocating() || position() + s > _segment_manager->max_size) { // would we make the file too big?
+        if (!is_still_allocating() || position() + s > _segment_manager->max_size // would we make the file too big?
+                || logical_position() + s > std::numeric_limits<position_type>::max()) {
             return write_result::no_space;
         } else if (!_buffer.empty() && (s > _buffer_ostream.size())) {  // enough data?
-            if (_segment_manager->cfg.mode == sync_mode::BATCH || writer.sync) {
+            if (_segment_manager->cfg.mode != sync_mode::PERIODIC || writer.sync) {
                 // TODO: this could cause starvation if we're really unlucky.
                 // If we run batch mode and find ourselves not fit in a non-empty
                 // buffer, we must force a cycle and wait for it (to keep flush order)
@@ -1188,7 +1466,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         }
 
         for (size_t entry = 0; entry < writer.num_entries; ++entry) {
-            replay_position rp(_desc.id, position());
+            replay_position rp(_desc.id, logical_position());
             auto id = writer.id(entry);
             auto entry_size = writer.num_entries == 1 ? size : writer.size(*this, entry);
             auto es = entry_size + entry_overhead_size;
@@ -1228,7 +1506,7 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
         ++_segment_manager->totals.allocation_count;
         ++_num_allocs;
 
-        if (_segment_manager->cfg.mode == sync_mode::BATCH || writer.sync) {
+        if (_segment_manager->cfg.mode != sync_mode::PERIODIC || writer.sync) {
             return write_result::ok_need_batch_sync;
         } else {
             // If this buffer alone is too big, potentially bigger than the maximum allowed size,
@@ -1242,13 +1520,18 @@ class db::commitlog::segment : public enable_shared_from_this<segment>, public c
     }
 
     position_type position() const {
-        return position_type(_file_pos + buffer_position());
+        return position_type(_file_pos + _compressing_size + buffer_position());
     }
 
     size_t file_position() const {
         return _file_pos;
     }
 
+    // The position of the next entry, in terms of replay positions.
+    uint64_t logical_position() const {
+        return _logical_pos + buffer_position();
+    }
+
     // ensures no more of this segment is writeable, by allocating any unused section at the end and marking it discarded
     // a.k.a. zero the tail.
     size_t clear_buffer_slack() {
@@ -1314,6 +1597,7 @@ future<R> db::commitlog::segment_manager::allocate_when_possible(T writer, db::t
     }
 
     scope_increment_counter allocating(totals.active_allocations);
+    scope_toggle_counter joinable(totals.joinable_allocations);
 
     auto permit = co_await std::move(fut);
     sseg_ptr s;
@@ -1323,6 +1607,7 @@ future<R> db::commitlog::segment_manager::allocate_when_possible(T writer, db::t
     } else {
         s = co_await active_segment(timeout);
     }
+    joinable.start();
 
     for (;;) {
         using write_result = segment::write_result;
@@ -1331,13 +1616,23 @@ future<R> db::commitlog::segment_manager::allocate_when_possible(T writer, db::t
             case write_result::ok:
                 co_return writer.result();
             case write_result::must_sync:
+                joinable.stop();
                 s = co_await with_timeout(timeout, s->sync());
+                joinable.start();
                 continue;
             case write_result::no_space:
+                joinable.stop();
                 s = co_await s->finish_and_get_new(timeout);
+                joinable.start();
                 continue;
             case write_result::ok_need_batch_sync:
-                s = co_await s->batch_cycle(timeout);
+                // The entry is in the buffer.
+                joinable.stop();
+                if (cfg.mode == sync_mode::GROUP) {
+                    s = co_await s->group_cycle(timeout);
+                } else {
+                    s = co_await s->batch_cycle(timeout);
+                }
                 co_return writer.result();
         }
     }
@@ -1374,6 +1669,7 @@ db::commitlog::segment_manager::segment_manager(config c)
         : (max_disk_size -
             (max_disk_size >= (max_size*2) ? max_size
                 : (max_disk_size > (max_size/2) ? (max_size/2) : max_disk_size/3))))
+    , chunk_compressor(make_chunk_compressor(cfg.chunk_compression))
     , _flush_semaphore(cfg.max_active_flushes)
     // That is enough concurrency to allow for our largest mutation (max_mutation_size), plus
     // an existing in-flight buffer. Since we'll force the cycling() of any buffer that is bigger
@@ -1531,6 +1827,16 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
         sm::make_counter("flush", totals.flush_count,
                        sm::description("Counts number of times the flush() method was called for a file.")),
 
+        sm::make_counter("group_commits", totals.group_commits,
+                       sm::description("Counts number of syncs done in \"group\" mode. "
+                                       "Divide alloc by this value to get the average number of mutations persisted by each of them.")),
+
+        sm::make_histogram("group_commit_size", sm::description("Histogram of the number of mutations persisted by each sync in \"group\" mode."),
+                       [this] { return to_metrics_histogram(group_commit_size); }).set_skip_when_empty(),
+
+        sm::make_histogram("group_commit_latency", sm::description("Histogram of the latency of syncs in \"group\" mode, in microseconds."),
+                       [this] { return to_metrics_histogram(group_commit_latency); }).set_skip_when_empty(),
+
         sm::make_counter("bytes_written", totals.bytes_written,
                        sm::description("Counts number of bytes written to the disk. "
                                        "Divide this value by \"alloc\" to get the average number of bytes per mutation written to the disk.")),
@@ -1544,6 +1850,9 @@ void db::commitlog::segment_manager::create_counters(const sstring& metrics_cate
         sm::make_counter("slack", totals.bytes_slack,
                        sm::description("Counts number of unused bytes written to the disk due to disk segment alignment.")),
 
+        sm::make_counter("bytes_saved_by_compression", totals.bytes_saved_by_compression,
+                       sm::description("Counts number of bytes not written to the disk thanks to the compression of segment chunks (see commitlog_compression).")),
+
         sm::make_gauge("pending_flushes", totals.pending_flushes,
                        sm::description("Holds number of currently pending flushes. See the related flush_limit_exceeded metric.")),
 
@@ -1774,7 +2083,7 @@ future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager:
 
 future<db::commitlog::segment_manager::sseg_ptr> db::commitlog::segment_manager::allocate_segment() {
     for (;;) {
-        descriptor d(next_id(), cfg.fname_prefix);
+        descriptor d(next_id(), cfg.fname_prefix, chunk_compressor ? descriptor::segment_version_3 : descriptor::segment_version_2);
         auto dst = filename(d);
         auto flags = open_flags::wo;
         if (cfg.use_o_dsync) {
@@ -2227,7 +2536,7 @@ void db::commitlog::segment_manager::on_timer() {
     // without waiting for them, so segement_manager could be shut down
     // while they are running.
     (void)seastar::with_gate(_gate, [this] {
-        if (cfg.mode != sync_mode::BATCH) {
+        if (cfg.mode == sync_mode::PERIODIC) {
             sync();
         }
 
@@ -2545,6 +2854,26 @@ const db::commitlog::config& db::commitlog::active_config() const {
     return _segment_manager->cfg;
 }
 
+namespace {
+
+// Returns the given buffers, then eof.
+class buffers_data_source final : public data_source_impl {
+    std::vector<temporary_buffer<char>> _buffers;
+    size_t _next = 0;
+public:
+    explicit buffers_data_source(std::vector<temporary_buffer<char>> buffers)
+        : _buffers(std::move(buffers))
+    { }
+    virtual future<temporary_buffer<char>> get() override {
+        if (_next == _buffers.size()) {
+            return make_ready_future<temporary_buffer<char>>();
+        }
+        return make_ready_future<temporary_buffer<char>>(std::move(_buffers[_next++]));
+    }
+};
+
+}
+
 // No commit_io_check needed in the log reader since the database will fail
 // on error at startup if required
 future<>
@@ -2573,6 +2902,8 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, commit_load_reader_f
         bool header = true;
         bool failed = false;
         fragmented_temporary_buffer::reader frag_reader;
+        compressor_ptr decompressor;
+        uint32_t decompressor_algorithm = 0;
 
         work(file f, descriptor din, commit_load_reader_func fn, position_type o = 0)
                 : f(f), d(din), func(std::move(fn)), fin(make_file_input_stream(f, 0, make_file_input_stream_options())), start_off(o) {
@@ -2682,6 +3013,10 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, commit_load_reader_f
 
             this->next = next;
 
+            if (d.ver >= descriptor::segment_version_3) {
+                co_return co_await read_compressed_chunk();
+            }
+
             if (start_off >= next) {
                 co_return co_await skip(next - pos);
             }
@@ -2691,6 +3026,133 @@ db::commitlog::read_log_file(sstring filename, sstring pfx, commit_load_reader_f
             }
         }
 
+        future<> skip_corrupt_chunk(const char* what, size_t start) {
+            auto slack = next - pos;
+            clogger.debug("Compressed segment chunk at {} {}. Skipping to next chunk ({} bytes)", start, what, slack);
+            corrupt_size += next - start;
+            return skip(slack);
+        }
+
+        future<> read_compressed_chunk() {
+            auto start = pos;
+            if (pos + segment::compressed_chunk_header_size + sizeof(uint32_t) > next) {
+                co_return co_await skip_corrupt_chunk("is too small", start);
+            }
+            auto buf = co_await frag_reader.read_exactly(fin, segment::compressed_chunk_header_size);
+            if (!advance(buf)) {
+                co_return;
+            }
+            auto in = buf.get_istream();
+            auto logical_start = read<uint32_t>(in);
+            auto raw_size = read<uint32_t>(in);
+            auto algorithm = read<uint32_t>(in);
+
+            crc32_nbo crc;
+            crc.process(logical_start);
+            crc.process(raw_size);
+            crc.process(algorithm);
+
+            if (!decompressor || algorithm != decompressor_algorithm) {
+                try {
+                    decompressor = make_chunk_compressor(commitlog::compression(algorithm));
+                } catch (...) {
+                    decompressor = nullptr;
+                }
+                if (!decompressor) {
+                    co_return co_await skip_corrupt_chunk("has an unknown compression", start);
+                }
+                decompressor_algorithm = algorithm;
+            }
+
+            std::vector<temporary_buffer<char>> blocks;
+            size_t decompressed = 0;
+            while (decompressed < raw_size) {
+                if (pos + segment::compressed_block_header_size > next) {
+                    co_return co_await skip_corrupt_chunk("has a broken block", start);
+                }
+                buf = co_await frag_reader.read_exactly(fin, segment::compressed_block_header_size);
+                if (!advance(buf)) {
+                    co_return;
+                }
+                in = buf.get_istream();
+                auto stored = read<uint32_t>(in);
+                auto size = read<uint32_t>(in);
+                if (size == 0 || size > segment::compression_block_size || size > raw_size - decompressed
+                        || stored == 0 || stored > size || pos + stored > next) {
+                    co_return co_await skip_corrupt_chunk("has a broken block", start);
+                }
+                crc.process(stored);
+                crc.process(size);
+
+                buf = co_await frag_reader.read_exactly(fin, stored);
+                advance(buf);
+                auto data = fragmented_temporary_buffer::view(buf);
+                crc.process_fragmented(data);
+
+                temporary_buffer<char> block(size);
+                if (stored == size) {
+                    auto dst = block.get_write();
+                    for (bytes_view frag : data) {
+                        dst = std::copy(frag.begin(), frag.end(), dst);
+                    }
+                } else {
+                    bytes_ostream linearization_buffer;
+                    auto compressed = buf.get_istream().read_bytes_view(stored, linearization_buffer);
+                    try {
+                        if (decompressor->uncompress(reinterpret_cast<const char*>(compressed.data()), stored, block.get_write(), size) != size) {
+                            throw std::runtime_error("unexpected size");
+                        }
+                    } catch (...) {
+                        clogger.debug("Failed to decompress block: {}", std::current_exception());
+                        co_return co_await skip_corrupt_chunk("has a block which cannot be decompressed", start);
+                    }
+                }
+                blocks.push_back(std::move(block));
+                decompressed += size;
+            }
+
+            buf = co_await frag_reader.read_exactly(fin, sizeof(uint32_t));
+            if (!advance(buf)) {
+                co_return;
+            }
+            in = buf.get_istream();
+            auto checksum = read<uint32_t>(in);
+            if (checksum != crc.checksum()) {
+                co_return co_await skip_corrupt_chunk("has a checksum error", start);
+            }
+            co_await skip(next - pos);
+
+            if (start_off >= logical_start + raw_size) {
+                co_return;
+            }
+
+            // Read the entries from the uncompressed data, where their positions are
+            // the replay positions they were written with.
+            auto saved_eof = eof;
+            auto saved_fin = std::exchange(fin, input_stream<char>(data_source(std::make_unique<buffers_data_source>(std::move(blocks)))));
+            auto saved_pos = std::exchange(pos, logical_start);
+            auto saved_next = std::exchange(this->next, logical_start + raw_size);
+            auto saved_file_size = std::exchange(file_size, logical_start + raw_size);
+            std::exception_ptr ex;
+            try {
+                while (!end_of_chunk()) {
+                    co_await read_entry();
+                }
+            } catch (...) {
+                ex = std::current_exception();
+            }
+            co_await fin.close();
+            fin = std::move(saved_fin);
+            pos = saved_pos;
+            this->next = saved_next;
+            file_size = saved_file_size;
+            // The end of the uncompressed data is not the end of the segment.
+            eof = saved_eof || failed;
+            if (ex) {
+                std::rethrow_exception(ex);
+            }
+        }
+
         using produce_func = std::function<future<>(buffer_and_replay_position, uint32_t)>;
 
         future<> produce(buffer_and_replay_position bar) {
@@ -2906,6 +3368,10 @@ uint64_t db::commitlog::get_flush_count() const {
     return _segment_manager->totals.flush_count;
 }
 
+uint64_t db::commitlog::get_num_group_commits() const {
+    return _segment_manager->totals.group_commits;
+}
+
 uint64_t db::commitlog::get_pending_tasks() const {
     return _segment_manager->totals.pending_flushes;
 }
@@ -2946,6 +3412,10 @@ uint64_t db::commitlog::get_num_active_allocations() const {
     return _segment_manager->totals.active_allocations;
 }
 
+std::chrono::microseconds db::commitlog::get_group_commit_window() const {
+    return _segment_manager->group_commit_window();
+}
+
 future<std::vector<db::commitlog::descriptor>> db::commitlog::list_existing_descriptors() const {
     return list_existing_descriptors(active_config().commit_log_location);
 }
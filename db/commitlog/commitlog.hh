@@ -80,8 +80,17 @@ class commitlog {
 private:
     ::shared_ptr<segment_manager> _segment_manager;
 public:
+    // PERIODIC syncs the log in the background every commitlog_sync_period_in_ms.
+    // BATCH syncs it before acknowledging each write.
+    // GROUP also syncs it before acknowledging each write, but a sync may be delayed
+    // a little, adaptively, for concurrent writes to join it (see segment::group_cycle).
     enum class sync_mode {
-        PERIODIC, BATCH
+        PERIODIC, BATCH, GROUP
+    };
+    // Compression of the chunks written to the segments.
+    // Segments with compressed chunks have version segment_version_3.
+    enum class compression : uint32_t {
+        NONE, LZ4, ZSTD
     };
     using force_sync = commitlog_entry_writer::force_sync;
     struct config {
@@ -104,6 +113,9 @@ class commitlog {
         uint64_t max_active_flushes = 0;
 
         sync_mode mode = sync_mode::PERIODIC;
+        // Upper bound of the time a GROUP mode sync waits for concurrent writes.
+        uint64_t commitlog_sync_group_window_max_in_us = 1000;
+        compression chunk_compression = compression::NONE;
         std::string fname_prefix = descriptor::FILENAME_PREFIX;
 
         bool use_o_dsync = false;
@@ -133,6 +145,7 @@ class commitlog {
 
         static inline constexpr uint32_t segment_version_1 = 1u;
         static inline constexpr uint32_t segment_version_2 = 2u;
+        static inline constexpr uint32_t segment_version_3 = 3u;
 
         descriptor(descriptor&&) noexcept = default;
         descriptor(const descriptor&) = default;
@@ -282,6 +295,7 @@ class commitlog {
     uint64_t get_total_size() const;
     uint64_t get_completed_tasks() const;
     uint64_t get_flush_count() const;
+    uint64_t get_num_group_commits() const;
     uint64_t get_pending_tasks() const;
     uint64_t get_pending_flushes() const;
     uint64_t get_pending_allocations() const;
@@ -290,6 +304,8 @@ class commitlog {
     uint64_t get_num_segments_destroyed() const;
     uint64_t get_num_blocked_on_new_segment() const;
     uint64_t get_num_active_allocations() const;
+    // How long a GROUP mode sync starting now would wait for more allocations.
+    std::chrono::microseconds get_group_commit_window() const;
 
 
     /**
@@ -13,7 +13,10 @@
 #include <unordered_map>
 #include <boost/range/adaptor/map.hpp>
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/semaphore.hh>
 #include <seastar/core/sharded.hh>
 
 #include "commitlog.hh"
@@ -45,6 +48,14 @@ class db::commitlog_replayer::impl {
     // not modify content), but...
     mutable seastar::sharded<column_mappings> _column_mappings;
 
+    // Bytes of mutations buffered, across all the segments replayed in
+    // parallel by a shard, before they are sent to their shards.
+    struct replay_memory {
+        semaphore units{max_buffered_bytes};
+        future<> stop() { return make_ready_future<>(); }
+    };
+    mutable seastar::sharded<replay_memory> _replay_memory;
+
     friend class db::commitlog_replayer;
 public:
     impl(seastar::sharded<replica::database>& db, seastar::sharded<db::system_keyspace>& sys_ks);
@@ -74,13 +85,39 @@ class db::commitlog_replayer::impl {
     // move start/stop of the thread local bookkeep to "top level"
     // and also make sure to assert on it actually being started.
     future<> start() {
-        return _column_mappings.start();
+        co_await _column_mappings.start();
+        co_await _replay_memory.start();
     }
     future<> stop() {
-        return _column_mappings.stop();
+        co_await _replay_memory.stop();
+        co_await _column_mappings.stop();
     }
 
-    future<> process(stats*, commitlog::buffer_and_replay_position buf_rp) const;
+    // The mutations read from a segment are not applied one by one, but in batches
+    // sent to their shards, which apply them in table and token order.
+    static constexpr size_t max_batch_mutations = 256;
+    static constexpr size_t max_batch_bytes = 1024 * 1024;
+    // Segments are replayed in parallel, each with a batch per shard, so
+    // the batches are also bounded together.
+    static constexpr size_t max_buffered_bytes = 16 * 1024 * 1024;
+
+    struct replay_entry {
+        commitlog_entry_reader cer;
+        const column_mapping* src_cm;
+        replay_position rp;
+        table_id table;
+        dht::token token;
+    };
+
+    struct replay_batches {
+        std::vector<std::vector<replay_entry>> entries = std::vector<std::vector<replay_entry>>(smp::count);
+        std::vector<size_t> bytes = std::vector<size_t>(smp::count);
+        std::vector<semaphore_units<>> units = std::vector<semaphore_units<>>(smp::count);
+    };
+
+    future<> process(stats*, replay_batches&, commitlog::buffer_and_replay_position buf_rp) const;
+    future<> buffer(stats*, replay_batches&, unsigned shard, size_t size, replay_entry) const;
+    future<> apply_batch(stats*, replay_batches&, unsigned shard) const;
     future<stats> recover(sstring file, const sstring& fname_prefix) const;
 
     typedef std::unordered_map<table_id, replay_position> rp_map;
@@ -182,31 +219,33 @@ db::commitlog_replayer::impl::recover(sstring file, const sstring& fname_prefix)
 
     if (rp.id < gp.id) {
         rlogger.debug("skipping replay of fully-flushed {}", file);
-        return make_ready_future<stats>();
+        co_return stats{};
     }
     position_type p = 0;
     if (rp.id == gp.id) {
         p = gp.pos;
     }
 
-    auto s = make_lw_shared<stats>();
+    stats s;
+    replay_batches batches;
     auto& exts = _db.local().extensions();
 
-    return db::commitlog::read_log_file(file, fname_prefix,
-            std::bind(&impl::process, this, s.get(), std::placeholders::_1),
-            p, &exts).then_wrapped([s](future<> f) {
-        try {
-            f.get();
-        } catch (commitlog::segment_data_corruption_error& e) {
-            s->corrupt_bytes += e.bytes();
-        } catch (...) {
-            throw;
-        }
-        return make_ready_future<stats>(*s);
-    });
+    try {
+        co_await db::commitlog::read_log_file(file, fname_prefix, [this, &s, &batches] (commitlog::buffer_and_replay_position buf_rp) {
+            return process(&s, batches, std::move(buf_rp));
+        }, p, &exts);
+    } catch (commitlog::segment_data_corruption_error& e) {
+        s.corrupt_bytes += e.bytes();
+    }
+
+    // Whatever was read up to the end of the segment, or to the corruption.
+    for (unsigned shard = 0; shard < smp::count; ++shard) {
+        co_await apply_batch(&s, batches, shard);
+    }
+    co_return s;
 }
 
-future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_replay_position buf_rp) const {
+future<> db::commitlog_replayer::impl::process(stats* s, replay_batches& batches, commitlog::buffer_and_replay_position buf_rp) const {
     auto&& buf = buf_rp.buffer;
     auto&& rp = buf_rp.position;
     try {
@@ -243,52 +282,10 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
 
         auto& table = _db.local().find_column_family(uuid);
         const auto& schema = *table.schema();
-        auto shard = table.get_effective_replication_map()->shard_of(schema, fm.token(schema));
-        return _db.invoke_on(shard, [this, cer = std::move(cer), &src_cm, rp] (replica::database& db) mutable -> future<> {
-            auto& fm = cer.mutation();
-            // TODO: might need better verification that the deserialized mutation
-            // is schema compatible. My guess is that just applying the mutation
-            // will not do this.
-            auto& cf = db.find_column_family(fm.column_family_id());
-
-            if (rlogger.is_enabled(logging::log_level::debug)) {
-                rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
-                        cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
-            }
-            if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
-                throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
-                        fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), rp, *err));
-            }
-            // Removed forwarding "new" RP. Instead give none/empty.
-            // This is what origin does, and it should be fine.
-            // The end result should be that once sstables are flushed out
-            // their "replay_position" attribute will be empty, which is
-            // lower than anything the new session will produce.
-            if (cf.schema()->version() != fm.schema_version()) {
-                auto& local_cm = _column_mappings.local().map;
-                auto cm_it = local_cm.try_emplace(fm.schema_version(), src_cm).first;
-                const column_mapping& cm = cm_it->second;
-                mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
-                converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
-                fm.partition().accept(cm, v);
-                return do_with(std::move(m), [&db, &cf] (const mutation& m) {
-                    return db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
-                });
-            } else {
-                return do_with(std::move(cer).mutation(), [&](const frozen_mutation& m) {
-                    return db.apply_in_memory(m, cf.schema(), db::rp_handle(), db::no_timeout);
-                });
-            }
-        }).then_wrapped([s] (future<> f) {
-            try {
-                f.get();
-                s->applied_mutations++;
-            } catch (...) {
-                s->invalid_mutations++;
-                // TODO: write mutation to file like origin.
-                rlogger.warn("error replaying: {}", std::current_exception());
-            }
-        });
+        auto token = fm.token(schema);
+        auto shard = table.get_effective_replication_map()->shard_of(schema, token);
+        auto size = fm.representation().size();
+        return buffer(s, batches, shard, size, replay_entry{std::move(cer), &src_cm, rp, uuid, token});
     } catch (replica::no_such_column_family&) {
         // No such CF now? Origin just ignores this.
     } catch (...) {
@@ -300,6 +297,87 @@ future<> db::commitlog_replayer::impl::process(stats* s, commitlog::buffer_and_r
     return make_ready_future<>();
 }
 
+future<> db::commitlog_replayer::impl::buffer(stats* s, replay_batches& batches, unsigned shard, size_t size, replay_entry e) const {
+    auto& memory = _replay_memory.local().units;
+    auto needed = std::min(size, max_buffered_bytes);
+    auto units = try_get_units(memory, needed);
+    if (!units) {
+        // Apply what this segment has buffered before waiting, so that the
+        // segments replayed in parallel can't all wait for each other.
+        for (unsigned i = 0; i < smp::count; ++i) {
+            co_await apply_batch(s, batches, i);
+        }
+        units = co_await get_units(memory, needed);
+    }
+    batches.units[shard].adopt(std::move(*units));
+    batches.entries[shard].push_back(std::move(e));
+    batches.bytes[shard] += size;
+    if (batches.entries[shard].size() >= max_batch_mutations || batches.bytes[shard] >= max_batch_bytes) {
+        co_await apply_batch(s, batches, shard);
+    }
+}
+
+future<> db::commitlog_replayer::impl::apply_batch(stats* s, replay_batches& batches, unsigned shard) const {
+    auto entries = std::exchange(batches.entries[shard], {});
+    // Released once the batch is applied.
+    auto units = std::exchange(batches.units[shard], {});
+    batches.bytes[shard] = 0;
+    if (entries.empty()) {
+        co_return;
+    }
+
+    *s += co_await _db.invoke_on(shard, [this, entries = std::move(entries)] (replica::database& db) mutable -> future<stats> {
+        // Mutations commute, so they can be applied in any order. Sorting them
+        // lets consecutive ones land next to each other in the memtable.
+        std::ranges::sort(entries, [] (const replay_entry& a, const replay_entry& b) {
+            return std::tie(a.table, a.token) < std::tie(b.table, b.token);
+        });
+
+        stats s;
+        for (auto& e : entries) {
+            try {
+                auto& fm = e.cer.mutation();
+                auto& rp = e.rp;
+                // TODO: might need better verification that the deserialized mutation
+                // is schema compatible. My guess is that just applying the mutation
+                // will not do this.
+                auto& cf = db.find_column_family(fm.column_family_id());
+
+                if (rlogger.is_enabled(logging::log_level::debug)) {
+                    rlogger.debug("replaying at {} v={} {}:{} at {}", fm.column_family_id(), fm.schema_version(),
+                            cf.schema()->ks_name(), cf.schema()->cf_name(), rp);
+                }
+                if (const auto err = validation::is_cql_key_invalid(*cf.schema(), fm.key()); err) {
+                    throw std::runtime_error(fmt::format("found entry with invalid key {} at {} v={} {}:{} at {}: {}.", fm.key(), fm.column_family_id(),
+                            fm.schema_version(), cf.schema()->ks_name(), cf.schema()->cf_name(), rp, *err));
+                }
+                // Removed forwarding "new" RP. Instead give none/empty.
+                // This is what origin does, and it should be fine.
+                // The end result should be that once sstables are flushed out
+                // their "replay_position" attribute will be empty, which is
+                // lower than anything the new session will produce.
+                if (cf.schema()->version() != fm.schema_version()) {
+                    auto& local_cm = _column_mappings.local().map;
+                    auto cm_it = local_cm.try_emplace(fm.schema_version(), *e.src_cm).first;
+                    const column_mapping& cm = cm_it->second;
+                    mutation m(cf.schema(), fm.decorated_key(*cf.schema()));
+                    converting_mutation_partition_applier v(cm, *cf.schema(), m.partition());
+                    fm.partition().accept(cm, v);
+                    co_await db.apply_in_memory(m, cf, db::rp_handle(), db::no_timeout);
+                } else {
+                    co_await db.apply_in_memory(fm, cf.schema(), db::rp_handle(), db::no_timeout);
+                }
+                s.applied_mutations++;
+            } catch (...) {
+                s.invalid_mutations++;
+                // TODO: write mutation to file like origin.
+                rlogger.warn("error replaying: {}", std::current_exception());
+            }
+        }
+        co_return s;
+    });
+}
+
 db::commitlog_replayer::commitlog_replayer(seastar::sharded<replica::database>& db, seastar::sharded<db::system_keyspace>& sys_ks)
     : _impl(std::make_unique<impl>(db, sys_ks))
 {}
@@ -338,11 +416,11 @@ future<> db::commitlog_replayer::recover(std::vector<sstring> files, sstring fna
             return map_reduce(smp::all_cpus(), [this, map, &fname_prefix] (unsigned id) {
                 return smp::submit_to(id, [this, id, map, &fname_prefix] () {
                     auto total = ::make_lw_shared<impl::stats>();
-                    // TODO: or something. For now, we do this serialized per shard,
-                    // to reduce mutation congestion. We could probably (says avi)
-                    // do 2 segments in parallel or something, but lets use this first.
+                    // Replay a few segments in parallel, to keep the disk and the
+                    // shards applying the mutations busy while others are decoded.
                     auto range = map->equal_range(id);
-                    return do_for_each(range.first, range.second, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
+                    auto parallelism = std::max(1u, _impl->_db.local().get_config().commitlog_replay_segments_in_parallel());
+                    return max_concurrent_for_each(range.first, range.second, parallelism, [this, total, &fname_prefix] (const std::pair<unsigned, sstring>& p) {
                         auto&f = p.second;
                         rlogger.debug("Replaying {}", f);
                         return _impl->recover(f, fname_prefix).then([f, total](impl::stats stats) {
@@ -25,6 +25,7 @@
 #include "cdc/cdc_extension.hh"
 #include "tombstone_gc_extension.hh"
 #include "db/per_partition_rate_limit_extension.hh"
+#include "db/sstable_filter_extension.hh"
 #include "config.hh"
 #include "extensions.hh"
 #include "log.hh"
@@ -362,8 +363,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The directory where hints files are stored if hinted handoff is enabled.")
     , view_hints_directory(this, "view_hints_directory", value_status::Used, "",
         "The directory where materialized-view updates are stored while a view replica is unreachable.")
-    , saved_caches_directory(this, "saved_caches_directory", value_status::Unused, "",
-        "The directory location where table key and row caches are stored.")
+    , saved_caches_directory(this, "saved_caches_directory", value_status::Used, "",
+        "The directory where the keys of the hottest partitions in the row cache are saved, to warm up the cache on restart.")
     /* Commonly used properties */
     /* Properties most frequently used when configuring Scylla. */
     /* Before starting a node for the first time, you should carefully evaluate your requirements. */
@@ -427,6 +428,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , compaction_throughput_mb_per_sec(this, "compaction_throughput_mb_per_sec", liveness::LiveUpdate, value_status::Used, 0,
         "Throttles compaction to the specified total throughput across the entire system. The faster you insert data, the faster you need to compact in order to keep the SSTable count down. The recommended Value is 16 to 32 times the rate of write throughput (in MBs/second). Setting the value to 0 disables compaction throttling.\n"
         "Related information: Configuring compaction")
+    , major_compaction_parallelism(this, "major_compaction_parallelism", liveness::LiveUpdate, value_status::Used, 1,
+        "Split a major compaction of a table into this many token ranges of similar size, which are compacted in parallel on each shard. The output is a single run of disjoint SSTables. Setting the value to 1 compacts the whole table at once.")
+    , compaction_tombstone_purge_interval_in_s(this, "compaction_tombstone_purge_interval_in_s", liveness::LiveUpdate, value_status::Used, 600,
+        "How often, in seconds, tables are checked for an SSTable with a high ratio of droppable tombstones, or of tombstones read per row read, which is then compacted to purge them, regardless of the compaction strategy. Only one such compaction runs at a time on each shard, in a scheduling group of its own. Setting the value to 0 disables it.")
     , compaction_large_partition_warning_threshold_mb(this, "compaction_large_partition_warning_threshold_mb", liveness::LiveUpdate, value_status::Used, 1000,
         "Log a warning when writing partitions larger than this value")
     , compaction_large_row_warning_threshold_mb(this, "compaction_large_row_warning_threshold_mb", liveness::LiveUpdate, value_status::Used, 10,
@@ -467,6 +472,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\n"
         "\tperiodic : Used with commitlog_sync_period_in_ms (Default: 10000 - 10 seconds ) to control how often the commit log is synchronized to disk. Periodic syncs are acknowledged immediately.\n"
         "\tbatch : Used with commitlog_sync_batch_window_in_ms (Default: disabled **) to control how long Scylla waits for other writes before performing a sync. When using this method, writes are not acknowledged until fsynced to disk.\n"
+        "\tgroup : Like batch, writes are not acknowledged until fsynced to disk, but concurrent writes are grouped into a single sync. How long a sync waits for other writes adapts to the observed sync latency and number of concurrent writes, and is bounded by commitlog_sync_group_window_max_in_us.\n"
         "Related information: Durability")
     , commitlog_segment_size_in_mb(this, "commitlog_segment_size_in_mb", value_status::Used, 64,
         "Sets the size of the individual commitlog file segments. A commitlog segment may be archived, deleted, or recycled after all its data has been flushed to SSTables. This amount of data can potentially include commitlog segments from every table in the system. The default size is usually suitable for most commitlog archiving, but if you want a finer granularity, 8 or 16 MB is reasonable. See Commit log archive configuration.\n"
@@ -480,6 +486,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     /* Note: does not exist on the listing page other than in above comment, wtf? */
     , commitlog_sync_batch_window_in_ms(this, "commitlog_sync_batch_window_in_ms", value_status::Used, 10000,
         "Controls how long the system waits for other writes before performing a sync in \"batch\" mode.")
+    , commitlog_sync_group_window_max_in_us(this, "commitlog_sync_group_window_max_in_us", value_status::Used, 1000,
+        "The maximum time in microseconds a sync waits for other writes to join it in \"group\" mode.")
     , commitlog_total_space_in_mb(this, "commitlog_total_space_in_mb", value_status::Used, -1,
         "Total space used for commitlogs. If the used space goes above this value, Scylla rounds up to the next nearest segment multiple and flushes memtables to disk for the oldest commitlog segments, removing those log segments. This reduces the amount of data to replay on startup, and prevents infrequently-updated tables from indefinitely keeping commitlog segments. A small total commitlog space tends to cause more flush activity on less-active tables.\n"
         "Related information: Configuring memtable throughput")
@@ -492,6 +500,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Whether or not to use O_DSYNC mode for commitlog segments IO. Can improve commitlog latency on some file systems.\n")
     , commitlog_use_hard_size_limit(this, "commitlog_use_hard_size_limit", value_status::Used, false,
         "Whether or not to use a hard size limit for commitlog disk usage. Default is false. Enabling this can cause latency spikes, whereas the default can lead to occasional disk usage peaks.\n")
+    , commitlog_replay_segments_in_parallel(this, "commitlog_replay_segments_in_parallel", value_status::Used, 4,
+        "The number of commitlog segments each shard replays in parallel on startup. Mutations read from the segments are applied in batches on the shards which own them.")
+    , commitlog_compression(this, "commitlog_compression", value_status::Used, "none",
+        "Compression of the data written to new commitlog segments: none, lz4 or zstd. Compressed segments can only be replayed by versions which support it.", {"none", "lz4", "zstd"})
     /* Compaction settings */
     /* Related information: Configuring compaction */
     , compaction_preheat_key_cache(this, "compaction_preheat_key_cache", value_status::Unused, true,
@@ -518,8 +530,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , memtable_flush_queue_size(this, "memtable_flush_queue_size", value_status::Unused, 4,
         "The number of full memtables to allow pending flush (memtables waiting for a write thread). At a minimum, set to the maximum number of indexes created on a single table.\n"
         "Related information: Flushing data from the memtable")
-    , memtable_flush_writers(this, "memtable_flush_writers", value_status::Invalid, 1,
-        "Sets the number of memtable flush writer threads. These threads are blocked by disk I/O, and each one holds a memtable in memory while blocked. If you have a large Java heap size and many data directories, you can increase the value for better flush performance.")
+    , memtable_flush_writers(this, "memtable_flush_writers", value_status::Used, 1,
+        "The number of memtables which each shard may write to sstables concurrently, including several sealed memtables of the same table. "
+        "Concurrent flushes keep fast disks busy under heavy write load, at the price of dirty memory being released later for each of the flushed memtables.")
     , memtable_heap_space_in_mb(this, "memtable_heap_space_in_mb", value_status::Unused, 0,
         "Total permitted memory to use for memtables. Triggers a flush based on memtable_cleanup_threshold. Cassandra stops accepting writes when the limit is exceeded until a flush completes. If unset, sets to default.")
     , memtable_offheap_space_in_mb(this, "memtable_offheap_space_in_mb", value_status::Unused, 0,
@@ -593,12 +606,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , key_cache_size_in_mb(this, "key_cache_size_in_mb", value_status::Unused, 100,
         "A global cache setting for tables. It is the maximum size of the key cache in memory. To disable set to 0.\n"
         "Related information: nodetool setcachecapacity.")
-    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Unused, 0,
-        "Number of keys from the row cache to save.")
+    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Used, 0,
+        "Maximum number of partition keys from the row cache to save per table and shard, the most frequently read ones. 0 saves all keys.")
     , row_cache_size_in_mb(this, "row_cache_size_in_mb", value_status::Unused, 0,
         "Maximum size of the row cache in memory. Row cache can save more time than key_cache_size_in_mb, but is space-intensive because it contains the entire row. Use the row cache only for hot rows or static rows. If you reduce the size, you may not get you hottest keys loaded on start up.")
-    , row_cache_save_period(this, "row_cache_save_period", value_status::Unused, 0,
-        "Duration in seconds that rows are saved in cache. Caches are saved to saved_caches_directory.")
+    , row_cache_save_period(this, "row_cache_save_period", liveness::LiveUpdate, value_status::Used, 0,
+        "Period in seconds of saving the keys of the hottest partitions in the row cache to saved_caches_directory. On startup, the saved partitions are read into the cache in the background. 0 disables saving.")
     , memory_allocator(this, "memory_allocator", value_status::Invalid, "NativeAllocator",
         "The off-heap memory allocator. In addition to caches, this property affects storage engine meta data. Supported values:\n"
         "\tNativeAllocator\n"
@@ -881,6 +894,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , enable_sstable_key_validation(this, "enable_sstable_key_validation", value_status::Used, ENABLE_SSTABLE_KEY_VALIDATION, "Enable validation of partition and clustering keys monotonicity"
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
+    , enable_sstable_partition_trie_index(this, "enable_sstable_partition_trie_index", value_status::Used, false, "Write a trie-based partition index (Partitions.db) for new sstables."
+        " Single-partition lookups then go through the trie instead of the Summary, which is written with a sparser sampling and takes correspondingly less memory."
+        " Sstables written with this option can still be read by versions which do not support it, with the Summary-based index.")
+    , enable_byte_comparable_keys(this, "enable_byte_comparable_keys", liveness::LiveUpdate, value_status::Used, false, "When merging the data of several sources (memtables, sstables) of a partition, order the rows by a byte-comparable encoding of their clustering position built once per row,"
+        " instead of comparing the clustering key components of every row with each other. Only applies to tables whose clustering key types all have such an encoding (integers, timestamps, dates, booleans, text, blobs)."
+        " Expected to speed up merging of rows with composite clustering keys, at the cost of the memory holding the encoding of the rows being merged.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Unused, true, "Enable SSTables 'mc' format to be used as the default file format.  Deprecated, please use \"sstable_format\" instead.")
@@ -1005,6 +1024,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "Keep SSTable index pages in the global cache after a SSTable read. Expected to improve performance for workloads with big partitions, but may degrade performance for workloads with small partitions. The amount of memory usable by index cache is limited with `index_cache_fraction`.")
     , index_cache_fraction(this, "index_cache_fraction", liveness::LiveUpdate, value_status::Used, 0.2,
         "The maximum fraction of cache memory permitted for use by index cache. Clamped to the [0.0; 1.0] range. Must be small enough to not deprive the row cache of memory, but should be big enough to fit a large fraction of the index. The default value 0.2 means that at least 80\% of cache memory is reserved for the row cache, while at most 20\% is usable by the index cache.")
+    , index_cache_pinned_fraction(this, "index_cache_pinned_fraction", liveness::LiveUpdate, value_status::Used, 0.1,
+        "The maximum fraction of cache memory permitted for use by pinned index pages of tables with `'index': 'PINNED'` caching. Pinned pages above this limit are evicted in LRU order. Clamped to the [0.0; 1.0] range.")
+    , cache_columnar_min_rows(this, "cache_columnar_min_rows", liveness::LiveUpdate, value_status::Used, 0,
+        "When the cache is full, cold partitions with at least this many rows are kept in a compact columnar representation. Reads convert back the rows they need, up to a bounded amount of work, and fall back to sstables for the rest. Only partitions without tombstones, TTLs, collections or counters are packed. 0 disables packing.")
+    , cache_warmup_throughput_mb_per_sec(this, "cache_warmup_throughput_mb_per_sec", liveness::LiveUpdate, value_status::Used, 16,
+        "Throttles reading the partitions saved in saved_caches_directory into the row cache on startup, per shard. 0 disables the warm-up.")
      , consistent_cluster_management(this, "consistent_cluster_management", value_status::Used, true, "Use RAFT for cluster management and DDL")
     , wasm_cache_memory_fraction(this, "wasm_cache_memory_fraction", value_status::Used, 0.01, "Maximum total size of all WASM instances stored in the cache as fraction of total shard memory")
     , wasm_cache_timeout_in_ms(this, "wasm_cache_timeout_in_ms", value_status::Used, 5000, "Time after which an instance is evicted from the cache")
@@ -1049,6 +1074,10 @@ void db::config::add_per_partition_rate_limit_extension() {
     _extensions->add_schema_extension<db::per_partition_rate_limit_extension>(db::per_partition_rate_limit_extension::NAME);
 }
 
+void db::config::add_sstable_filter_extension() {
+    _extensions->add_schema_extension<db::sstable_filter_extension>(db::sstable_filter_extension::NAME);
+}
+
 void db::config::setup_directories() {
     maybe_in_workdir(commitlog_directory, "commitlog");
     if (!schema_commitlog_directory.is_set()) {
@@ -130,6 +130,7 @@ class config final : public utils::config_file {
     // For testing only
     void add_cdc_extension();
     void add_per_partition_rate_limit_extension();
+    void add_sstable_filter_extension();
 
     /// True iff the feature is enabled.
     bool check_experimental(experimental_features_t::feature f) const;
@@ -182,6 +183,8 @@ class config final : public utils::config_file {
     named_value<bool> rpc_interface_prefer_ipv6;
     named_value<seed_provider_type> seed_provider;
     named_value<uint32_t> compaction_throughput_mb_per_sec;
+    named_value<uint32_t> major_compaction_parallelism;
+    named_value<uint32_t> compaction_tombstone_purge_interval_in_s;
     named_value<uint32_t> compaction_large_partition_warning_threshold_mb;
     named_value<uint32_t> compaction_large_row_warning_threshold_mb;
     named_value<uint32_t> compaction_large_cell_warning_threshold_mb;
@@ -200,11 +203,14 @@ class config final : public utils::config_file {
     named_value<uint32_t> schema_commitlog_segment_size_in_mb;
     named_value<uint32_t> commitlog_sync_period_in_ms;
     named_value<uint32_t> commitlog_sync_batch_window_in_ms;
+    named_value<uint32_t> commitlog_sync_group_window_max_in_us;
     named_value<int64_t> commitlog_total_space_in_mb;
     named_value<bool> commitlog_reuse_segments; // unused. retained for upgrade compat
     named_value<int64_t> commitlog_flush_threshold_in_mb;
     named_value<bool> commitlog_use_o_dsync;
     named_value<bool> commitlog_use_hard_size_limit;
+    named_value<uint32_t> commitlog_replay_segments_in_parallel;
+    named_value<sstring> commitlog_compression;
     named_value<bool> compaction_preheat_key_cache;
     named_value<uint32_t> concurrent_compactors;
     named_value<uint32_t> in_memory_compaction_limit_in_mb;
@@ -351,6 +357,8 @@ class config final : public utils::config_file {
     named_value<bool> enable_node_aggregated_table_metrics;
     named_value<bool> enable_sstable_data_integrity_check;
     named_value<bool> enable_sstable_key_validation;
+    named_value<bool> enable_sstable_partition_trie_index;
+    named_value<bool> enable_byte_comparable_keys;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
     named_value<bool> enable_sstables_mc_format;
@@ -424,6 +432,9 @@ class config final : public utils::config_file {
 
     named_value<bool> cache_index_pages;
     named_value<double> index_cache_fraction;
+    named_value<double> index_cache_pinned_fraction;
+    named_value<uint32_t> cache_columnar_min_rows;
+    named_value<uint32_t> cache_warmup_throughput_mb_per_sec;
 
     named_value<bool> consistent_cluster_management;
 
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "db/sstable_filter_options.hh"
+#include "schema/schema.hh"
+#include "serializer.hh"
+
+namespace db {
+
+class sstable_filter_extension : public schema_extension {
+    sstable_filter_options _options;
+public:
+    static constexpr auto NAME = "sstable_filter";
+
+    sstable_filter_extension() = default;
+    sstable_filter_extension(const sstable_filter_options& opts) : _options(opts) {}
+
+    explicit sstable_filter_extension(const std::map<sstring, sstring>& tags) : _options(tags) {}
+    explicit sstable_filter_extension(const bytes& b) : _options(deserialize(b)) {}
+    explicit sstable_filter_extension(const sstring& s) {
+        throw std::logic_error("Cannot create sstable filter info from string");
+    }
+
+    bytes serialize() const override {
+        return ser::serialize_to_buffer<bytes>(_options.to_map());
+    }
+    static std::map<sstring, sstring> deserialize(const bytes_view& buffer) {
+        return ser::deserialize_from_buffer(buffer, boost::type<std::map<sstring, sstring>>());
+    }
+    const sstable_filter_options& get_options() const {
+        return _options;
+    }
+};
+
+}
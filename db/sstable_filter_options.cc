@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/range/adaptor/map.hpp>
+
+#include "db/sstable_filter_options.hh"
+#include "exceptions/exceptions.hh"
+
+namespace db {
+
+const char* sstable_filter_options::type_key = "type";
+
+static const std::map<sstring, utils::filter_type> filter_types = {
+    {"bloom", utils::filter_type::bloom},
+    {"blocked_bloom", utils::filter_type::blocked_bloom},
+    {"binary_fuse", utils::filter_type::binary_fuse},
+};
+
+sstable_filter_options::sstable_filter_options(std::map<sstring, sstring> map) {
+    if (auto it = map.find(type_key); it != map.end()) {
+        auto t = filter_types.find(it->second);
+        if (t == filter_types.end()) {
+            throw exceptions::configuration_exception(format(
+                    "Invalid value for {} option: {}, expected one of: {}",
+                    type_key, it->second, fmt::join(filter_types | boost::adaptors::map_keys, ", ")));
+        }
+        _type = t->second;
+        map.erase(it);
+    }
+
+    if (!map.empty()) {
+        throw exceptions::configuration_exception(format(
+                "Unknown keys in map for sstable_filter extension: {}",
+                fmt::join(map | boost::adaptors::map_keys, ", ")));
+    }
+}
+
+std::map<sstring, sstring> sstable_filter_options::to_map() const {
+    for (auto& [name, type] : filter_types) {
+        if (type == _type) {
+            return {{type_key, name}};
+        }
+    }
+    std::abort();
+}
+
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <map>
+
+#include <seastar/core/sstring.hh>
+
+#include "utils/i_filter.hh"
+
+using namespace seastar;
+
+namespace db {
+
+// Options of the sstable_filter table extension, which selects the filter
+// written to the Filter.db component of the table's new sstables:
+//
+//   WITH sstable_filter = {'type': 'blocked_bloom'}
+//
+// Existing sstables keep the filter they were written with.
+class sstable_filter_options final {
+private:
+    static const char* type_key;
+
+private:
+    utils::filter_type _type = utils::filter_type::bloom;
+
+public:
+    sstable_filter_options() = default;
+    sstable_filter_options(std::map<sstring, sstring> map);
+
+    std::map<sstring, sstring> to_map() const;
+
+    utils::filter_type type() const {
+        return _type;
+    }
+};
+
+}
@@ -746,6 +746,7 @@ class clients_table : public streaming_virtual_table {
             .with_column("ssl_enabled", boolean_type)
             .with_column("ssl_protocol", utf8_type)
             .with_column("username", utf8_type)
+            .with_column("bounced_requests", long_type)
             .with_version(system_keyspace::generate_schema_version(id))
             .build();
     }
@@ -852,6 +853,9 @@ class clients_table : public streaming_virtual_table {
                     set_cell(cr.cells(), "ssl_protocol", *cd.ssl_protocol);
                 }
                 set_cell(cr.cells(), "username", cd.username ? *cd.username : sstring("anonymous"));
+                if (cd.bounced_requests) {
+                    set_cell(cr.cells(), "bounced_requests", *cd.bounced_requests);
+                }
                 co_await result.emit_row(std::move(cr));
             }
             co_await result.emit_partition_end();
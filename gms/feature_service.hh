@@ -130,6 +130,10 @@ class feature_service final : public peering_sharded_service<feature_service> {
     gms::feature tablets { *this, "TABLETS"sv };
     gms::feature uuid_sstable_identifiers { *this, "UUID_SSTABLE_IDENTIFIERS"sv };
     gms::feature table_digest_insensitive_to_expiry { *this, "TABLE_DIGEST_INSENSITIVE_TO_EXPIRY"sv };
+    gms::feature sstable_filter_types { *this, "SSTABLE_FILTER_TYPES"sv };
+    gms::feature zstd_dictionary_compression { *this, "ZSTD_DICTIONARY_COMPRESSION"sv };
+    gms::feature cache_admission_policy { *this, "CACHE_ADMISSION_POLICY"sv };
+    gms::feature cache_index_pinning { *this, "CACHE_INDEX_PINNING"sv };
     // If this feature is enabled, schema versions are persisted by the group 0 command
     // that modifies schema instead of being calculated as a digest (hash) by each node separately.
     // The feature controls both the 'global' schema version (the one gossiped as application_state::SCHEMA)
@@ -35,6 +35,7 @@
 #include "db/system_keyspace.hh"
 #include "db/system_distributed_keyspace.hh"
 #include "db/batchlog_manager.hh"
+#include "db/cache_warmer.hh"
 #include "db/commitlog/commitlog.hh"
 #include "db/hints/manager.hh"
 #include "db/commitlog/commitlog_replayer.hh"
@@ -68,6 +69,7 @@
 #include "service/cache_hitrate_calculator.hh"
 #include "compaction/compaction_manager.hh"
 #include "sstables/sstables.hh"
+#include "comparable_bytes.hh"
 #include "gms/feature_service.hh"
 #include "replica/distributed_loader.hh"
 #include "sstables_loader.hh"
@@ -93,6 +95,7 @@
 #include "tools/entry_point.hh"
 #include "test/perf/entry_point.hh"
 #include "db/per_partition_rate_limit_extension.hh"
+#include "db/sstable_filter_extension.hh"
 #include "lang/wasm_instance_cache.hh"
 #include "lang/wasm_alien_thread_runner.hh"
 #include "sstables/sstables_manager.hh"
@@ -595,6 +598,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
     ext->add_schema_extension<db::paxos_grace_seconds_extension>(db::paxos_grace_seconds_extension::NAME);
     ext->add_schema_extension<tombstone_gc_extension>(tombstone_gc_extension::NAME);
     ext->add_schema_extension<db::per_partition_rate_limit_extension>(db::per_partition_rate_limit_extension::NAME);
+    ext->add_schema_extension<db::sstable_filter_extension>(db::sstable_filter_extension::NAME);
 
     auto cfg = make_lw_shared<db::config>(ext);
     auto init = app.get_options_description().add_options();
@@ -720,6 +724,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             // See the comment at the definition of sstables::global_cache_index_pages.
             smp::invoke_on_all([&cfg] {
                 sstables::global_cache_index_pages = cfg->cache_index_pages.operator utils::updateable_value<bool>();
+                comparable_bytes::global_byte_comparable_keys = cfg->enable_byte_comparable_keys.operator utils::updateable_value<bool>();
             }).get();
 
             ::sighup_handler sighup_handler(opts, *cfg);
@@ -935,6 +940,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             dir_set.add(cfg->data_file_directories());
             dir_set.add(cfg->commitlog_directory());
             dir_set.add(cfg->schema_commitlog_directory());
+            dir_set.add(cfg->saved_caches_directory());
             dirs.emplace(cfg->developer_mode());
             dirs->create_and_verify(std::move(dir_set)).get();
 
@@ -966,6 +972,7 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
             dbcfg.gossip_scheduling_group = make_sched_group("gossip", 1000);
             dbcfg.commitlog_scheduling_group = make_sched_group("commitlog", 1000);
             dbcfg.available_memory = memory::stats().total_memory();
+            auto tombstone_purge_scheduling_group = make_sched_group("tombstone_purge", 100);
 
             supervisor::notify("starting compaction_manager");
             // get_cm_cfg is called on each shard when starting a sharded<compaction_manager>
@@ -977,6 +984,9 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .major_compaction_parallelism = cfg->major_compaction_parallelism,
+                    .tombstone_purge_sched_group = compaction_manager::scheduling_group{tombstone_purge_scheduling_group},
+                    .tombstone_purge_interval_in_s = cfg->compaction_tombstone_purge_interval_in_s,
                 };
             });
             cm.start(std::move(get_cm_cfg), std::ref(stop_signal.as_sharded_abort_source()), std::ref(task_manager)).get();
@@ -1481,6 +1491,25 @@ To start the scylla server proper, simply invoke as: scylla server (or just scyl
                     cf.trigger_compaction();
                 });
             }).get();
+
+            supervisor::notify("starting cache warmer");
+            static sharded<db::cache_warmer> cache_warmer;
+            auto cache_warmup_scheduling_group = make_sched_group("cache_warmup", 50);
+            // updateable_value is not shard-safe (#7316), so the config is made on each shard
+            auto get_cw_cfg = sharded_parameter([&] {
+                return db::cache_warmer::config {
+                    .directory = cfg->saved_caches_directory(),
+                    .save_period_in_s = cfg->row_cache_save_period,
+                    .keys_to_save = cfg->row_cache_keys_to_save,
+                    .throughput_mb_per_sec = cfg->cache_warmup_throughput_mb_per_sec,
+                    .sched_group = cache_warmup_scheduling_group,
+                };
+            });
+            cache_warmer.start(std::ref(db), std::move(get_cw_cfg)).get();
+            cache_warmer.invoke_on_all(&db::cache_warmer::start).get();
+            auto stop_cache_warmer = defer_verbose_shutdown("cache warmer", [] {
+                cache_warmer.stop().get();
+            });
             api::set_server_gossip(ctx, gossiper).get();
             api::set_server_snitch(ctx, snitch).get();
             auto stop_snitch_api = defer_verbose_shutdown("snitch API", [&ctx] {
@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "columnar_rows.hh"
+#include "schema/schema.hh"
+#include "utils/fragment_range.hh"
+
+namespace {
+
+void write_varint(bytes_ostream& out, uint64_t v) {
+    bytes::value_type buf[10];
+    size_t n = 0;
+    while (v >= 0x80) {
+        buf[n++] = bytes::value_type(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = bytes::value_type(v);
+    out.write(bytes_view(buf, n));
+}
+
+uint64_t read_varint(managed_bytes_view& in) {
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        auto b = read_simple<uint8_t>(in);
+        v |= uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return v;
+        }
+    }
+    throw std::runtime_error("columnar_rows: malformed varint");
+}
+
+uint64_t zigzag(int64_t v) noexcept {
+    return (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) noexcept {
+    return int64_t(v >> 1) ^ -int64_t(v & 1);
+}
+
+template <typename T>
+void write_be(bytes_ostream& out, T v) {
+    v = net::hton(v);
+    out.write(bytes_view(reinterpret_cast<const bytes::value_type*>(&v), sizeof(v)));
+}
+
+// A sequence of timestamps, encoded as tags.
+class timestamp_encoder {
+    api::timestamp_type _prev;
+public:
+    explicit timestamp_encoder(api::timestamp_type base) : _prev(base) {}
+    void write(bytes_ostream& out, api::timestamp_type ts) {
+        // Timestamps are arbitrary, so the difference may not fit in int64_t.
+        write_varint(out, zigzag(int64_t(uint64_t(ts) - uint64_t(_prev))) + 1);
+        _prev = ts;
+    }
+    void write_absent(bytes_ostream& out) {
+        write_varint(out, 0);
+    }
+};
+
+class timestamp_decoder {
+    api::timestamp_type _prev;
+public:
+    explicit timestamp_decoder(api::timestamp_type base) : _prev(base) {}
+    std::optional<api::timestamp_type> read(managed_bytes_view& in) {
+        auto tag = read_varint(in);
+        if (!tag) {
+            return std::nullopt;
+        }
+        _prev = api::timestamp_type(uint64_t(_prev) + uint64_t(unzigzag(tag - 1)));
+        return _prev;
+    }
+};
+
+void write_value(bytes_ostream& out, managed_bytes_view v) {
+    write_varint(out, v.size_bytes());
+    for (bytes_view frag : fragment_range(v)) {
+        out.write(frag);
+    }
+}
+
+managed_bytes_view read_value(managed_bytes_view& in) {
+    auto len = read_varint(in);
+    if (len > in.size_bytes()) {
+        throw std::runtime_error("columnar_rows: value exceeds its section");
+    }
+    auto v = in.prefix(len);
+    in.remove_prefix(len);
+    return v;
+}
+
+// The header and the sections of encoded rows.
+struct columnar_layout {
+    uint32_t row_count;
+    api::timestamp_type base;
+    uint32_t last_key_offset;
+    managed_bytes_view keys;
+    managed_bytes_view markers;
+    std::vector<std::pair<column_id, managed_bytes_view>> columns;
+
+    explicit columnar_layout(managed_bytes_view in) {
+        row_count = read_simple<uint32_t>(in);
+        auto column_count = read_simple<uint32_t>(in);
+        in.remove_prefix(16);
+        base = api::timestamp_type(read_simple<uint64_t>(in));
+        auto keys_size = read_simple<uint32_t>(in);
+        last_key_offset = read_simple<uint32_t>(in);
+        auto markers_size = read_simple<uint32_t>(in);
+        std::vector<std::pair<column_id, uint32_t>> column_headers;
+        column_headers.reserve(column_count);
+        for (uint32_t i = 0; i < column_count; ++i) {
+            auto id = read_simple<uint32_t>(in);
+            auto size = read_simple<uint32_t>(in);
+            column_headers.emplace_back(id, size);
+        }
+
+        auto section = [&in] (size_t size) {
+            if (size > in.size_bytes()) {
+                throw std::runtime_error("columnar_rows: section exceeds the data");
+            }
+            auto v = in.prefix(size);
+            in.remove_prefix(size);
+            return v;
+        };
+        keys = section(keys_size);
+        markers = section(markers_size);
+        columns.reserve(column_count);
+        for (auto [id, size] : column_headers) {
+            columns.emplace_back(id, section(size));
+        }
+    }
+};
+
+}
+
+bool columnar_rows::can_encode(const schema& s, const rows_entry& e) {
+    if (s.is_counter() || e.dummy() || e.range_tombstone()) {
+        return false;
+    }
+    auto& row = e.row();
+    if (row.deleted_at()) {
+        return false;
+    }
+    auto& marker = row.marker();
+    if (!marker.is_missing() && (!marker.is_live() || marker.is_expiring())) {
+        return false;
+    }
+    bool ok = true;
+    row.cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& c) {
+        auto& def = s.regular_column_at(id);
+        if (!ok || !def.is_atomic() || def.is_counter()) {
+            ok = false;
+            return;
+        }
+        auto acv = c.as_atomic_cell(def);
+        ok = acv.is_live() && !acv.is_live_and_has_ttl();
+    });
+    return ok;
+}
+
+columnar_rows::columnar_rows(const bytes_ostream& encoded)
+    : _data(managed_bytes::initialized_later(), encoded.size_bytes())
+    , _first(clustering_key::make_empty())
+    , _last(clustering_key::make_empty())
+{
+    managed_bytes_mutable_view out(_data);
+    for (bytes_view frag : encoded.fragments()) {
+        write_fragmented(out, single_fragmented_view(frag));
+    }
+    columnar_layout layout{managed_bytes_view(_data)};
+    auto keys = layout.keys;
+    _first = clustering_key::from_bytes(read_value(keys));
+    keys = layout.keys;
+    keys.remove_prefix(layout.last_key_offset);
+    _last = clustering_key::from_bytes(read_value(keys));
+}
+
+std::optional<bytes_ostream> columnar_rows::encode(const schema& s, rows_entry::container_type::const_iterator first,
+        rows_entry::container_type::const_iterator last) {
+    uint32_t row_count = 0;
+    api::timestamp_type base = api::max_timestamp;
+    std::vector<bool> has_column(s.regular_columns_count());
+    for (auto i = first; i != last; ++i) {
+        ++row_count;
+        if (!i->row().marker().is_missing()) {
+            base = std::min(base, i->row().marker().timestamp());
+        }
+        i->row().cells().for_each_cell([&] (column_id id, const atomic_cell_or_collection& c) {
+            has_column[id] = true;
+            base = std::min(base, c.as_atomic_cell(s.regular_column_at(id)).timestamp());
+        });
+    }
+    if (!row_count) {
+        return std::nullopt;
+    }
+
+    std::vector<column_id> columns;
+    for (column_id id = 0; id < has_column.size(); ++id) {
+        if (has_column[id]) {
+            columns.push_back(id);
+        }
+    }
+
+    bytes_ostream keys;
+    size_t last_key_offset = 0;
+    bytes_ostream markers;
+    std::vector<bytes_ostream> cells(columns.size());
+    timestamp_encoder marker_ts(base);
+    std::vector<timestamp_encoder> cell_ts(columns.size(), timestamp_encoder(base));
+    for (auto i = first; i != last; ++i) {
+        const rows_entry& e = *i;
+        last_key_offset = keys.size_bytes();
+        write_value(keys, e.key().representation());
+        auto& marker = e.row().marker();
+        if (marker.is_missing()) {
+            marker_ts.write_absent(markers);
+        } else {
+            marker_ts.write(markers, marker.timestamp());
+        }
+        auto& row = e.row().cells();
+        for (size_t i = 0; i < columns.size(); ++i) {
+            auto c = row.find_cell(columns[i]);
+            if (!c) {
+                cell_ts[i].write_absent(cells[i]);
+                continue;
+            }
+            auto acv = c->as_atomic_cell(s.regular_column_at(columns[i]));
+            cell_ts[i].write(cells[i], acv.timestamp());
+            write_value(cells[i], acv.value());
+        }
+    }
+
+    auto fits = [] (const bytes_ostream& section) {
+        return section.size_bytes() <= std::numeric_limits<uint32_t>::max();
+    };
+    if (!fits(keys) || !fits(markers) || !std::all_of(cells.begin(), cells.end(), fits)) {
+        return std::nullopt;
+    }
+
+    bytes_ostream out;
+    write_be<uint32_t>(out, row_count);
+    write_be<uint32_t>(out, columns.size());
+    write_be<uint64_t>(out, s.version().uuid().get_most_significant_bits());
+    write_be<uint64_t>(out, s.version().uuid().get_least_significant_bits());
+    write_be<uint64_t>(out, uint64_t(base));
+    write_be<uint32_t>(out, keys.size_bytes());
+    write_be<uint32_t>(out, last_key_offset);
+    write_be<uint32_t>(out, markers.size_bytes());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        write_be<uint32_t>(out, columns[i]);
+        write_be<uint32_t>(out, cells[i].size_bytes());
+    }
+    out.append(keys);
+    out.append(markers);
+    for (auto& c : cells) {
+        out.append(c);
+    }
+    return out;
+}
+
+uint32_t columnar_rows::row_count() const {
+    managed_bytes_view in(_data);
+    return read_simple<uint32_t>(in);
+}
+
+table_schema_version columnar_rows::schema_version() const {
+    managed_bytes_view in(_data);
+    in.remove_prefix(8);
+    auto msb = read_simple<uint64_t>(in);
+    auto lsb = read_simple<uint64_t>(in);
+    return table_schema_version(utils::UUID(msb, lsb));
+}
+
+void columnar_rows::for_each_row(const schema& s, noncopyable_function<void(clustering_key&&, deletable_row&&)> func) const {
+    columnar_layout layout{managed_bytes_view(_data)};
+
+    struct column_cursor {
+        const column_definition* def;
+        managed_bytes_view in;
+        timestamp_decoder ts;
+    };
+    timestamp_decoder marker_ts(layout.base);
+    std::vector<column_cursor> columns;
+    columns.reserve(layout.columns.size());
+    for (auto [id, section] : layout.columns) {
+        columns.push_back(column_cursor{&s.regular_column_at(id), section, timestamp_decoder(layout.base)});
+    }
+
+    for (uint32_t i = 0; i < layout.row_count; ++i) {
+        auto key = clustering_key::from_bytes(read_value(layout.keys));
+        deletable_row row;
+        if (auto ts = marker_ts.read(layout.markers)) {
+            row.apply(row_marker(*ts));
+        }
+        for (auto& c : columns) {
+            if (auto ts = c.ts.read(c.in)) {
+                auto value = read_value(c.in);
+                row.cells().append_cell(c.def->id, atomic_cell::make_live(*c.def->type, *ts, value));
+            }
+        }
+        func(std::move(key), std::move(row));
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <seastar/util/noncopyable_function.hh>
+
+#include "bytes_ostream.hh"
+#include "schema/schema_fwd.hh"
+#include "utils/managed_bytes.hh"
+#include "mutation/mutation_partition.hh"
+
+// Compact, immutable, representation of a run of clustering rows of a partition.
+//
+// Used by the row cache to hold wide partitions which are cold, where
+// a rows_entry, its B-tree slot, the radix tree of its cells and a separate
+// allocation per cell cost several times more memory than the data itself.
+// The rows are laid out column by column in a single buffer, with timestamps
+// delta-encoded within each column, so uniform rows (like time series) take
+// little more than their keys and values.
+//
+// A partition is packed into many columnar_rows of a bounded number of rows,
+// so that each of them can be converted back without stalling.
+//
+// Only rows without any tombstone, TTL, collection or counter can be represented,
+// see can_encode().
+//
+// Layout (integers big-endian, varints are LEB128):
+//
+//   u32        row count
+//   u32        number of column sections
+//   2 x u64    schema version
+//   u64        base timestamp, the smallest timestamp of any marker or cell
+//   u32        length of the keys section
+//   u32        offset of the last key in the keys section
+//   u32        length of the markers section
+//   2 x u32    id and section length, for each column section
+//
+//   keys section:      for each row, varint length and the clustering key
+//   markers section:   for each row, varint tag
+//   column section:    for each row, varint tag followed, when not zero, by
+//                      varint length and the cell value
+//
+// A tag is 0 when the row has no marker (or no cell in the column), and otherwise
+// zigzag(timestamp - previous timestamp in the section) + 1, where the previous
+// timestamp of the first row is the base timestamp. The difference wraps around,
+// like in unsigned arithmetic.
+class columnar_rows {
+    managed_bytes _data;
+    clustering_key _first;
+    clustering_key _last;
+public:
+    // Copies encoded rows, obtained from encode(), into memory of the current allocator.
+    explicit columnar_rows(const bytes_ostream& encoded);
+
+    columnar_rows(columnar_rows&&) noexcept = default;
+    columnar_rows& operator=(columnar_rows&&) noexcept = default;
+
+    // Returns true if the row can be represented.
+    static bool can_encode(const schema&, const rows_entry&);
+    // Encodes the clustering rows in [first, last), which must all satisfy can_encode(),
+    // or returns std::nullopt if they are too large to be represented.
+    static std::optional<bytes_ostream> encode(const schema&, rows_entry::container_type::const_iterator first,
+            rows_entry::container_type::const_iterator last);
+
+    uint32_t row_count() const;
+    table_schema_version schema_version() const;
+    size_t external_memory_usage() const noexcept {
+        return _data.external_memory_usage() + _first.external_memory_usage() + _last.external_memory_usage();
+    }
+    // Keys of the first and of the last row.
+    const clustering_key& first_key() const noexcept { return _first; }
+    const clustering_key& last_key() const noexcept { return _last; }
+
+    // Calls func for every row, in clustering order.
+    // The rows are allocated with the current allocator.
+    // Must be called with the schema the rows were encoded with.
+    void for_each_row(const schema&, noncopyable_function<void(clustering_key&&, deletable_row&&)> func) const;
+};
@@ -133,9 +133,9 @@ template<compact_for_sstables SSTableCompaction>
 class compact_mutation_state {
     const schema& _schema;
     gc_clock::time_point _query_time;
-    std::function<api::timestamp_type(const dht::decorated_key&)> _get_max_purgeable;
+    std::function<max_purgeable(const dht::decorated_key&)> _get_max_purgeable;
     can_gc_fn _can_gc;
-    api::timestamp_type _max_purgeable = api::missing_timestamp;
+    std::optional<max_purgeable> _max_purgeable;
     std::optional<gc_clock::time_point> _gc_before;
     const query::partition_slice& _slice;
     uint64_t _row_limit{};
@@ -144,6 +144,7 @@ class compact_mutation_state {
     tombstone_gc_state _tombstone_gc_state;
 
     tombstone _partition_tombstone;
+    bool _partition_tombstone_purgeable{};
 
     bool _static_row_live{};
     uint64_t _rows_in_current_partition;
@@ -212,7 +213,7 @@ class compact_mutation_state {
             _empty_partition_in_gc_consumer = false;
             gc_consumer.consume_new_partition(*_dk);
             auto pt = _partition_tombstone;
-            if (pt && can_purge_tombstone(pt)) {
+            if (pt && _partition_tombstone_purgeable) {
                 gc_consumer.consume(pt);
             }
         }
@@ -225,7 +226,7 @@ class compact_mutation_state {
             ++_stats.partitions;
             consumer.consume_new_partition(*_dk);
             auto pt = _partition_tombstone;
-            if (pt && !can_purge_tombstone(pt)) {
+            if (pt && !_partition_tombstone_purgeable) {
                 consumer.consume(pt);
             }
         }
@@ -241,9 +242,15 @@ class compact_mutation_state {
             // called for tombstones that are older than grace period, in
             // order to avoid unnecessary bloom filter checks when calculating
             // max purgeable timestamp.
-            return satisfy_grace_period(deletion_time) && can_gc(t);
+            return satisfy_grace_period(deletion_time) && can_gc_expired(t);
         }
-        return can_gc(t) && satisfy_grace_period(deletion_time);
+        if (can_gc(t)) {
+            return satisfy_grace_period(deletion_time);
+        }
+        if (sstable_compaction() && t && satisfy_grace_period(deletion_time)) {
+            on_tombstone_kept();
+        }
+        return false;
     }
 
     bool can_purge_tombstone(const tombstone& t) {
@@ -274,12 +281,27 @@ class compact_mutation_state {
         if (!t) {
             return false;
         }
-        if (_max_purgeable == api::missing_timestamp) {
+        if (!_max_purgeable) {
             _max_purgeable = _get_max_purgeable(*_dk);
         }
-        return t.timestamp < _max_purgeable;
+        return t.timestamp < _max_purgeable->timestamp();
     };
 
+    // Like can_gc(), for tombstones past their grace period.
+    bool can_gc_expired(tombstone t) {
+        if (can_gc(t)) {
+            return true;
+        }
+        if (sstable_compaction() && t) {
+            on_tombstone_kept();
+        }
+        return false;
+    }
+
+    void on_tombstone_kept() {
+        tombstone_purge_stats::local().on_tombstone_kept(_max_purgeable->get_source());
+    }
+
 public:
     compact_mutation_state(compact_mutation_state&&) = delete; // Because 'this' is captured
 
@@ -301,12 +323,13 @@ class compact_mutation_state {
     }
 
     compact_mutation_state(const schema& s, gc_clock::time_point compaction_time,
-            std::function<api::timestamp_type(const dht::decorated_key&)> get_max_purgeable,
+            std::function<max_purgeable(const dht::decorated_key&)> get_max_purgeable,
             const tombstone_gc_state& gc_state)
         : _schema(s)
         , _query_time(compaction_time)
         , _get_max_purgeable(std::move(get_max_purgeable))
-        , _can_gc([this] (tombstone t) { return can_gc(t); })
+        // Only called for expired cells and tombstones.
+        , _can_gc([this] (tombstone t) { return can_gc_expired(t); })
         , _slice(s.full_slice())
         , _tombstone_gc_state(gc_state)
         , _last_dk({dht::token(), partition_key::make_empty()})
@@ -333,7 +356,7 @@ class compact_mutation_state {
         _static_row_live = false;
         _partition_tombstone = {};
         _current_partition_limit = std::min(_row_limit, _partition_row_limit);
-        _max_purgeable = api::missing_timestamp;
+        _max_purgeable.reset();
         _gc_before = std::nullopt;
         _last_static_row.reset();
         _last_pos = position_in_partition::for_partition_start();
@@ -346,7 +369,8 @@ class compact_mutation_state {
     requires CompactedFragmentsConsumerV2<Consumer> && CompactedFragmentsConsumerV2<GCConsumer>
     void consume(tombstone t, Consumer& consumer, GCConsumer& gc_consumer) {
         _partition_tombstone = t;
-        if (can_purge_tombstone(t)) {
+        _partition_tombstone_purgeable = can_purge_tombstone(t);
+        if (_partition_tombstone_purgeable) {
             partition_is_not_empty_for_gc_consumer(gc_consumer);
         } else {
             partition_is_not_empty(consumer);
@@ -642,7 +666,7 @@ class compact_mutation_v2 {
 
     // Can only be used for compact_for_sstables::yes
     compact_mutation_v2(const schema& s, gc_clock::time_point compaction_time,
-            std::function<api::timestamp_type(const dht::decorated_key&)> get_max_purgeable,
+            std::function<max_purgeable(const dht::decorated_key&)> get_max_purgeable,
             const tombstone_gc_state& gc_state,
             Consumer consumer, GCConsumer gc_consumer = GCConsumer())
         : _state(make_lw_shared<compact_mutation_state<SSTableCompaction>>(s, compaction_time, get_max_purgeable, gc_state))
@@ -99,6 +99,28 @@ mutation_partition_v2::operator=(mutation_partition_v2&& x) noexcept {
     return *this;
 }
 
+std::optional<mutation_partition_v2::rows_type::iterator>
+mutation_partition_v2::append_position(const schema& s, const rows_entry& e) {
+    if (_rows.empty() || e.is_last_dummy()) {
+        return std::nullopt;
+    }
+    rows_entry::tri_compare cmp(s);
+    // The last dummy, if present, is always the last entry, so e goes right before it.
+    auto i = _rows.end();
+    auto last = std::prev(i);
+    if (last->is_last_dummy()) {
+        if (last == _rows.begin()) {
+            return last;
+        }
+        i = last;
+        --last;
+    }
+    if (cmp(*last, e) < 0) {
+        return i;
+    }
+    return std::nullopt;
+}
+
 void mutation_partition_v2::ensure_last_dummy(const schema& s) {
     check_schema(s);
     if (_rows.empty() || !_rows.rbegin()->is_last_dummy()) {
@@ -261,9 +283,16 @@ stop_iteration mutation_partition_v2::apply_monotonically(const schema& s, const
         if (i != _rows.end()) {
             auto x = cmp(*i, src_e);
             if (x < 0) {
-                bool match;
-                i = _rows.lower_bound(src_e, match, cmp);
-                miss = !match;
+                if (auto tail = append_position(s, src_e)) {
+                    // Rows written in clustering order, as is typical for time series,
+                    // go past the last row, so we can avoid the lookup.
+                    i = *tail;
+                    ++app_stats.rows_appended;
+                } else {
+                    bool match;
+                    i = _rows.lower_bound(src_e, match, cmp);
+                    miss = !match;
+                }
             } else {
                 miss = x > 0;
             }
@@ -216,6 +216,9 @@ class mutation_partition_v2 final {
 private:
     // Erases the entry if it's safe to do so without changing the logical state of the partition.
     rows_type::iterator maybe_drop(const schema&, cache_tracker*, rows_type::iterator, mutation_application_stats&);
+    // If e sorts after all rows of this partition, returns the position before which it
+    // should be inserted, which is either end() or the last dummy entry. Constant time.
+    std::optional<rows_type::iterator> append_position(const schema&, const rows_entry& e);
     void insert_row(const schema& s, const clustering_key& key, deletable_row&& row);
     void insert_row(const schema& s, const clustering_key& key, const deletable_row& row);
 public:
@@ -13,6 +13,7 @@
 #include "readers/clustering_combined.hh"
 #include "readers/range_tombstone_change_merger.hh"
 #include "readers/combined.hh"
+#include "comparable_bytes.hh"
 
 extern logging::logger mrlog;
 
@@ -155,6 +156,9 @@ class mutation_reader_merger {
     struct reader_and_fragment {
         reader_iterator reader{};
         mutation_fragment_v2 fragment;
+        // The encoding of fragment.position(), for mergers ordering fragments
+        // by it. Left empty for partition starts, which sort first anyway.
+        bytes encoded_position;
 
         reader_and_fragment(reader_iterator r, mutation_fragment_v2 f)
             : reader(r)
@@ -224,6 +228,9 @@ class mutation_reader_merger {
     // that the gallop mode was stopped (galloping reader lost to some other reader).
     int _gallop_mode_hits = 0;
     const schema_ptr _schema;
+    // Whether fragments of the current partition are ordered by their encoded
+    // positions rather than with position_in_partition::less_compare.
+    const bool _byte_comparable_positions;
     streamed_mutation::forwarding _fwd_sm;
     mutation_reader::forwarding _fwd_mr;
 private:
@@ -335,13 +342,18 @@ struct mutation_reader_merger::reader_heap_compare {
 
 struct mutation_reader_merger::fragment_heap_compare {
     position_in_partition::less_compare cmp;
+    bool byte_comparable;
 
-    explicit fragment_heap_compare(const schema& s)
-        : cmp(s) {
+    fragment_heap_compare(const schema& s, bool byte_comparable)
+        : cmp(s)
+        , byte_comparable(byte_comparable) {
     }
 
     bool operator()(const mutation_reader_merger::reader_and_fragment& a, const mutation_reader_merger::reader_and_fragment& b) {
         // Invert comparison as this is a max-heap.
+        if (byte_comparable) {
+            return comparable_bytes::tri_compare(b.encoded_position, a.encoded_position) < 0;
+        }
         return cmp(b.fragment.position(), a.fragment.position());
     }
 };
@@ -401,7 +413,10 @@ future<mutation_reader_merger::needs_merge> mutation_reader_merger::prepare_one(
                 }
 
                 _fragment_heap.emplace_back(rk.reader, std::move(*mfo));
-                boost::range::push_heap(_fragment_heap, fragment_heap_compare(*_schema));
+                if (_byte_comparable_positions) {
+                    _fragment_heap.back().encoded_position = comparable_bytes::encode_position(*_schema, _fragment_heap.back().fragment.position());
+                }
+                boost::range::push_heap(_fragment_heap, fragment_heap_compare(*_schema, _byte_comparable_positions));
             }
         } else if (_fwd_sm == streamed_mutation::forwarding::yes && rk.last_kind != mutation_fragment_v2::kind::partition_end) {
             // When in streamed_mutation::forwarding mode we need
@@ -465,6 +480,7 @@ mutation_reader_merger::mutation_reader_merger(schema_ptr schema,
         mutation_reader::forwarding fwd_mr)
     : _selector(std::move(selector))
     , _schema(std::move(schema))
+    , _byte_comparable_positions(comparable_bytes::global_byte_comparable_keys() && comparable_bytes::clustering_key_is_byte_comparable(*_schema))
     , _fwd_sm(fwd_sm)
     , _fwd_mr(fwd_mr) {
     maybe_add_readers(std::nullopt);
@@ -542,15 +558,23 @@ future<mutation_fragment_batch_opt> mutation_reader_merger::maybe_produce_batch(
     }
 
     const auto equal = position_in_partition::equal_compare(*_schema);
+    bytes current_position;
+    auto at_current_position = [&] (const reader_and_fragment& rf) {
+        if (_byte_comparable_positions) {
+            return rf.encoded_position == current_position;
+        }
+        return equal(_current.back().fragment.position(), rf.fragment.position());
+    };
     do {
-        boost::range::pop_heap(_fragment_heap, fragment_heap_compare(*_schema));
+        boost::range::pop_heap(_fragment_heap, fragment_heap_compare(*_schema, _byte_comparable_positions));
         auto& n = _fragment_heap.back();
         const auto kind = n.fragment.mutation_fragment_kind();
         _current.emplace_back(std::move(n.fragment), &*n.reader);
         _next.emplace_back(n.reader, kind);
+        current_position = std::move(n.encoded_position);
         _fragment_heap.pop_back();
     }
-    while (!_fragment_heap.empty() && equal(_current.back().fragment.position(), _fragment_heap.front().fragment.position()));
+    while (!_fragment_heap.empty() && at_current_position(_fragment_heap.front()));
 
     if (_next.size() == 1 && _next.front().reader == _galloping_reader.reader) {
         ++_gallop_mode_hits;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "compaction/compaction_garbage_collector.hh"
 #include "gc_clock.hh"
 #include "readers/flat_mutation_reader_fwd.hh"
 #include "timestamp.hh"
@@ -34,6 +35,6 @@ class tombstone_gc_state;
 /// Intra-partition forwarding: `fast_forward_to(position_range)` is supported
 /// if the source reader supports it
 flat_mutation_reader_v2 make_compacting_reader(flat_mutation_reader_v2 source, gc_clock::time_point compaction_time,
-        std::function<api::timestamp_type(const dht::decorated_key&)> get_max_purgeable,
+        std::function<max_purgeable(const dht::decorated_key&)> get_max_purgeable,
         const tombstone_gc_state& gc_state,
         streamed_mutation::forwarding fwd = streamed_mutation::forwarding::no);
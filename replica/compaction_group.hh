@@ -92,6 +92,9 @@ class compaction_group {
     size_t memtable_count() const noexcept;
     // Returns minimum timestamp from memtable list
     api::timestamp_type min_memtable_timestamp() const;
+    // Returns minimum timestamp from the memtables which contain the partition,
+    // or which are being flushed
+    api::timestamp_type min_memtable_timestamp(const dht::decorated_key& dk) const;
     // Add sstable to main set
     void add_sstable(sstables::shared_sstable sstable);
     // Add sstable to maintenance set
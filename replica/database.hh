@@ -436,6 +436,8 @@ class table : public enable_lw_shared_from_this<table>
     // Ensures that concurrent updates to sstable set will work correctly
     seastar::named_semaphore _sstable_set_mutation_sem = {1, named_semaphore_exception_factory{"sstable set mutation"}};
     mutable row_cache _cache; // Cache covers only sstables.
+    // Statistics and pinning of the cached index pages of the table's sstables.
+    lw_shared_ptr<sstables::index_cache_table> _index_cache_table;
     // Initialized when the table is populated via update_sstables_known_generation.
     std::optional<sstables::sstable_generation_generator> _sstable_generation_generator;
 
@@ -748,6 +750,7 @@ class table : public enable_lw_shared_from_this<table>
     // TODO: expose stats, whatever, instead of exposing active memtables themselves.
     std::vector<memtable*> active_memtables();
     api::timestamp_type min_memtable_timestamp() const;
+    api::timestamp_type min_memtable_timestamp(const dht::decorated_key& dk) const;
     const row_cache& get_row_cache() const {
         return _cache;
     }
@@ -104,6 +104,7 @@ void
 region_group::execute_one() {
     auto req = std::move(_blocked_requests.front());
     _blocked_requests.pop_front();
+    account_blocked_request(*req);
     req->allocate();
 }
 
@@ -133,7 +134,7 @@ future<> region_group::release_queued_allocations() {
 region_group::region_group(sstring name,
         reclaim_config cfg, scheduling_group deferred_work_sg)
     : _cfg(std::move(cfg))
-    , _blocked_requests(on_request_expiry{std::move(name)})
+    , _blocked_requests(on_request_expiry{*this, std::move(name)})
     , _releaser(reclaimer_can_block() ? start_releaser(deferred_work_sg) : make_ready_future<>())
 {
 }
@@ -198,6 +199,7 @@ region_group::shutdown() noexcept {
 }
 
 void region_group::on_request_expiry::operator()(std::unique_ptr<allocating_function>& func) noexcept {
+    _rg.account_blocked_request(*func);
     func->fail(std::make_exception_ptr(blocked_requests_timed_out_error{_name}));
 }
 
@@ -207,7 +209,7 @@ future<flush_permit> flush_permit::reacquire_sstable_write_permit() && {
     return _manager->get_flush_permit(std::move(_background_permit));
 }
 
-dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg)
+dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, unsigned flush_concurrency, scheduling_group deferred_work_sg)
     : _db(&db)
     , _region_group("memtable (unspooled)", dirty_memory_manager_logalloc::reclaim_config{
             .unspooled_hard_limit = threshold / 2,
@@ -215,7 +217,8 @@ dirty_memory_manager::dirty_memory_manager(replica::database& db, size_t thresho
             .real_hard_limit = threshold,
             .start_reclaiming = std::bind_front(&dirty_memory_manager::start_reclaiming, this)
       }, deferred_work_sg)
-    , _flush_serializer(1)
+    , _flush_concurrency(std::max(flush_concurrency, 1u))
+    , _flush_serializer(_flush_concurrency)
     , _waiting_flush(flush_when_needed()) {}
 
 void
@@ -230,6 +233,16 @@ dirty_memory_manager::setup_collectd(sstring namestr) {
 
         sm::make_gauge(namestr +"_unspooled_dirty_bytes", [this] { return unspooled_dirty_memory(); },
                        sm::description("Holds the size of used memory in bytes. Compare it to \"dirty_bytes\" to see how many memory is wasted (neither used nor available).")),
+
+        sm::make_gauge(namestr + "_active_flushes", [this] { return active_flushes(); },
+                       sm::description("Holds the number of memtables which are currently being written to sstables. "
+                                       "A value which stays at the flush concurrency limit (memtable_flush_writers) means that flushing is a bottleneck.")),
+
+        sm::make_counter(namestr + "_blocked_requests_time_ms", [this] {
+                            return std::chrono::duration_cast<std::chrono::milliseconds>(_region_group.blocked_requests_time()).count();
+                       },
+                       sm::description("Counts the total time in milliseconds spent by requests which were blocked due to reaching the memory quota, "
+                                       "until they were either executed or timed out.")),
     });
 }
 
@@ -285,7 +298,7 @@ future<> dirty_memory_manager::flush_when_needed() {
                     return sleep(1ms);
                 }
 
-                // Do not wait. The semaphore will protect us against a concurrent flush. But we
+                // Do not wait. The semaphore limits the number of concurrent flushes. But we
                 // want to start a new one as soon as the permits are destroyed and the semaphore is
                 // made ready again, not when we are done with the current one.
                 (void)this->flush_one(mtlist, std::move(permit)).handle_exception([] (std::exception_ptr ex) {
@@ -103,6 +103,8 @@ class region_group : public logalloc::region_listener {
     using region_heap = dirty_memory_manager_logalloc::region_heap;
 public:
     struct allocating_function {
+        // When the request was blocked, for accounting the time spent throttled.
+        const std::chrono::steady_clock::time_point blocked_at = std::chrono::steady_clock::now();
         virtual ~allocating_function() = default;
         virtual void allocate() = 0;
         virtual void fail(std::exception_ptr) = 0;
@@ -137,9 +139,10 @@ class region_group : public logalloc::region_listener {
             }
         };
 
+        region_group& _rg;
         sstring _name;
     public:
-        explicit on_request_expiry(sstring name) : _name(std::move(name)) {}
+        on_request_expiry(region_group& rg, sstring name) : _rg(rg), _name(std::move(name)) {}
         void operator()(std::unique_ptr<allocating_function>&) noexcept;
     };
 private:
@@ -167,6 +170,9 @@ class region_group : public logalloc::region_listener {
     expiring_fifo<std::unique_ptr<allocating_function>, on_request_expiry, db::timeout_clock> _blocked_requests;
 
     uint64_t _blocked_requests_counter = 0;
+    // Total time spent by requests which are no longer blocked, either because they were
+    // executed or because they timed out.
+    std::chrono::steady_clock::duration _blocked_requests_time{};
 
     size_t _unspooled_total_memory = 0;
 
@@ -325,7 +331,15 @@ class region_group : public logalloc::region_listener {
     size_t blocked_requests() const noexcept;
 
     uint64_t blocked_requests_counter() const noexcept;
+
+    std::chrono::steady_clock::duration blocked_requests_time() const noexcept {
+        return _blocked_requests_time;
+    }
 private:
+    void account_blocked_request(const allocating_function& req) noexcept {
+        _blocked_requests_time += std::chrono::steady_clock::now() - req.blocked_at;
+    }
+
     // Returns true if and only if constraints of this group are not violated.
     // That's taking into account any constraints imposed by enclosing (parent) groups.
     bool execution_permitted() noexcept;
@@ -396,11 +410,13 @@ class dirty_memory_manager {
     // memory usage minus bytes that were already written to disk.
     dirty_memory_manager_logalloc::region_group _region_group;
 
-    // We would like to serialize the flushing of memtables. While flushing many memtables
-    // simultaneously can sustain high levels of throughput, the memory is not freed until the
-    // memtable is totally gone. That means that if we have throttled requests, they will stay
-    // throttled for a long time. Even when we have unspooled dirty, that only provides a rough
-    // estimate, and we can't release requests that early.
+    // We would like to limit the number of memtables flushed concurrently, by default to one.
+    // While flushing many memtables simultaneously can sustain high levels of throughput, the
+    // memory is not freed until the memtable is totally gone. That means that if we have
+    // throttled requests, they will stay throttled for a long time. Even when we have unspooled
+    // dirty, that only provides a rough estimate, and we can't release requests that early.
+    // Fast disks may need more than one flush in flight to be kept busy, though.
+    const unsigned _flush_concurrency;
     semaphore _flush_serializer;
     // We will accept a new flush before another one ends, once it is done with the data write.
     // That is so we can keep the disk always busy. But there is still some background work that is
@@ -462,14 +478,20 @@ class dirty_memory_manager {
     //
     // We then set the soft limit to 80 % of the unspooled dirty hard limit, which is equal to 40 % of
     // the user-supplied threshold.
-    dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, scheduling_group deferred_work_sg);
+    //
+    // Flush Concurrency
+    // -----------------
+    // Up to flush_concurrency memtables, possibly of the same table, are written to sstables at
+    // the same time.
+    dirty_memory_manager(replica::database& db, size_t threshold, double soft_limit, unsigned flush_concurrency, scheduling_group deferred_work_sg);
     dirty_memory_manager()
         : _db(nullptr)
         , _region_group("memtable (unspooled)",
                 dirty_memory_manager_logalloc::reclaim_config{
                     .start_reclaiming = std::bind_front(&dirty_memory_manager::start_reclaiming, this),
                 })
-        , _flush_serializer(1)
+        , _flush_concurrency(1)
+        , _flush_serializer(_flush_concurrency)
         , _waiting_flush(make_ready_future<>()) {}
 
     static dirty_memory_manager& from_region_group(dirty_memory_manager_logalloc::region_group *rg) noexcept {
@@ -520,6 +542,11 @@ class dirty_memory_manager {
         return _region_group.unspooled_throttle_threshold();
     }
 
+    // The number of memtables which are being written to sstables.
+    unsigned active_flushes() const noexcept {
+        return _flush_concurrency - std::min<size_t>(_flush_serializer.available_units(), _flush_concurrency);
+    }
+
     future<> flush_one(replica::memtable_list& cf, flush_permit&& permit) noexcept;
 
     future<flush_permit> get_flush_permit() noexcept {
@@ -239,6 +239,10 @@ memtable::find_or_create_partition(const dht::decorated_key& key) {
     return i->partition();
 }
 
+bool memtable::contains_partition(const dht::decorated_key& key) const {
+    return partitions.find(key, dht::ring_position_comparator(*_schema)) != partitions.end();
+}
+
 boost::iterator_range<memtable::partitions_type::const_iterator>
 memtable::slice(const dht::partition_range& range) const {
     if (query::is_single_partition(range)) {
@@ -740,6 +744,7 @@ memtable::make_flat_reader_opt(schema_ptr s,
 
 flat_mutation_reader_v2
 memtable::make_flush_reader(schema_ptr s, reader_permit permit) {
+    _flush_started = true;
     if (!_merged_into_cache) {
         return make_flat_mutation_reader_v2<flush_reader>(std::move(s), std::move(permit), shared_from_this());
     } else {
@@ -825,6 +830,7 @@ stop_iteration memtable_entry::clear_gently() noexcept {
 }
 
 void memtable::mark_flushed(mutation_source underlying) noexcept {
+    _flush_started = true;
     _underlying = std::move(underlying);
 }
 
@@ -126,6 +126,9 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     mutation_source_opt _underlying;
     uint64_t _flushed_memory = 0;
     bool _merged_into_cache = false;
+    // Set once the flush started. Partitions are then moved to the cache,
+    // so the memtable may no longer contain all of its data.
+    bool _flush_started = false;
     replica::table_stats& _table_stats;
 
     class memtable_encoding_stats_collector : public encoding_stats_collector {
@@ -222,6 +225,7 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     }
 
     size_t partition_count() const noexcept { return nr_partitions; }
+    bool contains_partition(const dht::decorated_key& key) const;
     logalloc::occupancy_stats occupancy() const noexcept;
 
     // Creates a reader of data in this memtable for given partition range.
@@ -268,6 +272,7 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private dirt
     bool empty() const noexcept { return partitions.empty(); }
     void mark_flushed(mutation_source) noexcept;
     bool is_flushed() const noexcept;
+    bool flush_started() const noexcept { return _flush_started; }
     void on_detach_from_region_group() noexcept;
     void revert_flushed_memory() noexcept;
 
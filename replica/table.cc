@@ -384,10 +384,28 @@ api::timestamp_type compaction_group::min_memtable_timestamp() const {
     );
 }
 
+api::timestamp_type compaction_group::min_memtable_timestamp(const dht::decorated_key& dk) const {
+    auto timestamp = api::max_timestamp;
+    for (const shared_memtable& m : *_memtables) {
+        // The lookup is skipped when the memtable can't lower the result.
+        // A memtable which is being flushed loses the partitions moved to the
+        // cache, while the sstable they were written to may not be visible
+        // to the compaction yet, so it's accounted as a whole.
+        if (m->get_min_timestamp() < timestamp && (m->flush_started() || m->contains_partition(dk))) {
+            timestamp = m->get_min_timestamp();
+        }
+    }
+    return timestamp;
+}
+
 api::timestamp_type table::min_memtable_timestamp() const {
     return *boost::range::min_element(compaction_groups() | boost::adaptors::transformed(std::mem_fn(&compaction_group::min_memtable_timestamp)));
 }
 
+api::timestamp_type table::min_memtable_timestamp(const dht::decorated_key& dk) const {
+    return compaction_group_for_token(dk.token()).min_memtable_timestamp(dk);
+}
+
 // Not performance critical. Currently used for testing only.
 future<bool>
 table::for_all_partitions_slow(schema_ptr s, reader_permit permit, std::function<bool (const dht::decorated_key&, const mutation_partition&)> func) const {
@@ -949,6 +967,9 @@ table::seal_active_memtable(compaction_group& cg, flush_permit&& flush_permit) n
         }
         auto write_permit = permit.release_sstable_write_permit();
 
+        co_await utils::get_local_injector().inject_with_handler("table_seal_active_memtable_pause_flush", [] (auto& handler) {
+            return handler.wait_for_message(db::timeout_clock::now() + 5min);
+        });
         utils::get_local_injector().inject("table_seal_active_memtable_try_flush", []() {
             throw std::system_error(ENOSPC, std::system_category(), "Injected error");
         });
@@ -1086,6 +1107,7 @@ void table::set_metrics() {
                 ms::make_counter("memtable_partition_hits", _stats.memtable_partition_hits, ms::description("Number of times a write operation was issued on an existing partition in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_row_writes", _stats.memtable_app_stats.row_writes, ms::description("Number of row writes performed in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_row_hits", _stats.memtable_app_stats.row_hits, ms::description("Number of rows overwritten by write operations in memtables"))(cf)(ks).set_skip_when_empty().set_skip_when_empty(),
+                ms::make_counter("memtable_rows_appended", _stats.memtable_app_stats.rows_appended, ms::description("Number of rows written after the last row of their partition in memtables, which is cheaper than an insertion in the middle"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_rows_dropped_by_tombstones", _stats.memtable_app_stats.rows_dropped_by_tombstones, ms::description("Number of rows dropped in memtables by a tombstone write"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_rows_compacted_with_tombstones", _stats.memtable_app_stats.rows_compacted_with_tombstones, ms::description("Number of rows scanned during write of a tombstone for the purpose of compaction in memtables"))(cf)(ks).set_skip_when_empty(),
                 ms::make_counter("memtable_range_tombstone_reads", _stats.memtable_range_tombstone_reads, ms::description("Number of range tombstones read from memtables"))(cf)(ks).set_skip_when_empty(),
@@ -1097,7 +1119,15 @@ void table::set_metrics() {
                 ms::make_gauge("pending_compaction", ms::description("Estimated number of compactions pending for this column family"), _stats.pending_compactions)(cf)(ks),
                 ms::make_gauge("pending_sstable_deletions",
                         ms::description("Number of tasks waiting to delete sstables from a table"),
-                        [this] { return _sstable_deletion_sem.waiters(); })(cf)(ks)
+                        [this] { return _sstable_deletion_sem.waiters(); })(cf)(ks),
+                ms::make_counter("index_page_hits", _index_cache_table->partition_index_stats.hits, ms::description("Index page requests which could be satisfied without waiting"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("index_page_misses", _index_cache_table->partition_index_stats.misses, ms::description("Index page requests which initiated a read from disk"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("index_page_evictions", _index_cache_table->partition_index_stats.evictions, ms::description("Index pages which got evicted from memory"))(cf)(ks).set_skip_when_empty(),
+                ms::make_gauge("index_page_used_bytes", _index_cache_table->partition_index_stats.used_bytes, ms::description("Amount of bytes used by index pages in memory"))(cf)(ks),
+                ms::make_counter("index_page_cache_hits", _index_cache_table->file_stats.page_hits, ms::description("Index page cache requests which were served from cache"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("index_page_cache_misses", _index_cache_table->file_stats.page_misses, ms::description("Index page cache requests which had to perform I/O"))(cf)(ks).set_skip_when_empty(),
+                ms::make_counter("index_page_cache_evictions", _index_cache_table->file_stats.page_evictions, ms::description("Index page cache pages which have been evicted"))(cf)(ks).set_skip_when_empty(),
+                ms::make_gauge("index_page_cache_bytes", _index_cache_table->file_stats.cached_bytes, ms::description("Number of bytes cached in the index page cache"))(cf)(ks),
         });
 
         // Metrics related to row locking
@@ -1146,7 +1176,11 @@ void table::set_metrics() {
                 ms::make_gauge("total_disk_space", ms::description("Total disk space used"), _stats.total_disk_space_used)(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
                 ms::make_gauge("live_sstable", ms::description("Live sstable count"), _stats.live_sstable_count)(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}),
                 ms::make_counter("read_latency_count", ms::description("Number of reads"), [this] {return _stats.reads.histogram().count();})(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
-                ms::make_counter("write_latency_count", ms::description("Number of writes"), [this] {return _stats.writes.histogram().count();})(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}).set_skip_when_empty()
+                ms::make_counter("write_latency_count", ms::description("Number of writes"), [this] {return _stats.writes.histogram().count();})(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
+                ms::make_counter("index_page_hits", _index_cache_table->partition_index_stats.hits, ms::description("Index page requests which could be satisfied without waiting"))(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
+                ms::make_counter("index_page_misses", _index_cache_table->partition_index_stats.misses, ms::description("Index page requests which initiated a read from disk"))(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
+                ms::make_counter("index_page_cache_hits", _index_cache_table->file_stats.page_hits, ms::description("Index page cache requests which were served from cache"))(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}).set_skip_when_empty(),
+                ms::make_counter("index_page_cache_misses", _index_cache_table->file_stats.page_misses, ms::description("Index page cache requests which had to perform I/O"))(cf)(ks)(node_table_metrics).aggregate({seastar::metrics::shard_label}).set_skip_when_empty()
             });
         }
     }
@@ -1659,6 +1693,7 @@ table::table(schema_ptr schema, config config, lw_shared_ptr<const storage_optio
     , _compaction_groups(_cg_manager->make_compaction_groups())
     , _sstables(make_compound_sstable_set())
     , _cache(_schema, sstables_as_snapshot_source(), row_cache_tracker, is_continuous::yes)
+    , _index_cache_table(row_cache_tracker.get_index_cache_table(_schema->id()))
     , _commitlog(nullptr)
     , _readonly(true)
     , _durable_writes(true)
@@ -1671,6 +1706,7 @@ table::table(schema_ptr schema, config config, lw_shared_ptr<const storage_optio
     if (!_config.enable_disk_writes) {
         tlogger.warn("Writes disabled, column family no durable.");
     }
+    _index_cache_table->set_pinned(_schema->caching_options().index_pinned());
     set_metrics();
 }
 
@@ -2079,6 +2115,13 @@ void table::set_schema(schema_ptr s) {
     }
     _schema = std::move(s);
 
+    if (_index_cache_table->pinned() != _schema->caching_options().index_pinned()) {
+        _index_cache_table->set_pinned(_schema->caching_options().index_pinned());
+        for (auto& sst : *get_sstables()) {
+            sst->update_index_cache_pinning();
+        }
+    }
+
     for (auto&& v : _views) {
         v->view_info()->set_base_info(
             v->view_info()->make_base_dependent_view_info(*_schema));
@@ -2911,6 +2954,9 @@ class compaction_group::table_state : public compaction::table_state {
     api::timestamp_type min_memtable_timestamp() const override {
         return _cg.min_memtable_timestamp();
     }
+    api::timestamp_type min_memtable_timestamp_for_key(const dht::decorated_key& dk) const override {
+        return _cg.min_memtable_timestamp(dk);
+    }
     future<> on_compaction_completion(sstables::compaction_completion_desc desc, sstables::offstrategy offstrategy) override {
         if (offstrategy) {
             co_await _cg.update_sstable_lists_on_off_strategy_completion(std::move(desc));
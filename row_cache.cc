@@ -64,11 +64,17 @@ cache_tracker::cache_tracker(utils::updateable_value<double> index_cache_fractio
 
 static thread_local cache_tracker* current_tracker;
 
+// Counters per row of the admission frequency sketch, which takes 128 KiB.
+static constexpr size_t admission_sketch_width = 1 << 16;
+
 cache_tracker::cache_tracker(utils::updateable_value<double> index_cache_fraction, mutation_application_stats& app_stats, register_metrics with_metrics)
     : _garbage(_region, this, app_stats)
     , _memtable_cleaner(_region, nullptr, app_stats)
     , _app_stats(app_stats)
     , _index_cache_fraction(std::move(index_cache_fraction))
+    , _index_cache_pinned_fraction(1.0)
+    , _packing_timer([this] { on_packing_timer(); })
+    , _frequencies(admission_sketch_width)
 {
     if (with_metrics) {
         setup_metrics();
@@ -109,11 +115,24 @@ cache_tracker::cache_tracker(utils::updateable_value<double> index_cache_fractio
             // 3. The parameter is trivially live-updateable.
             //
             // Perhaps this logic should be encapsulated somewhere else, maybe in `class lru` itself.
+            //
+            // Pinned index entries are not evicted by the above, unless they take more than
+            // index_cache_pinned_fraction of cache memory, or there is nothing else to evict.
             size_t total_cache_space = _region.occupancy().total_space();
-            size_t index_cache_space = _partition_index_cache_stats.used_bytes + _index_cached_file_stats.cached_bytes;
+            size_t pinned_space = _lru.pinned_bytes();
+            if (pinned_space > total_cache_space * _index_cache_pinned_fraction.get()) {
+                return _lru.evict_pinned();
+            }
+            // Cached pages of remote sstable data are linked with the index pages, so they count as such.
+            size_t index_cache_space = _partition_index_cache_stats.used_bytes + _index_cached_file_stats.cached_bytes
+                    + _remote_data_cached_file_stats.cached_bytes - pinned_space;
             bool should_evict_index = index_cache_space > total_cache_space * _index_cache_fraction.get();
 
-            return _lru.evict(should_evict_index);
+            auto result = _lru.evict(should_evict_index);
+            if (result == memory::reclaiming_result::reclaimed_nothing) {
+                result = _lru.evict_pinned();
+            }
+            return result;
         });
     });
 }
@@ -129,6 +148,130 @@ memory::reclaiming_result cache_tracker::evict_from_lru_shallow() noexcept {
     });
 }
 
+static constexpr auto packing_period = 1s;
+// Bounds the work done by a single pass of packing.
+static constexpr size_t packing_max_entries = 1024;
+// Bounds the work of packing or unpacking a single run of rows.
+static constexpr size_t packing_max_run_rows = 128;
+
+void cache_tracker::set_columnar_min_rows(utils::updateable_value<uint32_t> min_rows) {
+    _columnar_min_rows = std::move(min_rows);
+    _row_evictions_at_last_packing = _stats.row_evictions;
+    _packing_timer.arm_periodic(packing_period);
+}
+
+void cache_tracker::on_packing_timer() {
+    auto min_rows = _columnar_min_rows();
+    // Cold partitions are only worth packing when the cache is full, which is when rows get evicted.
+    if (!min_rows || _stats.row_evictions == _row_evictions_at_last_packing) {
+        return;
+    }
+    _row_evictions_at_last_packing = _stats.row_evictions;
+    try {
+        pack_cold_partitions(min_rows, packing_max_entries);
+    } catch (...) {
+        clogger.warn("Failed to pack cold partitions: {}", std::current_exception());
+    }
+}
+
+size_t cache_tracker::pack_cold_partitions(uint32_t min_rows, size_t max_entries) {
+    size_t packed = 0;
+    _packing_section(_region, [&] {
+        with_allocator(_region.allocator(), [&] {
+            std::vector<cache_entry*> candidates;
+            size_t visited = 0;
+            _lru.for_each_coldest([&] (evictable& e) {
+                if (visited++ == max_entries) {
+                    return stop_iteration::yes;
+                }
+                if (e.is_index()) {
+                    return stop_iteration::no;
+                }
+                mutation_partition_v2::rows_type::iterator it(&static_cast<rows_entry&>(e));
+                auto& pv = partition_version::container_of(mutation_partition_v2::container_of(*it.owning_tree()));
+                if (!pv.is_referenced_from_entry()) {
+                    return stop_iteration::no;
+                }
+                partition_entry& pe = partition_entry::container_of(pv);
+                if (pe.is_locked()) {
+                    return stop_iteration::no;
+                }
+                cache_entry* ce = &cache_entry::container_of(pe);
+                if (std::find(candidates.begin(), candidates.end(), ce) == candidates.end()) {
+                    candidates.push_back(ce);
+                }
+                return stop_iteration::no;
+            });
+            // Packing doesn't move cache entries, nor any other rows, so the candidates stay valid.
+            // Partitions which are left partially packed are continued by the next pass.
+            for (cache_entry* ce : candidates) {
+                packed += ce->pack(*this, min_rows);
+                if (packed && need_preempt()) {
+                    break;
+                }
+            }
+        });
+    });
+    return packed;
+}
+
+void cache_tracker::record_access(uint64_t partition_hash) noexcept {
+    auto resets = _frequencies.resets();
+    _frequencies.increment(partition_hash);
+    if (_frequencies.resets() != resets) {
+        _evicted_before_sketch_reset = _stats.row_evictions != _row_evictions_at_sketch_reset;
+        _row_evictions_at_sketch_reset = _stats.row_evictions;
+    }
+}
+
+bool cache_tracker::admit(uint64_t partition_hash) noexcept {
+    // Until the cache is full, admitting doesn't cost anything.
+    if (!_evicted_before_sketch_reset && _stats.row_evictions == _row_evictions_at_sketch_reset) {
+        return true;
+    }
+    std::optional<uint64_t> victim;
+    size_t visited = 0;
+    _lru.for_each_coldest([&] (evictable& e) {
+        if (e.is_index()) {
+            return stop_iteration(++visited == 16);
+        }
+        mutation_partition_v2::rows_type::iterator it(&static_cast<rows_entry&>(e));
+        auto& pv = partition_version::container_of(mutation_partition_v2::container_of(*it.owning_tree()));
+        if (pv.is_referenced_from_entry()) {
+            victim = cache_entry::container_of(partition_entry::container_of(pv)).admission_hash();
+        }
+        return stop_iteration::yes;
+    });
+    if (!victim || _frequencies.estimate(partition_hash) > _frequencies.estimate(*victim)) {
+        return true;
+    }
+    ++_stats.partition_admission_rejections;
+    return false;
+}
+
+lw_shared_ptr<sstables::index_cache_table> cache_tracker::get_index_cache_table(table_id id) {
+    auto [it, inserted] = _index_cache_tables.emplace(id, nullptr);
+    if (!inserted) {
+        return it->second->shared_from_this();
+    }
+    try {
+        auto t = make_lw_shared<sstables::index_cache_table>(*this, id);
+        it->second = t.get();
+        return t;
+    } catch (...) {
+        _index_cache_tables.erase(it);
+        throw;
+    }
+}
+
+void cache_tracker::set_index_cache_pinned_fraction(utils::updateable_value<double> fraction) {
+    _index_cache_pinned_fraction = std::move(fraction);
+}
+
+sstables::index_cache_table::~index_cache_table() {
+    _tracker._index_cache_tables.erase(_id);
+}
+
 void cache_tracker::set_compaction_scheduling_group(seastar::scheduling_group sg) {
     _memtable_cleaner.set_scheduling_group(sg);
     _garbage.set_scheduling_group(sg);
@@ -136,6 +279,7 @@ void cache_tracker::set_compaction_scheduling_group(seastar::scheduling_group sg
 
 namespace sstables {
 void register_index_page_cache_metrics(seastar::metrics::metric_groups&, cached_file_stats&);
+void register_remote_data_cache_metrics(seastar::metrics::metric_groups&, cached_file_stats&);
 void register_index_page_metrics(seastar::metrics::metric_groups&, partition_index_cache_stats&);
 };
 
@@ -185,8 +329,21 @@ cache_tracker::setup_metrics() {
             sm::description("total amount of attempts to compact expired rows during read")),
         sm::make_counter("rows_compacted_away", _stats.rows_compacted_away,
             sm::description("total amount of compacted and removed rows during read")),
+        sm::make_counter("columnar_runs_packed", _stats.columnar_runs_packed,
+            sm::description("total number of runs of rows of cold partitions which were packed into the columnar representation")),
+        sm::make_counter("columnar_runs_unpacked", _stats.columnar_runs_unpacked,
+            sm::description("total number of packed runs of rows which were brought back by a read")),
+        sm::make_counter("columnar_runs_dropped", _stats.columnar_runs_dropped,
+            sm::description("total number of packed runs of rows which were evicted, invalidated or not unpacked by a read")),
+        sm::make_gauge("columnar_runs", sm::description("current number of packed runs of rows"), _stats.columnar_runs),
+        sm::make_gauge("columnar_bytes", sm::description("current bytes used by packed runs of rows"), _stats.columnar_bytes),
+        sm::make_counter("partition_admission_rejections", _stats.partition_admission_rejections,
+            sm::description("total number of partitions missing in cache which were not inserted into it by reads, because they were accessed less frequently than the partitions they would evict")),
+        sm::make_gauge("index_pinned_bytes", sm::description("current bytes used by unused sstable index pages of tables with pinned index"),
+            [this] { return _lru.pinned_bytes(); }),
     });
     sstables::register_index_page_cache_metrics(_metrics, _index_cached_file_stats);
+    sstables::register_remote_data_cache_metrics(_metrics, _remote_data_cached_file_stats);
     sstables::register_index_page_metrics(_metrics, _partition_index_cache_stats);
 }
 
@@ -429,14 +586,16 @@ class single_partition_populating_reader final : public flat_mutation_reader_v2:
                     _cache._tracker.on_mispopulate();
                 }
                 _end_of_stream = true;
-            } else if (phase == _cache.phase_of(_read_context->range().start()->value())) {
+            } else if (phase != _cache.phase_of(_read_context->range().start()->value())) {
+                _cache._tracker.on_mispopulate();
+                _reader = read_directly_from_underlying(*_read_context, std::move(*mfopt));
+            } else if (!_cache.admit(mfopt->as_partition_start().key())) {
+                _reader = read_directly_from_underlying(*_read_context, std::move(*mfopt));
+            } else {
                 _reader = _cache._read_section(_cache._tracker.region(), [&] {
                     cache_entry& e = _cache.find_or_create_incomplete(mfopt->as_partition_start(), phase);
                     return e.read(_cache, *_read_context, phase);
                 });
-            } else {
-                _cache._tracker.on_mispopulate();
-                _reader = read_directly_from_underlying(*_read_context, std::move(*mfopt));
             }
           });
         });
@@ -492,12 +651,21 @@ void cache_tracker::clear_continuity(cache_entry& ce) noexcept {
     ce.set_continuous(false);
 }
 
-void row_cache::on_partition_hit() {
+void row_cache::on_partition_hit(const dht::decorated_key& dk) {
     _tracker.on_partition_hit();
+    _tracker.record_access(cache_entry::admission_hash(*_schema, dk));
 }
 
-void row_cache::on_partition_miss() {
+void row_cache::on_partition_miss(const dht::decorated_key& dk) {
     _tracker.on_partition_miss();
+    _tracker.record_access(cache_entry::admission_hash(*_schema, dk));
+}
+
+bool row_cache::admit(const dht::decorated_key& dk) noexcept {
+    if (!_schema->caching_options().frequency_based_admission()) {
+        return true;
+    }
+    return _tracker.admit(cache_entry::admission_hash(*_schema, dk));
 }
 
 void row_cache::on_row_hit() {
@@ -570,10 +738,10 @@ class range_populating_reader {
                         return make_ready_future<flat_mutation_reader_v2_opt>(std::nullopt);
                     });
                 }
-                _cache.on_partition_miss();
                 const partition_start& ps = mfopt->as_partition_start();
                 const dht::decorated_key& key = ps.key();
-                if (_reader.creation_phase() == _cache.phase_of(key)) {
+                _cache.on_partition_miss(key);
+                if (_reader.creation_phase() == _cache.phase_of(key) && _cache.admit(key)) {
                     return _cache._read_section(_cache._tracker.region(), [&] {
                         cache_entry& e = _cache.find_or_create_incomplete(ps, _reader.creation_phase(),
                                                                this->can_set_continuity() ? &*_last_key : nullptr);
@@ -581,7 +749,9 @@ class range_populating_reader {
                         return make_ready_future<flat_mutation_reader_v2_opt>(e.read(_cache, _read_context, _reader.creation_phase()));
                     });
                 } else {
-                    _cache._tracker.on_mispopulate();
+                    if (_reader.creation_phase() != _cache.phase_of(key)) {
+                        _cache._tracker.on_mispopulate();
+                    }
                     _last_key = row_cache::previous_entry_pointer(key);
                     return make_ready_future<flat_mutation_reader_v2_opt>(read_directly_from_underlying(_read_context, std::move(*mfopt)));
                 }
@@ -621,7 +791,7 @@ class scanning_and_populating_reader final : public flat_mutation_reader_v2::imp
 private:
     flat_mutation_reader_v2 read_from_entry(cache_entry& ce) {
         _cache.upgrade_entry(ce);
-        _cache.on_partition_hit();
+        _cache.on_partition_hit(ce.key());
         return ce.read(_cache, *_read_context);
     }
 
@@ -792,13 +962,13 @@ row_cache::make_reader_opt(schema_ptr s,
             if (hint.match) {
                 cache_entry& e = *i;
                 upgrade_entry(e);
-                on_partition_hit();
+                on_partition_hit(e.key());
                 return e.read(*this, make_context());
             } else if (i->continuous()) {
                 return {};
             } else {
                 tracing::trace(trace_state, "Range {} not found in cache", range);
-                on_partition_miss();
+                on_partition_miss(pos.as_decorated_key());
                 return make_flat_mutation_reader_v2<single_partition_populating_reader>(*this, make_context());
             }
         });
@@ -1111,6 +1281,8 @@ future<> row_cache::update(external_updater eu, replica::memtable& m) {
             cache_entry& entry = *cache_i;
             upgrade_entry(entry);
             assert(entry.schema() == _schema);
+            // The memtable may have rows in the range of any packed run.
+            entry.drop_packed(_tracker);
             _tracker.on_partition_merge();
             mem_e.upgrade_schema(_tracker.region(), _schema, _tracker.memtable_cleaner());
             return entry.partition().apply_to_incomplete(*_schema, std::move(mem_e.partition()), _tracker.memtable_cleaner(),
@@ -1264,6 +1436,57 @@ void row_cache::evict() {
     while (_tracker.region().evict_some() == memory::reclaiming_result::reclaimed_something) {}
 }
 
+future<std::vector<row_cache::hot_partition>> row_cache::get_hot_partitions(size_t max_partitions) {
+    return seastar::async([this, max_partitions] {
+        // A min-heap of the hottest partitions seen so far when max_partitions is set.
+        std::vector<hot_partition> hot;
+        auto hotter = [] (const hot_partition& a, const hot_partition& b) {
+            return a.frequency > b.frequency;
+        };
+        auto add = [&] (hot_partition p) {
+            if (!max_partitions || hot.size() < max_partitions) {
+                hot.push_back(std::move(p));
+                if (max_partitions) {
+                    std::push_heap(hot.begin(), hot.end(), hotter);
+                }
+            } else if (p.frequency > hot.front().frequency) {
+                std::pop_heap(hot.begin(), hot.end(), hotter);
+                hot.back() = std::move(p);
+                std::push_heap(hot.begin(), hot.end(), hotter);
+            }
+        };
+
+        std::optional<dht::decorated_key> last;
+        bool done = false;
+        while (!done) {
+            auto batch = _read_section(_tracker.region(), [&] {
+                std::vector<hot_partition> batch;
+                auto cmp = dht::ring_position_comparator(*_schema);
+                auto it = last ? _partitions.lower_bound(dht::ring_position_view::for_after_key(*last), cmp) : _partitions.begin();
+                while (!it->is_dummy_entry()) {
+                    batch.push_back(hot_partition{it->key(), _tracker.estimate_frequency(it->admission_hash())});
+                    ++it;
+                    if (need_preempt()) {
+                        break;
+                    }
+                }
+                done = it->is_dummy_entry();
+                return batch;
+            });
+            if (!batch.empty()) {
+                last = batch.back().key;
+            }
+            for (auto& p : batch) {
+                add(std::move(p));
+            }
+            seastar::thread::maybe_yield();
+        }
+
+        std::stable_sort(hot.begin(), hot.end(), hotter);
+        return hot;
+    });
+}
+
 row_cache::row_cache(schema_ptr s, snapshot_source src, cache_tracker& tracker, is_continuous cont)
     : _tracker(tracker)
     , _schema(std::move(s))
@@ -1282,6 +1505,7 @@ row_cache::row_cache(schema_ptr s, snapshot_source src, cache_tracker& tracker,
 cache_entry::cache_entry(cache_entry&& o) noexcept
     : _key(std::move(o._key))
     , _pe(std::move(o._pe))
+    , _packed(std::move(o._packed))
     , _flags(o._flags)
 {
 }
@@ -1289,10 +1513,154 @@ cache_entry::cache_entry(cache_entry&& o) noexcept
 cache_entry::~cache_entry() {
 }
 
+uint64_t cache_entry::admission_hash(const ::schema& s, const dht::decorated_key& dk) noexcept {
+    // Tokens of different tables collide, mix in the table.
+    uint64_t h = uint64_t(dk.token().raw()) ^ std::hash<table_id>()(s.id());
+    // Finalizer of murmur3, so that all bits of the hash depend on all bits of the token.
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
 void cache_entry::evict(cache_tracker& tracker) noexcept {
+    drop_packed(tracker);
     _pe.evict(tracker.cleaner());
 }
 
+size_t cache_entry::pack(cache_tracker& tracker, uint32_t min_rows) {
+    if (_pe._snapshot || _pe.version()->next()) {
+        return 0;
+    }
+    const schema& s = *schema();
+    auto& rows = _pe.version()->partition().mutable_clustered_rows();
+    if (!is_packed()) {
+        uint32_t row_count = 0;
+        for (auto i = rows.begin(); i != rows.end() && row_count < min_rows; ++i) {
+            row_count += !i->dummy();
+        }
+        if (row_count < std::max(min_rows, 1u)) {
+            return 0;
+        }
+    }
+
+    size_t packed = 0;
+    auto del = current_deleter<rows_entry>();
+    position_in_partition::less_compare less(s);
+    auto i = rows.begin();
+    do {
+        // A run is made of rows with nothing missing between them.
+        // The last dummy, which can't be encoded, ends every run.
+        size_t skipped = 0;
+        while (!columnar_rows::can_encode(s, *i)) {
+            if (++i == rows.end() || (++skipped % packing_max_run_rows == 0 && need_preempt())) {
+                return packed;
+            }
+        }
+        auto first = i;
+        size_t run_rows = 0;
+        size_t rows_memory = 0;
+        do {
+            rows_memory += i->memory_usage(s);
+            ++run_rows;
+            ++i;
+        } while (run_rows < packing_max_run_rows && i->continuous() && columnar_rows::can_encode(s, *i));
+
+        auto encoded = columnar_rows::encode(s, first, i);
+        if (!encoded || encoded->size_bytes() >= rows_memory) {
+            continue;
+        }
+        auto pos = std::partition_point(_packed.begin(), _packed.end(), [&] (const columnar_rows& run) {
+            return less(run.last_key(), first->key());
+        }) - _packed.begin();
+        _packed.emplace_back(*encoded);
+        std::rotate(_packed.begin() + pos, _packed.end() - 1, _packed.end());
+
+        // Leave the rows as if they were evicted, so that it is still correct
+        // to read the partition should the packed rows be dropped.
+        while (first != i) {
+            tracker.on_row_packed(*first);
+            first = rows.erase_and_dispose(first, del);
+        }
+        i = first;
+        i->set_continuous(false);
+        tracker.on_columnar_run_packed(_packed[pos].external_memory_usage());
+        ++packed;
+    } while (!need_preempt());
+    return packed;
+}
+
+void cache_entry::unpack(cache_tracker& tracker, const query::clustering_row_ranges& ranges) {
+    if (_packed.empty()) {
+        return;
+    }
+    const schema& s = *schema();
+    bool can_unpack = _packed.front().schema_version() == s.version() && !_pe._snapshot && !_pe.version()->next();
+    position_in_partition::less_compare less(s);
+    for (auto& r : ranges) {
+        auto start = position_in_partition_view::for_range_start(r);
+        auto end = position_in_partition_view::for_range_end(r);
+        auto first = std::partition_point(_packed.begin(), _packed.end(), [&] (const columnar_rows& run) {
+            return !less(start, position_in_partition_view::for_key(run.last_key()));
+        });
+        // Unpack one run at a time, and drop the rest once we should yield.
+        while (can_unpack && first != _packed.end() && less(position_in_partition_view::for_key(first->first_key()), end)) {
+            unpack_run(tracker, *first);
+            tracker.on_columnar_run_unpacked(first->external_memory_usage());
+            first = _packed.erase(first);
+            can_unpack = !need_preempt();
+        }
+        auto last = std::partition_point(first, _packed.end(), [&] (const columnar_rows& run) {
+            return less(position_in_partition_view::for_key(run.first_key()), end);
+        });
+        drop_packed(tracker, first, last);
+    }
+}
+
+void cache_entry::unpack_run(cache_tracker& tracker, const columnar_rows& run) {
+    const schema& s = *schema();
+    auto& rows = _pe.version()->partition().mutable_clustered_rows();
+    auto next = rows.upper_bound(position_in_partition_view::for_key(run.last_key()), rows_entry::tri_compare(s));
+    // Keep the rows brought back by an earlier attempt which failed to allocate.
+    // Nothing else can be in the range of the run.
+    position_in_partition::less_compare less(s);
+    std::optional<position_in_partition> resume_after;
+    if (next != rows.begin() && !less(std::prev(next)->position(), position_in_partition_view::for_key(run.first_key()))) {
+        resume_after = std::prev(next)->position();
+    }
+    bool first = true;
+    run.for_each_row(s, [&] (clustering_key&& key, deletable_row&& row) {
+        // The range before the first row may be missing other runs or evicted rows.
+        bool continuous = !std::exchange(first, false);
+        if (resume_after && !less(*resume_after, position_in_partition_view::for_key(key))) {
+            return;
+        }
+        auto e = alloc_strategy_unique_ptr<rows_entry>(current_allocator().construct<rows_entry>(key, std::move(row)));
+        e->set_continuous(continuous);
+        auto& entry = *e;
+        rows.insert_before(next, std::move(e));
+        tracker.on_row_unpacked(entry);
+    });
+}
+
+void cache_entry::drop_packed(cache_tracker& tracker, managed_vector<columnar_rows>::iterator first,
+        managed_vector<columnar_rows>::iterator last) noexcept {
+    for (auto i = first; i != last; ++i) {
+        tracker.on_columnar_run_dropped(i->external_memory_usage());
+    }
+    auto new_end = std::move(last, _packed.end(), first);
+    while (_packed.end() != new_end) {
+        _packed.pop_back();
+    }
+}
+
+void cache_entry::drop_packed(cache_tracker& tracker) noexcept {
+    drop_packed(tracker, _packed.begin(), _packed.end());
+    _packed.clear_and_release();
+}
+
 void row_cache::set_schema(schema_ptr new_schema) noexcept {
     _schema = std::move(new_schema);
 }
@@ -1381,8 +1749,9 @@ flat_mutation_reader_v2 cache_entry::read(row_cache& rc, std::unique_ptr<read_co
 
 // Assumes reader is in the corresponding partition
 flat_mutation_reader_v2 cache_entry::do_read(row_cache& rc, read_context& reader) {
-    auto snp = _pe.read(rc._tracker.region(), rc._tracker.cleaner(), &rc._tracker, reader.phase());
     auto ckr = query::clustering_key_filter_ranges::get_native_ranges(*schema(), reader.native_slice(), _key.key());
+    unpack(rc._tracker, ckr.ranges());
+    auto snp = _pe.read(rc._tracker.region(), rc._tracker.cleaner(), &rc._tracker, reader.phase());
     schema_ptr entry_schema = to_query_domain(reader.slice(), schema());
     auto r = make_cache_flat_mutation_reader(entry_schema, _key, std::move(ckr), rc, reader, std::move(snp));
     r.upgrade_schema(to_query_domain(reader.slice(), rc.schema()));
@@ -1391,8 +1760,9 @@ flat_mutation_reader_v2 cache_entry::do_read(row_cache& rc, read_context& reader
 }
 
 flat_mutation_reader_v2 cache_entry::do_read(row_cache& rc, std::unique_ptr<read_context> unique_ctx) {
-    auto snp = _pe.read(rc._tracker.region(), rc._tracker.cleaner(), &rc._tracker, unique_ctx->phase());
     auto ckr = query::clustering_key_filter_ranges::get_native_ranges(*schema(), unique_ctx->native_slice(), _key.key());
+    unpack(rc._tracker, ckr.ranges());
+    auto snp = _pe.read(rc._tracker.region(), rc._tracker.cleaner(), &rc._tracker, unique_ctx->phase());
     schema_ptr reader_schema = unique_ctx->schema();
     schema_ptr entry_schema = to_query_domain(unique_ctx->slice(), schema());
     auto rc_schema = to_query_domain(unique_ctx->slice(), rc.schema());
@@ -1410,6 +1780,7 @@ void row_cache::upgrade_entry(cache_entry& e) {
     if (e.schema() != _schema && !e.partition().is_locked()) {
         auto& r = _tracker.region();
         assert(!r.reclaiming_enabled());
+        e.drop_packed(_tracker);
         e.partition().upgrade(r, _schema, _tracker.cleaner(), &_tracker);
     }
 }
@@ -19,6 +19,8 @@
 #include "utils/phased_barrier.hh"
 #include "utils/histogram.hh"
 #include "mutation/partition_version.hh"
+#include "mutation/columnar_rows.hh"
+#include "utils/managed_vector.hh"
 #include <seastar/core/metrics_registration.hh>
 #include "mutation/mutation_cleaner.hh"
 #include "utils/double-decker.hh"
@@ -53,6 +55,10 @@ class lsa_manager;
 class cache_entry {
     dht::decorated_key _key;
     partition_entry _pe;
+    // Runs of clustering rows of a cold partition in a compact form, sorted by key.
+    // The rows of each run were removed from _pe, and the entry following them was
+    // marked discontinuous. Reads bring the rows back with unpack() before using _pe.
+    managed_vector<columnar_rows> _packed;
     // True when we know that there is nothing between this entry and the previous one in cache
     struct {
         bool _continuous : 1;
@@ -116,6 +122,31 @@ class cache_entry {
     // The caller is still responsible for unlinking and destroying this entry.
     void evict(cache_tracker&) noexcept;
 
+    bool is_packed() const noexcept { return !_packed.empty(); }
+    // Replaces runs of clustering rows with columnar_rows, if the partition has at least
+    // min_rows of them (or was packed already) and has a single version which is not
+    // being read. Packs one run at a time, until need_preempt() or until there is nothing
+    // left to pack. Returns the number of runs packed.
+    // Must be called with the cache region's allocator, with reclaim disabled.
+    size_t pack(cache_tracker&, uint32_t min_rows);
+    // Moves the packed rows which overlap with ranges back into the partition.
+    // Runs which can't be used, because the partition changed since they were packed,
+    // or which are left after need_preempt(), are dropped instead.
+    // Must be called with the cache region's allocator, with reclaim disabled.
+    // Can be retried after it throws.
+    void unpack(cache_tracker&, const query::clustering_row_ranges& ranges);
+    // Forgets the packed rows, which leaves the partition as if they were evicted.
+    void drop_packed(cache_tracker&) noexcept;
+private:
+    void unpack_run(cache_tracker&, const columnar_rows&);
+    void drop_packed(cache_tracker&, managed_vector<columnar_rows>::iterator first,
+            managed_vector<columnar_rows>::iterator last) noexcept;
+public:
+
+    // Identifies a partition of a table in cache_tracker's frequency sketch.
+    static uint64_t admission_hash(const ::schema&, const dht::decorated_key&) noexcept;
+    uint64_t admission_hash() const noexcept { return admission_hash(*schema(), _key); }
+
     const dht::decorated_key& key() const noexcept { return _key; }
     dht::ring_position_view position() const noexcept {
         if (is_dummy_entry()) {
@@ -256,8 +287,11 @@ class row_cache final {
     logalloc::allocating_section _read_section;
     flat_mutation_reader_v2 create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader_v2 make_scanning_reader(const dht::partition_range&, std::unique_ptr<cache::read_context>);
-    void on_partition_hit();
-    void on_partition_miss();
+    void on_partition_hit(const dht::decorated_key&);
+    void on_partition_miss(const dht::decorated_key&);
+    // Decides whether a partition missing in cache should be inserted, according to
+    // the admission policy of the table (see caching_options).
+    bool admit(const dht::decorated_key&) noexcept;
     void on_row_hit();
     void on_row_miss();
     void on_static_row_insert();
@@ -456,6 +490,18 @@ class row_cache final {
     // If it did, use invalidate() instead.
     void evict();
 
+    struct hot_partition {
+        dht::decorated_key key;
+        // See cache_tracker::estimate_frequency().
+        unsigned frequency;
+    };
+    // Returns up to max_partitions (all, if 0) of the partitions present in cache,
+    // the most frequently read ones first.
+    //
+    // Doesn't synchronize with updates, partitions inserted or removed concurrently
+    // may or may not be included.
+    future<std::vector<hot_partition>> get_hot_partitions(size_t max_partitions);
+
     const cache_tracker& get_cache_tracker() const {
         return _tracker;
     }
@@ -12,12 +12,20 @@
 #include "exceptions/exceptions.hh"
 #include "utils/rjson.hh"
 
-caching_options::caching_options(sstring k, sstring r, bool enabled)
-        : _key_cache(k), _row_cache(r), _enabled(enabled) {
+caching_options::caching_options(sstring k, sstring r, bool enabled, sstring admission, sstring index)
+        : _key_cache(k), _row_cache(r), _enabled(enabled), _admission(admission), _index(index) {
     if ((k != "ALL") && (k != "NONE")) {
         throw exceptions::configuration_exception("Invalid key value: " + k); 
     }
 
+    if ((admission != "ALL") && (admission != "FREQUENT")) {
+        throw exceptions::configuration_exception("Invalid admission value: " + admission);
+    }
+
+    if ((index != "EVICTABLE") && (index != "PINNED")) {
+        throw exceptions::configuration_exception("Invalid index value: " + index);
+    }
+
     if ((r == "ALL") || (r == "NONE")) {
         return;
     } else {
@@ -40,6 +48,12 @@ caching_options::to_map() const {
     if (!_enabled) {
         res.insert({"enabled", "false"});
     }
+    if (_admission != default_admission) {
+        res.insert({"admission", _admission});
+    }
+    if (_index != default_index) {
+        res.insert({"index", _index});
+    }
     return res;
 }
 
@@ -58,6 +72,8 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
     sstring k = default_key;
     sstring r = default_row;
     bool e = true;
+    sstring a = default_admission;
+    sstring i = default_index;
 
     for (auto& p : map) {
         if (p.first == "keys") {
@@ -66,11 +82,15 @@ caching_options::from_map(const std::map<sstring, sstring>& map) {
             r = p.second;
         } else if (p.first == "enabled") {
             e = p.second == "true";
+        } else if (p.first == "admission") {
+            a = p.second;
+        } else if (p.first == "index") {
+            i = p.second;
         } else {
             throw exceptions::configuration_exception(format("Invalid caching option: {}", p.first));
         }
     }
-    return caching_options(k, r, e);
+    return caching_options(k, r, e, a, i);
 }
 
 caching_options
@@ -21,11 +21,23 @@ class caching_options {
     // this (and maybe we shouldn't)
     static constexpr auto default_key = "ALL";
     static constexpr auto default_row = "ALL";
+    // Which partitions missing in cache are inserted into it when read:
+    //  - "ALL": every one,
+    //  - "FREQUENT": only those accessed more often than the ones they would evict
+    //    (TinyLFU), so that scans don't push the working set out of cache.
+    static constexpr auto default_admission = "ALL";
+    // How the sstable index pages of the table are cached:
+    //  - "EVICTABLE": along with other index pages and the row cache, see index_cache_fraction,
+    //  - "PINNED": unused pages are not evicted, as long as the pinned pages of all tables
+    //    fit in index_cache_pinned_fraction of cache memory.
+    static constexpr auto default_index = "EVICTABLE";
 
     sstring _key_cache;
     sstring _row_cache;
     bool _enabled = true;
-    caching_options(sstring k, sstring r, bool enabled);
+    sstring _admission = default_admission;
+    sstring _index = default_index;
+    caching_options(sstring k, sstring r, bool enabled, sstring admission = default_admission, sstring index = default_index);
 
     friend class schema;
     caching_options();
@@ -34,6 +46,14 @@ class caching_options {
         return _enabled;
     }
 
+    bool frequency_based_admission() const {
+        return _admission == "FREQUENT";
+    }
+
+    bool index_pinned() const {
+        return _index == "PINNED";
+    }
+
     std::map<sstring, sstring> to_map() const;
 
     sstring to_sstring() const;
@@ -35,6 +35,7 @@
 #include "utils/rjson.hh"
 #include "tombstone_gc_options.hh"
 #include "db/per_partition_rate_limit_extension.hh"
+#include "db/sstable_filter_extension.hh"
 #include "db/tags/utils.hh"
 #include "db/tags/extension.hh"
 
@@ -1372,6 +1373,12 @@ schema_ptr schema_builder::build() {
             dynamic_pointer_cast<db::per_partition_rate_limit_extension>(it->second)->get_options();
     }
 
+    // cache the `sstable_filter` parameters for fast access through the schema object.
+    if (auto it = new_raw._extensions.find(db::sstable_filter_extension::NAME); it != new_raw._extensions.end()) {
+        new_raw._sstable_filter_options =
+            dynamic_pointer_cast<db::sstable_filter_extension>(it->second)->get_options();
+    }
+
     if (static_props.use_null_sharder) {
         new_raw._sharder = get_sharder(1, 0);
     }
@@ -1424,6 +1431,11 @@ schema_builder& schema_builder::with_per_partition_rate_limit_options(const db::
     return *this;
 }
 
+schema_builder& schema_builder::with_sstable_filter_options(const db::sstable_filter_options& opts) {
+    add_extension(db::sstable_filter_extension::NAME, ::make_shared<db::sstable_filter_extension>(opts));
+    return *this;
+}
+
 schema_builder& schema_builder::set_paxos_grace_seconds(int32_t seconds) {
     add_extension(db::paxos_grace_seconds_extension::NAME, ::make_shared<db::paxos_grace_seconds_extension>(seconds));
     return *this;
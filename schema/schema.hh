@@ -30,6 +30,7 @@
 #include "timestamp.hh"
 #include "tombstone_gc_options.hh"
 #include "db/per_partition_rate_limit_options.hh"
+#include "db/sstable_filter_options.hh"
 #include "schema_fwd.hh"
 #include "data_dictionary/keyspace_element.hh"
 
@@ -607,6 +608,7 @@ class schema final : public enable_lw_shared_from_this<schema>, public data_dict
         double _read_repair_chance = 0.0;
         double _crc_check_chance = 1;
         db::per_partition_rate_limit_options _per_partition_rate_limit_options;
+        db::sstable_filter_options _sstable_filter_options;
         int32_t _min_compaction_threshold = DEFAULT_MIN_COMPACTION_THRESHOLD;
         int32_t _max_compaction_threshold = DEFAULT_MAX_COMPACTION_THRESHOLD;
         int32_t _min_index_interval = DEFAULT_MIN_INDEX_INTERVAL;
@@ -804,6 +806,10 @@ class schema final : public enable_lw_shared_from_this<schema>, public data_dict
         return _raw._per_partition_rate_limit_options;
     }
 
+    const db::sstable_filter_options& sstable_filter_options() const {
+        return _raw._sstable_filter_options;
+    }
+
     const ::speculative_retry& speculative_retry() const {
         return _raw._speculative_retry;
     }
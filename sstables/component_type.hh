@@ -26,6 +26,8 @@ enum class component_type {
     TemporaryTOC,
     TemporaryStatistics,
     Scylla,
+    Partitions,
+    RemoteData,
     Unknown,
 };
 
@@ -63,6 +65,10 @@ struct fmt::formatter<sstables::component_type> : fmt::formatter<std::string_vie
             return formatter<std::string_view>::format("TemporaryStatistics", ctx);
         case Scylla:
             return formatter<std::string_view>::format("Scylla", ctx);
+        case Partitions:
+            return formatter<std::string_view>::format("Partitions", ctx);
+        case RemoteData:
+            return formatter<std::string_view>::format("RemoteData", ctx);
         case Unknown:
             return formatter<std::string_view>::format("Unknown", ctx);
         }
@@ -8,12 +8,14 @@
 
 #include <stdexcept>
 #include <cstdlib>
+#include <deque>
 
 #include <boost/range/algorithm/find_if.hpp>
 #include <seastar/core/align.hh>
 #include <seastar/core/bitops.hh>
 #include <seastar/core/byteorder.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/loop.hh>
 
 #include "../compress.hh"
 #include "compress.hh"
@@ -22,6 +24,8 @@
 #include "segmented_compress_params.hh"
 #include "utils/class_registrator.hh"
 #include "reader_permit.hh"
+#include "reader_concurrency_semaphore.hh"
+#include "stats.hh"
 
 namespace sstables {
 
@@ -333,9 +337,27 @@ compression::locate(uint64_t position, const compression::segmented_offsets::acc
 
 }
 
+// compressed_file_data_source_impl reads and uncompresses the chunks of a
+// compressed file.
+//
+// To keep sequential reads from being bound by the latency of uncompressing
+// a chunk at a time, chunks are read and uncompressed ahead of the consumer:
+// up to `read_ahead` of them (as passed in file_input_stream_options), in
+// addition to the one the consumer waits for. Every chunk in flight holds
+// the reader permit's memory for its uncompressed data, and chunks are only
+// read ahead when the semaphore has memory to spare. The read-ahead window
+// starts empty and grows with every chunk the consumer reads sequentially,
+// so that short reads don't uncompress chunks they won't use. The underlying
+// file_input_stream reads at most one buffer ahead of the chunks.
 template <typename ChecksumType>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_source_impl : public data_source_impl {
+    // A chunk being read and uncompressed, starting at uncompressed position pos.
+    struct chunk {
+        uint64_t pos;
+        future<temporary_buffer<char>> data;
+    };
+
     std::optional<input_stream<char>> _input_stream;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::accessor _offsets;
@@ -343,8 +365,17 @@ class compressed_file_data_source_impl : public data_source_impl {
     reader_permit _permit;
     uint64_t _underlying_pos;
     uint64_t _pos;
-    uint64_t _beg_pos;
     uint64_t _end_pos;
+    // Position of the next chunk to read from _input_stream.
+    uint64_t _fetch_pos;
+    // Chunks in flight, in file order. The first one holds _pos.
+    std::deque<chunk> _chunks;
+    // Resolves when the last chunk in flight was read from _input_stream,
+    // which only supports one read at a time.
+    future<> _last_read = make_ready_future<>();
+    unsigned _max_read_ahead;
+    unsigned _read_ahead = 0;
+    sstables::sstables_stats _stats;
 public:
     compressed_file_data_source_impl(file f, sstables::compression* cm,
                 uint64_t pos, size_t len, file_input_stream_options options, reader_permit permit)
@@ -352,14 +383,14 @@ class compressed_file_data_source_impl : public data_source_impl {
             , _offsets(_compression_metadata->offsets.get_accessor())
             , _compression(*cm)
             , _permit(std::move(permit))
+            , _max_read_ahead(options.read_ahead)
     {
-        _beg_pos = pos;
         if (pos > _compression_metadata->uncompressed_file_length()) {
             throw std::runtime_error("attempt to uncompress beyond end");
         }
         if (len == 0 || pos == _compression_metadata->uncompressed_file_length()) {
             // Nothing to read
-            _end_pos = _pos = _beg_pos;
+            _end_pos = _pos = _fetch_pos = pos;
             return;
         }
         if (len <= _compression_metadata->uncompressed_file_length() - pos) {
@@ -367,35 +398,146 @@ class compressed_file_data_source_impl : public data_source_impl {
         } else {
             _end_pos = _compression_metadata->uncompressed_file_length();
         }
-        // _beg_pos and _end_pos specify positions in the compressed stream.
-        // We need to translate them into a range of uncompressed chunks,
+        // pos and _end_pos specify positions in the uncompressed stream.
+        // We need to translate them into a range of compressed chunks,
         // and open a file_input_stream to read that range.
-        auto start = _compression_metadata->locate(_beg_pos, _offsets);
+        auto start = _compression_metadata->locate(pos, _offsets);
         auto end = _compression_metadata->locate(_end_pos - 1, _offsets);
+        // The chunks read ahead already keep reads queued on _input_stream, so
+        // it only needs one buffer of its own ahead of them to keep the disk
+        // busy, rather than doubling the read-ahead window.
+        options.read_ahead = std::min(options.read_ahead, 1u);
         _input_stream = make_file_input_stream(std::move(f),
                 start.chunk_start,
                 end.chunk_start + end.chunk_len - start.chunk_start,
                 std::move(options));
         _underlying_pos = start.chunk_start;
-        _pos = _beg_pos;
+        _pos = _fetch_pos = pos;
+    }
+
+    ~compressed_file_data_source_impl() {
+        _stats.on_decompression_chunks_done(_chunks.size());
     }
+
     virtual future<temporary_buffer<char>> get() override {
         if (_pos >= _end_pos) {
             return make_ready_future<temporary_buffer<char>>();
         }
-        auto addr = _compression_metadata->locate(_pos, _offsets);
-        // Uncompress the next chunk. We need to skip part of the first
-        // chunk, but then continue to read from beginning of chunks.
-        if (_pos != _beg_pos && addr.offset != 0) {
-            throw std::runtime_error("compressed reader out of sync");
+        read_ahead();
+        auto c = pop_chunk();
+        if (_pos < c.pos) {
+            return make_exception_future<temporary_buffer<char>>(std::runtime_error("compressed reader out of sync"));
+        }
+        if (!c.data.available()) {
+            _stats.on_decompression_read_ahead_stall();
+        }
+        return std::move(c.data).then([this, skip = _pos - c.pos] (temporary_buffer<char> out) {
+            out.trim_front(std::min<uint64_t>(skip, out.size()));
+            _pos += out.size();
+            _read_ahead = std::min(_read_ahead + 1, _max_read_ahead);
+            return out;
+        });
+    }
+
+    virtual future<> close() override {
+        // The chunks in flight refer to this object and to _input_stream.
+        return drop_chunks(std::numeric_limits<uint64_t>::max()).then([this] {
+            return std::exchange(_last_read, make_ready_future<>()).handle_exception([] (std::exception_ptr) {});
+        }).then([this] {
+            if (!_input_stream) {
+                return make_ready_future<>();
+            }
+            return _input_stream->close();
+        });
+    }
+
+    virtual future<temporary_buffer<char>> skip(uint64_t n) override {
+        _pos += n;
+        assert(_pos <= _end_pos);
+        if (_pos == _end_pos) {
+            return make_ready_future<temporary_buffer<char>>();
         }
+        _read_ahead /= 2;
+        // Chunks which were read ahead and are still needed are kept.
+        return drop_chunks(_pos).then([this] {
+            if (!_chunks.empty()) {
+                return make_ready_future<temporary_buffer<char>>();
+            }
+            return std::exchange(_last_read, make_ready_future<>()).then([this] {
+                auto addr = _compression_metadata->locate(_pos, _offsets);
+                auto underlying_n = addr.chunk_start - _underlying_pos;
+                _underlying_pos = addr.chunk_start;
+                _fetch_pos = _pos;
+                return _input_stream->skip(underlying_n);
+            }).then([] {
+                return make_ready_future<temporary_buffer<char>>();
+            });
+        });
+    }
+private:
+    chunk pop_chunk() noexcept {
+        auto c = std::move(_chunks.front());
+        _chunks.pop_front();
+        _stats.on_decompression_chunks_done(1);
+        return c;
+    }
+
+    // Waits for, and discards, the chunks in flight which end at or before pos.
+    future<> drop_chunks(uint64_t pos) {
+        return do_until([this, pos] {
+            return _chunks.empty() || _chunks.front().pos + _compression_metadata->uncompressed_chunk_length() > pos;
+        }, [this] {
+            // Errors in chunks the consumer doesn't need anymore are not its concern.
+            return pop_chunk().data.discard_result().handle_exception([] (std::exception_ptr) {});
+        });
+    }
+
+    bool has_memory_for_read_ahead() {
+        auto& sem = _permit.semaphore();
+        return sem.available_resources().memory >= ssize_t(_compression_metadata->uncompressed_chunk_length());
+    }
+
+    void read_ahead() {
+        if (_chunks.empty() && _fetch_pos < _end_pos) {
+            push_chunk();
+        }
+        while (_chunks.size() <= _read_ahead && _fetch_pos < _end_pos && has_memory_for_read_ahead()) {
+            push_chunk();
+            _stats.on_decompression_read_ahead();
+        }
+    }
+
+    void push_chunk() {
+        auto addr = _compression_metadata->locate(_fetch_pos, _offsets);
+        auto pos = _fetch_pos - addr.offset;
+        _fetch_pos = pos + _compression_metadata->uncompressed_chunk_length();
+        _chunks.push_back(chunk{pos, read_chunk(addr)});
+        _stats.on_decompression_chunk_start();
+    }
+
+    future<temporary_buffer<char>> read_chunk(sstables::compression::chunk_and_offset addr) {
         if (!addr.chunk_len) {
-            throw sstables::malformed_sstable_exception(format("compressed chunk_len must be greater than zero, chunk_start={}", addr.chunk_start));
+            return make_exception_future<temporary_buffer<char>>(sstables::malformed_sstable_exception(
+                    format("compressed chunk_len must be greater than zero, chunk_start={}", addr.chunk_start)));
         }
-        return _input_stream->read_exactly(addr.chunk_len).then([this, addr](temporary_buffer<char> buf) {
+        promise<> read_done;
+        auto prev = std::exchange(_last_read, read_done.get_future());
+        return prev.then([this, addr] {
+            return _input_stream->read_exactly(addr.chunk_len);
+        }).then_wrapped([read_done = std::move(read_done)] (future<temporary_buffer<char>> f) mutable {
+            // A failed read fails the reads queued after it too.
+            if (f.failed()) {
+                auto ex = f.get_exception();
+                read_done.set_exception(ex);
+                return make_exception_future<temporary_buffer<char>>(std::move(ex));
+            }
+            read_done.set_value();
+            return f;
+        }).then([this, addr] (temporary_buffer<char> buf) {
             if (buf.size() != addr.chunk_len) {
-                throw sstables::malformed_sstable_exception(format("compressed reader hit premature end-of-file at file offset {}, expected chunk_len={}, actual={}", _underlying_pos, addr.chunk_len, buf.size()));
+                throw sstables::malformed_sstable_exception(format("compressed reader hit premature end-of-file at file offset {}, expected chunk_len={}, actual={}", addr.chunk_start, addr.chunk_len, buf.size()));
             }
+            _underlying_pos = addr.chunk_start + addr.chunk_len;
             return _permit.request_memory(_compression_metadata->uncompressed_chunk_length()).then(
                     [this, addr, buf = std::move(buf)] (reader_permit::resource_units res_units) mutable {
                 // The last 4 bytes of the chunk are the adler32/crc32 checksum
@@ -406,7 +548,7 @@ class compressed_file_data_source_impl : public data_source_impl {
                 auto expected_checksum = read_be<uint32_t>(buf.get() + compressed_len);
                 auto actual_checksum = ChecksumType::checksum(buf.get(), compressed_len);
                 if (expected_checksum != actual_checksum) {
-                    throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} failed checksum, expected={}, actual={}", addr.chunk_len, _underlying_pos, expected_checksum, actual_checksum));
+                    throw sstables::malformed_sstable_exception(format("compressed chunk of size {} at file offset {} failed checksum, expected={}, actual={}", addr.chunk_len, addr.chunk_start, expected_checksum, actual_checksum));
                 }
 
                 // We know that the uncompressed data will take exactly
@@ -419,36 +561,11 @@ class compressed_file_data_source_impl : public data_source_impl {
                 auto len = _compression.uncompress(buf.get(), compressed_len, out.get_write(), out.size());
 
                 out.trim(len);
-                out.trim_front(addr.offset);
-                _pos += out.size();
-                _underlying_pos += addr.chunk_len;
 
                 return make_tracked_temporary_buffer(std::move(out), std::move(res_units));
             });
         });
     }
-
-    virtual future<> close() override {
-        if (!_input_stream) {
-            return make_ready_future<>();
-        }
-        return _input_stream->close();
-    }
-
-    virtual future<temporary_buffer<char>> skip(uint64_t n) override {
-        _pos += n;
-        assert(_pos <= _end_pos);
-        if (_pos == _end_pos) {
-            return make_ready_future<temporary_buffer<char>>();
-        }
-        auto addr = _compression_metadata->locate(_pos, _offsets);
-        auto underlying_n = addr.chunk_start - _underlying_pos;
-        _underlying_pos = addr.chunk_start;
-        _beg_pos = _pos;
-        return _input_stream->skip(underlying_n).then([] {
-            return make_ready_future<temporary_buffer<char>>();
-        });
-    }
 };
 
 template <typename ChecksumType>
@@ -492,17 +609,44 @@ class compressed_file_data_sink_impl : public data_sink_impl {
     sstables::local_compression _compression;
     size_t _pos = 0;
     uint32_t _full_checksum;
+    // The compressor configured for the table, to train a dictionary with.
+    compressor_ptr _template;
+    table_id _table;
+    // Chunks to train a dictionary on, shared with the written data.
+    std::vector<temporary_buffer<char>> _samples;
+    size_t _sampled = 0;
+    size_t _dictionary_sample_size;
 public:
-    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
+    compressed_file_data_sink_impl(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc,
+            compressor_ptr tmpl, table_id table)
             : _out(std::move(out))
             , _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_writer())
             , _compression(lc)
             , _full_checksum(ChecksumType::init_checksum())
+            , _template(std::move(tmpl))
+            , _table(table)
+            , _dictionary_sample_size(_template ? _template->dictionary_sample_size(_table) : 0)
     {}
 
     virtual future<> put(net::packet data) override { abort(); }
     virtual future<> put(temporary_buffer<char> buf) override {
+        if (_dictionary_sample_size) {
+            _sampled += buf.size();
+            _samples.push_back(buf.share());
+            if (_sampled >= _dictionary_sample_size) {
+                submit_samples();
+            }
+        }
+        return compress_and_write(std::move(buf));
+    }
+private:
+    void submit_samples() {
+        _dictionary_sample_size = 0;
+        _template->train_dictionary(_table, std::exchange(_samples, {}));
+    }
+
+    future<> compress_and_write(temporary_buffer<char> buf) {
         auto output_len = _compression.compress_max_size(buf.size());
 
         // account space for checksum that goes after compressed data.
@@ -542,7 +686,12 @@ class compressed_file_data_sink_impl : public data_sink_impl {
         auto f = _out.write(compressed.get(), compressed.size());
         return f.then([compressed = std::move(compressed)] {});
     }
+public:
     virtual future<> close() override {
+        // Sstables smaller than the sample size are trained on all their data.
+        if (!_samples.empty()) {
+            submit_samples();
+        }
         return _out.close();
     }
 
@@ -555,20 +704,26 @@ template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 class compressed_file_data_sink : public data_sink {
 public:
-    compressed_file_data_sink(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc)
+    compressed_file_data_sink(output_stream<char> out, sstables::compression* cm, sstables::local_compression lc,
+            compressor_ptr tmpl, table_id table)
         : data_sink(std::make_unique<compressed_file_data_sink_impl<ChecksumType, mode>>(
-                std::move(out), cm, std::move(lc))) {}
+                std::move(out), cm, std::move(lc), std::move(tmpl), table)) {}
 };
 
 template <typename ChecksumType, compressed_checksum_mode mode>
 requires ChecksumUtils<ChecksumType>
 inline output_stream<char> make_compressed_file_output_stream(output_stream<char> out,
          sstables::compression* cm,
-         const compression_parameters& cp) {
+         const compression_parameters& cp,
+         table_id table) {
     // buffer of output stream is set to chunk length, because flush must
     // happen every time a chunk was filled up.
 
-    auto p = cp.get_compressor();
+    auto tmpl = cp.get_compressor();
+    auto p = tmpl ? tmpl->dictionary_compressor(table) : nullptr;
+    if (!p) {
+        p = tmpl;
+    }
     cm->set_compressor(p);
     cm->set_uncompressed_chunk_length(cp.chunk_length());
     // FIXME: crc_check_chance can be configured by the user.
@@ -576,7 +731,7 @@ inline output_stream<char> make_compressed_file_output_stream(output_stream<char
     // defaults to 1.0.
     cm->options.elements.push_back({{"crc_check_chance"}, {"1.0"}});
 
-    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(out), cm, p));
+    return output_stream<char>(compressed_file_data_sink<ChecksumType, mode>(std::move(out), cm, p, std::move(tmpl), table));
 }
 
 input_stream<char> sstables::make_compressed_file_k_l_format_input_stream(file f,
@@ -594,8 +749,9 @@ input_stream<char> sstables::make_compressed_file_m_format_input_stream(file f,
 
 output_stream<char> sstables::make_compressed_file_m_format_output_stream(output_stream<char> out,
         sstables::compression* cm,
-        const compression_parameters& cp) {
+        const compression_parameters& cp,
+        table_id table) {
     return make_compressed_file_output_stream<crc32_utils, compressed_checksum_mode::checksum_all>(
-            std::move(out), cm, cp);
+            std::move(out), cm, cp, table);
 }
 
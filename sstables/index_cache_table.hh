@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <seastar/core/shared_ptr.hh>
+
+#include "schema/schema_fwd.hh"
+#include "utils/cached_file_stats.hh"
+#include "sstables/partition_index_cache_stats.hh"
+
+class cache_tracker;
+
+namespace sstables {
+
+// The part of the sstable index caches which belongs to a single table.
+//
+// Shared by the index caches of all sstables of the table on a shard, which
+// account their operations here as well as in the global statistics of the
+// cache_tracker. Obtained with cache_tracker::get_index_cache_table().
+class index_cache_table : public seastar::enable_lw_shared_from_this<index_cache_table> {
+    cache_tracker& _tracker;
+    table_id _id;
+    bool _pinned = false;
+public:
+    cached_file_stats file_stats;
+    partition_index_cache_stats partition_index_stats;
+
+    index_cache_table(cache_tracker& tracker, table_id id) noexcept
+        : _tracker(tracker)
+        , _id(id)
+    { }
+    ~index_cache_table();
+
+    index_cache_table(const index_cache_table&) = delete;
+
+    table_id id() const noexcept { return _id; }
+
+    // When set, unused index pages of the table are pinned in memory (see index_evictable).
+    // Affects pages which become unused later.
+    bool pinned() const noexcept { return _pinned; }
+    void set_pinned(bool pinned) noexcept { _pinned = pinned; }
+};
+
+}
@@ -18,6 +18,7 @@
 #include "sstables/scanning_clustered_index_cursor.hh"
 #include "sstables/mx/bsearch_clustered_cursor.hh"
 #include "sstables/sstables_manager.hh"
+#include "comparable_bytes.hh"
 
 namespace sstables {
 
@@ -401,6 +402,9 @@ struct index_bound {
     uint64_t data_file_position = 0;
     indexable_element element = indexable_element::partition;
     std::optional<open_rt_marker> end_open_marker;
+    // Engaged when current_list holds only the entries of a single token, loaded
+    // through the partition trie index, rather than a whole summary page.
+    std::optional<trie::partition_payload> trie_page;
 
     // Holds the cursor for the current partition. Lazily initialized.
     std::unique_ptr<clustered_index_cursor> clustered_cursor;
@@ -417,6 +421,7 @@ struct index_bound {
             , data_file_position(other.data_file_position)
             , element(other.element)
             , end_open_marker(other.end_open_marker)
+            , trie_page(other.trie_page)
     { }
 
     index_bound(index_bound&&) noexcept = default;
@@ -442,10 +447,13 @@ class index_reader {
     logalloc::region& _region;
     use_caching _use_caching;
     bool _single_page_read;
+    // Holds pages loaded through the partition trie index when caching is disabled.
+    // Lazily initialized.
+    std::unique_ptr<partition_index_cache> _local_trie_page_cache;
 
-    std::unique_ptr<index_consume_entry_context<index_consumer>> make_context(uint64_t begin, uint64_t end, index_consumer& consumer) {
+    std::unique_ptr<index_consume_entry_context<index_consumer>> make_context(uint64_t begin, uint64_t end, index_consumer& consumer, bool bounded_read) {
         auto index_file = make_tracked_index_file(*_sstable, _permit, _trace_state, _use_caching);
-        auto input = make_file_input_stream(index_file, begin, (_single_page_read ? end : _sstable->index_size()) - begin,
+        auto input = make_file_input_stream(index_file, begin, (bounded_read ? end : _sstable->index_size()) - begin,
                         get_file_input_stream_options());
         auto trust_pi = trust_promoted_index(_sstable->has_correct_promoted_index_entries());
         auto ck_values_fixed_lengths = _sstable->get_version() >= sstable_version_types::mc
@@ -458,7 +466,7 @@ class index_reader {
     future<> advance_context(index_bound& bound, uint64_t begin, uint64_t end, int quantity) {
         if (!bound.context) {
             bound.consumer = std::make_unique<index_consumer>(_region, _sstable->get_schema());
-            bound.context = make_context(begin, end, *bound.consumer);
+            bound.context = make_context(begin, end, *bound.consumer, _single_page_read);
             bound.consumer->prepare(quantity);
             return make_ready_future<>();
         }
@@ -498,7 +506,7 @@ class index_reader {
     future<> advance_to_page(index_bound& bound, uint64_t summary_idx) {
         sstlog.trace("index {}: advance_to_page({}), bound {}", fmt::ptr(this), summary_idx, fmt::ptr(&bound));
         assert(!bound.current_list || bound.current_summary_idx <= summary_idx);
-        if (bound.current_list && bound.current_summary_idx == summary_idx) {
+        if (bound.current_list && bound.current_summary_idx == summary_idx && !bound.trie_page) {
             sstlog.trace("index {}: same page", fmt::ptr(this));
             return make_ready_future<>();
         }
@@ -547,6 +555,7 @@ class index_reader {
             bound.current_summary_idx = summary_idx;
             bound.current_index_idx = 0;
             bound.current_pi_idx = 0;
+            bound.trie_page.reset();
             if (bound.current_list->empty()) {
                 throw malformed_sstable_exception(format("missing index entry for summary index {} (bound {})", summary_idx, fmt::ptr(&bound)), _sstable->index_filename());
             }
@@ -622,6 +631,9 @@ class index_reader {
             bound.end_open_marker.reset();
             return reset_clustered_cursor(bound);
         }
+        if (bound.trie_page) {
+            return advance_past_trie_page(bound);
+        }
         auto& summary = _sstable->get_summary();
         if (bound.current_summary_idx + 1 < summary.header.size) {
             return advance_to_page(bound, bound.current_summary_idx + 1);
@@ -629,6 +641,126 @@ class index_reader {
         return advance_to_end(bound);
     }
 
+    // Returns the index of the summary page which covers the given position in the index file.
+    uint64_t summary_idx_for_index_position(uint64_t index_pos) const {
+        auto& entries = _sstable->get_summary().entries;
+        auto i = std::upper_bound(entries.begin(), entries.end(), index_pos, [] (uint64_t pos, const summary_entry& e) {
+            return pos < e.position;
+        });
+        return i == entries.begin() ? 0 : std::distance(entries.begin(), i) - 1;
+    }
+
+    partition_index_cache& trie_page_cache() {
+        if (_use_caching) {
+            return *_sstable->_trie_page_cache;
+        }
+        if (!_local_trie_page_cache) {
+            _local_trie_page_cache = std::make_unique<partition_index_cache>(_sstable->manager().get_cache_tracker().get_lru(),
+                                                                             _sstable->manager().get_cache_tracker().region(),
+                                                                             _sstable->manager().get_cache_tracker().get_partition_index_cache_stats());
+        }
+        return *_local_trie_page_cache;
+    }
+
+    trie::partition_trie_reader make_partition_trie_reader() {
+        auto f = make_tracked_file(_sstable->partitions_file(), _permit);
+        if (_trace_state) {
+            f = tracing::make_traced_file(std::move(f), _trace_state, format("{}:", _sstable->filename(component_type::Partitions)));
+        }
+        return trie::partition_trie_reader([f = std::move(f)] (uint64_t pos, size_t len) mutable {
+            return f.dma_read_bulk<char>(pos, len);
+        }, _sstable->partition_trie_footer(), _sstable->partitions_file_size());
+    }
+
+    // Moves the bound past the last entry of a page loaded by advance_lower_with_trie().
+    future<> advance_past_trie_page(index_bound& bound) {
+        auto data_end = bound.trie_page->data_end;
+        if (data_end == data_file_end()) {
+            return advance_to_end(bound);
+        }
+        if (&bound != &_lower_bound) {
+            // The upper bound only needs to delimit the data file range, don't bother
+            // loading the summary page of the next partition.
+            bound.data_file_position = data_end;
+            bound.element = indexable_element::partition;
+            bound.end_open_marker.reset();
+            bound.current_list = {};
+            bound.trie_page.reset();
+            return reset_clustered_cursor(bound);
+        }
+        auto summary_idx = summary_idx_for_index_position(bound.trie_page->index_offset + bound.trie_page->index_length);
+        bound.current_list = {};
+        bound.trie_page.reset();
+        bound.previous_summary_idx = summary_idx + 1;
+        return advance_to_page(bound, summary_idx).then([this, &bound, summary_idx, data_end] {
+            auto& entries = bound.current_list->_entries;
+            auto i = std::partition_point(entries.begin(), entries.end(), [data_end] (const managed_ref<index_entry>& e) {
+                return e->position() < data_end;
+            });
+            if (i == entries.end() || (*i)->position() != data_end) {
+                throw malformed_sstable_exception(format("partition trie points at data position {} which is missing from summary page {}",
+                        data_end, summary_idx), _sstable->index_filename());
+            }
+            bound.current_index_idx = std::distance(entries.begin(), i);
+            bound.data_file_position = data_end;
+            return make_ready_future<>();
+        });
+    }
+
+    // Positions the lower bound on the partition with the given key using the partition trie index.
+    // Loads only the index entries of the key's token. Returns false, leaving the lower bound
+    // untouched, if the sstable has no partition with the key.
+    //
+    // Precondition: the lower bound was not advanced yet.
+    future<bool> advance_lower_with_trie(dht::ring_position_view key) {
+        auto trie_reader = make_lw_shared<trie::partition_trie_reader>(make_partition_trie_reader());
+        return trie_reader->lookup(comparable_bytes::encode_token(key.token())).then(
+                [this, key, trie_reader] (std::optional<trie::lookup_result> res) {
+            if (!res || !res->prefix_match) {
+                sstlog.trace("index {}: token {} not in the partition trie", fmt::ptr(this), key.token());
+                return make_ready_future<bool>(false);
+            }
+            auto page = res->payload;
+            auto loader = [this, page] (uint64_t) -> future<index_list> {
+                auto consumer = std::make_unique<index_consumer>(_region, _sstable->get_schema());
+                auto context = make_context(page.index_offset, page.index_offset + page.index_length, *consumer, true);
+                consumer->prepare(1);
+                auto& ctx = *context;
+                return ctx.consume_input().finally([context = std::move(context)] () mutable {
+                    auto& ctx = *context;
+                    return ctx.close().finally([context = std::move(context)] {});
+                }).then([consumer = std::move(consumer)] {
+                    return std::move(consumer->indexes);
+                });
+            };
+            return trie_page_cache().get_or_load(page.index_offset, loader).then([this, key, page] (partition_index_cache::entry_ptr ref) {
+                auto i = _alloc_section(_region, [&] {
+                    auto& entries = ref->_entries;
+                    return std::lower_bound(entries.begin(), entries.end(), key, index_comparator(*_sstable->_schema));
+                });
+                // i is valid until next allocation point
+                auto& entries = ref->_entries;
+                if (i == entries.end() || index_comparator(*_sstable->_schema)(key, *i)) {
+                    return make_ready_future<bool>(false);
+                }
+                auto summary_idx = summary_idx_for_index_position(page.index_offset);
+                _lower_bound.current_index_idx = std::distance(entries.begin(), i);
+                _lower_bound.current_pi_idx = 0;
+                _lower_bound.data_file_position = (*i)->position();
+                _lower_bound.element = indexable_element::partition;
+                _lower_bound.end_open_marker.reset();
+                _lower_bound.current_list = std::move(ref);
+                _lower_bound.trie_page = page;
+                _lower_bound.current_summary_idx = summary_idx;
+                _lower_bound.previous_summary_idx = summary_idx + 1;
+                sstlog.trace("index {}: found through the partition trie, pos={}", fmt::ptr(this), _lower_bound.data_file_position);
+                return reset_clustered_cursor(_lower_bound).then([] {
+                    return true;
+                });
+            });
+        });
+    }
+
     future<> advance_to(index_bound& bound, dht::ring_position_view pos) {
         sstlog.trace("index {} bound {}: advance_to({}), _previous_summary_idx={}, _current_summary_idx={}",
             fmt::ptr(this), fmt::ptr(&bound), pos, bound.previous_summary_idx, bound.current_summary_idx);
@@ -932,6 +1064,17 @@ class index_reader {
     // If upper_bound is provided, the upper bound within position is looked up
     future<bool> advance_lower_and_check_if_present(
             dht::ring_position_view key, std::optional<position_in_partition_view> pos = {}) {
+        if (_sstable->has_partition_trie_index() && key.key() && !_upper_bound
+                && !_lower_bound.current_list && _lower_bound.current_summary_idx == 0 && !eof()) {
+            return advance_lower_with_trie(key).then([this, pos] (bool found) {
+                if (!found || !pos) {
+                    return make_ready_future<bool>(found);
+                }
+                return advance_upper_past(*pos).then([] {
+                    return make_ready_future<bool>(true);
+                });
+            });
+        }
         return advance_to(_lower_bound, key).then([this, key, pos] {
             if (eof()) {
                 return make_ready_future<bool>(false);
@@ -1100,6 +1243,11 @@ class index_reader {
         auto close_lb = close(_lower_bound);
         auto close_ub = _upper_bound ? close(*_upper_bound) : make_ready_future<>();
         return when_all(std::move(close_lb), std::move(close_ub)).discard_result().finally([this] {
+            if (_local_trie_page_cache) {
+                return _local_trie_page_cache->evict_gently();
+            }
+            return make_ready_future<>();
+        }).finally([this] {
             if (_local_index_cache) {
                 return _local_index_cache->evict_gently();
             }
@@ -408,6 +408,9 @@ class mp_row_consumer_k_l {
     // As explained above, the key object is only valid during this call, and
     // if the implementation wishes to save it, it must copy the *contents*.
     proceed consume_row_start(sstables::key_view key, sstables::deletion_time deltime) {
+        if (_reader->counts_reads()) {
+            _sst->get_stats().on_counted_row_read();
+        }
         if (!_is_mutation_end) {
             return proceed::yes;
         }
@@ -678,6 +681,9 @@ class mp_row_consumer_k_l {
 
     // Consume one row tombstone.
     proceed consume_shadowable_row_tombstone(bytes_view col_name, sstables::deletion_time deltime) {
+        if (_reader->counts_reads()) {
+            _sst->get_stats().on_counted_tombstone_read();
+        }
         auto key = composite_view(column::fix_static_name(*_schema, col_name)).explode();
         auto ck = clustering_key_prefix::from_exploded_view(key);
         auto ret = flush_if_needed(std::move(ck));
@@ -727,6 +733,9 @@ class mp_row_consumer_k_l {
     proceed consume_range_tombstone(
         bytes_view start_col, bytes_view end_col,
         sstables::deletion_time deltime) {
+        if (_reader->counts_reads()) {
+            _sst->get_stats().on_counted_tombstone_read();
+        }
         auto compound = _schema->is_compound() || _treat_non_compound_rt_as_compound;
         auto start = composite_view(column::fix_static_name(*_schema, start_col), compound).explode();
 
@@ -1167,7 +1176,9 @@ class sstable_mutation_reader : public mp_row_consumer_reader_k_l {
             , _slice(slice)
             , _fwd(fwd)
             , _fwd_mr(fwd_mr)
-            , _monitor(mon) { }
+            , _monitor(mon) {
+        _counts_reads = _monitor.counts_reads();
+    }
 
     // Reference to _consumer is passed to data_consume_rows() in the constructor so we must not allow move/copy
     sstable_mutation_reader(sstable_mutation_reader&&) = delete;
@@ -1516,6 +1527,7 @@ class crawling_sstable_mutation_reader : public mp_row_consumer_reader_k_l {
         , _consumer(this, _schema, std::move(permit), _schema->full_slice(), std::move(trace_state), streamed_mutation::forwarding::no, _sst)
         , _context(data_consume_rows<DataConsumeRowsContext>(*_schema, _sst, _consumer))
         , _monitor(mon) {
+        _counts_reads = _monitor.counts_reads();
         _monitor.on_read_started(_context->reader_position());
     }
 public:
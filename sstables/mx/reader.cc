@@ -320,6 +320,9 @@ class mp_row_consumer_m {
             [] (const fragmented_temporary_buffer& b) { return fragmented_temporary_buffer::view(b); }));
 
         _sst->get_stats().on_row_read();
+        if (_reader->counts_reads()) {
+            _sst->get_stats().on_counted_row_read();
+        }
         sstlog.trace("mp_row_consumer_m {}: consume_row_start({})", fmt::ptr(this), key);
 
         _in_progress_row.emplace(std::move(key));
@@ -370,6 +373,9 @@ class mp_row_consumer_m {
         }
         if (_in_progress_row->tomb()) {
             _sst->get_stats().on_row_tombstone_read();
+            if (_reader->counts_reads()) {
+                _sst->get_stats().on_counted_tombstone_read();
+            }
         }
         return data_consumer::proceed::yes;
     }
@@ -489,6 +495,9 @@ class mp_row_consumer_m {
     data_consumer::proceed consume_range_tombstone(const std::vector<fragmented_temporary_buffer>& ecp,
                                             bound_kind kind,
                                             tombstone tomb) {
+        if (_reader->counts_reads()) {
+            _sst->get_stats().on_counted_tombstone_read();
+        }
         auto ck = clustering_key_prefix::from_range(ecp | boost::adaptors::transformed(
             [] (const fragmented_temporary_buffer& b) { return fragmented_temporary_buffer::view(b); }));
         if (kind == bound_kind::incl_start || kind == bound_kind::excl_start) {
@@ -502,6 +511,9 @@ class mp_row_consumer_m {
                                             sstables::bound_kind_m kind,
                                             tombstone end_tombstone,
                                             tombstone start_tombstone) {
+        if (_reader->counts_reads()) {
+            _sst->get_stats().on_counted_tombstone_read();
+        }
         auto ck = clustering_key_prefix::from_range(ecp | boost::adaptors::transformed(
             [] (const fragmented_temporary_buffer& b) { return fragmented_temporary_buffer::view(b); }));
         switch (kind) {
@@ -1320,6 +1332,7 @@ class mx_sstable_mutation_reader : public mp_row_consumer_reader_mx {
             , _fwd(fwd)
             , _fwd_mr(fwd_mr)
             , _monitor(mon) {
+        _counts_reads = _monitor.counts_reads();
         if (reversed()) {
             if (!_single_partition_read) {
                 on_internal_error(sstlog, format(
@@ -1776,6 +1789,7 @@ class mx_crawling_sstable_mutation_reader : public mp_row_consumer_reader_mx {
         , _consumer(this, _schema, std::move(permit), _schema->full_slice(), std::move(trace_state), streamed_mutation::forwarding::no, _sst)
         , _context(data_consume_rows<DataConsumeRowsContext>(*_schema, _sst, _consumer))
         , _monitor(mon) {
+        _counts_reads = _monitor.counts_reads();
         _monitor.on_read_started(_context->reader_position());
     }
 public:
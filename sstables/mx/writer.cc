@@ -18,6 +18,7 @@
 #include "mutation/atomic_cell.hh"
 #include "utils/exceptions.hh"
 #include "db/large_data_handler.hh"
+#include "comparable_bytes.hh"
 
 #include <functional>
 #include <boost/iterator/iterator_facade.hpp>
@@ -533,6 +534,16 @@ class writer : public sstable_writer::writer_impl {
     bool _compression_enabled = false;
     std::unique_ptr<file_writer> _data_writer;
     std::unique_ptr<file_writer> _index_writer;
+    // Engaged iff the sstable has a partition trie index (Partitions.db).
+    std::unique_ptr<file_writer> _partitions_writer;
+    std::optional<trie::partition_trie_writer<file_writer>> _partition_trie;
+    // The trie entry of the current token. It is added to the trie once the
+    // next token starts, as only then the extent of its index entries is known.
+    struct pending_trie_entry {
+        bytes key;
+        uint64_t index_offset;
+    };
+    std::optional<pending_trie_entry> _pending_trie_entry;
     bool _tombstone_written = false;
     bool _static_row_written = false;
     // The length of partition header (partition key, partition deletion and static row, if present)
@@ -626,6 +637,9 @@ class writer : public sstable_writer::writer_impl {
             _index_writer->offset(), _index_sampling_state);
     }
 
+    void add_partition_trie_entry(const dht::token& token);
+    void flush_pending_trie_entry();
+
     void maybe_set_pi_first_clustering(const clustering_info& info);
     void maybe_add_pi_block();
     void add_pi_block();
@@ -789,6 +803,9 @@ class writer : public sstable_writer::writer_impl {
         // exactly what callers used to do anyway.
         estimated_partitions = std::max(uint64_t(1), estimated_partitions);
 
+        if (cfg.remote_data) {
+            _sst.make_remote_data_location(*cfg.remote_data);
+        }
         _sst.open_sstable();
         _sst.create_data().get();
         _compression_enabled = !_sst.has_component(component_type::CRC);
@@ -796,7 +813,8 @@ class writer : public sstable_writer::writer_impl {
         _sst._shards = { shard };
 
         _cfg.monitor->on_write_started(_data_writer->offset_tracker());
-        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format);
+        _sst._components->filter = utils::i_filter::get_filter(estimated_partitions, _schema.bloom_filter_fp_chance(), utils::filter_format::m_format,
+                _schema.sstable_filter_options().type());
         _pi_write_m.promoted_index_block_size = cfg.promoted_index_block_size;
         _pi_write_m.promoted_index_auto_scale_threshold = cfg.promoted_index_auto_scale_threshold;
         _index_sampling_state.summary_byte_cost = _cfg.summary_byte_cost;
@@ -823,6 +841,7 @@ writer::~writer() {
             }
         }
     };
+    close_writer(_partitions_writer);
     close_writer(_index_writer);
     close_writer(_data_writer);
 }
@@ -884,11 +903,18 @@ void writer::init_file_writers() {
             make_compressed_file_m_format_output_stream(
                 output_stream<char>(std::move(out)),
                 &_sst._components->compression,
-                _schema.get_compressor_params()), _sst.filename(component_type::Data));
+                _schema.get_compressor_params(), _schema.id()), _sst.filename(component_type::Data));
     }
 
     out = _sst._storage->make_data_or_index_sink(_sst, component_type::Index).get0();
     _index_writer = std::make_unique<file_writer>(output_stream<char>(std::move(out)), _sst.filename(component_type::Index));
+
+    if (_sst.has_partition_trie_index()) {
+        file_output_stream_options options;
+        options.buffer_size = _sst.sstable_buffer_size;
+        _partitions_writer = std::make_unique<file_writer>(_sst.make_component_file_writer(component_type::Partitions, std::move(options)).get0());
+        _partition_trie.emplace(*_partitions_writer);
+    }
 }
 
 std::unique_ptr<file_writer> writer::close_writer(std::unique_ptr<file_writer>& w) {
@@ -908,6 +934,28 @@ void writer::close_data_writer() {
     }
 }
 
+void writer::add_partition_trie_entry(const dht::token& token) {
+    auto key = comparable_bytes::encode_token(token);
+    if (_pending_trie_entry && _pending_trie_entry->key == key) {
+        // Partitions sharing a token share the trie entry.
+        return;
+    }
+    flush_pending_trie_entry();
+    _pending_trie_entry = pending_trie_entry{std::move(key), _index_writer->offset()};
+}
+
+void writer::flush_pending_trie_entry() {
+    if (!_pending_trie_entry) {
+        return;
+    }
+    _partition_trie->add(_pending_trie_entry->key, trie::partition_payload{
+        .index_offset = _pending_trie_entry->index_offset,
+        .index_length = _index_writer->offset() - _pending_trie_entry->index_offset,
+        .data_end = _data_writer->offset(),
+    });
+    _pending_trie_entry.reset();
+}
+
 void writer::consume_new_partition(const dht::decorated_key& dk) {
     _c_stats.start_offset = _data_writer->offset();
     _prev_row_start = _data_writer->offset();
@@ -921,6 +969,10 @@ void writer::consume_new_partition(const dht::decorated_key& dk) {
     auto p_key = disk_string_view<uint16_t>();
     p_key.value = bytes_view(*_partition_key);
 
+    if (_partition_trie) {
+        add_partition_trie_entry(dk.token());
+    }
+
     // Write index file entry from partition key into index file.
     // Write an index entry minus the "promoted index" (sample of columns)
     // part. We can only write that after processing the entire partition
@@ -1449,6 +1501,13 @@ void writer::consume_end_of_stream() {
         _collector.add_compression_ratio(_sst._components->compression.compressed_file_length(), _sst._components->compression.uncompressed_file_length());
     }
 
+    if (_partition_trie) {
+        flush_pending_trie_entry();
+        _partition_trie->finish();
+        _sst._metadata_size_on_disk += _partitions_writer->offset();
+        _partition_trie.reset();
+        close_writer(_partitions_writer);
+    }
     close_writer(_index_writer);
     _sst.set_first_and_last_keys();
 
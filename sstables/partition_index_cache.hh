@@ -20,6 +20,7 @@
 #include "utils/lru.hh"
 #include "utils/lsa/weak_ptr.hh"
 #include "sstables/partition_index_cache_stats.hh"
+#include "sstables/index_cache_table.hh"
 
 namespace sstables {
 
@@ -113,7 +114,7 @@ class partition_index_cache {
         entry_ptr& operator=(std::nullptr_t) noexcept {
             if (_ref) {
                 if (_ref.unique() && _ref->ready()) {
-                    _ref->_parent->_lru.add(*_ref);
+                    _ref->_parent->link(*_ref);
                 }
                 _ref = nullptr;
             }
@@ -154,6 +155,22 @@ class partition_index_cache {
     logalloc::allocating_section _as;
     lru& _lru;
     partition_index_cache_stats& _stats;
+    lw_shared_ptr<index_cache_table> _table;
+private:
+    // Applies f to the statistics, and to the statistics of the owning table, if any.
+    template <typename Func>
+    void update_stats(Func&& f) noexcept {
+        f(_stats);
+        if (_table) {
+            f(_table->partition_index_stats);
+        }
+    }
+
+    // Links an unused entry in the LRU.
+    void link(entry& e) noexcept {
+        e.set_pinned_size(_table && _table->pinned() ? e.size_in_allocator() : 0);
+        _lru.add(e);
+    }
 public:
 
     // Create a cache with a given LRU attached.
@@ -164,6 +181,15 @@ class partition_index_cache {
             , _stats(stats)
     { }
 
+    // Create a cache of index pages of the given table.
+    // Operations are also accounted in the table's statistics, and unused entries
+    // are pinned when the table's index is pinned.
+    partition_index_cache(lw_shared_ptr<index_cache_table> table, lru& lru_, logalloc::region& r, partition_index_cache_stats& stats)
+            : partition_index_cache(lru_, r, stats)
+    {
+        _table = std::move(table);
+    }
+
     ~partition_index_cache() {
         with_allocator(_region.allocator(), [&] {
             _cache.clear_and_dispose([this] (entry* e) noexcept {
@@ -192,18 +218,20 @@ class partition_index_cache {
             entry& cp = *i;
             auto ptr = share(cp);
             if (cp.ready()) {
-                ++_stats.hits;
+                update_stats([] (partition_index_cache_stats& s) { ++s.hits; });
                 return make_ready_future<entry_ptr>(std::move(ptr));
             } else {
-                ++_stats.blocks;
+                update_stats([] (partition_index_cache_stats& s) { ++s.blocks; });
                 return ptr.get_entry().promise()->get_shared_future().then([ptr] () mutable {
                     return std::move(ptr);
                 });
             }
         }
 
-        ++_stats.misses;
-        ++_stats.blocks;
+        update_stats([] (partition_index_cache_stats& s) {
+            ++s.misses;
+            ++s.blocks;
+        });
 
         entry_ptr ptr = _as(_region, [&] {
             return with_allocator(_region.allocator(), [&] {
@@ -227,8 +255,10 @@ class partition_index_cache {
                 partition_index_page&& page = f.get0();
                 e.promise()->set_value();
                 e.set_page(std::move(page));
-                _stats.used_bytes += e.size_in_allocator();
-                ++_stats.populations;
+                update_stats([&e] (partition_index_cache_stats& s) {
+                    s.used_bytes += e.size_in_allocator();
+                    ++s.populations;
+                });
                 return ptr;
             } catch (...) {
                 e.promise()->set_exception(std::current_exception());
@@ -242,8 +272,21 @@ class partition_index_cache {
     }
 
     void on_evicted(entry& p) {
-        _stats.used_bytes -= p.size_in_allocator();
-        ++_stats.evictions;
+        update_stats([&p] (partition_index_cache_stats& s) {
+            s.used_bytes -= p.size_in_allocator();
+            ++s.evictions;
+        });
+    }
+
+    // Relinks unused entries in the LRU, so that they become pinned or unpinned
+    // according to the current setting of the owning table.
+    void update_pinning() noexcept {
+        for (auto& e : _cache) {
+            if (e.is_linked()) {
+                _lru.remove(e);
+                link(e);
+            }
+        }
     }
 
     // Evicts all unreferenced entries.
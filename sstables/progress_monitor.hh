@@ -39,6 +39,10 @@ class read_monitor {
     // parameters are the current position in the data file
     virtual void on_read_started(const reader_position_tracker&) = 0;
     virtual void on_read_completed() = 0;
+    // Whether the reads count towards the reads of the sstable (see
+    // sstables_stats::rows_read()), which reflect the workload. Reads made
+    // by compaction don't.
+    virtual bool counts_reads() const noexcept { return true; }
 };
 
 struct noop_read_monitor final : public read_monitor {
@@ -46,6 +50,12 @@ struct noop_read_monitor final : public read_monitor {
     virtual void on_read_completed() override {}
 };
 
+struct uncounted_read_monitor final : public read_monitor {
+    virtual void on_read_started(const reader_position_tracker&) override {}
+    virtual void on_read_completed() override {}
+    virtual bool counts_reads() const noexcept override { return false; }
+};
+
 read_monitor& default_read_monitor();
 
 struct read_monitor_generator {
@@ -60,4 +70,8 @@ struct no_read_monitoring final : public read_monitor_generator {
 };
 
 read_monitor_generator& default_read_monitor_generator();
+
+// For reads which don't count towards the reads of the sstables, and don't
+// need monitoring otherwise.
+read_monitor_generator& uncounted_read_monitor_generator();
 }
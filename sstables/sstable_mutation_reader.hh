@@ -50,11 +50,18 @@ class mp_row_consumer_reader_base {
     bool _before_partition = true;
 
     std::optional<dht::decorated_key> _current_partition_key;
+
+    // See read_monitor::counts_reads().
+    bool _counts_reads = true;
 public:
     mp_row_consumer_reader_base(shared_sstable sst)
         : _sst(std::move(sst))
     { }
 
+    bool counts_reads() const noexcept {
+        return _counts_reads;
+    }
+
     // Called when all fragments relevant to the query range or fast forwarding window
     // within the current partition have been pushed.
     // If no skipping is required, this method may not be called before transitioning
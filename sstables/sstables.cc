@@ -59,6 +59,8 @@
 #include "counters.hh"
 #include "binary_search.hh"
 #include "utils/bloom_filter.hh"
+#include "utils/blocked_bloom_filter.hh"
+#include "utils/binary_fuse_filter.hh"
 #include "utils/cached_file.hh"
 #include "utils/stall_free.hh"
 #include "checked-file-impl.hh"
@@ -125,6 +127,17 @@ read_monitor_generator& default_read_monitor_generator() {
     return noop_read_monitor_generator;
 }
 
+static uncounted_read_monitor default_uncounted_read_monitor;
+struct uncounted_read_monitoring final : public read_monitor_generator {
+    virtual read_monitor& operator()(shared_sstable sst) override {
+        return default_uncounted_read_monitor;
+    }
+};
+static uncounted_read_monitoring uncounted_read_monitor_generator_instance;
+read_monitor_generator& uncounted_read_monitor_generator() {
+    return uncounted_read_monitor_generator_instance;
+}
+
 future<file> sstable::new_sstable_component_file(const io_error_handler& error_handler, component_type type, open_flags flags, file_open_options options) noexcept {
   try {
     auto f = _storage->open_component(*this, type, flags, options, _manager.config().enable_sstable_data_integrity_check());
@@ -843,7 +856,7 @@ void sstable::generate_toc() {
     _recognized_components.insert(component_type::Digest);
     _recognized_components.insert(component_type::Index);
     _recognized_components.insert(component_type::Summary);
-    _recognized_components.insert(component_type::Data);
+    _recognized_components.insert(_remote_data ? component_type::RemoteData : component_type::Data);
     if (_schema->bloom_filter_fp_chance() != 1.0) {
         _recognized_components.insert(component_type::Filter);
     }
@@ -853,6 +866,9 @@ void sstable::generate_toc() {
         _recognized_components.insert(component_type::CompressionInfo);
     }
     _recognized_components.insert(component_type::Scylla);
+    if (_manager.config().enable_sstable_partition_trie_index()) {
+        _recognized_components.insert(component_type::Partitions);
+    }
 }
 
 file_writer::~file_writer() {
@@ -915,6 +931,45 @@ future<file_writer> sstable::make_component_file_writer(component_type c, file_o
 void sstable::open_sstable() {
     generate_toc();
     _storage->open(*this);
+    if (_remote_data) {
+        write_remote_data_location();
+    }
+}
+
+void sstable::make_remote_data_location(const data_dictionary::storage_options::s3& target) {
+    // The object is named after the sstable for the ease of inspection, and
+    // prefixed with a time UUID, as other nodes may write into the same bucket.
+    auto object = format("/{}/{}/{}", target.bucket, utils::UUID_gen::get_time_UUID(), component_basename(component_type::Data));
+    _remote_data.emplace(remote_data_location{target.endpoint, std::move(object)});
+}
+
+// The location is kept as two lines, the endpoint and the object name.
+void sstable::write_remote_data_location() {
+    unsigned buffer_size = 4096;
+    do_write_simple(component_type::RemoteData, [&] (version_types v, file_writer& w) {
+        auto value = format("{}\n{}\n", _remote_data->endpoint, _remote_data->object);
+        w.write(value.data(), value.size());
+    }, buffer_size);
+}
+
+future<> sstable::read_remote_data_location() {
+    if (_remote_data) {
+        co_return;
+    }
+    co_await do_read_simple(component_type::RemoteData, [&] (version_types v, file f) -> future<> {
+        auto bufptr = allocate_aligned_buffer<char>(4096, 4096);
+        size_t size = co_await f.dma_read(0, bufptr.get(), 4096);
+        if (size >= 4096) {
+            throw malformed_sstable_exception("SSTable RemoteData too big: " + to_sstring(size) + " bytes", filename(component_type::RemoteData));
+        }
+
+        std::vector<sstring> lines;
+        boost::split(lines, std::string_view(bufptr.get(), size), boost::is_any_of("\n"));
+        if (lines.size() < 2 || lines[0].empty() || lines[1].empty()) {
+            throw malformed_sstable_exception("Invalid RemoteData", filename(component_type::RemoteData));
+        }
+        _remote_data.emplace(remote_data_location{std::move(lines[0]), std::move(lines[1])});
+    });
 }
 
 void sstable::write_toc(file_writer w) {
@@ -1298,9 +1353,18 @@ future<file> sstable::open_file(component_type type, open_flags flags, file_open
 }
 
 future<> sstable::open_or_create_data(open_flags oflags, file_open_options options) noexcept {
+    auto data_opened = make_ready_future<>();
+    if (!has_remote_data()) {
+        data_opened = open_file(component_type::Data, oflags, options).then([this] (file f) { _data_file = std::move(f); });
+    } else if (oflags == open_flags::ro) {
+        data_opened = read_remote_data_location().then([this, oflags, options] {
+            return open_file(component_type::Data, oflags, options).then([this] (file f) { _data_file = std::move(f); });
+        });
+    }
+    // Remote data of new sstables is written directly to object storage, see storage::make_data_or_index_sink().
     return when_all_succeed(
         open_file(component_type::Index, oflags, options).then([this] (file f) { _index_file = std::move(f); }),
-        open_file(component_type::Data, oflags, options).then([this] (file f) { _data_file = std::move(f); })
+        std::move(data_opened)
     ).discard_result();
 }
 
@@ -1335,16 +1399,34 @@ future<> sstable::update_info_for_opened_data(sstable_open_config cfg) {
     _data_file_size = st.st_size;
     _data_file_write_time = db_clock::from_time_t(st.st_mtime);
 
+    if (has_remote_data()) {
+        // Every read of remote data is a request to object storage, so its pages
+        // are cached in memory, along with the index pages.
+        co_await read_remote_data_location();
+        assert(!_cached_data_file);
+        _cached_data_file = seastar::make_shared<cached_file>(_data_file,
+                                                               _manager.get_cache_tracker().get_remote_data_cached_file_stats(),
+                                                               _manager.get_cache_tracker().get_lru(),
+                                                               _manager.get_cache_tracker().region(),
+                                                               _data_file_size);
+        _data_file = make_cached_seastar_file(*_cached_data_file);
+    }
+
     auto size = co_await _index_file.size();
     _index_file_size = size;
     assert(!_cached_index_file);
     _cached_index_file = seastar::make_shared<cached_file>(_index_file,
+                                                            _index_cache_table,
                                                             _manager.get_cache_tracker().get_index_cached_file_stats(),
                                                             _manager.get_cache_tracker().get_lru(),
                                                             _manager.get_cache_tracker().region(),
                                                             _index_file_size);
     _index_file = make_cached_seastar_file(*_cached_index_file);
 
+    if (has_partition_trie_index()) {
+        co_await open_partition_trie_index();
+    }
+
     this->set_min_max_position_range();
     this->set_first_and_last_keys();
     _run_identifier = _components->scylla_metadata->get_optional_run_identifier().value_or(run_id::create_random_id());
@@ -1353,6 +1435,23 @@ future<> sstable::update_info_for_opened_data(sstable_open_config cfg) {
     }
 }
 
+future<> sstable::open_partition_trie_index() {
+    auto f = co_await open_file(component_type::Partitions, open_flags::ro);
+    _partitions_file_size = co_await f.size();
+    assert(!_cached_partitions_file);
+    _cached_partitions_file = seastar::make_shared<cached_file>(std::move(f),
+                                                                _index_cache_table,
+                                                                _manager.get_cache_tracker().get_index_cached_file_stats(),
+                                                                _manager.get_cache_tracker().get_lru(),
+                                                                _manager.get_cache_tracker().region(),
+                                                                _partitions_file_size);
+    _partitions_file = make_cached_seastar_file(*_cached_partitions_file);
+    trie::partition_trie_reader::read_function read = [this] (uint64_t pos, size_t len) {
+        return _partitions_file.dma_read_bulk<char>(pos, len);
+    };
+    _partition_trie_footer = co_await trie::partition_trie_reader::read_footer(read, _partitions_file_size);
+}
+
 future<> sstable::create_data() noexcept {
     auto oflags = open_flags::wo | open_flags::create | open_flags::exclusive;
     file_open_options opt;
@@ -1366,6 +1465,12 @@ future<> sstable::create_data() noexcept {
 future<> sstable::drop_caches() {
     return _cached_index_file->evict_gently().then([this] {
         return _index_cache->evict_gently();
+    }).then([this] {
+        return _trie_page_cache->evict_gently();
+    }).then([this] {
+        return _cached_partitions_file ? _cached_partitions_file->evict_gently() : make_ready_future<>();
+    }).then([this] {
+        return _cached_data_file ? _cached_data_file->evict_gently() : make_ready_future<>();
     });
 }
 
@@ -1378,6 +1483,14 @@ future<> sstable::read_filter(sstable_open_config cfg) {
     return seastar::async([this] () mutable {
         sstables::filter filter;
         read_simple<component_type::Filter>(filter).get();
+        if (filter.hashes == 0 && utils::filter::blocked_bloom_filter::is_blocked_bloom_filter_storage(filter.buckets.elements)) {
+            _components->filter = std::make_unique<utils::filter::blocked_bloom_filter>(std::move(filter.buckets.elements));
+            return;
+        }
+        if (filter.hashes == 0 && utils::filter::binary_fuse_filter::is_binary_fuse_filter_storage(filter.buckets.elements)) {
+            _components->filter = std::make_unique<utils::filter::binary_fuse_filter>(std::move(filter.buckets.elements));
+            return;
+        }
         auto nr_bits = filter.buckets.elements.size() * std::numeric_limits<typename decltype(filter.buckets.elements)::value_type>::digits;
         large_bitset bs(nr_bits, std::move(filter.buckets.elements));
         utils::filter_format format = (_version >= sstable_version_types::mc)
@@ -1392,6 +1505,23 @@ void sstable::write_filter() {
         return;
     }
 
+    if (auto bf = dynamic_cast<utils::filter::blocked_bloom_filter*>(_components->filter.get())) {
+        // Versions which don't know the blocked filter see a classic filter with no hash
+        // functions, which reports every key as present.
+        write_simple<component_type::Filter>(sstables::filter_ref(0, bf->get_storage()));
+        return;
+    }
+    if (auto ff = dynamic_cast<utils::filter::binary_fuse_filter*>(_components->filter.get())) {
+        // The filter can only be built once all the keys are known.
+        ff->seal();
+        if (!ff->fallback()) {
+            write_simple<component_type::Filter>(sstables::filter_ref(0, ff->get_storage()));
+            return;
+        }
+        // More keys than estimated were added, and the filter was rebuilt as a bloom filter.
+        _components->filter = ff->release_fallback();
+    }
+
     auto f = static_cast<utils::filter::murmur3_bloom_filter *>(_components->filter.get());
 
     auto&& bs = f->bits();
@@ -2530,6 +2660,13 @@ future<> sstable::close_files() {
             general_disk_error();
         });
     }
+    auto partitions_closed = make_ready_future<>();
+    if (_partitions_file) {
+        partitions_closed = _partitions_file.close().handle_exception([me = shared_from_this()] (auto ep) {
+            sstlog.warn("sstable close partitions_file failed: {}", ep);
+            general_disk_error();
+        });
+    }
     auto data_closed = make_ready_future<>();
     if (_data_file) {
         data_closed = _data_file.close().handle_exception([me = shared_from_this()] (auto ep) {
@@ -2561,7 +2698,7 @@ future<> sstable::close_files() {
 
     _on_closed(*this);
 
-    return when_all_succeed(std::move(index_closed), std::move(data_closed), std::move(unlinked)).discard_result().then([this, me = shared_from_this()] {
+    return when_all_succeed(std::move(index_closed), std::move(partitions_closed), std::move(data_closed), std::move(unlinked)).discard_result().then([this, me = shared_from_this()] {
         if (_open_mode) {
             if (_open_mode.value() == open_flags::ro) {
                 _stats.on_close_for_reading();
@@ -2831,6 +2968,22 @@ void register_index_page_cache_metrics(seastar::metrics::metric_groups& metrics,
     });
 }
 
+void register_remote_data_cache_metrics(seastar::metrics::metric_groups& metrics, cached_file_stats& m) {
+    namespace sm = seastar::metrics;
+    metrics.add_group("sstables", {
+        sm::make_counter("remote_data_cache_hits", [&m] { return m.page_hits; },
+            sm::description("Requests for pages of sstable data kept in object storage which were served from cache")),
+        sm::make_counter("remote_data_cache_misses", [&m] { return m.page_misses; },
+            sm::description("Requests for pages of sstable data kept in object storage which had to be fetched from it")),
+        sm::make_counter("remote_data_cache_evictions", [&m] { return m.page_evictions; },
+            sm::description("Total number of pages of sstable data kept in object storage which have been evicted")),
+        sm::make_counter("remote_data_cache_populations", [&m] { return m.page_populations; },
+            sm::description("Total number of pages of sstable data kept in object storage which were inserted into the cache")),
+        sm::make_gauge("remote_data_cache_bytes", [&m] { return m.cached_bytes; },
+            sm::description("Total number of bytes of sstable data kept in object storage which are cached")),
+    });
+}
+
 void register_index_page_metrics(seastar::metrics::metric_groups& metrics, partition_index_cache_stats& m) {
     namespace sm = seastar::metrics;
     metrics.add_group("sstables", {
@@ -2906,6 +3059,12 @@ future<> init_metrics() {
             sm::description("Number of partitions seeked")),
         sm::make_counter("row_reads", [] { return sstables_stats::get_shard_stats().row_reads; },
             sm::description("Number of rows read")),
+        sm::make_counter("decompression_read_aheads", [] { return sstables_stats::get_shard_stats().decompression_read_aheads; },
+            sm::description("Number of compressed chunks read and uncompressed ahead of the reader")),
+        sm::make_counter("decompression_read_ahead_stalls", [] { return sstables_stats::get_shard_stats().decompression_read_ahead_stalls; },
+            sm::description("Number of times a reader had to wait for a compressed chunk to be read and uncompressed")),
+        sm::make_gauge("decompression_chunks_in_flight", [] { return sstables_stats::get_shard_stats().decompression_chunks_in_flight; },
+            sm::description("Number of compressed chunks currently being read and uncompressed, or waiting for the reader")),
 
         sm::make_counter("capped_local_deletion_time", [] { return sstables_stats::get_shard_stats().capped_local_deletion_time; },
             sm::description("Was local deletion time capped at maximum allowed value in Statistics")),
@@ -2929,7 +3088,11 @@ future<> init_metrics() {
         sm::make_counter("total_deleted", [] { return sstables_stats::get_shard_stats().deleted; },
             sm::description("Counter of deleted sstables")),
 
-        sm::make_gauge("bloom_filter_memory_size", [] { return utils::filter::bloom_filter::get_shard_stats().memory_size; },
+        sm::make_gauge("bloom_filter_memory_size", [] {
+                return utils::filter::bloom_filter::get_shard_stats().memory_size
+                        + utils::filter::blocked_bloom_filter::get_shard_stats().memory_size
+                        + utils::filter::binary_fuse_filter::get_shard_stats().memory_size;
+            },
             sm::description("Bloom filter memory usage in bytes.")),
     });
   });
@@ -2966,7 +3129,10 @@ sstable::sstable(schema_ptr schema,
     , _storage(make_storage(manager, storage, std::move(table_dir), _state))
     , _version(v)
     , _format(f)
-    , _index_cache(std::make_unique<partition_index_cache>(
+    , _index_cache_table(manager.get_cache_tracker().get_index_cache_table(_schema->id()))
+    , _index_cache(std::make_unique<partition_index_cache>(_index_cache_table,
+            manager.get_cache_tracker().get_lru(), manager.get_cache_tracker().region(), manager.get_cache_tracker().get_partition_index_cache_stats()))
+    , _trie_page_cache(std::make_unique<partition_index_cache>(_index_cache_table,
             manager.get_cache_tracker().get_lru(), manager.get_cache_tracker().region(), manager.get_cache_tracker().get_partition_index_cache_stats()))
     , _now(now)
     , _read_error_handler(error_handler_gen(sstable_read_error))
@@ -2977,6 +3143,17 @@ sstable::sstable(schema_ptr schema,
     manager.add(this);
 }
 
+void sstable::update_index_cache_pinning() noexcept {
+    _index_cache->update_pinning();
+    _trie_page_cache->update_pinning();
+    if (_cached_index_file) {
+        _cached_index_file->update_pinning();
+    }
+    if (_cached_partitions_file) {
+        _cached_partitions_file->update_pinning();
+    }
+}
+
 file sstable::uncached_index_file() {
     return _cached_index_file->get_file();
 }
@@ -2999,9 +3176,13 @@ future<> sstable::destroy() {
     }
 
     co_await _index_cache->evict_gently();
+    co_await _trie_page_cache->evict_gently();
     if (_cached_index_file) {
         co_await _cached_index_file->evict_gently();
     }
+    if (_cached_partitions_file) {
+        co_await _cached_partitions_file->evict_gently();
+    }
     co_await _storage->destroy(*this);
 
     if (ex) {
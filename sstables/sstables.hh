@@ -35,6 +35,7 @@
 #include "sstables/shareable_components.hh"
 #include "sstables/storage.hh"
 #include "sstables/generation_type.hh"
+#include "sstables/trie_index.hh"
 #include "mutation/mutation_fragment_stream_validator.hh"
 #include "readers/flat_mutation_reader_fwd.hh"
 #include "tracing/trace_state.hh"
@@ -95,10 +96,24 @@ class data_consume_context;
 
 class index_reader;
 class partition_index_cache;
+class index_cache_table;
 class sstables_manager;
 
 extern size_t summary_byte_cost(double summary_ratio);
 
+// Location of the Data component of an sstable whose other components are kept
+// locally, but whose data is kept in object storage. It is stored in the
+// RemoteData component, in place of the Data component.
+struct remote_data_location {
+    sstring endpoint;
+    // Full name of the object, including the bucket.
+    sstring object;
+};
+
+// How many times sparser the Summary is sampled for sstables which have
+// a partition trie index (see trie_index.hh).
+constexpr size_t partition_trie_summary_sparsity = 16;
+
 struct sstable_writer_config {
     size_t promoted_index_block_size;
     size_t promoted_index_auto_scale_threshold;
@@ -112,6 +127,9 @@ struct sstable_writer_config {
     size_t summary_byte_cost;
     sstring origin;
     locator::effective_replication_map_ptr erm;
+    // If engaged, the Data component is written to the given object storage
+    // bucket instead of along with the other components.
+    std::optional<data_dictionary::storage_options::s3> remote_data;
 
 private:
     explicit sstable_writer_config() {}
@@ -363,6 +381,27 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _index_file;
     }
     file uncached_index_file();
+
+    bool has_partition_trie_index() const {
+        return has_component(component_type::Partitions);
+    }
+    bool has_remote_data() const {
+        return has_component(component_type::RemoteData);
+    }
+    // Valid only if has_remote_data() and the sstable was opened or written.
+    const remote_data_location& get_remote_data_location() const {
+        return *_remote_data;
+    }
+    // The following are valid only if has_partition_trie_index().
+    file& partitions_file() {
+        return _partitions_file;
+    }
+    uint64_t partitions_file_size() const {
+        return _partitions_file_size;
+    }
+    const trie::trie_footer& partition_trie_footer() const {
+        return _partition_trie_footer;
+    }
     // Returns size of bloom filter data.
     uint64_t filter_size() const;
 
@@ -524,7 +563,15 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     std::set<generation_type> _compaction_ancestors;
     file _index_file;
     seastar::shared_ptr<cached_file> _cached_index_file;
+    file _partitions_file;
+    seastar::shared_ptr<cached_file> _cached_partitions_file;
+    uint64_t _partitions_file_size = 0;
+    trie::trie_footer _partition_trie_footer;
     file _data_file;
+    // Engaged when the Data component is kept in object storage. Its pages are
+    // then cached in memory, in _cached_data_file.
+    std::optional<remote_data_location> _remote_data;
+    seastar::shared_ptr<cached_file> _cached_data_file;
     uint64_t _data_file_size;
     uint64_t _index_file_size;
     // on-disk size of components but data and index.
@@ -554,7 +601,11 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     const format_types _format;
 
     filter_tracker _filter_tracker;
+    lw_shared_ptr<index_cache_table> _index_cache_table;
     std::unique_ptr<partition_index_cache> _index_cache;
+    // Index pages loaded through the partition trie index, keyed by their position
+    // in the index file rather than by summary index like _index_cache.
+    std::unique_ptr<partition_index_cache> _trie_page_cache;
 
     enum class mark_for_deletion {
         implicit = -1,
@@ -616,6 +667,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     void generate_toc();
     void open_sstable();
 
+    void make_remote_data_location(const data_dictionary::storage_options::s3& target);
+    future<> read_remote_data_location();
+    void write_remote_data_location();
+
     future<> read_compression();
     void write_compression();
 
@@ -726,6 +781,7 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     }
 
     future<> open_or_create_data(open_flags oflags, file_open_options options = {}) noexcept;
+    future<> open_partition_trie_index();
     // runs in async context (called from storage::open)
     void write_toc(file_writer w);
 public:
@@ -735,6 +791,10 @@ class sstable : public enable_lw_shared_from_this<sstable> {
         return _schema;
     }
 
+    // Pins or unpins the cached index pages of this sstable which are not in use,
+    // following a change of index_cache_table::pinned() of its table.
+    void update_index_cache_pinning() noexcept;
+
     bool has_scylla_component() const {
         return has_component(component_type::Scylla);
     }
@@ -889,6 +949,9 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     sstables_stats& get_stats() {
         return _stats;
     }
+    const sstables_stats& get_stats() const {
+        return _stats;
+    }
 
     bool has_correct_min_max_column_names() const noexcept {
         return _version >= sstable_version_types::md;
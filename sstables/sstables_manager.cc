@@ -133,6 +133,11 @@ sstable_writer_config sstables_manager::configure_writer(sstring origin) const {
             ? mutation_fragment_stream_validation_level::clustering_key
             : mutation_fragment_stream_validation_level::token;
     cfg.summary_byte_cost = summary_byte_cost(_db_config.sstable_summary_ratio());
+    if (_db_config.enable_sstable_partition_trie_index()) {
+        // Point lookups are served by the partition trie, the Summary is only
+        // used to find where range scans start, so it can be much sparser.
+        cfg.summary_byte_cost *= partition_trie_summary_sparsity;
+    }
 
     cfg.origin = std::move(origin);
 
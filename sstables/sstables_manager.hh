@@ -71,6 +71,7 @@ class storage_manager : public peering_sharded_service<storage_manager> {
 
     storage_manager(const db::config&, config cfg);
     shared_ptr<s3::client> get_endpoint_client(sstring endpoint);
+    bool is_known_endpoint(const sstring& endpoint) const noexcept { return _s3_endpoints.contains(endpoint); }
     future<> stop();
 };
 
@@ -127,6 +128,9 @@ class sstables_manager {
         assert(_storage != nullptr);
         return _storage->get_endpoint_client(std::move(endpoint));
     }
+    bool is_known_endpoint(const sstring& endpoint) const noexcept {
+        return _storage != nullptr && _storage->is_known_endpoint(endpoint);
+    }
 
     virtual sstable_writer_config configure_writer(sstring origin) const;
     bool uuid_sstable_identifiers() const;
@@ -36,15 +36,46 @@ class sstables_stats {
         uint64_t closed_for_writing = 0;
         uint64_t deleted = 0;
         uint64_t promoted_index_auto_scale_events = 0;
+        uint64_t decompression_read_aheads = 0;
+        uint64_t decompression_read_ahead_stalls = 0;
+        uint64_t decompression_chunks_in_flight = 0;
     } _shard_stats;
 
     stats& _stats = _shard_stats;
 
+    // Reads of this sstable only, as opposed to the statistics of the shard above,
+    // and only those which count (see read_monitor::counts_reads()).
+    uint64_t _rows_read = 0;
+    uint64_t _tombstones_read = 0;
+
 public:
     static const stats& get_shard_stats() noexcept {
         return _shard_stats;
     }
 
+    uint64_t rows_read() const noexcept {
+        return _rows_read;
+    }
+
+    // Row and range tombstones.
+    uint64_t tombstones_read() const noexcept {
+        return _tombstones_read;
+    }
+
+    inline void on_counted_row_read() noexcept {
+        ++_rows_read;
+    }
+
+    inline void on_counted_tombstone_read() noexcept {
+        ++_tombstones_read;
+    }
+
+    // Halves the reads of the sstable, so that they follow the recent workload.
+    void decay_reads() noexcept {
+        _rows_read /= 2;
+        _tombstones_read /= 2;
+    }
+
     inline void on_partition_write() noexcept {
         ++_stats.partition_writes;
     }
@@ -130,6 +161,19 @@ class sstables_stats {
     inline void on_promoted_index_auto_scale() noexcept {
         ++_stats.promoted_index_auto_scale_events;
     }
+
+    inline void on_decompression_read_ahead() noexcept {
+        ++_stats.decompression_read_aheads;
+    }
+    inline void on_decompression_read_ahead_stall() noexcept {
+        ++_stats.decompression_read_ahead_stalls;
+    }
+    inline void on_decompression_chunk_start() noexcept {
+        ++_stats.decompression_chunks_in_flight;
+    }
+    inline void on_decompression_chunks_done(uint64_t chunks) noexcept {
+        _stats.decompression_chunks_in_flight -= chunks;
+    }
 };
 
 }
@@ -84,6 +84,10 @@ future<data_sink> filesystem_storage::make_data_or_index_sink(sstable& sst, comp
     options.write_behind = 10;
 
     assert(type == component_type::Data || type == component_type::Index);
+    if (type == component_type::Data && sst._remote_data) {
+        auto client = sst.manager().get_endpoint_client(sst._remote_data->endpoint);
+        return make_ready_future<data_sink>(client->make_upload_jumbo_sink(sst._remote_data->object));
+    }
     return make_file_data_sink(type == component_type::Data ? std::move(sst._data_file) : std::move(sst._index_file), options);
 }
 
@@ -109,6 +113,12 @@ future<> filesystem_storage::rename_new_file(const sstable& sst, sstring from_na
 }
 
 future<file> filesystem_storage::open_component(const sstable& sst, component_type type, open_flags flags, file_open_options options, bool check_integrity) {
+    if (type == component_type::Data && sst._remote_data) {
+        assert(flags == open_flags::ro);
+        auto client = sst.manager().get_endpoint_client(sst._remote_data->endpoint);
+        return make_ready_future<file>(client->make_readable_file(sst._remote_data->object));
+    }
+
     auto create_flags = open_flags::create | open_flags::exclusive;
     auto readonly = (flags & create_flags) != create_flags;
     auto tgt_dir = !readonly && _temp_dir ? *_temp_dir : _dir;
@@ -406,6 +416,19 @@ future<> filesystem_storage::wipe(const sstable& sst, sync_dir sync) noexcept {
         return sst.toc_filename();
     }();
 
+    // The remote data object is shared by the snapshots of the sstable, which
+    // hard-link its RemoteData component, so it's deleted along with the last link.
+    // If the object cannot be deleted, it's left behind in the bucket.
+    bool delete_remote_data = false;
+    if (sst._remote_data) {
+        try {
+            auto st = co_await file_stat(sst.filename(component_type::RemoteData));
+            delete_remote_data = st.number_of_links == 1;
+        } catch (...) {
+            sstlog.warn("Failed to check links of {}: {}. Keeping {}.", sst.filename(component_type::RemoteData), std::current_exception(), sst._remote_data->object);
+        }
+    }
+
     try {
         co_await remove_by_toc_name(name, sync);
     } catch (...) {
@@ -415,6 +438,15 @@ future<> filesystem_storage::wipe(const sstable& sst, sync_dir sync) noexcept {
         // c. Eventually we may want to record these failures in a system table
         //    and notify the administrator about that for manual handling (rather than aborting).
         sstlog.warn("Failed to delete {}: {}. Ignoring.", name, std::current_exception());
+        delete_remote_data = false;
+    }
+
+    if (delete_remote_data) {
+        try {
+            co_await sst.manager().get_endpoint_client(sst._remote_data->endpoint)->delete_object(sst._remote_data->object);
+        } catch (...) {
+            sstlog.warn("Failed to delete {} of {}: {}. Ignoring.", sst._remote_data->object, name, std::current_exception());
+        }
     }
 
     if (_temp_dir) {
@@ -487,6 +519,9 @@ future<> s3_storage::ensure_remote_prefix(const sstable& sst) {
 }
 
 void s3_storage::open(sstable& sst) {
+    if (sst._remote_data) {
+        throw std::runtime_error(format("Cannot keep the data of {} apart, as it is kept in object storage already", sst.get_filename()));
+    }
     auto uuid = utils::UUID_gen::get_time_UUID();
     entry_descriptor desc("", "", "", sst._generation, sst._version, sst._format, component_type::TOC);
     sst.manager().system_keyspace().sstables_registry_create_entry(_location, uuid, status_creating, std::move(desc)).get();
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/coroutine.hh>
+#include "sstables/trie_index.hh"
+#include "sstables/exceptions.hh"
+#include "vint-serialization.hh"
+
+namespace sstables::trie {
+
+namespace internal {
+
+size_t common_prefix_length(bytes_view a, bytes_view b) noexcept {
+    auto n = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+}
+
+partition_trie_reader::partition_trie_reader(read_function read, trie_footer footer, uint64_t file_size)
+    : _read(std::move(read))
+    , _footer(footer)
+    , _nodes_end(file_size - trie_footer::serialized_size)
+{ }
+
+future<trie_footer> partition_trie_reader::read_footer(read_function& read, uint64_t file_size) {
+    if (file_size < trie_footer::serialized_size) {
+        throw malformed_sstable_exception(format("partition trie too small: {} bytes", file_size));
+    }
+    auto buf = co_await read(file_size - trie_footer::serialized_size, trie_footer::serialized_size);
+    if (buf.size() != trie_footer::serialized_size) {
+        throw malformed_sstable_exception(format("partition trie footer truncated: {} bytes", buf.size()));
+    }
+    trie_footer footer;
+    footer.root_position = read_be<uint64_t>(buf.get());
+    footer.key_count = read_be<uint64_t>(buf.get() + sizeof(uint64_t));
+    if (footer.root_position != trie_footer::no_root && footer.root_position >= file_size - trie_footer::serialized_size) {
+        throw malformed_sstable_exception(format("partition trie root position {} out of bounds", footer.root_position));
+    }
+    co_return footer;
+}
+
+future<partition_trie_reader::node> partition_trie_reader::read_node(uint64_t pos) {
+    if (pos >= _nodes_end) {
+        throw malformed_sstable_exception(format("partition trie node position {} out of bounds", pos));
+    }
+    auto buf = co_await _read(pos, std::min<uint64_t>(internal::max_node_size, _nodes_end - pos));
+    auto in = bytes_view(reinterpret_cast<const int8_t*>(buf.get()), buf.size());
+    auto read_vint = [&] {
+        if (in.empty()) {
+            throw malformed_sstable_exception(format("partition trie node at {} truncated", pos));
+        }
+        auto len = unsigned_vint::serialized_size_from_first_byte(in[0]);
+        if (len > in.size()) {
+            throw malformed_sstable_exception(format("partition trie node at {} truncated", pos));
+        }
+        auto v = unsigned_vint::deserialize(in);
+        in.remove_prefix(len);
+        return v;
+    };
+    if (in.empty()) {
+        throw malformed_sstable_exception(format("partition trie node at {} truncated", pos));
+    }
+    auto flags = uint8_t(in[0]);
+    in.remove_prefix(1);
+
+    node n;
+    if (flags & internal::leaf_node_flag) {
+        partition_payload p;
+        p.index_offset = read_vint();
+        p.index_length = read_vint();
+        p.data_end = read_vint();
+        n.payload = p;
+        co_return n;
+    }
+    auto count = read_vint();
+    if (count == 0 || count > 256 || count > in.size()) {
+        throw malformed_sstable_exception(format("partition trie node at {} has invalid child count {}", pos, count));
+    }
+    n.transitions.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        n.transitions.push_back(uint8_t(in[i]));
+    }
+    in.remove_prefix(count);
+    n.children.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        auto delta = read_vint();
+        if (delta == 0 || delta > pos) {
+            throw malformed_sstable_exception(format("partition trie node at {} has invalid child offset {}", pos, delta));
+        }
+        n.children.push_back(pos - delta);
+    }
+    co_return n;
+}
+
+future<lookup_result> partition_trie_reader::rightmost_leaf(uint64_t pos) {
+    while (true) {
+        auto n = co_await read_node(pos);
+        if (n.payload) {
+            co_return lookup_result{*n.payload, false};
+        }
+        pos = n.children.back();
+    }
+}
+
+future<std::optional<lookup_result>> partition_trie_reader::lookup(bytes_view key) {
+    if (_footer.root_position == trie_footer::no_root) {
+        co_return std::nullopt;
+    }
+    // The deepest subtree seen so far whose keys are all smaller than `key`.
+    std::optional<uint64_t> smaller;
+    uint64_t pos = _footer.root_position;
+    size_t depth = 0;
+    while (true) {
+        auto n = co_await read_node(pos);
+        if (n.payload) {
+            co_return lookup_result{*n.payload, true};
+        }
+        if (depth == key.size()) {
+            // All keys below this node extend `key`, hence are greater.
+            break;
+        }
+        auto b = uint8_t(key[depth]);
+        auto it = std::upper_bound(n.transitions.begin(), n.transitions.end(), b);
+        if (it == n.transitions.begin()) {
+            break;
+        }
+        auto idx = std::distance(n.transitions.begin(), it) - 1;
+        if (n.transitions[idx] != b) {
+            co_return co_await rightmost_leaf(n.children[idx]);
+        }
+        if (idx > 0) {
+            smaller = n.children[idx - 1];
+        }
+        pos = n.children[idx];
+        ++depth;
+    }
+    if (!smaller) {
+        co_return std::nullopt;
+    }
+    co_return co_await rightmost_leaf(*smaller);
+}
+
+}
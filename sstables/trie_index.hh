@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <seastar/core/future.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/util/noncopyable_function.hh>
+#include "bytes.hh"
+#include "bytes_ostream.hh"
+#include "sstables/types.hh"
+#include "sstables/writer.hh"
+
+// Trie-based partition index (the Partitions.db component).
+//
+// The partition index trie maps the byte-comparable form (comparable_bytes::encode_token())
+// of every partition token present in the sstable to the location of the partition's
+// entries in Index.db. Only the shortest prefix which distinguishes a token from its
+// neighbours is stored, so the trie for a few million partitions is a few
+// megabytes and its upper levels stay resident in the index file cache.
+// A point lookup descends the trie (usually within one or two pages, since
+// the nodes of every subtree are laid out contiguously) and then reads just
+// the index entries of the matching token, instead of binary searching the
+// in-memory Summary and reading a whole summary page from Index.db.
+//
+// On-disk format:
+//
+//   nodes, in post-order (children always precede their parent):
+//     leaf:     byte 0x80, vint index_offset, vint index_length, vint data_end
+//     internal: byte 0x00, vint n_children, n_children transition bytes (ascending),
+//               n_children vints, each the distance from the start of this node
+//               back to the start of the corresponding child
+//   footer (trie_footer::serialized_size bytes, big endian):
+//     u64 root_position (or trie_footer::no_root when there are no keys)
+//     u64 key_count
+//
+// Keys fed to the trie must be strictly increasing and no key may be a prefix of
+// another one, which trivially holds for the fixed-length token encoding.
+
+namespace sstables::trie {
+
+// Location of the index entries of all partitions sharing a token.
+struct partition_payload {
+    // Position in Index.db of the entry of the first partition with the token.
+    uint64_t index_offset;
+    // Number of bytes in Index.db taken by the entries of partitions with the token.
+    uint64_t index_length;
+    // Position in Data.db right after the last partition with the token.
+    uint64_t data_end;
+
+    bool operator==(const partition_payload&) const = default;
+};
+
+struct trie_footer {
+    static constexpr uint64_t no_root = std::numeric_limits<uint64_t>::max();
+    static constexpr size_t serialized_size = 16;
+
+    uint64_t root_position = no_root;
+    uint64_t key_count = 0;
+};
+
+namespace internal {
+
+constexpr uint8_t leaf_node_flag = 0x80;
+// Upper bound on the size of any serialized node.
+constexpr size_t max_node_size = 1 + max_vint_length + 256 + 256 * max_vint_length;
+
+size_t common_prefix_length(bytes_view a, bytes_view b) noexcept;
+
+}
+
+// Builds the trie incrementally from a sorted stream of keys and writes it to `W`.
+// Nodes are flushed as soon as no further key can be added below them, so memory use
+// is bounded by the key length, not by the number of keys.
+template <Writer W>
+class partition_trie_writer {
+    struct pending_node {
+        uint8_t transition;
+        std::vector<std::pair<uint8_t, uint64_t>> children;
+        std::optional<partition_payload> payload;
+    };
+
+    W& _out;
+    uint64_t _pos = 0;
+    uint64_t _key_count = 0;
+    // Nodes along the path of the most recently inserted (truncated) key.
+    std::vector<pending_node> _stack;
+    bytes _last_inserted;
+    // The last key passed to add() is inserted only once its successor is known,
+    // since that determines how much of it has to be kept.
+    bytes _prev_key;
+    size_t _prev_common_prefix = 0;
+    std::optional<partition_payload> _prev_payload;
+    bytes_ostream _tmp;
+private:
+    uint64_t write_node(const pending_node& n) {
+        auto node_pos = _pos;
+        _tmp.clear();
+        if (n.payload) {
+            assert(n.children.empty());
+            _tmp.write(bytes_view(reinterpret_cast<const int8_t*>(&internal::leaf_node_flag), 1));
+            write_vint(_tmp, n.payload->index_offset);
+            write_vint(_tmp, n.payload->index_length);
+            write_vint(_tmp, n.payload->data_end);
+        } else {
+            const int8_t flags = 0;
+            _tmp.write(bytes_view(&flags, 1));
+            write_vint(_tmp, uint64_t(n.children.size()));
+            for (auto&& [transition, child_pos] : n.children) {
+                _tmp.write(bytes_view(reinterpret_cast<const int8_t*>(&transition), 1));
+            }
+            for (auto&& [transition, child_pos] : n.children) {
+                write_vint(_tmp, node_pos - child_pos);
+            }
+        }
+        for (bytes_view frag : _tmp) {
+            _out.write(reinterpret_cast<const char*>(frag.data()), frag.size());
+        }
+        _pos += _tmp.size();
+        return node_pos;
+    }
+
+    void pop_node() {
+        auto n = std::move(_stack.back());
+        _stack.pop_back();
+        auto pos = write_node(n);
+        _stack.back().children.emplace_back(n.transition, pos);
+    }
+
+    void insert(bytes_view key, const partition_payload& payload) {
+        auto cp = internal::common_prefix_length(key, _last_inserted);
+        if (!_stack.empty() && cp >= std::min(key.size(), _last_inserted.size())) {
+            throw std::runtime_error(format("partition trie: key {} is a prefix of, or equal to, the previous key {}",
+                    to_hex(key), to_hex(_last_inserted)));
+        }
+        while (_stack.size() > cp + 1) {
+            pop_node();
+        }
+        if (_stack.empty()) {
+            _stack.push_back(pending_node{});
+        }
+        for (size_t i = cp; i < key.size(); ++i) {
+            _stack.push_back(pending_node{uint8_t(key[i])});
+        }
+        _stack.back().payload = payload;
+        _last_inserted = bytes(key);
+        ++_key_count;
+    }
+
+    void insert_prev(size_t next_common_prefix) {
+        auto len = std::max(_prev_common_prefix, next_common_prefix) + 1;
+        if (len > _prev_key.size()) {
+            throw std::runtime_error(format("partition trie: key {} is a prefix of one of its neighbours", to_hex(_prev_key)));
+        }
+        insert(bytes_view(_prev_key).substr(0, len), *_prev_payload);
+    }
+public:
+    explicit partition_trie_writer(W& out) : _out(out) {}
+
+    // Keys must be strictly increasing in unsigned lexicographical order.
+    void add(bytes_view key, const partition_payload& payload) {
+        if (_prev_payload) {
+            if (compare_unsigned(_prev_key, key) >= 0) {
+                throw std::runtime_error(format("partition trie: keys out of order: {} after {}", to_hex(key), to_hex(_prev_key)));
+            }
+            auto cp = internal::common_prefix_length(_prev_key, key);
+            insert_prev(cp);
+            _prev_common_prefix = cp;
+        }
+        _prev_key = bytes(key);
+        _prev_payload = payload;
+    }
+
+    // Writes out all remaining nodes followed by the footer.
+    trie_footer finish() {
+        if (_prev_payload) {
+            insert_prev(0);
+            _prev_payload.reset();
+        }
+        trie_footer footer;
+        while (_stack.size() > 1) {
+            pop_node();
+        }
+        if (!_stack.empty()) {
+            footer.root_position = write_node(_stack.back());
+            _stack.clear();
+        }
+        footer.key_count = _key_count;
+        write(sstable_version_types::me, _out, footer.root_position);
+        write(sstable_version_types::me, _out, footer.key_count);
+        _pos += trie_footer::serialized_size;
+        return footer;
+    }
+
+    uint64_t key_count() const { return _key_count; }
+};
+
+// Result of a partition_trie_reader lookup.
+struct lookup_result {
+    partition_payload payload;
+    // True iff the stored (truncated) key is a prefix of the looked-up key, in which case the
+    // looked-up key may belong to the payload's token. Otherwise, the payload is that of the
+    // greatest token smaller than the looked-up key.
+    bool prefix_match;
+};
+
+class partition_trie_reader {
+public:
+    // Reads `len` bytes (or fewer, if the file ends earlier) at `pos`.
+    using read_function = noncopyable_function<future<temporary_buffer<char>> (uint64_t pos, size_t len)>;
+private:
+    read_function _read;
+    trie_footer _footer;
+    // Position of the footer, which also ends the node area.
+    uint64_t _nodes_end;
+
+    struct node {
+        std::optional<partition_payload> payload;
+        std::vector<uint8_t> transitions;
+        std::vector<uint64_t> children;
+    };
+
+    future<node> read_node(uint64_t pos);
+    future<lookup_result> rightmost_leaf(uint64_t pos);
+public:
+    partition_trie_reader(read_function read, trie_footer footer, uint64_t file_size);
+
+    static future<trie_footer> read_footer(read_function& read, uint64_t file_size);
+
+    // Finds the leaf whose key is a prefix of `key`, or failing that, the greatest leaf
+    // smaller than `key`. Returns a disengaged optional if all leaves are greater than `key`.
+    //
+    // Since stored keys are truncated, a prefix match does not imply equality of the full key;
+    // callers must verify the match against the index entries it points to.
+    future<std::optional<lookup_result>> lookup(bytes_view key);
+
+    const trie_footer& footer() const { return _footer; }
+};
+
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "test/lib/random_utils.hh"
+#include "utils/bloom_filter.hh"
+#include "utils/blocked_bloom_filter.hh"
+#include "utils/binary_fuse_filter.hh"
+
+using namespace utils;
+
+namespace {
+
+std::vector<bytes> make_keys(size_t n) {
+    std::vector<bytes> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(tests::random::get_bytes(16));
+    }
+    return keys;
+}
+
+double false_positive_rate(i_filter& f, size_t probes) {
+    size_t false_positives = 0;
+    for (size_t i = 0; i < probes; ++i) {
+        // Longer than the inserted keys, so never one of them.
+        false_positives += f.is_present(tests::random::get_bytes(17));
+    }
+    return double(false_positives) / probes;
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_blocked_bloom_filter_no_false_negatives) {
+    for (auto fp_chance : {0.1, 0.01, 0.001}) {
+        auto keys = make_keys(20000);
+        auto f = i_filter::get_filter(keys.size(), fp_chance, filter_format::m_format, filter_type::blocked_bloom);
+        BOOST_REQUIRE(dynamic_cast<filter::blocked_bloom_filter*>(f.get()));
+        for (auto& k : keys) {
+            f->add(k);
+        }
+        for (auto& k : keys) {
+            BOOST_REQUIRE(f->is_present(k));
+            BOOST_REQUIRE(f->is_present(make_hashed_key(k)));
+        }
+        auto rate = false_positive_rate(*f, 100000);
+        BOOST_TEST_MESSAGE(format("fp_chance={} actual={}", fp_chance, rate));
+        BOOST_REQUIRE_LT(rate, fp_chance * 1.5);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_blocked_bloom_filter_storage_round_trip) {
+    auto keys = make_keys(1000);
+    filter::blocked_bloom_filter f(64);
+    for (auto& k : keys) {
+        f.add(k);
+    }
+
+    filter::blocked_bloom_filter::storage copy;
+    for (auto w : f.get_storage()) {
+        copy.push_back(w);
+    }
+    BOOST_REQUIRE(filter::blocked_bloom_filter::is_blocked_bloom_filter_storage(copy));
+    filter::blocked_bloom_filter f2(std::move(copy));
+    BOOST_REQUIRE_EQUAL(f2.num_blocks(), 64);
+    for (auto& k : keys) {
+        BOOST_REQUIRE(f2.is_present(k));
+    }
+
+    f2.clear();
+    BOOST_REQUIRE(filter::blocked_bloom_filter::is_blocked_bloom_filter_storage(f2.get_storage()));
+
+    // A classic bloom filter bit array is not mistaken for a blocked filter.
+    filter::blocked_bloom_filter::storage bits;
+    bits.resize(64);
+    BOOST_REQUIRE(!filter::blocked_bloom_filter::is_blocked_bloom_filter_storage(bits));
+    BOOST_REQUIRE_THROW(filter::blocked_bloom_filter(std::move(bits)), std::invalid_argument);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_blocked_bloom_filter_probe_implementations_agree) {
+    for (int i = 0; i < 100000; ++i) {
+        std::array<uint64_t, filter::blocked_bloom_filter::words_per_block> block;
+        for (auto& w : block) {
+            // Dense blocks, so that both outcomes are frequent.
+            w = tests::random::get_int<uint64_t>() | tests::random::get_int<uint64_t>() | tests::random::get_int<uint64_t>();
+        }
+        auto h = tests::random::get_int<uint32_t>();
+        BOOST_REQUIRE_EQUAL(filter::internal::blocked_bloom_filter_block_contains(block.data(), h),
+                filter::internal::blocked_bloom_filter_block_contains_generic(block.data(), h));
+
+        // Setting the bits of the key makes it present.
+        auto masks = filter::internal::blocked_bloom_filter_masks(h);
+        for (unsigned j = 0; j < masks.size(); ++j) {
+            block[j / 2] |= uint64_t(masks[j]) << ((j % 2) * 32);
+        }
+        BOOST_REQUIRE(filter::internal::blocked_bloom_filter_block_contains(block.data(), h));
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_binary_fuse_filter_no_false_negatives) {
+    for (auto fp_chance : {0.1, 0.01, 0.001}) {
+        auto keys = make_keys(20000);
+        auto f = i_filter::get_filter(keys.size(), fp_chance, filter_format::m_format, filter_type::binary_fuse);
+        auto ff = dynamic_cast<filter::binary_fuse_filter*>(f.get());
+        BOOST_REQUIRE(ff);
+        for (auto& k : keys) {
+            f->add(k);
+        }
+        // Duplicates must not prevent building the filter.
+        f->add(keys[0]);
+        f->add(keys[1]);
+        ff->seal();
+        BOOST_REQUIRE_EQUAL(ff->fingerprint_bits(), filter::binary_fuse_filter::fingerprint_bits_for(fp_chance));
+        for (auto& k : keys) {
+            BOOST_REQUIRE(f->is_present(k));
+            BOOST_REQUIRE(f->is_present(make_hashed_key(k)));
+        }
+        auto rate = false_positive_rate(*f, 100000);
+        BOOST_TEST_MESSAGE(format("fp_chance={} actual={} bits/key={}", fp_chance, rate,
+                double(ff->get_storage().size() * 64) / keys.size()));
+        BOOST_REQUIRE_LT(rate, fp_chance * 1.5);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_binary_fuse_filter_small) {
+    for (size_t n : {0, 1, 2, 3, 10}) {
+        auto keys = make_keys(n);
+        filter::binary_fuse_filter f(8);
+        // Unsealed filters report every key as present.
+        BOOST_REQUIRE(f.is_present(tests::random::get_bytes(17)));
+        for (auto& k : keys) {
+            f.add(k);
+        }
+        f.seal();
+        BOOST_REQUIRE_THROW(f.add(tests::random::get_bytes(16)), std::logic_error);
+        for (auto& k : keys) {
+            BOOST_REQUIRE(f.is_present(k));
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_binary_fuse_filter_falls_back_to_bloom) {
+    auto keys = make_keys(1100);
+    auto memory_before = filter::binary_fuse_filter::get_shard_stats().memory_size;
+    filter::binary_fuse_filter f(7, 1000);
+    for (size_t i = 0; i < 1000; ++i) {
+        f.add(keys[i]);
+    }
+    BOOST_REQUIRE(!f.fallback());
+    // The recorded hashes are accounted for.
+    BOOST_REQUIRE_GE(filter::binary_fuse_filter::get_shard_stats().memory_size, memory_before + 1000 * sizeof(hashed_key));
+    for (size_t i = 1000; i < keys.size(); ++i) {
+        f.add(keys[i]);
+    }
+    BOOST_REQUIRE(f.fallback());
+    BOOST_REQUIRE_EQUAL(filter::binary_fuse_filter::get_shard_stats().memory_size, memory_before);
+    BOOST_REQUIRE(dynamic_cast<filter::murmur3_bloom_filter*>(f.fallback()));
+    f.seal();
+    for (auto& k : keys) {
+        BOOST_REQUIRE(f.is_present(k));
+        BOOST_REQUIRE(f.fallback()->is_present(make_hashed_key(k)));
+    }
+    BOOST_REQUIRE_LT(false_positive_rate(f, 100000), 0.02);
+
+    auto bf = f.release_fallback();
+    for (auto& k : keys) {
+        BOOST_REQUIRE(bf->is_present(k));
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_binary_fuse_filter_storage_round_trip) {
+    // Widths which do and don't divide 64, so that some fingerprints straddle words.
+    for (unsigned bits : {4, 7, 8, 13, 32}) {
+        auto keys = make_keys(5000);
+        filter::binary_fuse_filter f(bits);
+        for (auto& k : keys) {
+            f.add(k);
+        }
+        f.seal();
+
+        filter::binary_fuse_filter::storage copy;
+        for (auto w : f.get_storage()) {
+            copy.push_back(w);
+        }
+        BOOST_REQUIRE(filter::binary_fuse_filter::is_binary_fuse_filter_storage(copy));
+        BOOST_REQUIRE(!filter::blocked_bloom_filter::is_blocked_bloom_filter_storage(copy));
+        filter::binary_fuse_filter f2(std::move(copy));
+        BOOST_REQUIRE_EQUAL(f2.fingerprint_bits(), bits);
+        for (auto& k : keys) {
+            BOOST_REQUIRE(f2.is_present(k));
+        }
+        for (int i = 0; i < 1000; ++i) {
+            auto k = tests::random::get_bytes(17);
+            BOOST_REQUIRE_EQUAL(f.is_present(k), f2.is_present(k));
+        }
+    }
+
+    filter::blocked_bloom_filter bbf(64);
+    filter::binary_fuse_filter::storage bits;
+    for (auto w : bbf.get_storage()) {
+        bits.push_back(w);
+    }
+    BOOST_REQUIRE(!filter::binary_fuse_filter::is_binary_fuse_filter_storage(bits));
+    BOOST_REQUIRE_THROW(filter::binary_fuse_filter(std::move(bits)), std::invalid_argument);
+}
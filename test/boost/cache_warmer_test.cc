@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/core/fstream.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/testing/test_case.hh>
+#include <seastar/util/closeable.hh>
+#include <seastar/util/file.hh>
+
+#include "test/lib/cql_test_env.hh"
+#include "test/lib/tmpdir.hh"
+#include "db/cache_warmer.hh"
+#include "replica/database.hh"
+#include "row_cache.hh"
+
+namespace {
+
+struct cache_reads {
+    uint64_t with_misses = 0;
+    uint64_t with_no_misses = 0;
+};
+
+cache_reads get_cache_reads(cql_test_env& e) {
+    return e.db().map_reduce0([] (const replica::database& db) {
+        auto& stats = db.find_column_family("ks", "t").get_row_cache().stats();
+        return cache_reads{stats.reads_with_misses.count(), stats.reads_with_no_misses.count()};
+    }, cache_reads{}, [] (cache_reads a, cache_reads b) {
+        return cache_reads{a.with_misses + b.with_misses, a.with_no_misses + b.with_no_misses};
+    }).get0();
+}
+
+void invalidate_cache(cql_test_env& e) {
+    e.db().invoke_on_all([] (replica::database& db) {
+        return db.find_column_family("ks", "t").get_row_cache().invalidate(row_cache::external_updater([] {}));
+    }).get();
+}
+
+temporary_buffer<char> with_byte(const temporary_buffer<char>& buf, size_t pos, char c) {
+    temporary_buffer<char> copy(std::max(buf.size(), pos + 1));
+    std::copy(buf.begin(), buf.end(), copy.get_write());
+    copy.get_write()[pos] = c;
+    return copy;
+}
+
+}
+
+SEASTAR_TEST_CASE(test_cache_warmer_round_trip) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.t (pk int PRIMARY KEY, v int)").get();
+        for (int i = 0; i < 10; ++i) {
+            e.execute_cql(format("INSERT INTO ks.t (pk, v) VALUES ({}, {})", i, i)).get();
+        }
+        e.db().invoke_on_all(&replica::database::flush_all_memtables).get();
+        invalidate_cache(e);
+        // Only the partitions read since are in cache, and get saved.
+        for (int i = 0; i < 5; ++i) {
+            e.execute_cql(format("SELECT * FROM ks.t WHERE pk = {}", i)).get();
+        }
+
+        tmpdir dir;
+        sharded<db::cache_warmer> warmer;
+        warmer.start(std::ref(e.db()), db::cache_warmer::config{
+            .directory = dir.path().native(),
+            .save_period_in_s = utils::updateable_value<uint32_t>(0),
+            .keys_to_save = utils::updateable_value<uint32_t>(0),
+            .throughput_mb_per_sec = utils::updateable_value<uint32_t>(1000),
+            .sched_group = default_scheduling_group(),
+        }).get();
+        auto stop_warmer = deferred_stop(warmer);
+        warmer.invoke_on_all(&db::cache_warmer::save).get();
+
+        auto s = e.local_db().find_schema("ks", "t");
+        std::set<int32_t> saved;
+        for (shard_id shard = 0; shard < smp::count; ++shard) {
+            auto buf = seastar::util::read_entire_file_contiguous(fs::path(warmer.local().file_name(shard))).get0();
+            for (auto& k : db::cache_warmer::parse_saved_keys(buf)) {
+                if (k.table == s->id()) {
+                    saved.insert(value_cast<int32_t>(int32_type->deserialize(k.key.explode(*s).front())));
+                }
+            }
+
+            // Truncated files are rejected, whatever the point they end at.
+            for (size_t size = 0; size < buf.size(); ++size) {
+                BOOST_REQUIRE_THROW(db::cache_warmer::parse_saved_keys(buf.share(0, size)), std::exception);
+            }
+            // So are corrupt ones: bad magic, unknown version, or trailing garbage.
+            BOOST_REQUIRE_THROW(db::cache_warmer::parse_saved_keys(with_byte(buf, 0, buf[0] ^ 1)), std::exception);
+            BOOST_REQUIRE_THROW(db::cache_warmer::parse_saved_keys(with_byte(buf, 7, buf[7] ^ 1)), std::exception);
+            BOOST_REQUIRE_THROW(db::cache_warmer::parse_saved_keys(with_byte(buf, buf.size(), 0)), std::exception);
+        }
+        BOOST_REQUIRE(saved == std::set<int32_t>({0, 1, 2, 3, 4}));
+
+        // A corrupt file doesn't prevent the others from being used.
+        auto corrupt = warmer.local().file_name(smp::count);
+        auto f = open_file_dma(corrupt, open_flags::wo | open_flags::create).get0();
+        auto out = make_file_output_stream(std::move(f)).get0();
+        out.write("garbage").get();
+        out.close().get();
+
+        // Restart the cache.
+        invalidate_cache(e);
+        warmer.invoke_on_all(&db::cache_warmer::warm_up).get();
+        auto warmed_up = warmer.map_reduce0([] (const db::cache_warmer& w) {
+            return w.get_stats().partitions_warmed_up;
+        }, uint64_t(0), std::plus<uint64_t>()).get0();
+        BOOST_REQUIRE_EQUAL(warmed_up, 5);
+
+        // The saved partitions are read from the cache, the others aren't.
+        auto before = get_cache_reads(e);
+        for (int i = 0; i < 5; ++i) {
+            e.execute_cql(format("SELECT * FROM ks.t WHERE pk = {}", i)).get();
+        }
+        auto after = get_cache_reads(e);
+        BOOST_REQUIRE_EQUAL(after.with_misses, before.with_misses);
+        BOOST_REQUIRE_EQUAL(after.with_no_misses, before.with_no_misses + 5);
+
+        e.execute_cql("SELECT * FROM ks.t WHERE pk = 5").get();
+        BOOST_REQUIRE_EQUAL(get_cache_reads(e).with_misses, after.with_misses + 1);
+    });
+}
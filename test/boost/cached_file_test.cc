@@ -21,6 +21,7 @@
 #include "test/lib/tmpdir.hh"
 
 #include "utils/cached_file.hh"
+#include "db/cache_tracker.hh"
 
 using namespace seastar;
 
@@ -281,6 +282,54 @@ SEASTAR_THREAD_TEST_CASE(test_eviction_via_lru) {
     }
 }
 
+SEASTAR_THREAD_TEST_CASE(test_pinned_pages) {
+    test_file tf = make_test_file(cached_file::page_size * 2 + 12);
+    cache_tracker tracker;
+    auto table = tracker.get_index_cache_table(table_id::create_random_id());
+    table->set_pinned(true);
+
+    {
+        cached_file_stats metrics;
+        logalloc::region region;
+        lru pin_lru;
+        cached_file cf(tf.f, table, metrics, pin_lru, region, tf.contents.size());
+
+        BOOST_REQUIRE_EQUAL(tf.contents, read_to_string(cf, 0));
+        BOOST_REQUIRE_EQUAL(cf.cached_bytes(), pin_lru.pinned_bytes());
+        BOOST_REQUIRE_EQUAL(cf.cached_bytes(), table->file_stats.cached_bytes);
+        BOOST_REQUIRE_EQUAL(3, table->file_stats.page_misses);
+
+        // Pinned pages are not evicted in LRU order.
+        with_allocator(region.allocator(), [&] {
+            BOOST_REQUIRE(pin_lru.evict() == memory::reclaiming_result::reclaimed_nothing);
+        });
+        BOOST_REQUIRE_EQUAL(tf.contents, read_to_string(cf, 0));
+        BOOST_REQUIRE_EQUAL(3, metrics.page_hits);
+        BOOST_REQUIRE_EQUAL(3, table->file_stats.page_hits);
+        BOOST_REQUIRE_EQUAL(0, table->file_stats.page_evictions);
+
+        table->set_pinned(false);
+        cf.update_pinning();
+        BOOST_REQUIRE_EQUAL(0, pin_lru.pinned_bytes());
+        with_allocator(region.allocator(), [&] {
+            BOOST_REQUIRE(pin_lru.evict() == memory::reclaiming_result::reclaimed_something);
+        });
+        BOOST_REQUIRE_EQUAL(1, table->file_stats.page_evictions);
+        BOOST_REQUIRE_EQUAL(cf.cached_bytes(), table->file_stats.cached_bytes);
+
+        table->set_pinned(true);
+        cf.update_pinning();
+        BOOST_REQUIRE_EQUAL(cf.cached_bytes(), pin_lru.pinned_bytes());
+        with_allocator(region.allocator(), [&] {
+            BOOST_REQUIRE(pin_lru.evict_pinned() == memory::reclaiming_result::reclaimed_something);
+        });
+        BOOST_REQUIRE_EQUAL(cf.cached_bytes(), pin_lru.pinned_bytes());
+        BOOST_REQUIRE_EQUAL(2, table->file_stats.page_evictions);
+        BOOST_REQUIRE_EQUAL(2, metrics.page_evictions);
+    }
+    BOOST_REQUIRE_EQUAL(0, table->file_stats.cached_bytes);
+}
+
 // A file which serves garbage but is very fast.
 class garbage_file_impl : public file_impl {
 private:
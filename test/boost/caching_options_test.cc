@@ -35,3 +35,38 @@ BOOST_AUTO_TEST_CASE(test_caching_options) {
         BOOST_REQUIRE_THROW(caching_options::from_sstring(in_str), std::exception);
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_caching_options_admission) {
+    using string_map = std::map<sstring, sstring>;
+    {
+        caching_options co = caching_options::from_map({{"keys", "ALL"}, {"rows_per_partition", "ALL"}});
+        BOOST_REQUIRE(!co.frequency_based_admission());
+        // The default is not serialized, so that schemas of existing tables don't change.
+        BOOST_REQUIRE(!co.to_map().contains("admission"));
+    }
+    {
+        string_map in_map = {{"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"admission", "FREQUENT"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(co.frequency_based_admission());
+        BOOST_REQUIRE(in_map == co.to_map());
+        BOOST_REQUIRE(co == caching_options::from_sstring(co.to_sstring()));
+    }
+    BOOST_REQUIRE_THROW(caching_options::from_map({{"admission", "SOMETIMES"}}), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(test_caching_options_index) {
+    using string_map = std::map<sstring, sstring>;
+    {
+        caching_options co = caching_options::from_map({{"keys", "ALL"}, {"rows_per_partition", "ALL"}});
+        BOOST_REQUIRE(!co.index_pinned());
+        BOOST_REQUIRE(!co.to_map().contains("index"));
+    }
+    {
+        string_map in_map = {{"keys", "ALL"}, {"rows_per_partition", "ALL"}, {"index", "PINNED"}};
+        caching_options co = caching_options::from_map(in_map);
+        BOOST_REQUIRE(co.index_pinned());
+        BOOST_REQUIRE(in_map == co.to_map());
+        BOOST_REQUIRE(co == caching_options::from_sstring(co.to_sstring()));
+    }
+    BOOST_REQUIRE_THROW(caching_options::from_map({{"index", "ALWAYS"}}), std::exception);
+}
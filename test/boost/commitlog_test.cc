@@ -103,6 +103,65 @@ SEASTAR_TEST_CASE(test_commitlog_written_to_disk_batch){
         });
 }
 
+// check that concurrent writes in group mode are all flushed, sharing syncs
+SEASTAR_TEST_CASE(test_commitlog_written_to_disk_group){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::GROUP;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        constexpr size_t n = 100;
+        sstring tmp = "hej bubba cow";
+        auto uuid = make_table_id();
+        std::vector<future<db::rp_handle>> writes;
+        for (size_t i = 0; i < n; ++i) {
+            writes.push_back(log.add_mutation(uuid, tmp.size(), db::commitlog::force_sync::no, [tmp](db::commitlog::output& dst) {
+                dst.write(tmp.data(), tmp.size());
+            }));
+        }
+        auto handles = co_await when_all_succeed(writes.begin(), writes.end());
+        std::set<db::replay_position> rps;
+        for (auto& h : handles) {
+            rps.insert(h.rp());
+        }
+        BOOST_REQUIRE_EQUAL(rps.size(), n);
+        BOOST_REQUIRE_GT(log.get_flush_count(), 0);
+        BOOST_REQUIRE_GT(log.get_num_group_commits(), 0);
+        BOOST_REQUIRE_LE(log.get_num_group_commits(), n / 2);
+    });
+}
+
+// check that allocations waiting for memory don't make a group mode sync wait for them
+SEASTAR_TEST_CASE(test_commitlog_group_window_ignores_blocked_allocations){
+    commitlog::config cfg;
+    cfg.mode = commitlog::sync_mode::GROUP;
+    cfg.commitlog_segment_size_in_mb = 1;
+    cfg.commitlog_sync_group_window_max_in_us = 1000000;
+    return cl_test(cfg, [](commitlog& log) -> future<> {
+        auto uuid = make_table_id();
+        auto write = [&log, uuid] (size_t size) {
+            return log.add_mutation(uuid, size, db::commitlog::force_sync::no, [size] (db::commitlog::output& dst) {
+                dst.fill('x', size);
+            });
+        };
+        // Give the syncs a latency to size the window from.
+        for (int i = 0; i < 10; ++i) {
+            co_await write(128);
+        }
+        BOOST_REQUIRE_GT(log.get_num_group_commits(), 0);
+
+        // The memory of the commitlog fits two of these, the next ones wait for it,
+        // until the buffer holding the first two is written.
+        constexpr size_t size = 300 * 1024;
+        std::vector<future<db::rp_handle>> writes;
+        for (int i = 0; i < 4; ++i) {
+            writes.push_back(write(size));
+        }
+        BOOST_REQUIRE_GT(log.get_pending_allocations(), 0);
+        BOOST_REQUIRE_EQUAL(log.get_num_active_allocations(), 4);
+        BOOST_REQUIRE_EQUAL(log.get_group_commit_window().count(), 0);
+        co_await when_all_succeed(writes.begin(), writes.end());
+    });
+}
+
 // check that an entry marked as sync is immediately flushed to a storage
 SEASTAR_TEST_CASE(test_commitlog_written_to_disk_sync){
     commitlog::config cfg;
@@ -417,6 +476,51 @@ SEASTAR_TEST_CASE(test_commitlog_reader){
         });
 }
 
+static future<> test_commitlog_compression(commitlog::compression compression) {
+    commitlog::config cfg;
+    cfg.commitlog_segment_size_in_mb = 1;
+    cfg.chunk_compression = compression;
+    return cl_test(cfg, [] (commitlog& log) -> future<> {
+        auto uuid = make_table_id();
+        // Enough to span a few segments, and to need several compression blocks per chunk.
+        std::map<db::replay_position, sstring> written;
+        rp_set set;
+        for (int i = 0; i < 5000; ++i) {
+            auto data = format("{}:{}", i, sstring(200 + i % 100, 'x'));
+            auto h = co_await log.add_mutation(uuid, data.size(), db::commitlog::force_sync::no, [data] (db::commitlog::output& dst) {
+                dst.write(data.data(), data.size());
+            });
+            written.emplace(h.rp(), data);
+            set.put(std::move(h));
+        }
+        co_await log.sync_all_segments();
+
+        auto segments = log.get_active_segment_names();
+        BOOST_REQUIRE(segments.size() > 1);
+        std::map<db::replay_position, sstring> read;
+        for (auto& segment : segments) {
+            commitlog::descriptor desc(segment, db::commitlog::descriptor::FILENAME_PREFIX);
+            BOOST_REQUIRE_EQUAL(desc.ver, commitlog::descriptor::segment_version_3);
+            co_await db::commitlog::read_log_file(segment, db::commitlog::descriptor::FILENAME_PREFIX, [&read] (db::commitlog::buffer_and_replay_position buf_rp) {
+                auto&& [buf, rp] = buf_rp;
+                auto linearization_buffer = bytes_ostream();
+                auto in = buf.get_istream();
+                read.emplace(rp, sstring(to_sstring_view(in.read_bytes_view(buf.size_bytes(), linearization_buffer))));
+                return make_ready_future<>();
+            });
+        }
+        BOOST_REQUIRE(read == written);
+    });
+}
+
+SEASTAR_TEST_CASE(test_commitlog_lz4_compression) {
+    return test_commitlog_compression(commitlog::compression::LZ4);
+}
+
+SEASTAR_TEST_CASE(test_commitlog_zstd_compression) {
+    return test_commitlog_compression(commitlog::compression::ZSTD);
+}
+
 static future<> corrupt_segment(sstring seg, uint64_t off, uint32_t value) {
     return open_file_dma(seg, open_flags::rw).then([off, value](file f) {
         size_t size = align_up<size_t>(off, 4096);
@@ -660,6 +764,62 @@ SEASTAR_TEST_CASE(test_commitlog_replay_invalid_key){
     });
 }
 
+// check that replay applies all the mutations of a segment, even when they
+// are more than fit in a single batch sent to a shard
+SEASTAR_TEST_CASE(test_commitlog_replay_many_mutations){
+    return do_with_cql_env_thread([] (cql_test_env& env) {
+        env.execute_cql("create table t (pk text primary key, v text)").get();
+
+        auto& db = env.local_db();
+        auto& table = db.find_column_family("ks", "t");
+        auto& cl = *table.commitlog();
+        auto s = table.schema();
+        auto& sharder = table.get_effective_replication_map()->get_sharder(*table.schema());
+        auto memtables = table.active_memtables();
+
+        // Only the memtables of this shard are checked below.
+        size_t n = 0;
+        for (size_t i = 0; n < 1000; ++i) {
+            auto md = tests::data_model::mutation_description({to_bytes(format("key{}", i))});
+            md.add_clustered_cell({}, "v", to_bytes("val"));
+            auto m = md.build(s);
+            if (sharder.shard_of(m.token()) != this_shard_id()) {
+                continue;
+            }
+            ++n;
+
+            auto fm = freeze(m);
+            commitlog_entry_writer cew(s, fm, db::commitlog::force_sync::no);
+            cl.add_entry(m.column_family_id(), cew, db::no_timeout).get();
+        }
+
+        BOOST_REQUIRE(std::ranges::all_of(memtables, std::mem_fn(&replica::memtable::empty)));
+
+        {
+            auto paths = cl.get_active_segment_names();
+            BOOST_REQUIRE(!paths.empty());
+            auto rp = db::commitlog_replayer::create_replayer(env.db(), env.get_system_keyspace()).get0();
+            rp.recover(paths, db::commitlog::descriptor::FILENAME_PREFIX).get();
+        }
+
+        {
+            std::vector<flat_mutation_reader_v2> readers;
+            readers.reserve(memtables.size());
+            auto permit = db.get_reader_concurrency_semaphore().make_tracking_only_permit(s.get(), "test", db::no_timeout, {});
+            for (auto mt : memtables) {
+                readers.push_back(mt->make_flat_reader(s, permit));
+            }
+            auto rd = make_combined_reader(s, permit, std::move(readers));
+            auto close_rd = deferred_close(rd);
+            size_t partitions = 0;
+            while (read_mutation_from_flat_mutation_reader(rd).get0()) {
+                ++partitions;
+            }
+            BOOST_REQUIRE_EQUAL(partitions, n);
+        }
+    });
+}
+
 using namespace std::chrono_literals;
 
 SEASTAR_TEST_CASE(test_commitlog_add_entries) {
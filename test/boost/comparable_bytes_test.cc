@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+
+#include "test/lib/random_utils.hh"
+#include "comparable_bytes.hh"
+#include "schema/schema_builder.hh"
+#include "dht/i_partitioner.hh"
+
+namespace {
+
+schema_ptr make_schema() {
+    return schema_builder("ks", "cf")
+            .with_column("pk1", utf8_type, column_kind::partition_key)
+            .with_column("pk2", int32_type, column_kind::partition_key)
+            .with_column("ck1", int32_type, column_kind::clustering_key)
+            .with_column("ck2", reversed_type_impl::get_instance(utf8_type), column_kind::clustering_key)
+            .with_column("ck3", reversed_type_impl::get_instance(long_type), column_kind::clustering_key)
+            .with_column("ck4", bytes_type, column_kind::clustering_key)
+            .with_column("v", int32_type)
+            .build();
+}
+
+// Small domains, so that equal components and shared prefixes are frequent.
+bytes random_component(size_t idx) {
+    switch (idx) {
+    case 0:
+        if (tests::random::get_int(0, 20) == 0) {
+            return bytes();
+        }
+        return int32_type->decompose(std::array<int32_t, 5>{std::numeric_limits<int32_t>::min(), -1, 0, 1,
+                std::numeric_limits<int32_t>::max()}[tests::random::get_int(0, 4)]);
+    case 1:
+        return utf8_type->decompose(tests::random::get_sstring(tests::random::get_int(0, 3)));
+    case 2:
+        if (tests::random::get_int(0, 20) == 0) {
+            return bytes();
+        }
+        return long_type->decompose(tests::random::get_int<int64_t>(-2, 2));
+    default: {
+        auto b = tests::random::get_bytes(tests::random::get_int(0, 3));
+        for (auto& c : b) {
+            c = tests::random::get_int(0, 2) - 1;
+        }
+        return b;
+    }
+    }
+}
+
+clustering_key_prefix random_prefix(const schema& s) {
+    std::vector<bytes> components;
+    auto n = tests::random::get_int<size_t>(0, s.clustering_key_size());
+    for (size_t i = 0; i < n; ++i) {
+        components.push_back(random_component(i));
+    }
+    return clustering_key_prefix::from_exploded(s, std::move(components));
+}
+
+position_in_partition random_position(const schema& s) {
+    switch (tests::random::get_int(0, 9)) {
+    case 0: return position_in_partition(position_in_partition::partition_start_tag_t());
+    case 1: return position_in_partition(position_in_partition::static_row_tag_t());
+    case 2: return position_in_partition(position_in_partition::end_of_partition_tag_t());
+    default: {
+        auto w = bound_weight(tests::random::get_int(-1, 1));
+        return position_in_partition(partition_region::clustered, w, random_prefix(s));
+    }
+    }
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_supported_types) {
+    BOOST_REQUIRE(comparable_bytes::is_byte_comparable(*int32_type));
+    BOOST_REQUIRE(comparable_bytes::is_byte_comparable(*utf8_type));
+    BOOST_REQUIRE(comparable_bytes::is_byte_comparable(*reversed_type_impl::get_instance(bytes_type)));
+    BOOST_REQUIRE(!comparable_bytes::is_byte_comparable(*double_type));
+    BOOST_REQUIRE(!comparable_bytes::is_byte_comparable(*uuid_type));
+
+    auto s = make_schema();
+    BOOST_REQUIRE(comparable_bytes::clustering_key_is_byte_comparable(*s));
+    auto s2 = schema_builder("ks", "cf2")
+            .with_column("pk", utf8_type, column_kind::partition_key)
+            .with_column("ck", timeuuid_type, column_kind::clustering_key)
+            .build();
+    BOOST_REQUIRE(!comparable_bytes::clustering_key_is_byte_comparable(*s2));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_position_order_matches_tri_compare) {
+    auto s = make_schema();
+    position_in_partition::tri_compare cmp(*s);
+    std::vector<position_in_partition> positions;
+    for (int i = 0; i < 500; ++i) {
+        positions.push_back(random_position(*s));
+    }
+    std::vector<bytes> encoded;
+    for (auto& p : positions) {
+        encoded.push_back(comparable_bytes::encode_position(*s, p));
+    }
+    for (size_t i = 0; i < positions.size(); ++i) {
+        for (size_t j = 0; j < positions.size(); ++j) {
+            auto expected = cmp(positions[i], positions[j]);
+            auto actual = comparable_bytes::tri_compare(encoded[i], encoded[j]);
+            if (expected != actual) {
+                BOOST_FAIL(format("order mismatch for {} and {}: expected {}, got {}", positions[i], positions[j],
+                        expected < 0 ? -1 : expected > 0, actual < 0 ? -1 : actual > 0));
+            }
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_prefix_order_matches_less_compare) {
+    auto s = make_schema();
+    clustering_key_prefix::less_compare less(*s);
+    std::vector<clustering_key_prefix> prefixes;
+    for (int i = 0; i < 300; ++i) {
+        prefixes.push_back(random_prefix(*s));
+    }
+    for (auto& a : prefixes) {
+        auto ea = comparable_bytes::encode_clustering_prefix(*s, a);
+        for (auto& b : prefixes) {
+            auto eb = comparable_bytes::encode_clustering_prefix(*s, b);
+            BOOST_REQUIRE_EQUAL(less(a, b), comparable_bytes::tri_compare(ea, eb) < 0);
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_decorated_key_order_matches_tri_compare) {
+    auto s = make_schema();
+    std::vector<dht::decorated_key> keys;
+    for (int i = 0; i < 300; ++i) {
+        auto pk = partition_key::from_exploded(*s, {
+            utf8_type->decompose(tests::random::get_sstring(tests::random::get_int(0, 3))),
+            int32_type->decompose(tests::random::get_int<int32_t>(-1, 1)),
+        });
+        keys.push_back(dht::decorate_key(*s, pk));
+    }
+    for (auto& a : keys) {
+        auto ea = comparable_bytes::encode_decorated_key(*s, a);
+        for (auto& b : keys) {
+            auto eb = comparable_bytes::encode_decorated_key(*s, b);
+            BOOST_REQUIRE(a.tri_compare(*s, b) == comparable_bytes::tri_compare(ea, eb));
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_token_order_matches_tri_compare) {
+    std::vector<dht::token> tokens = {
+        dht::token::from_int64(std::numeric_limits<int64_t>::min() + 1),
+        dht::token::from_int64(-1),
+        dht::token::from_int64(0),
+        dht::token::from_int64(1),
+        dht::token::from_int64(std::numeric_limits<int64_t>::max()),
+    };
+    for (int i = 0; i < 300; ++i) {
+        tokens.push_back(dht::token::from_int64(tests::random::get_int<int64_t>()));
+    }
+    for (auto& a : tokens) {
+        auto ea = comparable_bytes::encode_token(a);
+        for (auto& b : tokens) {
+            auto eb = comparable_bytes::encode_token(b);
+            BOOST_REQUIRE(a <=> b == comparable_bytes::tri_compare(ea, eb));
+        }
+    }
+}
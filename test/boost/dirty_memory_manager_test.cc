@@ -263,6 +263,35 @@ SEASTAR_TEST_CASE(test_region_groups_basic_throttling) {
     });
 }
 
+SEASTAR_TEST_CASE(test_region_groups_blocked_requests_time) {
+    return seastar::async([] {
+        raii_region_group simple({ .unspooled_hard_limit = logalloc::segment_size });
+        auto big_region = std::make_unique<test_region>();
+        big_region->listen(&simple);
+        big_region->alloc();
+
+        auto fut = simple.run_when_memory_available([] {}, db::no_timeout);
+        BOOST_REQUIRE_EQUAL(fut.available(), false);
+        BOOST_REQUIRE_EQUAL(simple.blocked_requests_counter(), 1);
+        // Only accounted once the request is no longer blocked.
+        BOOST_REQUIRE(simple.blocked_requests_time() == std::chrono::steady_clock::duration::zero());
+
+        sleep(std::chrono::milliseconds(10)).get();
+        big_region.reset();
+        quiesce(std::move(fut));
+        BOOST_REQUIRE(simple.blocked_requests_time() >= std::chrono::milliseconds(10));
+
+        // Requests which time out are accounted as well.
+        auto time_before = simple.blocked_requests_time();
+        big_region = std::make_unique<test_region>();
+        big_region->listen(&simple);
+        big_region->alloc();
+        fut = simple.run_when_memory_available([] {}, db::timeout_clock::now() + std::chrono::milliseconds(10));
+        BOOST_REQUIRE_THROW(fut.get(), timed_out_error);
+        BOOST_REQUIRE(simple.blocked_requests_time() > time_before);
+    });
+}
+
 SEASTAR_TEST_CASE(test_region_groups_fifo_order) {
     // tests that requests that are queued for later execution execute in FIFO order
     return seastar::async([] {
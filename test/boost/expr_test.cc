@@ -21,6 +21,7 @@
 #include "test/lib/expr_test_utils.hh"
 #include "cql3/expr/evaluate.hh"
 #include "cql3/expr/expr-utils.hh"
+#include "cql3/expr/column_filter.hh"
 #include "cql3/functions/aggregate_fcts.hh"
 
 using namespace cql3;
@@ -4671,3 +4672,116 @@ BOOST_AUTO_TEST_CASE(test_levellize_aggregation_depth) {
     // Somewhat fragile, but easiest way to test entire structure
     BOOST_REQUIRE_EQUAL(fmt::format("{:debug}", e2), "foo.my_agg(system.sum(system.$$first$$(r)), system.$$first$$(system.$$first$$(TTL(r))))");
 }
+
+// Creates a schema with a regular column r of the given type, for testing column_filter.
+static schema_ptr make_column_filter_test_schema(data_type type) {
+    return schema_builder("test_ks", "test_cf")
+        .with_column("pk", int32_type, column_kind::partition_key)
+        .with_column("r", std::move(type), column_kind::regular_column)
+        .build();
+}
+
+// Checks that restr compiles to a column_filter which agrees with is_satisfied_by() for all values of r.
+static void check_column_filter(const schema_ptr& schema, const expression& restr, const std::vector<raw_value>& values,
+                                const std::vector<raw_value>& bind_values = {}) {
+    const column_definition& r = *schema->get_column_definition("r");
+    for (const raw_value& value : values) {
+        auto [inputs, inputs_data] = make_evaluation_inputs(schema, {{"pk", make_int_raw(0)}, {"r", value}}, bind_values);
+        auto filter = column_filter::compile(r, restr, *inputs.options);
+        BOOST_REQUIRE(filter);
+        BOOST_REQUIRE_EQUAL((*filter)(inputs.static_and_regular_columns[0]), is_satisfied_by(restr, inputs));
+    }
+}
+
+static const std::vector<oper_t> column_filter_test_ops = {oper_t::EQ, oper_t::NEQ, oper_t::LT, oper_t::LTE, oper_t::GT, oper_t::GTE};
+
+BOOST_AUTO_TEST_CASE(column_filter_int) {
+    schema_ptr schema = make_column_filter_test_schema(int32_type);
+    expression r = column_value(schema->get_column_definition("r"));
+    std::vector<raw_value> values = {make_int_raw(std::numeric_limits<int32_t>::min()), make_int_raw(-1), make_int_raw(0),
+                                     make_int_raw(4), make_int_raw(5), make_int_raw(6),
+                                     make_int_raw(std::numeric_limits<int32_t>::max()), raw_value::make_null(), make_empty_raw()};
+
+    for (oper_t op : column_filter_test_ops) {
+        for (int32_t c : {std::numeric_limits<int32_t>::min(), 5, std::numeric_limits<int32_t>::max()}) {
+            check_column_filter(schema, binary_operator(r, op, make_int_const(c)), values);
+        }
+    }
+    check_column_filter(schema, conjunction{.children = {binary_operator(r, oper_t::GT, make_int_const(-1)),
+                                                         binary_operator(r, oper_t::LTE, make_int_const(5)),
+                                                         binary_operator(r, oper_t::NEQ, make_int_const(4))}},
+                        values);
+    check_column_filter(schema, conjunction{.children = {binary_operator(r, oper_t::GT, make_int_const(5)),
+                                                         binary_operator(r, oper_t::LT, make_int_const(5))}},
+                        values);
+}
+
+BOOST_AUTO_TEST_CASE(column_filter_bigint_bind_variables) {
+    schema_ptr schema = make_column_filter_test_schema(long_type);
+    expression r = column_value(schema->get_column_definition("r"));
+    std::vector<raw_value> values = {make_bigint_raw(std::numeric_limits<int64_t>::min()), make_bigint_raw(-10), make_bigint_raw(0),
+                                     make_bigint_raw(10), make_bigint_raw(std::numeric_limits<int64_t>::max()),
+                                     raw_value::make_null(), make_empty_raw()};
+    expression restr = conjunction{.children = {binary_operator(r, oper_t::GTE, make_bind_variable(0, long_type)),
+                                                binary_operator(r, oper_t::LT, make_bind_variable(1, long_type))}};
+
+    check_column_filter(schema, restr, values, {make_bigint_raw(-10), make_bigint_raw(10)});
+    check_column_filter(schema, restr, values, {make_bigint_raw(std::numeric_limits<int64_t>::min()), make_bigint_raw(std::numeric_limits<int64_t>::min())});
+    check_column_filter(schema, restr, values, {raw_value::make_null(), make_bigint_raw(10)});
+}
+
+BOOST_AUTO_TEST_CASE(column_filter_timestamp) {
+    schema_ptr schema = make_column_filter_test_schema(timestamp_type);
+    expression r = column_value(schema->get_column_definition("r"));
+    auto make_timestamp_raw = [] (int64_t millis) {
+        return raw_value::make_value(timestamp_type->decompose(db_clock::time_point(db_clock::duration(millis))));
+    };
+    std::vector<raw_value> values = {make_timestamp_raw(-1000), make_timestamp_raw(0), make_timestamp_raw(1000),
+                                     make_timestamp_raw(1700000000000), raw_value::make_null(), make_empty_raw()};
+
+    for (oper_t op : column_filter_test_ops) {
+        check_column_filter(schema, binary_operator(r, op, constant(make_timestamp_raw(1000), timestamp_type)), values);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(column_filter_double) {
+    schema_ptr schema = make_column_filter_test_schema(double_type);
+    expression r = column_value(schema->get_column_definition("r"));
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    std::vector<raw_value> values = {make_double_raw(-inf), make_double_raw(-1.5), make_double_raw(-0.0),
+                                     make_double_raw(0.0), make_double_raw(1.5), make_double_raw(inf),
+                                     make_double_raw(std::numeric_limits<double>::quiet_NaN()),
+                                     raw_value::make_null(), make_empty_raw()};
+
+    for (oper_t op : column_filter_test_ops) {
+        for (double c : {-inf, -1.5, -0.0, 0.0, 1.5, inf}) {
+            check_column_filter(schema, binary_operator(r, op, make_double_const(c)), values);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(column_filter_not_compiled) {
+    schema_ptr schema = make_column_filter_test_schema(int32_type);
+    const column_definition& r_def = *schema->get_column_definition("r");
+    expression r = column_value(&r_def);
+    auto [inputs, inputs_data] = make_evaluation_inputs(schema, {{"pk", make_int_raw(0)}, {"r", make_int_raw(1)}});
+
+    BOOST_REQUIRE(!column_filter::compile(r_def, binary_operator(r, oper_t::IN, make_int_list_const({1, 2})), *inputs.options));
+    BOOST_REQUIRE(!column_filter::compile(r_def, binary_operator(r, oper_t::LT, r), *inputs.options));
+    BOOST_REQUIRE(!column_filter::compile(r_def, binary_operator(r, oper_t::EQ, make_empty_const(int32_type)), *inputs.options));
+    // One restriction which can't be compiled makes the whole conjunction evaluated by is_satisfied_by().
+    BOOST_REQUIRE(!column_filter::compile(r_def, conjunction{.children = {binary_operator(r, oper_t::GT, make_int_const(0)),
+                                                                          binary_operator(r, oper_t::LT, r)}},
+                                          *inputs.options));
+
+    schema_ptr double_schema = make_column_filter_test_schema(double_type);
+    const column_definition& d_def = *double_schema->get_column_definition("r");
+    BOOST_REQUIRE(!column_filter::compile(d_def, binary_operator(column_value(&d_def), oper_t::EQ,
+                                                                 make_double_const(std::numeric_limits<double>::quiet_NaN())),
+                                          *inputs.options));
+
+    schema_ptr text_schema = make_column_filter_test_schema(utf8_type);
+    const column_definition& t_def = *text_schema->get_column_definition("r");
+    BOOST_REQUIRE(!column_filter::compile(t_def, binary_operator(column_value(&t_def), oper_t::EQ, make_text_const("a")),
+                                          *inputs.options));
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include "utils/frequency_sketch.hh"
+
+static uint64_t key_hash(uint64_t k) {
+    // splitmix64
+    k += 0x9e3779b97f4a7c15ull;
+    k = (k ^ (k >> 30)) * 0xbf58476d1ce4e5b9ull;
+    k = (k ^ (k >> 27)) * 0x94d049bb133111ebull;
+    return k ^ (k >> 31);
+}
+
+BOOST_AUTO_TEST_CASE(test_frequency_sketch_estimates) {
+    utils::frequency_sketch sketch(1024);
+    BOOST_REQUIRE_EQUAL(sketch.estimate(key_hash(1)), 0);
+
+    for (unsigned i = 0; i < 5; ++i) {
+        sketch.increment(key_hash(1));
+    }
+    // Keys accessed once, as by a scan.
+    for (uint64_t k = 100; k < 400; ++k) {
+        sketch.increment(key_hash(k));
+    }
+    // Counting never underestimates, and saturates.
+    BOOST_REQUIRE_GE(sketch.estimate(key_hash(1)), 5);
+    size_t overestimated = 0;
+    for (uint64_t k = 100; k < 400; ++k) {
+        BOOST_REQUIRE_GE(sketch.estimate(key_hash(k)), 1);
+        overestimated += sketch.estimate(key_hash(k)) > 1;
+    }
+    BOOST_REQUIRE_LT(overestimated, 30);
+    BOOST_REQUIRE_LT(sketch.estimate(key_hash(100)), sketch.estimate(key_hash(1)));
+
+    for (unsigned i = 0; i < 100; ++i) {
+        sketch.increment(key_hash(2));
+    }
+    BOOST_REQUIRE_EQUAL(sketch.estimate(key_hash(2)), utils::frequency_sketch::max_frequency);
+}
+
+BOOST_AUTO_TEST_CASE(test_frequency_sketch_aging) {
+    utils::frequency_sketch sketch(64);
+    for (unsigned i = 0; i < 8; ++i) {
+        sketch.increment(key_hash(1));
+    }
+    BOOST_REQUIRE_EQUAL(sketch.resets(), 0);
+    auto before = sketch.estimate(key_hash(1));
+
+    // Enough other accesses to halve the counters once.
+    std::mt19937_64 rnd(0);
+    uint64_t k = 1000;
+    while (sketch.resets() == 0) {
+        sketch.increment(key_hash(k++ + rnd() % 1000000));
+    }
+    BOOST_REQUIRE_LE(sketch.estimate(key_hash(1)), before / 2 + 1);
+}
@@ -1109,6 +1109,46 @@ SEASTAR_TEST_CASE(failed_flush_prevents_writes) {
 #endif
 }
 
+SEASTAR_TEST_CASE(flushes_run_concurrently) {
+#ifndef SCYLLA_ENABLE_ERROR_INJECTION
+    std::cerr << "Skipping test as it depends on error injection. Please run in mode where it's enabled (debug,dev).\n";
+    return make_ready_future<>();
+#else
+    auto db_config = make_shared<db::config>();
+    db_config->memtable_flush_writers.set(2);
+    return do_with_cql_env_thread([](cql_test_env& env) {
+        env.execute_cql("CREATE TABLE ks.t1 (pk int PRIMARY KEY, v int)").get();
+        env.execute_cql("CREATE TABLE ks.t2 (pk int PRIMARY KEY, v int)").get();
+        replica::table& t1 = env.local_db().find_column_family("ks", "t1");
+        replica::table& t2 = env.local_db().find_column_family("ks", "t2");
+        for (auto* t : {&t1, &t2}) {
+            mutation m(t->schema(), tests::generate_partition_key(t->schema()));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("v"), data_value(int32_t(1)), api::new_timestamp());
+            t->apply(m);
+        }
+
+        // The first flush holds its sstable write permit until it is released.
+        utils::get_local_injector().enable("table_seal_active_memtable_pause_flush", true /* oneshot */);
+        auto f1 = t1.flush();
+        auto release = defer([] {
+            utils::get_local_injector().receive_message("table_seal_active_memtable_pause_flush");
+        });
+
+        // With two flush writers, the second flush doesn't wait for it.
+        BOOST_REQUIRE(eventually_true([&] {
+            return t2.min_memtable_timestamp() == api::max_timestamp;
+        }));
+        BOOST_REQUIRE(!f1.available());
+        BOOST_REQUIRE(t1.min_memtable_timestamp() < api::max_timestamp);
+
+        release.cancel();
+        utils::get_local_injector().receive_message("table_seal_active_memtable_pause_flush");
+        std::move(f1).get();
+        BOOST_REQUIRE(t1.min_memtable_timestamp() == api::max_timestamp);
+    }, db_config);
+#endif
+}
+
 SEASTAR_TEST_CASE(flushing_rate_is_reduced_if_compaction_doesnt_keep_up) {
     BOOST_ASSERT(smp::count == 2);
     // The test simulates a situation where 2 threads issue flushes to 2
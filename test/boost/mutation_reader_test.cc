@@ -55,6 +55,7 @@
 #include "readers/empty_v2.hh"
 #include "readers/next_partition_adaptor.hh"
 #include "readers/combined.hh"
+#include "comparable_bytes.hh"
 #include "readers/compacting.hh"
 #include "readers/foreign.hh"
 #include "readers/filtering.hh"
@@ -1225,6 +1226,11 @@ SEASTAR_TEST_CASE(test_combined_mutation_source_is_a_mutation_source) {
         run_mutation_source_tests(make_combined_populator(1));
         run_mutation_source_tests(make_combined_populator(2));
         run_mutation_source_tests(make_combined_populator(3));
+
+        // Merge the fragments by their encoded positions, for the schemas which support it.
+        comparable_bytes::global_byte_comparable_keys = true;
+        auto reset_byte_comparable_keys = defer([] { comparable_bytes::global_byte_comparable_keys = false; });
+        run_mutation_source_tests(make_combined_populator(3));
     });
 }
 
@@ -1999,6 +1999,53 @@ SEASTAR_THREAD_TEST_CASE(test_row_merging) {
     BOOST_REQUIRE(r1.equal(column_kind::regular_column, s, r3_backup, s));
 }
 
+SEASTAR_THREAD_TEST_CASE(test_apply_monotonically_appends_rows_in_order) {
+    simple_schema table;
+    auto&& s = *table.schema();
+    auto pk = table.make_pkey(0);
+
+    auto check = [&] (bool with_last_dummy) {
+        mutation expected(table.schema(), pk);
+        mutation_partition_v2 target(s);
+        if (with_last_dummy) {
+            target.ensure_last_dummy(s);
+        }
+        mutation_application_stats app_stats;
+
+        auto apply_row = [&] (uint32_t ck) {
+            mutation m(table.schema(), pk);
+            table.add_row(m, table.make_ckey(ck), format("v{}", ck));
+            expected.apply(m);
+            apply_resume res;
+            target.apply_monotonically(s, s, mutation_partition_v2(s, m.partition()), no_cache_tracker, app_stats,
+                    never_preempt(), res, is_evictable::no);
+        };
+
+        // The first row has nothing to be appended to.
+        for (uint32_t ck = 0; ck < 100; ck += 2) {
+            apply_row(ck);
+        }
+        BOOST_REQUIRE_EQUAL(app_stats.rows_appended, 49);
+
+        // Out of order writes and overwrites fall back to the lookup.
+        apply_row(51);
+        apply_row(50);
+        apply_row(0);
+        BOOST_REQUIRE_EQUAL(app_stats.rows_appended, 49);
+
+        apply_row(100);
+        BOOST_REQUIRE_EQUAL(app_stats.rows_appended, 50);
+
+        if (with_last_dummy) {
+            BOOST_REQUIRE(std::as_const(target).clustered_rows().rbegin()->is_last_dummy());
+        }
+        assert_that(table.schema(), target).is_equal_to_compacted(expected.partition());
+    };
+
+    check(false);
+    check(true);
+}
+
 SEASTAR_TEST_CASE(test_continuity_merging) {
     return seastar::async([] {
         simple_schema table;
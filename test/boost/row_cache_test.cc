@@ -4688,3 +4688,203 @@ SEASTAR_TEST_CASE(test_compact_range_tombstones_on_read) {
         BOOST_REQUIRE(tracker_stats.rows_compacted_away == 2);
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_packing_of_cold_partitions) {
+    simple_schema s;
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    cache_tracker tracker;
+    memtable_snapshot_source underlying(s.schema());
+
+    auto pkey = s.make_pkey(0);
+    mutation m(s.schema(), pkey);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        s.add_row(m, s.make_ckey(i), format("v{}", i));
+    }
+    underlying.apply(m);
+
+    // Rows with tombstones can't be packed, but the rows around them can.
+    auto pkey_with_tombstone = s.make_pkey(1);
+    mutation m_with_tombstone(s.schema(), pkey_with_tombstone);
+    for (uint32_t i = 0; i < 100; ++i) {
+        s.add_row(m_with_tombstone, s.make_ckey(i), format("v{}", i));
+    }
+    m_with_tombstone.partition().apply_delete(*s.schema(), s.make_ckey(50), s.new_tombstone());
+    underlying.apply(m_with_tombstone);
+
+    row_cache cache(s.schema(), snapshot_source([&] { return underlying(); }), tracker);
+    cache.populate(m);
+    cache.populate(m_with_tombstone);
+
+    // The readers keep references to their ranges and slices.
+    std::deque<dht::partition_range> ranges;
+    std::deque<query::partition_slice> slices;
+    auto read = [&] (const dht::decorated_key& dk, query::clustering_range range = query::clustering_range::make_open_ended_both_sides()) {
+        auto& pr = ranges.emplace_back(dht::partition_range::make_singular(dk));
+        auto& slice = slices.emplace_back(partition_slice_builder(*s.schema()).with_range(std::move(range)).build());
+        return cache.make_reader(s.schema(), semaphore.make_permit(), pr, slice);
+    };
+    // Packing yields after every run in debug mode, so keep going until there is nothing left.
+    auto pack = [&] (uint32_t min_rows) {
+        size_t runs = 0;
+        while (auto n = tracker.pack_cold_partitions(min_rows, 10000)) {
+            runs += n;
+        }
+        return runs;
+    };
+    auto& stats = tracker.get_stats();
+    auto rows = stats.rows;
+
+    BOOST_REQUIRE_EQUAL(pack(2000), 0);
+    // Runs have at most 128 rows: 8 of them in the first partition,
+    // and 2, around the deleted row, in the second.
+    BOOST_REQUIRE_EQUAL(pack(10), 10);
+    BOOST_REQUIRE(cache.lookup(pkey).is_packed());
+    BOOST_REQUIRE(cache.lookup(pkey_with_tombstone).is_packed());
+    BOOST_REQUIRE_EQUAL(stats.columnar_runs, 10);
+    BOOST_REQUIRE_GT(stats.columnar_bytes, 0);
+    BOOST_REQUIRE_EQUAL(stats.rows, rows - 1099);
+
+    // A read of a single row brings back only the run which contains it,
+    // without going to the underlying source.
+    auto misses = stats.reads_with_misses;
+    auto ck = s.make_ckey(300);
+    assert_that(read(pkey, query::clustering_range::make_singular(ck)))
+        .produces(m.sliced({query::clustering_range::make_singular(ck)}))
+        .produces_end_of_stream();
+    BOOST_REQUIRE_EQUAL(stats.reads_with_misses, misses);
+    BOOST_REQUIRE_EQUAL(stats.columnar_runs_unpacked, 1);
+    BOOST_REQUIRE_EQUAL(stats.columnar_runs, 9);
+    BOOST_REQUIRE_EQUAL(stats.rows, rows - 1099 + 128);
+
+    // A full read unpacks runs until it should yield, and reads the rest from the underlying source.
+    assert_that(read(pkey)).produces(m).produces_end_of_stream();
+    BOOST_REQUIRE(!cache.lookup(pkey).is_packed());
+    BOOST_REQUIRE_GE(stats.columnar_runs_unpacked, 2);
+    BOOST_REQUIRE_EQUAL(stats.columnar_runs_unpacked + stats.columnar_runs_dropped, 8);
+    assert_that(read(pkey)).produces(m).produces_end_of_stream();
+    assert_that(read(pkey_with_tombstone)).produces(m_with_tombstone).produces_end_of_stream();
+    BOOST_REQUIRE_EQUAL(stats.columnar_runs, 0);
+    BOOST_REQUIRE_EQUAL(stats.columnar_bytes, 0);
+
+    // A write drops the packed rows of the partition.
+    BOOST_REQUIRE_GT(pack(10), 0);
+    BOOST_REQUIRE(cache.lookup(pkey).is_packed());
+    BOOST_REQUIRE(cache.lookup(pkey_with_tombstone).is_packed());
+    auto dropped = stats.columnar_runs_dropped;
+    auto runs = stats.columnar_runs;
+    mutation m2(s.schema(), pkey);
+    s.add_row(m2, s.make_ckey(50), "updated");
+    s.add_row(m2, s.make_ckey(1000), "new");
+    auto mt = make_lw_shared<replica::memtable>(s.schema());
+    mt->apply(m2);
+    cache.update(row_cache::external_updater([&] { underlying.apply(m2); }), *mt).get();
+    BOOST_REQUIRE(!cache.lookup(pkey).is_packed());
+    BOOST_REQUIRE(cache.lookup(pkey_with_tombstone).is_packed());
+    BOOST_REQUIRE_EQUAL(stats.columnar_runs_dropped - dropped, runs - stats.columnar_runs);
+    assert_that(read(pkey)).produces(m + m2).produces_end_of_stream();
+
+    // Eviction drops the packed rows.
+    BOOST_REQUIRE_GT(pack(10), 0);
+    cache.evict();
+    BOOST_REQUIRE_EQUAL(stats.columnar_runs, 0);
+    BOOST_REQUIRE_EQUAL(stats.columnar_bytes, 0);
+    assert_that(read(pkey)).produces(m + m2).produces_end_of_stream();
+    assert_that(read(pkey_with_tombstone)).produces(m_with_tombstone).produces_end_of_stream();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_frequency_based_admission) {
+    simple_schema base;
+    simple_schema s(schema_builder(base.schema())
+            .set_caching_options(caching_options::from_map({{"admission", "FREQUENT"}}))
+            .build(), api::new_timestamp());
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    cache_tracker tracker;
+    auto& stats = tracker.get_stats();
+
+    memtable_snapshot_source underlying(s.schema());
+    std::vector<mutation> muts;
+    for (uint32_t i = 0; i < 3; ++i) {
+        mutation m(s.schema(), s.make_pkey(i));
+        s.add_row(m, s.make_ckey(0), "v");
+        underlying.apply(m);
+        muts.push_back(std::move(m));
+    }
+    row_cache cache(s.schema(), snapshot_source([&] { return underlying(); }), tracker);
+    auto read = [&] (row_cache& cache, const mutation& m) {
+        assert_that(cache.make_reader(m.schema(), semaphore.make_permit(), dht::partition_range::make_singular(m.decorated_key())))
+            .produces(m)
+            .produces_end_of_stream();
+    };
+
+    // Everything is admitted until the cache starts evicting.
+    read(cache, muts[0]);
+    read(cache, muts[1]);
+    BOOST_REQUIRE_EQUAL(stats.partitions, 2);
+    while (stats.partition_evictions == 0) {
+        tracker.region().evict_some();
+    }
+    BOOST_REQUIRE_EQUAL(stats.partitions, 1);
+
+    // muts[1] is next to be evicted, and was accessed 4 times.
+    for (int i = 0; i < 3; ++i) {
+        read(cache, muts[1]);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        read(cache, muts[2]);
+        BOOST_REQUIRE_EQUAL(stats.partition_admission_rejections, i + 1);
+        BOOST_REQUIRE_EQUAL(stats.partitions, 1);
+    }
+    read(cache, muts[2]);
+    BOOST_REQUIRE_EQUAL(stats.partition_admission_rejections, 4);
+    BOOST_REQUIRE_EQUAL(stats.partitions, 2);
+
+    // Tables with the default policy admit everything.
+    memtable_snapshot_source base_underlying(base.schema());
+    mutation m(base.schema(), base.make_pkey(0));
+    base.add_row(m, base.make_ckey(0), "v");
+    base_underlying.apply(m);
+    row_cache base_cache(base.schema(), snapshot_source([&] { return base_underlying(); }), tracker);
+    read(base_cache, m);
+    BOOST_REQUIRE_EQUAL(stats.partition_admission_rejections, 4);
+    BOOST_REQUIRE_EQUAL(stats.partitions, 3);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_get_hot_partitions) {
+    simple_schema s;
+    tests::reader_concurrency_semaphore_wrapper semaphore;
+    cache_tracker tracker;
+
+    memtable_snapshot_source underlying(s.schema());
+    std::vector<mutation> muts;
+    for (uint32_t i = 0; i < 4; ++i) {
+        mutation m(s.schema(), s.make_pkey(i));
+        s.add_row(m, s.make_ckey(0), "v");
+        underlying.apply(m);
+        muts.push_back(std::move(m));
+    }
+    row_cache cache(s.schema(), snapshot_source([&] { return underlying(); }), tracker);
+
+    BOOST_REQUIRE(cache.get_hot_partitions(0).get().empty());
+
+    // muts[i] is read i + 1 times, muts[3] is not in cache.
+    for (uint32_t i = 0; i < 3; ++i) {
+        for (uint32_t j = 0; j <= i; ++j) {
+            assert_that(cache.make_reader(s.schema(), semaphore.make_permit(), dht::partition_range::make_singular(muts[i].decorated_key())))
+                .produces(muts[i])
+                .produces_end_of_stream();
+        }
+    }
+
+    auto hot = cache.get_hot_partitions(0).get();
+    BOOST_REQUIRE_EQUAL(hot.size(), 3);
+    for (uint32_t i = 0; i < 3; ++i) {
+        BOOST_REQUIRE(hot[i].key.equal(*s.schema(), muts[2 - i].decorated_key()));
+        BOOST_REQUIRE_EQUAL(hot[i].frequency, 3 - i);
+    }
+
+    hot = cache.get_hot_partitions(2).get();
+    BOOST_REQUIRE_EQUAL(hot.size(), 2);
+    BOOST_REQUIRE(hot[0].key.equal(*s.schema(), muts[2].decorated_key()));
+    BOOST_REQUIRE(hot[1].key.equal(*s.schema(), muts[1].decorated_key()));
+}
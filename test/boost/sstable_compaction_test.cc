@@ -36,6 +36,7 @@
 #include "partition_slice_builder.hh"
 #include "compaction/time_window_compaction_strategy.hh"
 #include "compaction/leveled_compaction_strategy.hh"
+#include "compaction/incremental_compaction_strategy.hh"
 #include "test/lib/mutation_assertions.hh"
 #include "counters.hh"
 #include "cell_locking.hh"
@@ -1659,6 +1660,75 @@ SEASTAR_TEST_CASE(size_tiered_beyond_max_threshold_test) {
   });
 }
 
+SEASTAR_TEST_CASE(incremental_compaction_strategy_test) {
+  return test_env::do_with_async([] (test_env& env) {
+    auto s = schema_builder("tests", "incremental_compaction_strategy_test")
+            .with_column("id", utf8_type, column_kind::partition_key)
+            .with_column("value", int32_type).build();
+    auto cf = env.make_table_for_tests(s);
+    auto stop_cf = deferred_stop(cf);
+    const auto keys = tests::generate_partition_keys(4, s);
+    constexpr uint64_t MB = 1024 * 1024;
+
+    // A run with a fragment of the given size for each key.
+    auto make_run = [&] (uint64_t fragment_size) {
+        auto run_identifier = sstables::run_id::create_random_id();
+        std::vector<sstables::shared_sstable> run;
+        for (auto& key : keys) {
+            auto sst = env.make_sstable(s);
+            sstables::test(sst).set_values_for_leveled_strategy(fragment_size, 0, 0, key.key(), key.key());
+            sstables::test(sst).set_run_identifier(run_identifier);
+            run.push_back(std::move(sst));
+        }
+        return run;
+    };
+    auto get_job = [&] (const std::map<sstring, sstring>& options, const std::vector<std::vector<sstables::shared_sstable>>& runs) {
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, options);
+        std::vector<sstables::shared_sstable> candidates;
+        for (auto& run : runs) {
+            candidates.insert(candidates.end(), run.begin(), run.end());
+        }
+        auto strategy_c = make_strategy_control_for_test(false);
+        return cs.get_sstables_for_compaction(cf.as_table_state(), *strategy_c, std::move(candidates));
+    };
+    std::map<sstring, sstring> options = {{"sstable_size_in_mb", "100"}};
+
+    // Runs of similar size are compacted together, whatever their number of fragments,
+    // and the output is fragmented.
+    std::vector<std::vector<sstables::shared_sstable>> runs;
+    for (auto i = 0; i < 4; i++) {
+        runs.push_back(make_run(100 * MB));
+    }
+    runs.push_back(make_run(2000 * MB));
+    auto desc = get_job(options, runs);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 16);
+    BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, 100 * MB);
+    for (auto& sst : runs.back()) {
+        BOOST_REQUIRE(std::ranges::find(desc.sstables, sst) == desc.sstables.end());
+    }
+
+    // Runs of different tiers are compacted together only when the space amplification,
+    // here (400MB + 1000MB) / 1000MB, exceeds the goal.
+    runs = { make_run(100 * MB), make_run(250 * MB) };
+    BOOST_REQUIRE(get_job(options, runs).sstables.empty());
+    options["space_amplification_goal"] = "1.5";
+    BOOST_REQUIRE(get_job(options, runs).sstables.empty());
+    options["space_amplification_goal"] = "1.25";
+    BOOST_REQUIRE_EQUAL(get_job(options, runs).sstables.size(), 8);
+
+    // The fragments of a run, which are of similar size, aren't reshaped among themselves.
+    auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::incremental, options);
+    BOOST_REQUIRE(cs.get_reshaping_job(make_run(100 * MB), s, reshape_mode::strict).sstables.empty());
+    auto single_fragment_runs = std::vector<sstables::shared_sstable>();
+    for (auto i = 0; i < 4; i++) {
+        single_fragment_runs.push_back(make_run(100 * MB).front());
+    }
+    desc = cs.get_reshaping_job(single_fragment_runs, s, reshape_mode::strict);
+    BOOST_REQUIRE_EQUAL(desc.sstables.size(), 4);
+    BOOST_REQUIRE_EQUAL(desc.max_sstable_bytes, 100 * MB);
+  });
+}
+
 SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     return test_env::do_with_async([] (test_env& env) {
         auto make_schema = [&] (std::string_view cf, sstables::compaction_strategy_type cst) {
@@ -1760,6 +1830,28 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
             auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::size_tiered, options);
             auto descriptor = cs.get_sstables_for_compaction(stcs_table.as_table_state(), *strategy_c, { sst });
             BOOST_REQUIRE(descriptor.sstables.size() == 0);
+            descriptor = cs.get_tombstone_purge_job(stcs_table.as_table_state(), { sst });
+            BOOST_REQUIRE(descriptor.sstables.size() == 0);
+
+            // ... unless reads of it return at least as many tombstones as rows.
+            for (auto i = 0; i < 1000; i++) {
+                sst->get_stats().on_counted_row_read();
+                sst->get_stats().on_counted_tombstone_read();
+            }
+            descriptor = cs.get_tombstone_purge_job(stcs_table.as_table_state(), { sst });
+            BOOST_REQUIRE(descriptor.sstables.size() == 1);
+            BOOST_REQUIRE(descriptor.sstables.front() == sst);
+        }
+        // tombstone purge jobs are available regardless of the compaction strategy
+        {
+            cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window, options);
+            descriptor = cs.get_tombstone_purge_job(twcs_table.as_table_state(), { sst });
+            BOOST_REQUIRE(descriptor.sstables.size() == 1);
+            BOOST_REQUIRE(descriptor.sstables.front() == sst);
+            cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::leveled, options);
+            descriptor = cs.get_tombstone_purge_job(lcs_table.as_table_state(), { sst });
+            BOOST_REQUIRE(descriptor.sstables.size() == 1);
+            BOOST_REQUIRE(descriptor.sstables.front()->get_sstable_level() == 1U);
         }
         // sstable which was recently created won't be included due to min interval
         {
@@ -1773,6 +1865,77 @@ SEASTAR_TEST_CASE(sstable_expired_data_ratio) {
     });
 }
 
+SEASTAR_TEST_CASE(tombstone_purge_after_tombstone_heavy_reads) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto builder = schema_builder("tests", "tombstone_purge_after_tombstone_heavy_reads")
+                .with_column("p1", utf8_type, column_kind::partition_key)
+                .with_column("c1", int32_type, column_kind::clustering_key)
+                .with_column("r1", int32_type);
+        builder.set_gc_grace_seconds(0);
+        builder.set_compaction_strategy(sstables::compaction_strategy_type::size_tiered);
+        builder.set_compaction_strategy_options({{"tombstone_threshold", "0.5"}});
+        auto s = builder.build();
+
+        auto cf = env.make_table_for_tests(s);
+        auto close_cf = deferred_stop(cf);
+        auto sst_gen = cf.make_sst_factory();
+        auto& cm = cf.get_compaction_manager();
+
+        // The first 10 rows are deleted, far fewer than the threshold of the cells
+        // of the partition, but as many as the rows of reads of the start of it.
+        mutation m(s, tests::generate_partition_key(s));
+        auto& r1 = *s->get_column_definition("r1");
+        auto deletion_time = gc_clock::now() - std::chrono::hours(1);
+        for (int32_t i = 0; i < 100; ++i) {
+            auto ck = clustering_key::from_single_value(*s, int32_type->decompose(i));
+            if (i < 10) {
+                m.partition().apply_delete(*s, ck, tombstone(api::new_timestamp(), deletion_time));
+            } else {
+                m.set_clustered_cell(ck, r1, atomic_cell::make_live(*int32_type, api::new_timestamp(), int32_type->decompose(i)));
+            }
+        }
+        auto sst = make_sstable_containing(sst_gen, {std::move(m)});
+        sstables::test(sst).set_data_file_write_time(db_clock::time_point::min());
+        cf->add_sstable_and_update_cache(sst).get();
+
+        auto in_table = [&] {
+            return cf->get_sstables()->contains(sst);
+        };
+        auto completed_tasks = cm.get_stats().completed_tasks;
+
+        cm.perform_tombstone_purge(cf.as_table_state()).get();
+        BOOST_REQUIRE(in_table());
+        BOOST_REQUIRE_EQUAL(cm.get_stats().completed_tasks, completed_tasks);
+
+        // Reads for compaction don't count.
+        uncounted_read_monitor monitor;
+        auto all = sst->make_reader(s, env.make_reader_permit(), query::full_partition_range, s->full_slice(), {},
+                streamed_mutation::forwarding::no, mutation_reader::forwarding::no, monitor);
+        read_mutation_from_flat_mutation_reader(all).get();
+        all.close().get();
+        BOOST_REQUIRE_EQUAL(sst->get_stats().rows_read(), 0);
+        BOOST_REQUIRE_EQUAL(sst->get_stats().tombstones_read(), 0);
+
+        auto slice = partition_slice_builder(*s)
+                .with_range(query::clustering_range::make_ending_with({clustering_key::from_single_value(*s, int32_type->decompose(10))}))
+                .build();
+        while (sst->get_stats().rows_read() + sst->get_stats().tombstones_read() < 1000) {
+            auto rd = sst->make_reader(s, env.make_reader_permit(), query::full_partition_range, slice);
+            read_mutation_from_flat_mutation_reader(rd).get();
+            rd.close().get();
+        }
+        BOOST_REQUIRE_GE(double(sst->get_stats().tombstones_read()) / sst->get_stats().rows_read(), 0.5);
+
+        cm.perform_tombstone_purge(cf.as_table_state()).get();
+        BOOST_REQUIRE(!in_table());
+        BOOST_REQUIRE_EQUAL(cm.get_stats().completed_tasks, completed_tasks + 1);
+
+        auto reads = sst->get_stats().rows_read();
+        sst->get_stats().decay_reads();
+        BOOST_REQUIRE_EQUAL(sst->get_stats().rows_read(), reads / 2);
+    });
+}
+
 SEASTAR_TEST_CASE(compaction_correctness_with_partitioned_sstable_set) {
     return test_env::do_with_async([] (test_env& env) {
         auto builder = schema_builder("tests", "tombstone_purge")
@@ -3762,6 +3925,145 @@ SEASTAR_TEST_CASE(test_twcs_compaction_across_buckets) {
     });
 }
 
+SEASTAR_TEST_CASE(twcs_cold_storage_test) {
+    return seastar::async([] {
+        auto db_cfg = std::make_unique<db::config>();
+        db_cfg->object_storage_config = std::unordered_map<sstring, s3::endpoint_config>{{ "s3.test", s3::endpoint_config{} }};
+        sharded<sstables::storage_manager> sstm;
+        sstm.start(std::cref(*db_cfg), sstables::storage_manager::config{}).get();
+        auto stop_sstm = deferred_stop(sstm);
+        test_env env({}, &sstm.local());
+        auto close_env = defer([&] { env.stop().get(); });
+
+        auto builder = schema_builder("tests", "twcs_cold_storage_test")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type);
+        builder.set_compaction_strategy(sstables::compaction_strategy_type::time_window);
+        auto s = builder.build();
+
+        auto sst_gen = env.make_sst_factory(s);
+        auto pkey = tests::generate_partition_key(s);
+        auto now = api::new_timestamp();
+        auto make_sstable_days_ago = [&] (int days) {
+            mutation m(s, pkey);
+            auto ts = now - std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::days(days)).count();
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(days)), ts);
+            return make_sstable_containing(sst_gen, {std::move(m)});
+        };
+
+        auto cf = env.make_table_for_tests(s);
+        auto close_cf = deferred_stop(cf);
+        auto control = make_strategy_control_for_test(false);
+
+        std::map<sstring, sstring> options = {
+            { time_window_compaction_strategy_options::COLD_STORAGE_ENDPOINT_KEY, "s3.test" },
+            { time_window_compaction_strategy_options::COLD_STORAGE_BUCKET_KEY, "cold" },
+            { time_window_compaction_strategy_options::COLD_STORAGE_AFTER_SECONDS_KEY, to_sstring(7 * 86400) },
+        };
+        auto cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window, options);
+
+        auto old_window = make_sstable_days_ago(30);
+        // Not compacted into a single sstable yet.
+        std::vector<shared_sstable> uncompacted_window = { make_sstable_days_ago(20), make_sstable_days_ago(20) };
+        auto recent_window = make_sstable_days_ago(1);
+
+        std::vector<shared_sstable> candidates = { old_window, recent_window };
+        candidates.insert(candidates.end(), uncompacted_window.begin(), uncompacted_window.end());
+        auto desc = cs.get_sstables_for_compaction(cf.as_table_state(), *control, candidates);
+        BOOST_REQUIRE(desc.sstables == std::vector<shared_sstable>{old_window});
+        BOOST_REQUIRE(desc.remote_data);
+        BOOST_REQUIRE_EQUAL(desc.remote_data->endpoint, "s3.test");
+        BOOST_REQUIRE_EQUAL(desc.remote_data->bucket, "cold");
+
+        candidates = { recent_window };
+        candidates.insert(candidates.end(), uncompacted_window.begin(), uncompacted_window.end());
+        desc = cs.get_sstables_for_compaction(cf.as_table_state(), *control, candidates);
+        BOOST_REQUIRE(desc.sstables.empty());
+
+        auto local_cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window, {});
+        desc = local_cs.get_sstables_for_compaction(cf.as_table_state(), *control, { old_window, recent_window });
+        BOOST_REQUIRE(desc.sstables.empty());
+
+        // The data is kept local if the endpoint isn't configured on this node.
+        options[time_window_compaction_strategy_options::COLD_STORAGE_ENDPOINT_KEY] = "s3.unknown";
+        auto unknown_endpoint_cs = sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window, options);
+        for (int i = 0; i < 2; i++) {
+            desc = unknown_endpoint_cs.get_sstables_for_compaction(cf.as_table_state(), *control, { old_window, recent_window });
+            BOOST_REQUIRE(desc.sstables.empty());
+            BOOST_REQUIRE(!desc.remote_data);
+        }
+
+        BOOST_REQUIRE_THROW(sstables::make_compaction_strategy(sstables::compaction_strategy_type::time_window,
+                {{ time_window_compaction_strategy_options::COLD_STORAGE_BUCKET_KEY, "cold" }}), exceptions::configuration_exception);
+    });
+}
+
+SEASTAR_TEST_CASE(sstable_remote_data_test, *boost::unit_test::precondition(tests::has_scylla_test_env)) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto cold_storage = std::get<data_dictionary::storage_options::s3>(env.get_storage_options().value);
+        simple_schema ss;
+        auto s = ss.schema();
+        // Only the data of the sstables is kept in object storage.
+        auto dir = env.tempdir().path().native();
+        auto make_local_sstable = [&] (sstables::generation_type gen) {
+            return env.manager().make_sstable(s, dir, data_dictionary::storage_options{}, gen);
+        };
+        auto sst_gen = [&] {
+            return make_local_sstable(env.new_generation());
+        };
+
+        std::vector<mutation> muts;
+        for (auto& pk : tests::generate_partition_keys(3, s)) {
+            mutation m(s, pk);
+            ss.add_row(m, ss.make_ckey(0), "val");
+            muts.push_back(std::move(m));
+        }
+        auto sst = make_sstable_containing(sst_gen, muts);
+
+        auto cf = env.make_table_for_tests(s);
+        auto close_cf = deferred_stop(cf);
+        auto desc = sstables::compaction_descriptor({ sst });
+        desc.remote_data = cold_storage;
+        auto ret = compact_sstables(std::move(desc), cf, sst_gen, replacer_fn_no_op(), can_purge_tombstones::no).get0();
+        BOOST_REQUIRE_EQUAL(ret.new_sstables.size(), 1);
+        auto remote = ret.new_sstables[0];
+        BOOST_REQUIRE(remote->has_remote_data());
+        BOOST_REQUIRE(!file_exists(remote->filename(component_type::Data)).get0());
+        BOOST_REQUIRE(file_exists(remote->filename(component_type::RemoteData)).get0());
+
+        auto assert_produces_muts = [&] (shared_sstable sst) {
+            auto rd = assert_that(sstable_reader(sst, s, env.make_reader_permit()));
+            for (auto& m : muts) {
+                rd.produces(m);
+            }
+            rd.produces_end_of_stream();
+        };
+
+        // Data is fetched from object storage once, and then read from the cache.
+        auto& stats = env.manager().get_cache_tracker().get_remote_data_cached_file_stats();
+        auto misses = stats.page_misses;
+        assert_produces_muts(remote);
+        BOOST_REQUIRE_GT(stats.page_misses, misses);
+        misses = stats.page_misses;
+        auto hits = stats.page_hits;
+        assert_produces_muts(remote);
+        BOOST_REQUIRE_EQUAL(stats.page_misses, misses);
+        BOOST_REQUIRE_GT(stats.page_hits, hits);
+
+        auto reloaded = make_local_sstable(remote->generation());
+        reloaded->load(s->get_sharder()).get();
+        BOOST_REQUIRE(reloaded->has_remote_data());
+        assert_produces_muts(reloaded);
+
+        // The object is deleted along with the sstable.
+        auto client = env.manager().get_endpoint_client(cold_storage.endpoint);
+        auto object = remote->get_remote_data_location().object;
+        BOOST_REQUIRE_GT(client->get_object_size(object).get0(), 0);
+        remote->unlink().get();
+        BOOST_REQUIRE_THROW(client->get_object_size(object).get(), std::exception);
+    }, test_env_config{ .storage = make_test_object_storage_options() });
+}
+
 SEASTAR_TEST_CASE(test_offstrategy_sstable_compaction) {
     return test_env::do_with_async([tmpdirs = std::vector<decltype(tmpdir())>()] (test_env& env) mutable {
         for (const auto version : writable_sstable_versions) {
@@ -4436,6 +4738,108 @@ SEASTAR_TEST_CASE(test_major_does_not_miss_data_in_memtable) {
     });
 }
 
+SEASTAR_TEST_CASE(test_split_for_parallel_compaction) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "test_split_for_parallel_compaction")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+        auto keys = tests::generate_partition_keys(1000, s);
+        auto sst_gen = env.make_sst_factory(s);
+
+        std::vector<mutation> muts;
+        for (auto& key : keys) {
+            mutation m(s, key);
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), api::timestamp_type(0));
+            muts.push_back(std::move(m));
+        }
+        auto sst = make_sstable_containing(sst_gen, muts);
+
+        auto check_ranges = [&] (const dht::token_range_vector& ranges, size_t expected) {
+            BOOST_REQUIRE_EQUAL(ranges.size(), expected);
+            BOOST_REQUIRE(!ranges.front().start());
+            BOOST_REQUIRE(!ranges.back().end());
+            for (size_t i = 1; i < ranges.size(); ++i) {
+                BOOST_REQUIRE(ranges[i - 1].end()->is_inclusive());
+                BOOST_REQUIRE(!ranges[i].start()->is_inclusive());
+                BOOST_REQUIRE(ranges[i - 1].end()->value() == ranges[i].start()->value());
+            }
+        };
+
+        check_ranges(sstables::split_for_parallel_compaction({sst}, 1).get(), 1);
+
+        auto ranges = sstables::split_for_parallel_compaction({sst}, 4).get();
+        check_ranges(ranges, 4);
+        // Every range has a similar share of the partitions.
+        for (auto& r : ranges) {
+            auto count = std::ranges::count_if(keys, [&] (const dht::decorated_key& dk) {
+                return r.contains(dk.token(), dht::token_comparator());
+            });
+            testlog.debug("{}: {} partitions", r, count);
+            BOOST_REQUIRE_GT(count, 100);
+            BOOST_REQUIRE_LT(count, 400);
+        }
+
+        // Can't split a single partition.
+        auto single = make_sstable_containing(sst_gen, {muts.front()});
+        check_ranges(sstables::split_for_parallel_compaction({single}, 4).get(), 1);
+    });
+}
+
+SEASTAR_TEST_CASE(test_parallel_major_compaction) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto s = schema_builder("tests", "test_parallel_major_compaction")
+                .with_column("id", utf8_type, column_kind::partition_key)
+                .with_column("value", int32_type).build();
+        auto keys = tests::generate_partition_keys(1000, s);
+
+        auto cf = env.make_table_for_tests(s);
+        auto close_cf = deferred_stop(cf);
+        auto sst_gen = cf.make_sst_factory();
+        compaction_manager_test(cf.get_compaction_manager()).set_major_compaction_parallelism(4);
+
+        // Overlapping sstables, half of the partitions of each one is overwritten by the next one.
+        std::vector<mutation> expected;
+        for (int32_t i = 0; i < 4; ++i) {
+            std::vector<mutation> muts;
+            for (size_t j = 0; j < keys.size(); ++j) {
+                if (j % 2 != size_t(i % 2)) {
+                    continue;
+                }
+                mutation m(s, keys[j]);
+                m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(i), api::timestamp_type(i));
+                muts.push_back(std::move(m));
+            }
+            cf->add_sstable_and_update_cache(make_sstable_containing(sst_gen, muts)).get();
+            if (i >= 2) {
+                std::move(muts.begin(), muts.end(), std::back_inserter(expected));
+            }
+        }
+        std::ranges::sort(expected, mutation_decorated_key_less_comparator());
+
+        cf->compact_all_sstables().get();
+
+        auto ssts = boost::copy_range<std::vector<sstables::shared_sstable>>(*cf->get_sstables());
+        BOOST_REQUIRE_GT(ssts.size(), 1);
+        BOOST_REQUIRE_LE(ssts.size(), 4);
+        std::ranges::sort(ssts, [&] (const sstables::shared_sstable& a, const sstables::shared_sstable& b) {
+            return a->get_first_decorated_key().less_compare(*s, b->get_first_decorated_key());
+        });
+        for (size_t i = 0; i < ssts.size(); ++i) {
+            BOOST_REQUIRE(ssts[i]->run_identifier() == ssts[0]->run_identifier());
+            if (i) {
+                BOOST_REQUIRE(ssts[i - 1]->get_last_decorated_key().less_compare(*s, ssts[i]->get_first_decorated_key()));
+            }
+        }
+
+        auto reader = cf->as_mutation_source().make_reader_v2(s, env.make_reader_permit());
+        auto assertions = assert_that(std::move(reader));
+        for (auto& m : expected) {
+            assertions.produces(m);
+        }
+        assertions.produces_end_of_stream();
+    });
+}
+
 SEASTAR_TEST_CASE(simple_backlog_controller_test) {
     auto run_controller_test = [] (sstables::compaction_strategy_type compaction_strategy_type, test_env& env) {
         /////////////
@@ -4553,6 +4957,7 @@ SEASTAR_TEST_CASE(simple_backlog_controller_test) {
        run_controller_test(sstables::compaction_strategy_type::size_tiered, env);
        run_controller_test(sstables::compaction_strategy_type::time_window, env);
        run_controller_test(sstables::compaction_strategy_type::leveled, env);
+       run_controller_test(sstables::compaction_strategy_type::incremental, env);
     });
 }
 
@@ -4626,6 +5031,9 @@ SEASTAR_TEST_CASE(test_compaction_strategy_cleanup_method) {
         // STCS: Check that 2 jobs are returned for a size tier containing 2x more files than max threshold.
         run_cleanup_strategy_test(sstables::compaction_strategy_type::size_tiered, 32);
 
+        // ICS: Check that 2 jobs are returned for a size tier containing 2x more runs than max threshold.
+        run_cleanup_strategy_test(sstables::compaction_strategy_type::incremental, 32);
+
         // Default implementation: check that it will return one job for each file
         run_cleanup_strategy_test(sstables::compaction_strategy_type::null, 1);
 
@@ -4987,6 +5395,60 @@ SEASTAR_TEST_CASE(compaction_optimization_to_avoid_bloom_filter_checks) {
     });
 }
 
+SEASTAR_TEST_CASE(compaction_purge_checks_memtables_for_overlap) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto builder = schema_builder("tests", "tombstone_purge")
+            .with_column("id", utf8_type, column_kind::partition_key)
+            .with_column("value", int32_type);
+        builder.set_gc_grace_seconds(0);
+        auto s = builder.build();
+        auto sst_gen = env.make_sst_factory(s);
+
+        auto t = env.make_table_for_tests(s);
+        t->disable_auto_compaction().get();
+        auto stop = deferred_stop(t);
+
+        auto compact = [&] (shared_sstable sst) {
+            column_family_test(t).add_sstable(sst).get();
+            auto desc = sstables::compaction_descriptor({sst});
+            desc.enable_garbage_collection(t->get_sstable_set());
+            return compact_sstables(std::move(desc), t, sst_gen).get0();
+        };
+        auto make_insert = [&] (const char* key, api::timestamp_type ts) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.set_clustered_cell(clustering_key::make_empty(), bytes("value"), data_value(int32_t(1)), ts);
+            return m;
+        };
+        auto make_delete = [&] (const char* key) {
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            m.partition().apply(tombstone(api::new_timestamp(), gc_clock::now() - std::chrono::hours(1)));
+            return m;
+        };
+        auto old_timestamp = api::new_timestamp();
+
+        // Older data of another partition in the memtable doesn't prevent purging the tombstone.
+        t->apply(make_insert("pk2", old_timestamp));
+        auto result = compact(make_sstable_containing(sst_gen, {make_delete("pk1")}));
+        BOOST_REQUIRE(result.new_sstables.empty());
+
+        // Older data of the same partition does.
+        auto kept = tombstone_purge_stats::local().kept_for_memtable;
+        t->apply(make_insert("pk1", old_timestamp));
+        result = compact(make_sstable_containing(sst_gen, {make_delete("pk1")}));
+        BOOST_REQUIRE_EQUAL(result.new_sstables.size(), 1);
+        BOOST_REQUIRE_EQUAL(tombstone_purge_stats::local().kept_for_memtable, kept + 1);
+
+        // Once a memtable is being flushed, its partitions are moved to the cache
+        // and it may no longer contain the partition, so older data of another
+        // partition holds back the purge too.
+        auto mt = t->active_memtables().front();
+        auto flush_reader = mt->make_flush_reader(s, env.make_reader_permit());
+        auto close_flush_reader = deferred_close(flush_reader);
+        result = compact(make_sstable_containing(sst_gen, {make_delete("pk3")}));
+        BOOST_REQUIRE_EQUAL(result.new_sstables.size(), 1);
+    });
+}
+
 static future<> run_incremental_compaction_test(sstables::offstrategy offstrategy, std::function<future<>(table_for_tests&, owned_ranges_ptr)> run_compaction) {
     return test_env::do_with_async([run_compaction = std::move(run_compaction), offstrategy] (test_env& env) {
         auto builder = schema_builder("tests", "test")
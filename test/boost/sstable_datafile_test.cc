@@ -11,6 +11,7 @@
 #include <seastar/core/align.hh>
 #include <seastar/core/aligned_buffer.hh>
 #include <seastar/util/closeable.hh>
+#include <seastar/core/sleep.hh>
 
 #include "sstables/sstables.hh"
 #include "sstables/compress.hh"
@@ -3193,3 +3194,91 @@ SEASTAR_TEST_CASE(test_sstable_set_predicate) {
         }
     });
 }
+
+static std::optional<sstring> get_compression_option(const sstables::compression& c, std::string_view key) {
+    for (auto& o : c.options.elements) {
+        if (std::string_view(reinterpret_cast<const char*>(o.key.value.data()), o.key.value.size()) == key) {
+            return sstring(o.value.value.begin(), o.value.value.end());
+        }
+    }
+    return std::nullopt;
+}
+
+SEASTAR_TEST_CASE(test_zstd_dictionary_compression) {
+    return test_env::do_with_async([] (test_env& env) {
+        auto make_schema = [] (std::map<sstring, sstring> compression) {
+            return schema_builder("ks", "cf")
+                    .with_column("pk", int32_type, column_kind::partition_key)
+                    .with_column("ck", int32_type, column_kind::clustering_key)
+                    .with_column("v", utf8_type)
+                    .set_compressor_params(compression_parameters(compression))
+                    .build();
+        };
+        auto plain_schema = make_schema({
+            {"sstable_compression", "org.apache.cassandra.io.compress.ZstdCompressor"},
+            {"chunk_length_in_kb", "4"},
+        });
+        auto dict_schema = make_schema({
+            {"sstable_compression", "org.apache.cassandra.io.compress.ZstdCompressor"},
+            {"chunk_length_in_kb", "4"},
+            {"dictionary_size_kb", "4"},
+        });
+
+        // Rows with a lot in common with each other, more than a single chunk holds.
+        auto make_mutations = [] (schema_ptr s, int first_pk) {
+            static const std::array<sstring, 4> countries = {"France", "Germany", "Poland", "United States"};
+            std::vector<mutation> muts;
+            for (int pk = first_pk; pk < first_pk + 20; ++pk) {
+                mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+                for (int ck = 0; ck < 100; ++ck) {
+                    auto v = format("{{\"user_id\": {}, \"email\": \"user-{}@example.com\", \"country\": \"{}\", \"status\": \"active\"}}",
+                            pk * 1000 + ck, tests::random::get_int(0, 100000), countries[tests::random::get_int(0, 3)]);
+                    m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), "v", data_value(v), 1);
+                }
+                muts.push_back(std::move(m));
+            }
+            return muts;
+        };
+
+        auto plain = make_sstable_containing(env.make_sstable(plain_schema), make_mutations(plain_schema, 0));
+        auto muts = make_mutations(dict_schema, 0);
+        // The first sstable is sampled to train the dictionary in the background,
+        // and written without it.
+        auto sst = make_sstable_containing(env.make_sstable(dict_schema), muts);
+        BOOST_REQUIRE(!get_compression_option(sst->get_compression(), "dictionary"));
+        std::optional<sstring> hash;
+        for (int attempt = 0; !hash; ++attempt) {
+            BOOST_REQUIRE_LT(attempt, 1000);
+            seastar::sleep(std::chrono::milliseconds(10)).get();
+            sst = make_sstable_containing(env.make_sstable(dict_schema), muts);
+            hash = get_compression_option(sst->get_compression(), "dictionary_hash");
+        }
+        BOOST_REQUIRE(get_compression_option(sst->get_compression(), "dictionary"));
+        BOOST_REQUIRE(!get_compression_option(plain->get_compression(), "dictionary"));
+        testlog.info("data size without dictionary: {}, with dictionary: {}", plain->ondisk_data_size(), sst->ondisk_data_size());
+        BOOST_REQUIRE_LT(sst->ondisk_data_size(), plain->ondisk_data_size());
+
+        // The dictionary is read back from CompressionInfo.db.
+        auto reopened = env.reusable_sst(sst).get();
+        auto rd = assert_that(reopened->as_mutation_source().make_reader_v2(dict_schema, env.make_reader_permit()));
+        boost::sort(muts, mutation_decorated_key_less_comparator());
+        for (auto& m : muts) {
+            rd.produces(m);
+        }
+        rd.produces_end_of_stream();
+
+        // The next sstables of the table reuse the dictionary.
+        auto sst2 = make_sstable_containing(env.make_sstable(dict_schema), make_mutations(dict_schema, 100));
+        BOOST_REQUIRE_EQUAL(get_compression_option(sst2->get_compression(), "dictionary_hash"), hash);
+
+        BOOST_REQUIRE_THROW(compression_parameters({
+            {"sstable_compression", "org.apache.cassandra.io.compress.ZstdCompressor"},
+            {"dictionary_size_kb", "32"},
+        }), exceptions::configuration_exception);
+        BOOST_REQUIRE_THROW(compression_parameters({
+            {"sstable_compression", "org.apache.cassandra.io.compress.ZstdCompressor"},
+            {"chunk_length_in_kb", "128"},
+            {"dictionary_size_kb", "4"},
+        }), exceptions::configuration_exception);
+    });
+}
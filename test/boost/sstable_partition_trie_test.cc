@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "test/lib/scylla_test_case.hh"
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/byteorder.hh>
+
+#include "test/lib/random_utils.hh"
+#include "test/lib/key_utils.hh"
+#include "test/lib/simple_schema.hh"
+#include "test/lib/sstable_test_env.hh"
+#include "test/lib/sstable_utils.hh"
+#include "test/lib/flat_mutation_reader_assertions.hh"
+#include "sstables/sstables.hh"
+#include "sstables/trie_index.hh"
+#include "sstables/exceptions.hh"
+#include "db/config.hh"
+
+using namespace sstables;
+
+namespace {
+
+struct memory_writer {
+    bytes buf;
+
+    void write(const char* data, size_t size) {
+        buf.append(reinterpret_cast<const int8_t*>(data), size);
+    }
+};
+
+trie::partition_trie_reader make_reader(const bytes& buf) {
+    trie::partition_trie_reader::read_function read = [&buf] (uint64_t pos, size_t len) {
+        len = std::min<uint64_t>(len, buf.size() - pos);
+        return make_ready_future<temporary_buffer<char>>(temporary_buffer<char>(reinterpret_cast<const char*>(buf.data()) + pos, len));
+    };
+    auto footer = trie::partition_trie_reader::read_footer(read, buf.size()).get0();
+    return trie::partition_trie_reader(std::move(read), footer, buf.size());
+}
+
+trie::partition_payload payload_for(uint64_t i) {
+    return trie::partition_payload{.index_offset = i * 10, .index_length = 10, .data_end = i * 100 + 100};
+}
+
+bytes key_of(uint64_t v) {
+    bytes b(bytes::initialized_later(), sizeof(v));
+    write_be<uint64_t>(reinterpret_cast<char*>(b.begin()), v);
+    return b;
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_empty_trie) {
+    memory_writer out;
+    trie::partition_trie_writer<memory_writer> w(out);
+    auto footer = w.finish();
+    BOOST_REQUIRE_EQUAL(footer.root_position, trie::trie_footer::no_root);
+    BOOST_REQUIRE_EQUAL(footer.key_count, 0);
+    BOOST_REQUIRE_EQUAL(out.buf.size(), trie::trie_footer::serialized_size);
+
+    auto reader = make_reader(out.buf);
+    BOOST_REQUIRE(!reader.lookup(key_of(0)).get0());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_single_key) {
+    memory_writer out;
+    trie::partition_trie_writer<memory_writer> w(out);
+    w.add(key_of(1000), payload_for(0));
+    w.finish();
+
+    auto reader = make_reader(out.buf);
+    BOOST_REQUIRE_EQUAL(reader.footer().key_count, 1);
+
+    auto res = reader.lookup(key_of(1000)).get0();
+    BOOST_REQUIRE(res);
+    BOOST_REQUIRE(res->prefix_match);
+    BOOST_REQUIRE(res->payload == payload_for(0));
+
+    // With a single key only its first byte is kept, so any key sharing it matches.
+    res = reader.lookup(key_of(1)).get0();
+    BOOST_REQUIRE(res);
+    BOOST_REQUIRE(res->prefix_match);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_lookups) {
+    std::vector<uint64_t> values;
+    for (int i = 0; i < 5000; ++i) {
+        values.push_back(tests::random::get_int<uint64_t>());
+    }
+    // Make sure some keys share long prefixes.
+    for (uint64_t i = 0; i < 300; ++i) {
+        values.push_back(0x0102030405060000ull + i * 3);
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+
+    memory_writer out;
+    trie::partition_trie_writer<memory_writer> w(out);
+    for (size_t i = 0; i < values.size(); ++i) {
+        w.add(key_of(values[i]), payload_for(i));
+    }
+    auto footer = w.finish();
+    BOOST_REQUIRE_EQUAL(footer.key_count, values.size());
+
+    auto reader = make_reader(out.buf);
+
+    // Present keys are always found.
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto res = reader.lookup(key_of(values[i])).get0();
+        BOOST_REQUIRE(res);
+        BOOST_REQUIRE(res->prefix_match);
+        BOOST_REQUIRE(res->payload == payload_for(i));
+    }
+
+    // Absent keys either match a neighbouring prefix or yield the greatest smaller key.
+    for (int n = 0; n < 5000; ++n) {
+        auto v = tests::random::get_int<uint64_t>();
+        auto it = std::upper_bound(values.begin(), values.end(), v);
+        auto res = reader.lookup(key_of(v)).get0();
+        if (it == values.begin()) {
+            BOOST_REQUIRE(!res || res->prefix_match);
+            if (res) {
+                BOOST_REQUIRE(res->payload == payload_for(0));
+            }
+            continue;
+        }
+        auto floor = std::distance(values.begin(), it) - 1;
+        BOOST_REQUIRE(res);
+        if (res->prefix_match) {
+            BOOST_REQUIRE(res->payload == payload_for(floor) || (size_t(floor + 1) < values.size() && res->payload == payload_for(floor + 1)));
+        } else {
+            BOOST_REQUIRE(res->payload == payload_for(floor));
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_rejects_out_of_order_keys) {
+    memory_writer out;
+    trie::partition_trie_writer<memory_writer> w(out);
+    w.add(key_of(10), payload_for(0));
+    BOOST_REQUIRE_THROW(w.add(key_of(10), payload_for(1)), std::runtime_error);
+    BOOST_REQUIRE_THROW(w.add(key_of(5), payload_for(1)), std::runtime_error);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_corrupt_footer) {
+    memory_writer out;
+    trie::partition_trie_writer<memory_writer> w(out);
+    w.add(key_of(10), payload_for(0));
+    w.finish();
+    out.buf[out.buf.size() - trie::trie_footer::serialized_size] = 0x7f;
+
+    trie::partition_trie_reader::read_function read = [&out] (uint64_t pos, size_t len) {
+        return make_ready_future<temporary_buffer<char>>(temporary_buffer<char>(reinterpret_cast<const char*>(out.buf.data()) + pos, len));
+    };
+    BOOST_REQUIRE_THROW(trie::partition_trie_reader::read_footer(read, out.buf.size()).get(), malformed_sstable_exception);
+}
+
+SEASTAR_TEST_CASE(test_reads_through_partition_trie) {
+    return test_env::do_with_async([] (test_env& env) {
+        env.db_config().enable_sstable_partition_trie_index.set(true);
+        simple_schema ss;
+        auto s = ss.schema();
+        auto permit = env.make_reader_permit();
+
+        auto pks = tests::generate_partition_keys(101, s);
+        auto absent = pks.back();
+        pks.pop_back();
+        std::vector<mutation> muts;
+        for (auto& pk : pks) {
+            mutation m(s, pk);
+            for (uint32_t ck = 0; ck < 5; ++ck) {
+                ss.add_row(m, ss.make_ckey(ck), "v");
+            }
+            muts.push_back(std::move(m));
+        }
+        auto sst = make_sstable_containing(env.make_sstable(s), muts);
+        BOOST_REQUIRE(sst->has_partition_trie_index());
+
+        auto singular = [] (const mutation& m) {
+            return dht::partition_range::make_singular(m.decorated_key());
+        };
+        auto& index_stats = env.manager().get_cache_tracker().get_partition_index_cache_stats();
+
+        for (auto& m : muts) {
+            auto pr = singular(m);
+            assert_that(sst->make_reader(s, permit, pr, s->full_slice()))
+                .produces(m)
+                .produces_end_of_stream();
+        }
+        {
+            auto pr = dht::partition_range::make_singular(absent);
+            assert_that(sst->make_reader(s, permit, pr, s->full_slice()))
+                .produces_end_of_stream();
+        }
+
+        // Pages loaded through the trie are cached by the sstable, not by the reader.
+        auto misses = index_stats.misses;
+        for (auto& m : muts) {
+            auto pr = singular(m);
+            assert_that(sst->make_reader(s, permit, pr, s->full_slice()))
+                .produces(m)
+                .produces_end_of_stream();
+        }
+        BOOST_REQUIRE_EQUAL(index_stats.misses, misses);
+
+        // Fast forwarding to other partitions continues from the page found through the trie.
+        {
+            auto pr = singular(muts[10]);
+            assert_that(sst->make_reader(s, permit, pr, s->full_slice()))
+                .produces(muts[10])
+                .produces_end_of_stream()
+                .fast_forward_to(dht::partition_range::make({dht::ring_position(muts[11].decorated_key()), false},
+                                                            {dht::ring_position(muts[14].decorated_key()), true}))
+                .produces(muts[12])
+                .produces(muts[13])
+                .produces(muts[14])
+                .produces_end_of_stream()
+                .fast_forward_to(dht::partition_range::make_starting_with({dht::ring_position(muts[98].decorated_key()), true}))
+                .produces(muts[98])
+                .produces(muts[99])
+                .produces_end_of_stream();
+        }
+
+        // Skipping within a partition found through the trie.
+        {
+            auto& m = muts[50];
+            auto pr = singular(m);
+            assert_that(sst->make_reader(s, permit, pr, s->full_slice(), {}, streamed_mutation::forwarding::yes))
+                .produces_partition_start(m.decorated_key())
+                .produces_end_of_stream()
+                .fast_forward_to(ss.make_ckey(1), ss.make_ckey(3))
+                .produces_row_with_key(ss.make_ckey(1))
+                .produces_row_with_key(ss.make_ckey(2))
+                .produces_end_of_stream()
+                .fast_forward_to(ss.make_ckey(4), ss.make_ckey(10))
+                .produces_row_with_key(ss.make_ckey(4))
+                .produces_end_of_stream();
+        }
+    });
+}
@@ -22,6 +22,7 @@
 #include "test/lib/reader_concurrency_semaphore.hh"
 #include "test/lib/scylla_test_case.hh"
 #include "test/lib/test_utils.hh"
+#include "test/lib/random_utils.hh"
 #include "schema/schema.hh"
 #include "compress.hh"
 #include "replica/database.hh"
@@ -705,7 +706,7 @@ SEASTAR_TEST_CASE(test_skipping_in_compressed_stream) {
         sstables::compression c;
         // this initializes "c"
         auto os = make_file_output_stream(f, file_output_stream_options()).get0();
-        auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp);
+        auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp, table_id::create_random_id());
 
         // Make sure that amount of written data is a multiple of chunk_len so that we hit #2143.
         temporary_buffer<char> buf1(c.uncompressed_chunk_length());
@@ -771,6 +772,77 @@ SEASTAR_TEST_CASE(test_skipping_in_compressed_stream) {
     });
 }
 
+SEASTAR_TEST_CASE(test_compressed_stream_read_ahead) {
+    return seastar::async([] {
+        tests::reader_concurrency_semaphore_wrapper semaphore;
+
+        tmpdir tmp;
+        auto file_path = (tmp.path() / "test").string();
+        file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor" },
+            { compression_parameters::CHUNK_LENGTH_KB, "4" },
+        });
+
+        sstables::compression c;
+        auto os = make_file_output_stream(f, file_output_stream_options()).get0();
+        auto out = make_compressed_file_m_format_output_stream(std::move(os), &c, cp, table_id::create_random_id());
+
+        // Not a multiple of the chunk length, so that the last chunk is short.
+        const size_t size = 100 * c.uncompressed_chunk_length() + 1000;
+        auto data = tests::random::get_bytes(size);
+        out.write(reinterpret_cast<const char*>(data.data()), data.size()).get();
+        out.close().get();
+        c.update(seastar::file_size(file_path).get0());
+
+        auto expect = [&] (input_stream<char>& in, uint64_t pos, size_t len) {
+            auto b = in.read_exactly(len).get0();
+            BOOST_REQUIRE_EQUAL(b.size(), len);
+            BOOST_REQUIRE(std::equal(b.begin(), b.end(), reinterpret_cast<const char*>(data.data()) + pos));
+        };
+
+        for (unsigned read_ahead : {0, 1, 4, 16}) {
+            file_input_stream_options opts;
+            opts.read_ahead = read_ahead;
+            auto make_is = [&] (uint64_t pos, size_t len) {
+                f = open_file_dma(file_path, open_flags::ro).get0();
+                return make_compressed_file_m_format_input_stream(f, &c, pos, len, opts, semaphore.make_permit());
+            };
+
+            // Sequential read of everything.
+            auto in = make_is(0, size);
+            expect(in, 0, size);
+            BOOST_REQUIRE(in.read().get0().empty());
+            in.close().get();
+
+            // Reads starting in the middle of a chunk, with skips within the chunks
+            // read ahead and beyond them.
+            for (int i = 0; i < 20; ++i) {
+                uint64_t pos = tests::random::get_int<uint64_t>(0, size - 1);
+                auto len = tests::random::get_int<size_t>(1, size - pos);
+                auto end = pos + len;
+                in = make_is(pos, len);
+                while (pos < end) {
+                    auto n = std::min<size_t>(tests::random::get_int<size_t>(1, 3 * c.uncompressed_chunk_length()), end - pos);
+                    expect(in, pos, n);
+                    pos += n;
+                    auto skip = std::min<size_t>(tests::random::get_int<size_t>(0, 20 * c.uncompressed_chunk_length()), end - pos);
+                    in.skip(skip).get();
+                    pos += skip;
+                }
+                BOOST_REQUIRE(in.read().get0().empty());
+                in.close().get();
+            }
+
+            // Closing with chunks in flight.
+            in = make_is(0, size);
+            expect(in, 0, 3 * c.uncompressed_chunk_length());
+            in.close().get();
+        }
+    });
+}
+
 // Test that sstables::key_view::tri_compare(const schema& s, partition_key_view other)
 // should correctly compare empty keys. The fact we did this incorrectly was
 // noticed while fixing #9375, and a separate issue on it is #10178.
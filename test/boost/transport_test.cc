@@ -10,7 +10,12 @@
 
 #include "transport/request.hh"
 #include "transport/response.hh"
+#include "transport/segment.hh"
+#include "transport/server.hh"
 
+#include <seastar/util/closeable.hh>
+
+#include "test/lib/cql_test_env.hh"
 #include "test/lib/random_utils.hh"
 
 namespace cql3 {
@@ -156,3 +161,231 @@ SEASTAR_THREAD_TEST_CASE(test_response_request_reader) {
     BOOST_CHECK_EQUAL(req.read_short(), 1);
     BOOST_CHECK_EQUAL(req.read_string(), "zed");
 }
+
+namespace {
+
+class memory_data_sink : public data_sink_impl {
+    std::vector<temporary_buffer<char>>& _bufs;
+public:
+    explicit memory_data_sink(std::vector<temporary_buffer<char>>& bufs) : _bufs(bufs) { }
+    virtual future<> put(net::packet data) override {
+        for (auto& buf : data.release()) {
+            _bufs.push_back(std::move(buf));
+        }
+        return make_ready_future<>();
+    }
+    virtual future<> flush() override { return make_ready_future<>(); }
+    virtual future<> close() override { return make_ready_future<>(); }
+};
+
+class memory_data_source : public data_source_impl {
+    std::deque<temporary_buffer<char>> _bufs;
+public:
+    explicit memory_data_source(std::vector<temporary_buffer<char>> bufs)
+        : _bufs(std::make_move_iterator(bufs.begin()), std::make_move_iterator(bufs.end())) { }
+    virtual future<temporary_buffer<char>> get() override {
+        if (_bufs.empty()) {
+            return make_ready_future<temporary_buffer<char>>();
+        }
+        auto buf = std::move(_bufs.front());
+        _bufs.pop_front();
+        return make_ready_future<temporary_buffer<char>>(std::move(buf));
+    }
+};
+
+bytes message_bytes(const net::packet& msg) {
+    bytes ret;
+    for (auto& frag : msg.fragments()) {
+        ret.append(reinterpret_cast<const int8_t*>(frag.base), frag.size);
+    }
+    return ret;
+}
+
+bytes make_envelope(bytes_view body) {
+    auto res = cql_transport::response(0, cql_transport::cql_binary_opcode::RESULT, tracing::trace_state_ptr());
+    res.write_bytes_as_string(body);
+    return message_bytes(res.make_message(5, cql_transport::cql_compression::none).release());
+}
+
+bytes make_random_envelope(size_t body_size) {
+    return make_envelope(tests::random::get_bytes(body_size));
+}
+
+std::vector<temporary_buffer<char>> write_segments(const std::vector<bytes>& envelopes, bool compressed) {
+    std::vector<temporary_buffer<char>> written;
+    output_stream<char> raw(data_sink(std::make_unique<memory_data_sink>(written)), 8192);
+    auto out = cql_transport::make_segment_output_stream(raw, compressed);
+    for (auto& e : envelopes) {
+        out.write(reinterpret_cast<const char*>(e.data()), e.size()).get();
+    }
+    out.close().get();
+    raw.close().get();
+    return written;
+}
+
+bytes read_segments(std::vector<temporary_buffer<char>> bufs, bool compressed) {
+    auto in = cql_transport::make_segment_input_stream(
+            input_stream<char>(data_source(std::make_unique<memory_data_source>(std::move(bufs)))), compressed);
+    auto close_in = deferred_close(in);
+    bytes ret;
+    while (auto buf = in.read().get0()) {
+        ret.append(reinterpret_cast<const int8_t*>(buf.get()), buf.size());
+    }
+    return ret;
+}
+
+size_t total_size(const std::vector<temporary_buffer<char>>& bufs) {
+    size_t size = 0;
+    for (auto& buf : bufs) {
+        size += buf.size();
+    }
+    return size;
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_round_trip) {
+    using namespace cql_transport::segment;
+    for (bool compressed : {false, true}) {
+        const auto segment_overhead = (compressed ? compressed_header_size : header_size) + crc_size;
+
+        // Small envelopes are packed into a single self-contained segment.
+        std::vector<bytes> small;
+        bytes small_concat;
+        for (int i = 0; i < 10; ++i) {
+            small.push_back(make_random_envelope(100));
+            small_concat.append(small.back().data(), small.back().size());
+        }
+        auto written = write_segments(small, compressed);
+        if (!compressed) {
+            BOOST_REQUIRE_EQUAL(total_size(written), small_concat.size() + segment_overhead);
+        }
+        BOOST_REQUIRE_EQUAL(read_segments(std::move(written), compressed), small_concat);
+
+        // A large envelope is split into several segments.
+        std::vector<bytes> large{make_random_envelope(3 * max_payload_size)};
+        written = write_segments(large, compressed);
+        if (!compressed) {
+            BOOST_REQUIRE_EQUAL(total_size(written), large.front().size() + 4 * segment_overhead);
+        }
+        BOOST_REQUIRE_EQUAL(read_segments(std::move(written), compressed), large.front());
+    }
+
+    // Compressible payloads get smaller.
+    auto envelope = make_envelope(bytes(10000, int8_t('a')));
+    auto written = write_segments({envelope}, true);
+    BOOST_REQUIRE_LT(total_size(written), envelope.size());
+    BOOST_REQUIRE_EQUAL(read_segments(std::move(written), true), envelope);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_corruption) {
+    for (bool compressed : {false, true}) {
+        // Corrupt the header and the payload checksum or the payload.
+        for (size_t corrupted_byte : {size_t(1), size_t(20)}) {
+            auto written = write_segments({make_random_envelope(100)}, compressed);
+            auto& buf = written.front().size() > corrupted_byte ? written.front() : written.back();
+            buf.get_write()[corrupted_byte % buf.size()] ^= 0x10;
+            BOOST_REQUIRE_THROW(read_segments(std::move(written), compressed), exceptions::protocol_exception);
+        }
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_segment_framing_switch) {
+    // Envelopes written before the segment stream is installed are sent as they are,
+    // ahead of the segments, and the underlying stream stays open.
+    std::vector<temporary_buffer<char>> written;
+    output_stream<char> raw(data_sink(std::make_unique<memory_data_sink>(written)), 8192);
+    auto envelope = make_random_envelope(100);
+    raw.write(reinterpret_cast<const char*>(envelope.data()), envelope.size()).get();
+
+    auto out = cql_transport::make_segment_output_stream(raw, false);
+    out.write(reinterpret_cast<const char*>(envelope.data()), envelope.size()).get();
+    out.close().get();
+    BOOST_REQUIRE_EQUAL(total_size(written), 2 * envelope.size() + cql_transport::segment::header_size + cql_transport::segment::crc_size);
+    bytes concat;
+    for (auto& buf : written) {
+        concat.append(reinterpret_cast<const int8_t*>(buf.get()), buf.size());
+    }
+    BOOST_REQUIRE(bytes_view(concat).substr(0, envelope.size()) == bytes_view(envelope));
+
+    raw.write(reinterpret_cast<const char*>(envelope.data()), envelope.size()).get();
+    raw.close().get();
+    BOOST_REQUIRE_EQUAL(total_size(written), 3 * envelope.size() + cql_transport::segment::header_size + cql_transport::segment::crc_size);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_response_spliced_values) {
+    auto small_value = managed_bytes(tests::random::get_bytes(100));
+    auto large_value = managed_bytes(tests::random::get_bytes(256 * 1024));
+
+    auto write_values = [&] (cql_transport::response& res) {
+        res.write_int(1);
+        res.write_owned_value(managed_bytes_view(small_value));
+        res.write_owned_value(managed_bytes_view(large_value));
+        res.write_owned_value(std::optional<managed_bytes_view>());
+        res.write_owned_value(managed_bytes_view(large_value));
+    };
+
+    auto copied = cql_transport::response(0, cql_transport::cql_binary_opcode::RESULT, tracing::trace_state_ptr());
+    write_values(copied);
+    auto spliced = cql_transport::response(0, cql_transport::cql_binary_opcode::RESULT, tracing::trace_state_ptr());
+    spliced.set_value_source(::make_shared<cql_transport::messages::result_message::void_message>());
+    write_values(spliced);
+
+    BOOST_REQUIRE_EQUAL(spliced.size(), copied.size());
+    auto msg = spliced.make_message(4, cql_transport::cql_compression::none).release();
+    BOOST_REQUIRE_EQUAL(message_bytes(msg), message_bytes(copied.make_message(4, cql_transport::cql_compression::none).release()));
+
+    // The large value is sent from where it is, the small one is copied.
+    auto points_into = [&msg] (const managed_bytes& v) {
+        auto data = reinterpret_cast<const char*>(managed_bytes_view(v).current_fragment().data());
+        return std::ranges::any_of(msg.fragments(), [data] (const net::fragment& f) { return f.base == data; });
+    };
+    BOOST_REQUIRE(points_into(large_value));
+    BOOST_REQUIRE(!points_into(small_value));
+
+    // Values which don't belong to the value source are always copied.
+    auto not_owned = cql_transport::response(0, cql_transport::cql_binary_opcode::RESULT, tracing::trace_state_ptr());
+    not_owned.set_value_source(::make_shared<cql_transport::messages::result_message::void_message>());
+    not_owned.write_value(managed_bytes_view(large_value));
+    auto not_owned_msg = not_owned.make_message(4, cql_transport::cql_compression::none).release();
+    BOOST_REQUIRE(std::ranges::none_of(not_owned_msg.fragments(), [&] (const net::fragment& f) {
+        return f.base == reinterpret_cast<const char*>(managed_bytes_view(large_value).current_fragment().data());
+    }));
+
+    // Compression needs the values copied.
+    auto compressed = cql_transport::response(0, cql_transport::cql_binary_opcode::RESULT, tracing::trace_state_ptr());
+    compressed.set_value_source(::make_shared<cql_transport::messages::result_message::void_message>());
+    write_values(compressed);
+    auto compressed_msg = compressed.make_message(4, cql_transport::cql_compression::lz4).release();
+    BOOST_REQUIRE_EQUAL(compressed_msg.len(), compressed.size() + 9);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_result_with_large_keys) {
+    do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table tbl (pk text, ck text, v text, primary key (pk, ck))").get();
+        const auto pk = sstring(20 * 1024, 'p');
+        const auto ck = sstring(20 * 1024, 'c');
+        const auto v = sstring(20 * 1024, 'v');
+        e.execute_cql(format("insert into tbl (pk, ck, v) values ('{}', '{}', '{}')", pk, ck, v)).get();
+
+        auto msg = e.execute_cql("select pk, ck, v from tbl").get0();
+        // The key components are exploded by the result visitor, which is gone
+        // by the time the response is sent, so they have to be copied. Only
+        // the cell value can be sent from the result.
+        auto response = cql_transport::make_result(0, msg, tracing::trace_state_ptr(), 4);
+        auto packet = response->make_message(4, cql_transport::cql_compression::none).release();
+        auto is_fragment = [&packet] (const sstring& value) {
+            return std::ranges::any_of(packet.fragments(), [&value] (const net::fragment& f) {
+                return std::string_view(f.base, f.size) == std::string_view(value);
+            });
+        };
+        BOOST_REQUIRE(is_fragment(v));
+        BOOST_REQUIRE(!is_fragment(pk));
+        BOOST_REQUIRE(!is_fragment(ck));
+
+        auto body = message_bytes(packet);
+        for (const auto& value : {pk, ck, v}) {
+            BOOST_REQUIRE(std::string_view(reinterpret_cast<const char*>(body.data()), body.size()).find(value) != std::string_view::npos);
+        }
+    }).get();
+}
@@ -37,6 +37,11 @@ def test_time_window_compaction_strategy_options(cql):
 def test_leveled_compaction_strategy_options(cql):
     assert_throws(cql, "sstable_size_in_mb value (-5) must be positive", "ALTER TABLE %s WITH compaction = { 'class' : 'LeveledCompactionStrategy', 'sstable_size_in_mb' : -5 }")
 
+def test_incremental_compaction_strategy_options(cql, scylla_only):
+    assert_throws(cql, "sstable_size_in_mb value (0) must be positive", "ALTER TABLE %s WITH compaction = { 'class' : 'IncrementalCompactionStrategy', 'sstable_size_in_mb' : 0 }")
+    assert_throws(cql, "space_amplification_goal value (0.9) must be greater than 1.0", "ALTER TABLE %s WITH compaction = { 'class' : 'IncrementalCompactionStrategy', 'space_amplification_goal' : 0.9 }")
+    assert_throws(cql, "bucket_high value (0.7) must be greater than 1.0", "ALTER TABLE %s WITH compaction = { 'class' : 'IncrementalCompactionStrategy', 'bucket_high' : 0.7 }")
+
 def test_not_allowed_options(cql):
     assert_throws(cql, "Invalid compaction strategy options {{abc, -54.54}} for chosen strategy type", "ALTER TABLE %s WITH compaction = { 'class' : 'SizeTieredCompactionStrategy', 'abc' : -54.54 }")
     assert_throws(cql, "Invalid compaction strategy options {{dog, 3}} for chosen strategy type", "ALTER TABLE %s WITH compaction = { 'class' : 'TimeWindowCompactionStrategy', 'dog' : 3 }")
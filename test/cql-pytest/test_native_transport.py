@@ -3,9 +3,13 @@
 # SPDX-License-Identifier: AGPL-3.0-or-later
 
 import pytest
+import socket
+import struct
 import time
 import nodetool
 from util import new_test_table
+from rest_api import scylla_inject_error
+from test_shedding import ScyllaMetrics
 from cassandra.cluster import NoHostAvailable
 
 def test_enable_disable_binary(cql, test_keyspace):
@@ -29,3 +33,91 @@ def test_enable_disable_binary(cql, test_keyspace):
                 pause += pause
         else:
             assert False
+
+# A prepared LWT statement with a non-deterministic partition key can't be
+# routed to the right shard by the driver, so with more than one shard some of
+# its executions have to run on another shard than the one which received them.
+# Such EXECUTE requests are forwarded, already decoded, to the other shard.
+def bounced_requests(cql):
+    return sum(r.bounced_requests for r in cql.execute("SELECT bounced_requests FROM system.clients"))
+
+def shard_count(cql):
+    return len(set(r.shard_id for r in cql.execute("SELECT shard_id FROM system.clients")))
+
+def test_forwarded_lwt_execute(scylla_only, cql, test_keyspace):
+    with new_test_table(cql, test_keyspace, 'pk timeuuid PRIMARY KEY, v int') as table:
+        before = bounced_requests(cql)
+        stmt = cql.prepare(f"INSERT INTO {table} (pk, v) VALUES (now(), ?) IF NOT EXISTS")
+        for i in range(50):
+            assert list(cql.execute(stmt, [i]))[0][0]
+        assert sorted(r.v for r in cql.execute(f"SELECT v FROM {table}")) == list(range(50))
+        if shard_count(cql) > 1:
+            assert bounced_requests(cql) > before
+
+# If the statement is missing from the prepared statements cache of the shard
+# the request is forwarded to, the client gets an UNPREPARED error, which the
+# driver handles by preparing the statement again and retrying.
+def test_forwarded_execute_unprepared_on_target_shard(scylla_only, cql, test_keyspace):
+    with new_test_table(cql, test_keyspace, 'pk timeuuid PRIMARY KEY, v int') as table:
+        stmt = cql.prepare(f"INSERT INTO {table} (pk, v) VALUES (now(), ?) IF NOT EXISTS")
+        with scylla_inject_error(cql, 'forwarded_execute_prepared_not_found', one_shot=True):
+            for i in range(20):
+                assert list(cql.execute(stmt, [i]))[0][0]
+        assert sorted(r.v for r in cql.execute(f"SELECT v FROM {table}")) == list(range(20))
+
+# Responses to requests pipelined on a connection are written together, with
+# a single flush, and each of them still arrives whole.
+def test_pipelined_responses_are_coalesced(scylla_only, cql):
+    def frame(stream, opcode, body):
+        return struct.pack('>BBhBi', 4, 0, stream, opcode, len(body)) + body
+    def string(s):
+        return struct.pack('>H', len(s)) + s.encode()
+    def read_exactly(sock, n):
+        buf = b''
+        while len(buf) < n:
+            chunk = sock.recv(n - len(buf))
+            assert chunk
+            buf += chunk
+        return buf
+    def read_frame(sock):
+        version, flags, stream, opcode, length = struct.unpack('>BBhBi', read_exactly(sock, 9))
+        assert version == 0x84
+        return stream, opcode, read_exactly(sock, length)
+
+    metrics = ScyllaMetrics.query(cql)
+    flushes_before = metrics.get('scylla_transport_response_flushes')
+    flushed_before = metrics.get('scylla_transport_responses_flushed')
+    if flushes_before is None:
+        pytest.skip('Metrics port 9180 is not available')
+
+    with socket.create_connection((cql.cluster.contact_points[0], cql.cluster.port)) as sock:
+        sock.sendall(frame(0, 0x01, struct.pack('>H', 1) + string('CQL_VERSION') + string('3.0.0')))
+        _, opcode, _ = read_frame(sock)
+        if opcode == 0x03:
+            # AUTHENTICATE, answered with SASL PLAIN credentials.
+            token = b'\0cassandra\0cassandra'
+            sock.sendall(frame(0, 0x0f, struct.pack('>i', len(token)) + token))
+            _, opcode, _ = read_frame(sock)
+            assert opcode == 0x10
+        else:
+            assert opcode == 0x02
+
+        count = 100
+        query = "SELECT key FROM system.local".encode()
+        body = struct.pack('>i', len(query)) + query + struct.pack('>HB', 1, 0)
+        sock.sendall(b''.join(frame(stream, 0x07, body) for stream in range(1, count + 1)))
+        streams = set()
+        for _ in range(count):
+            stream, opcode, body = read_frame(sock)
+            assert opcode == 0x08
+            # A Rows result (kind 2) with the row of system.local.
+            assert struct.unpack('>i', body[:4])[0] == 2
+            assert b'local' in body
+            streams.add(stream)
+        assert streams == set(range(1, count + 1))
+
+    metrics = ScyllaMetrics.query(cql)
+    flushes = metrics.get('scylla_transport_response_flushes') - flushes_before
+    flushed = metrics.get('scylla_transport_responses_flushed') - flushed_before
+    assert flushed >= count
+    assert flushed > flushes
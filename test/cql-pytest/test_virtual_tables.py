@@ -34,6 +34,7 @@ def test_clients(scylla_only, cql):
         'ssl_enabled',
         'ssl_protocol',
         'username',
+        'bounced_requests',
     ])
     cls = list(cql.execute(f"SELECT {columns} FROM system.clients"))
     for cl in cls:
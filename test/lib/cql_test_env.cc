@@ -109,6 +109,7 @@ cql_test_config::cql_test_config(shared_ptr<db::config> cfg)
 
     db_config->add_cdc_extension();
     db_config->add_per_partition_rate_limit_extension();
+    db_config->add_sstable_filter_extension();
 
     db_config->flush_schema_tables_after_modification.set(false);
     db_config->commitlog_use_o_dsync(false);
@@ -547,6 +548,9 @@ class single_node_cql_env : public cql_test_env {
                     .available_memory = dbcfg.available_memory,
                     .static_shares = cfg->compaction_static_shares,
                     .throughput_mb_per_sec = cfg->compaction_throughput_mb_per_sec,
+                    .major_compaction_parallelism = cfg->major_compaction_parallelism,
+                    .tombstone_purge_sched_group = compaction_manager::scheduling_group{dbcfg.compaction_scheduling_group},
+                    .tombstone_purge_interval_in_s = cfg->compaction_tombstone_purge_interval_in_s,
                 };
             });
             _cm.start(std::move(get_cm_cfg), std::ref(abort_sources), std::ref(_task_manager)).get();
@@ -278,6 +278,10 @@ class compaction_manager_test {
     void propagate_replacement(table_state& table_s, const std::vector<sstables::shared_sstable>& removed, const std::vector<sstables::shared_sstable>& added) {
         _cm.propagate_replacement(table_s, removed, added);
     }
+
+    void set_major_compaction_parallelism(uint32_t parallelism) {
+        _cm._cfg.major_compaction_parallelism = utils::updateable_value<uint32_t>(parallelism);
+    }
 private:
     sstables::compaction_data& register_compaction(shared_ptr<compaction::compaction_task_executor> task);
 
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/testing/test_runner.hh>
+
+#include <random>
+
+#include "comparable_bytes.hh"
+#include "schema/schema_builder.hh"
+
+// Compares the cost of ordering composite clustering keys with the
+// type-dispatching comparators and with their byte-comparable encodings.
+class comparable_bytes_keys {
+public:
+    static constexpr size_t count = 1000;
+private:
+    schema_ptr _schema;
+    std::vector<clustering_key> _keys;
+    std::vector<bytes> _encoded;
+public:
+    comparable_bytes_keys()
+        : _schema(schema_builder("ks", "cf")
+                .with_column("pk", utf8_type, column_kind::partition_key)
+                .with_column("ck1", int32_type, column_kind::clustering_key)
+                .with_column("ck2", utf8_type, column_kind::clustering_key)
+                .with_column("ck3", reversed_type_impl::get_instance(long_type), column_kind::clustering_key)
+                .with_column("v", int32_type)
+                .build())
+    {
+        auto eng = seastar::testing::local_random_engine;
+        // Few distinct leading components, so that most comparisons go past the first one.
+        auto ck1 = std::uniform_int_distribution<int32_t>(0, 3);
+        auto ck2 = std::uniform_int_distribution<int>(0, 7);
+        auto ck3 = std::uniform_int_distribution<int64_t>();
+        for (size_t i = 0; i < count; ++i) {
+            _keys.push_back(clustering_key::from_exploded(*_schema, {
+                int32_type->decompose(ck1(eng)),
+                utf8_type->decompose(format("user-{:04}", ck2(eng))),
+                long_type->decompose(ck3(eng)),
+            }));
+        }
+        for (auto& k : _keys) {
+            _encoded.push_back(comparable_bytes::encode_position(*_schema, position_in_partition_view::for_key(k)));
+        }
+    }
+
+    const schema& get_schema() const { return *_schema; }
+    const std::vector<clustering_key>& keys() const { return _keys; }
+    const std::vector<bytes>& encoded() const { return _encoded; }
+};
+
+PERF_TEST_F(comparable_bytes_keys, less_compare) {
+    clustering_key::less_compare less(get_schema());
+    for (size_t i = 1; i < count; ++i) {
+        perf_tests::do_not_optimize(less(keys()[i - 1], keys()[i]));
+    }
+    return count - 1;
+}
+
+PERF_TEST_F(comparable_bytes_keys, position_tri_compare) {
+    position_in_partition::tri_compare cmp(get_schema());
+    for (size_t i = 1; i < count; ++i) {
+        perf_tests::do_not_optimize(cmp(position_in_partition_view::for_key(keys()[i - 1]),
+                position_in_partition_view::for_key(keys()[i])));
+    }
+    return count - 1;
+}
+
+PERF_TEST_F(comparable_bytes_keys, comparable_bytes_compare) {
+    for (size_t i = 1; i < count; ++i) {
+        perf_tests::do_not_optimize(comparable_bytes::tri_compare(encoded()[i - 1], encoded()[i]));
+    }
+    return count - 1;
+}
+
+PERF_TEST_F(comparable_bytes_keys, comparable_bytes_encode) {
+    for (auto& k : keys()) {
+        perf_tests::do_not_optimize(comparable_bytes::encode_position(get_schema(), position_in_partition_view::for_key(k)));
+    }
+    return count;
+}
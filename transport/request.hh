@@ -207,7 +207,9 @@ class request_reader {
         PAGING_STATE,
         SERIAL_CONSISTENCY,
         TIMESTAMP,
-        NAMES_FOR_VALUES
+        NAMES_FOR_VALUES,
+        KEYSPACE,
+        NOW_IN_SECONDS
     };
 
     using options_flag_enum = super_enum<options_flag,
@@ -217,12 +219,18 @@ class request_reader {
         options_flag::PAGING_STATE,
         options_flag::SERIAL_CONSISTENCY,
         options_flag::TIMESTAMP,
-        options_flag::NAMES_FOR_VALUES
+        options_flag::NAMES_FOR_VALUES,
+        options_flag::KEYSPACE,
+        options_flag::NOW_IN_SECONDS
     >;
 public:
     std::unique_ptr<cql3::query_options> read_options(uint8_t version, const cql3::cql_config& cql_config) {
         auto consistency = read_consistency();
-        auto flags = enum_set<options_flag_enum>::from_mask(read_byte());
+        // Since v5 the flags are an [int].
+        auto flags = enum_set<options_flag_enum>::from_mask(version >= 5 ? uint32_t(read_int()) : uint8_t(read_byte()));
+        if (flags.contains<options_flag::KEYSPACE>() || flags.contains<options_flag::NOW_IN_SECONDS>()) {
+            throw exceptions::protocol_exception("Per-query keyspace and now_in_seconds are not supported");
+        }
         std::vector<cql3::raw_value_view> values;
         cql3::unset_bind_variable_vector unset;
         std::vector<sstring_view> names;
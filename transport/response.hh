@@ -34,10 +34,24 @@ enum class cql_binary_opcode : uint8_t {
 };
 
 class response {
+    // Values smaller than this are cheaper to copy to the body than to send as separate fragments.
+    static constexpr size_t min_spliced_value_size = 16 * 1024;
+
+    // A fragment of a value which is sent directly from the result it belongs to,
+    // after the first offset bytes of _body.
+    struct spliced_value {
+        size_t offset;
+        bytes_view value;
+    };
+
     int16_t           _stream;
     cql_binary_opcode _opcode;
     uint8_t           _flags = 0; // a bitwise OR mask of zero or more cql_frame_flags values
     bytes_ostream _body;
+    // Keeps the values referenced by _spliced_values alive.
+    ::shared_ptr<messages::result_message> _value_source;
+    std::vector<spliced_value> _spliced_values;
+    size_t _spliced_size = 0;
 public:
     template<typename T>
     class placeholder;
@@ -57,6 +71,12 @@ class response {
         _flags |= flag;
     }
 
+    // Large values passed to write_owned_value() are not copied, the response
+    // references them instead. They must belong to source.
+    void set_value_source(::shared_ptr<messages::result_message> source) noexcept {
+        _value_source = std::move(source);
+    }
+
     void serialize(const event::schema_change& event, uint8_t version);
     void write_byte(uint8_t b);
     void write_int(int32_t n);
@@ -75,7 +95,12 @@ class response {
     void write_string_multimap(std::multimap<sstring, sstring> string_map);
     void write_value(bytes_opt value);
     void write_value(std::optional<managed_bytes_view> value);
-    void write(const cql3::metadata& m, bool skip = false);
+    // Like write_value(), but the value belongs to the value source, so a large
+    // one is referenced rather than copied. Values which may not outlive the
+    // building of the response, like key components exploded by the result
+    // visitor, must be written with write_value().
+    void write_owned_value(std::optional<managed_bytes_view> value);
+    void write(const cql3::metadata& m, bool skip = false, std::optional<bytes> new_metadata_id = std::nullopt);
     void write(const cql3::prepared_metadata& m, uint8_t version);
 
     // Make a non-owning scattered_message of the response. Remains valid as long
@@ -86,9 +111,37 @@ class response {
         return _opcode;
     }
     size_t size() const {
-        return _body.size();
+        return _body.size() + _spliced_size;
     }
 private:
+    // Calls fn for each non-empty fragment of the body, with the spliced values in place.
+    template <typename Func>
+    void for_each_fragment(Func&& fn) const {
+        auto maybe_fn = [&fn] (bytes_view fragment) {
+            if (!fragment.empty()) {
+                fn(fragment);
+            }
+        };
+        size_t pos = 0;
+        auto spliced = _spliced_values.begin();
+        for (bytes_view fragment : _body.fragments()) {
+            while (spliced != _spliced_values.end() && spliced->offset < pos + fragment.size()) {
+                auto prefix = spliced->offset - pos;
+                maybe_fn(fragment.substr(0, prefix));
+                fragment.remove_prefix(prefix);
+                pos += prefix;
+                maybe_fn(spliced->value);
+                ++spliced;
+            }
+            maybe_fn(fragment);
+            pos += fragment.size();
+        }
+        for (; spliced != _spliced_values.end(); ++spliced) {
+            maybe_fn(spliced->value);
+        }
+    }
+
+    void unsplice_values();
     void compress(cql_compression compression);
     void compress_lz4();
     void compress_snappy();
@@ -107,7 +160,7 @@ class response {
     }
 
     sstring make_frame(uint8_t version, size_t length) {
-        if (version > 0x04) {
+        if (version > 0x05) {
             throw exceptions::protocol_exception(format("Invalid or unsupported protocol version: {:d}", version));
         }
 
@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "transport/segment.hh"
+
+#include <deque>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/unaligned.hh>
+#include <seastar/net/byteorder.hh>
+#include <seastar/net/packet.hh>
+
+#include <libdeflate.h>
+#include <lz4.h>
+
+#include "exceptions/exceptions.hh"
+
+namespace cql_transport {
+
+namespace segment {
+
+uint32_t crc24(uint64_t bytes, unsigned len) noexcept {
+    constexpr uint32_t crc24_init = 0x875060;
+    constexpr uint32_t crc24_poly = 0x1974f0b;
+    uint32_t crc = crc24_init;
+    while (len--) {
+        crc ^= (bytes & 0xff) << 16;
+        bytes >>= 8;
+        for (int i = 0; i < 8; ++i) {
+            crc <<= 1;
+            if (crc & 0x1000000) {
+                crc ^= crc24_poly;
+            }
+        }
+    }
+    return crc;
+}
+
+uint32_t crc32_init() noexcept {
+    // The CRC32 of the payload is seeded with these bytes, so that a zeroed
+    // payload doesn't have a zero checksum.
+    static const uint32_t init = [] {
+        const unsigned char initial_bytes[] = { 0xfa, 0x2d, 0x55, 0xca };
+        return libdeflate_crc32(0, initial_bytes, sizeof(initial_bytes));
+    }();
+    return init;
+}
+
+uint32_t crc32(uint32_t crc, const char* data, size_t size) noexcept {
+    return libdeflate_crc32(crc, data, size);
+}
+
+}
+
+namespace {
+
+using namespace segment;
+
+uint64_t read_le(const char* p, unsigned len) noexcept {
+    uint64_t v = 0;
+    for (unsigned i = 0; i < len; ++i) {
+        v |= uint64_t(uint8_t(p[i])) << (8 * i);
+    }
+    return v;
+}
+
+void write_le(char* p, uint64_t v, unsigned len) noexcept {
+    for (unsigned i = 0; i < len; ++i) {
+        p[i] = char(v & 0xff);
+        v >>= 8;
+    }
+}
+
+// Size of the part of the header covered by the CRC24.
+unsigned header_fields_size(bool compressed) noexcept {
+    return (compressed ? compressed_header_size : header_size) - 3;
+}
+
+class segment_source final : public data_source_impl {
+    input_stream<char> _in;
+    const bool _compressed;
+public:
+    segment_source(input_stream<char> in, bool compressed)
+        : _in(std::move(in))
+        , _compressed(compressed)
+    { }
+
+    virtual future<temporary_buffer<char>> get() override {
+        // An empty buffer signals the end of the stream, so skip empty segments.
+        for (;;) {
+            auto payload = co_await read_segment();
+            if (!payload || !payload->empty()) {
+                co_return payload ? std::move(*payload) : temporary_buffer<char>();
+            }
+        }
+    }
+
+    virtual future<> close() override {
+        return _in.close();
+    }
+private:
+    // Returns std::nullopt on the end of the stream.
+    future<std::optional<temporary_buffer<char>>> read_segment() {
+        const auto fields_size = header_fields_size(_compressed);
+        auto header = co_await _in.read_exactly(fields_size + 3);
+        if (header.empty()) {
+            co_return std::nullopt;
+        }
+        if (header.size() != fields_size + 3) {
+            throw exceptions::protocol_exception("truncated segment header");
+        }
+        auto fields = read_le(header.get(), fields_size);
+        if (crc24(fields, fields_size) != read_le(header.get() + fields_size, 3)) {
+            throw exceptions::protocol_exception("segment header checksum mismatch");
+        }
+        const size_t payload_size = fields & max_payload_size;
+        const size_t uncompressed_size = _compressed ? (fields >> 17) & max_payload_size : 0;
+
+        auto payload = co_await _in.read_exactly(payload_size + crc_size);
+        if (payload.size() != payload_size + crc_size) {
+            throw exceptions::protocol_exception("truncated segment");
+        }
+        if (crc32(crc32_init(), payload.get(), payload_size) != read_le(payload.get() + payload_size, crc_size)) {
+            throw exceptions::protocol_exception("segment payload checksum mismatch");
+        }
+        payload.trim(payload_size);
+        if (!uncompressed_size) {
+            co_return std::move(payload);
+        }
+        temporary_buffer<char> out(uncompressed_size);
+        auto ret = LZ4_decompress_safe(payload.get(), out.get_write(), payload.size(), out.size());
+        if (ret < 0 || size_t(ret) != uncompressed_size) {
+            throw exceptions::protocol_exception("segment LZ4 decompression failure");
+        }
+        co_return std::move(out);
+    }
+};
+
+class segment_sink final : public data_sink_impl {
+    static constexpr size_t envelope_header_size = 9;
+
+    output_stream<char>& _out;
+    const bool _compressed;
+
+    // Data written to the sink but not yet to _out.
+    std::deque<temporary_buffer<char>> _pending;
+    // The sizes of the complete envelopes at the front of _pending.
+    std::deque<size_t> _complete;
+
+    // The state of the envelope which is being written.
+    char _header[envelope_header_size];
+    size_t _header_filled = 0;
+    size_t _body_left = 0;
+public:
+    segment_sink(output_stream<char>& out, bool compressed)
+        : _out(out)
+        , _compressed(compressed)
+    { }
+
+    virtual future<> put(net::packet data) override {
+        for (auto& buf : data.release()) {
+            track_envelopes(buf.get(), buf.size());
+            if (!buf.empty()) {
+                _pending.push_back(std::move(buf));
+            }
+        }
+        while (!_complete.empty()) {
+            if (_complete.front() > max_payload_size) {
+                // Too large for a single segment.
+                auto left = _complete.front();
+                _complete.pop_front();
+                while (left) {
+                    auto size = std::min(left, max_payload_size);
+                    co_await write_segment(take(size), size, false);
+                    left -= size;
+                }
+            } else {
+                size_t size = 0;
+                while (!_complete.empty() && size + _complete.front() <= max_payload_size) {
+                    size += _complete.front();
+                    _complete.pop_front();
+                }
+                co_await write_segment(take(size), size, true);
+            }
+        }
+    }
+
+    virtual future<> flush() override {
+        return _out.flush();
+    }
+
+    virtual future<> close() override {
+        return _out.flush();
+    }
+private:
+    void track_envelopes(const char* p, size_t n) {
+        while (n) {
+            if (_header_filled < envelope_header_size) {
+                auto c = std::min(n, envelope_header_size - _header_filled);
+                std::copy_n(p, c, _header + _header_filled);
+                _header_filled += c;
+                p += c;
+                n -= c;
+                if (_header_filled < envelope_header_size) {
+                    break;
+                }
+                _body_left = net::ntoh(read_unaligned<uint32_t>(_header + 5));
+            }
+            auto c = std::min(n, _body_left);
+            _body_left -= c;
+            p += c;
+            n -= c;
+            if (!_body_left) {
+                _complete.push_back(envelope_header_size + net::ntoh(read_unaligned<uint32_t>(_header + 5)));
+                _header_filled = 0;
+            }
+        }
+    }
+
+    std::vector<temporary_buffer<char>> take(size_t size) {
+        std::vector<temporary_buffer<char>> bufs;
+        while (size) {
+            auto& front = _pending.front();
+            if (front.size() <= size) {
+                size -= front.size();
+                bufs.push_back(std::move(front));
+                _pending.pop_front();
+            } else {
+                bufs.push_back(front.share(0, size));
+                front.trim_front(size);
+                size = 0;
+            }
+        }
+        return bufs;
+    }
+
+    future<> write_segment(std::vector<temporary_buffer<char>> bufs, size_t size, bool self_contained) {
+        if (_compressed) {
+            return write_compressed_segment(std::move(bufs), size, self_contained);
+        }
+        temporary_buffer<char> header(header_size);
+        uint64_t fields = size | (uint64_t(self_contained) << 17);
+        write_le(header.get_write(), fields, 3);
+        write_le(header.get_write() + 3, crc24(fields, 3), 3);
+
+        auto crc = crc32_init();
+        net::packet p(std::move(header));
+        for (auto& buf : bufs) {
+            crc = crc32(crc, buf.get(), buf.size());
+            p = net::packet(std::move(p), std::move(buf));
+        }
+        temporary_buffer<char> trailer(crc_size);
+        write_le(trailer.get_write(), crc, crc_size);
+        p = net::packet(std::move(p), std::move(trailer));
+        return _out.write(std::move(p));
+    }
+
+    future<> write_compressed_segment(std::vector<temporary_buffer<char>> bufs, size_t size, bool self_contained) {
+        temporary_buffer<char> in;
+        if (bufs.size() == 1) {
+            in = std::move(bufs.front());
+        } else {
+            in = temporary_buffer<char>(size);
+            auto out = in.get_write();
+            for (auto& buf : bufs) {
+                out = std::copy_n(buf.get(), buf.size(), out);
+            }
+        }
+        temporary_buffer<char> buf(compressed_header_size + LZ4_COMPRESSBOUND(size) + crc_size);
+        auto payload = buf.get_write() + compressed_header_size;
+        auto compressed_size = size_t(LZ4_compress_default(in.get(), payload, size, LZ4_COMPRESSBOUND(size)));
+        size_t uncompressed_size = size;
+        if (compressed_size == 0 || compressed_size >= size) {
+            // Not worth it, send the payload as it is.
+            std::copy_n(in.get(), size, payload);
+            compressed_size = size;
+            uncompressed_size = 0;
+        }
+        uint64_t fields = compressed_size | (uint64_t(uncompressed_size) << 17) | (uint64_t(self_contained) << 34);
+        write_le(buf.get_write(), fields, 5);
+        write_le(buf.get_write() + 5, crc24(fields, 5), 3);
+        write_le(payload + compressed_size, crc32(crc32_init(), payload, compressed_size), crc_size);
+        buf.trim(compressed_header_size + compressed_size + crc_size);
+        return _out.write(std::move(buf));
+    }
+};
+
+}
+
+input_stream<char> make_segment_input_stream(input_stream<char> in, bool compressed) {
+    return input_stream<char>(data_source(std::make_unique<segment_source>(std::move(in), compressed)));
+}
+
+output_stream<char> make_segment_output_stream(output_stream<char>& out, bool compressed) {
+    return output_stream<char>(data_sink(std::make_unique<segment_sink>(out, compressed)), 8192);
+}
+
+}
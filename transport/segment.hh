@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <seastar/core/iostream.hh>
+
+#include "seastarx.hh"
+
+namespace cql_transport {
+
+/**
+ * Framing of the native protocol v5.
+ *
+ * Once a v5 connection is established, i.e. after the server responded to
+ * STARTUP with READY or AUTHENTICATE, the frames of the older protocol versions
+ * (called envelopes in the v5 specification) are no longer sent as they are, but
+ * wrapped in segments. A segment is self-contained if it holds one or more
+ * complete envelopes, otherwise it holds a part of a single envelope which is
+ * too large to fit in one segment.
+ *
+ * A segment consists of a header, protected by a CRC24, and of a payload, followed
+ * by its CRC32. When LZ4 compression was negotiated in STARTUP, the payload of each
+ * segment is compressed, unless that doesn't make it smaller.
+ *
+ * Uncompressed header (little-endian, 6 bytes):
+ *   17 bits payload length, 1 bit self-contained flag, 6 bits padding, 24 bits CRC24.
+ * Compressed header (little-endian, 8 bytes):
+ *   17 bits compressed length, 17 bits uncompressed length (0 if not compressed),
+ *   1 bit self-contained flag, 5 bits padding, 24 bits CRC24.
+ */
+namespace segment {
+
+constexpr size_t max_payload_size = (size_t(1) << 17) - 1;
+constexpr size_t header_size = 6;
+constexpr size_t compressed_header_size = 8;
+constexpr size_t crc_size = 4;
+
+// CRC24 of the first len bytes of the little-endian representation of bytes,
+// as used to protect segment headers.
+uint32_t crc24(uint64_t bytes, unsigned len) noexcept;
+
+// The CRC32 of segment payloads. Data can be checksummed in pieces by passing
+// the result of the previous call as crc.
+uint32_t crc32_init() noexcept;
+uint32_t crc32(uint32_t crc, const char* data, size_t size) noexcept;
+
+}
+
+// Returns a stream of the envelopes carried in the segments read from in.
+// Throws exceptions::protocol_exception on corrupted segments.
+input_stream<char> make_segment_input_stream(input_stream<char> in, bool compressed);
+
+// Returns a stream which writes the envelopes written to it to out, in segments.
+// Envelopes are grouped in segments only on their boundaries, so they should
+// be written whole before the stream is flushed.
+// out must outlive the returned stream. Closing the returned stream flushes out,
+// but does not close it, so that the connection keeps owning its socket stream.
+output_stream<char> make_segment_output_stream(output_stream<char>& out, bool compressed);
+
+}
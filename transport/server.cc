@@ -36,6 +36,7 @@
 #include <seastar/net/tls.hh>
 #include <seastar/util/lazy.hh>
 #include <seastar/util/short_streams.hh>
+#include <seastar/util/later.hh>
 #include <seastar/core/execution_stage.hh>
 #include "utils/result_try.hh"
 #include "utils/result_combinators.hh"
@@ -64,6 +65,8 @@
 #include "utils/bit_cast.hh"
 #include "db/config.hh"
 #include "utils/reusable_buffer.hh"
+#include "utils/hashers.hh"
+#include "utils/error_injection.hh"
 
 template<typename T = void>
 using coordinator_result = exceptions::coordinator_result<T>;
@@ -270,6 +273,12 @@ cql_server::cql_server(distributed<cql3::query_processor>& qp, auth::service& au
         sm::make_counter("requests_shed", _stats.requests_shed,
                         sm::description("Holds an incrementing counter with the requests that were shed due to overload (threshold configured via max_concurrent_requests_per_shard). "
                                             "The first derivative of this value shows how often we shed requests due to overload in the \"CQL transport\" component.")),
+        sm::make_counter("response_flushes", _stats.response_flushes,
+                        sm::description("Counts the flushes of responses to client connections. "
+                                        "Responses which are ready at the same time are written with a single flush, "
+                                        "so responses_flushed divided by response_flushes is the number of responses per flush.")),
+        sm::make_counter("responses_flushed", _stats.responses_flushed,
+                        sm::description("Counts the responses written to client connections.")),
         sm::make_gauge("requests_memory_available", [this] { return _memory_available.current(); },
                         sm::description(
                             seastar::format("Holds the amount of available memory for admitting new requests (max is {}B)."
@@ -338,7 +347,8 @@ cql_server::connection::parse_frame(temporary_buffer<char> buf) const {
     cql_binary_frame_v3 v3;
     switch (_version) {
     case 3:
-    case 4: {
+    case 4:
+    case 5: {
         cql_binary_frame_v3 raw = read_unaligned<cql_binary_frame_v3>(buf.get());
         v3 = net::ntoh(raw);
         break;
@@ -490,6 +500,11 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
                     } else if (res_op == cql_binary_opcode::READY) {
                         client_state.set_auth_state(auth_state::READY);
                     }
+                    if (_version >= 5 && (res_op == cql_binary_opcode::AUTHENTICATE || res_op == cql_binary_opcode::READY)) {
+                        // STARTUP is not processed in parallel with reading the following
+                        // requests, so nothing is reading from _read_buf now.
+                        _read_buf = make_segment_input_stream(std::move(_read_buf), _compression == cql_compression::lz4);
+                    }
                 }
                 break;
             case auth_state::AUTHENTICATION:
@@ -619,6 +634,7 @@ client_data cql_server::connection::make_client_data() const {
     std::tie(cd.ip, cd.port, cd.ct) = make_client_key(_client_state);
     cd.shard_id = this_shard_id();
     cd.protocol_version = _version;
+    cd.bounced_requests = _bounced_requests;
     cd.driver_name = _client_state.get_driver_name();
     cd.driver_version = _client_state.get_driver_version();
     if (const auto user_ptr = _client_state.user(); user_ptr) {
@@ -746,6 +762,7 @@ future<> cql_server::connection::process_request() {
             ++_server._stats.requests_serving;
 
             _pending_requests_gate.enter();
+            ++_requests_being_processed;
             auto leave = defer([this] {
                 _shedding_timer.cancel();
                 _shed_incoming_requests = false;
@@ -766,6 +783,7 @@ future<> cql_server::connection::process_request() {
                     process_request_one(istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit);
 
             future<> request_response_future = request_process_future.then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave), stream] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+                --_requests_being_processed;
                 try {
                     if (response_f.failed()) {
                         const auto message = format("request processing failed, error [{}]", response_f.get_exception());
@@ -774,7 +792,8 @@ future<> cql_server::connection::process_request() {
                                                   message,
                                                   tracing::trace_state_ptr()));
                     } else {
-                        write_response(response_f.get0(), std::move(mem_permit), _compression);
+                        // Since v5 compression is applied to whole segments, not to single frames.
+                        write_response(response_f.get0(), std::move(mem_permit), _version < 5 ? _compression : cql_compression::none);
                     }
                     _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave)] {});
                 } catch (...) {
@@ -811,6 +830,9 @@ static utils::reusable_buffer_guard output_buffer_guard() {
 future<fragmented_temporary_buffer> cql_server::connection::read_and_decompress_frame(size_t length, uint8_t flags)
 {
     if (flags & cql_frame_flags::compression) {
+        if (_version >= 5) {
+            throw exceptions::protocol_exception("Compressed frames are not allowed in protocol v5, compression applies to segments");
+        }
         if (_compression == cql_compression::lz4) {
             if (length < 4) {
                 throw std::runtime_error(fmt::format("CQL frame truncated: expected to have at least 4 bytes, got {}", length));
@@ -872,6 +894,9 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_st
          if (compression == "lz4") {
              _compression = cql_compression::lz4;
          } else if (compression == "snappy") {
+             if (_version >= 5) {
+                 throw exceptions::protocol_exception("Snappy compression is not supported in protocol v5");
+             }
              _compression = cql_compression::snappy;
          } else {
              throw exceptions::protocol_exception(format("Unknown compression algorithm: {}", compression));
@@ -947,10 +972,6 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_op
     return make_ready_future<std::unique_ptr<cql_server::response>>(make_supported(stream, std::move(trace_state)));
 }
 
-std::unique_ptr<cql_server::response>
-make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata = false);
-
 template<typename Process>
 future<cql_server::result_with_foreign_response_ptr>
 cql_server::connection::process_on_shard(::shared_ptr<messages::result_message::bounce_to_shard> bounce_msg, uint16_t stream, fragmented_temporary_buffer::istream is,
@@ -975,9 +996,21 @@ cql_server::connection::process_on_shard(::shared_ptr<messages::result_message::
     });
 }
 
+// An EXECUTE request which has to be executed on another shard. Instead of parsing
+// the request again, the other shard uses the options decoded here, which reference
+// the request buffers of this shard. Keeps them alive until the request completes.
+struct cql_server::forwarded_execute {
+    ::shared_ptr<messages::result_message::bounce_to_shard> bounce;
+    std::unique_ptr<cql_query_state> q_state;
+    cql3::prepared_cache_key_type cache_key;
+    std::optional<bytes> result_metadata_id;
+    bool skip_metadata;
+};
+
 using process_fn_return_type = std::variant<
     cql_server::result_with_foreign_response_ptr,
-    ::shared_ptr<messages::result_message::bounce_to_shard>>;
+    ::shared_ptr<messages::result_message::bounce_to_shard>,
+    std::unique_ptr<cql_server::forwarded_execute>>;
 
 static inline cql_server::result_with_foreign_response_ptr convert_error_message_to_coordinator_result(messages::result_message* msg) {
     return std::move(*dynamic_cast<messages::result_message::exception*>(msg)).get_exception();
@@ -995,8 +1028,14 @@ cql_server::connection::process(uint16_t stream, request_reader in, service::cli
                    (process_fn_return_type msg) mutable {
         auto* bounce_msg = std::get_if<shared_ptr<messages::result_message::bounce_to_shard>>(&msg);
         if (bounce_msg) {
+            ++_bounced_requests;
             return process_on_shard(*bounce_msg, stream, is, client_state, std::move(permit), trace_state, process_fn);
         }
+        auto* forwarded = std::get_if<std::unique_ptr<forwarded_execute>>(&msg);
+        if (forwarded) {
+            ++_bounced_requests;
+            return process_forwarded_execute(std::move(*forwarded), stream, client_state, trace_state);
+        }
         auto ptr = std::get<cql_server::result_with_foreign_response_ptr>(std::move(msg));
         return make_ready_future<cql_server::result_with_foreign_response_ptr>(std::move(ptr));
     });
@@ -1033,7 +1072,7 @@ process_query_internal(service::client_state& client_state, distributed<cql3::qu
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return process_fn_return_type(make_foreign(make_result(stream, msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
         }
     });
 }
@@ -1047,6 +1086,12 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_pr
         tracing::trace_state_ptr trace_state) {
 
     auto query = sstring(in.read_long_string_view());
+    if (_version >= 5) {
+        // Since v5 the query is followed by [int] flags, 0x01 meaning that a keyspace follows.
+        if (in.read_int() & 0x01) {
+            throw exceptions::protocol_exception("Per-query keyspace is not supported");
+        }
+    }
 
     tracing::add_query(trace_state, query);
     tracing::begin(trace_state, "Preparing CQL3 query", client_state.get_client_address());
@@ -1067,7 +1112,7 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_pr
             tracing::trace(trace_state, "Done preparing on a local shard - preparing a result. ID is [{}]", seastar::value_of([&msg] {
                 return messages::result_message::prepared::cql::get_id(msg);
             }));
-            return make_result(stream, *msg, trace_state, _version);
+            return make_result(stream, msg, trace_state, _version);
         });
     });
 }
@@ -1078,6 +1123,10 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
         service_permit permit, tracing::trace_state_ptr trace_state, bool init_trace, cql3::computed_function_values cached_pk_fn_calls) {
     cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
     auto& id = cql3::prepared_cache_key_type::cql_id(cache_key);
+    std::optional<bytes> result_metadata_id;
+    if (version >= 5) {
+        result_metadata_id = in.read_short_bytes();
+    }
     bool needs_authorization = false;
 
     // First, try to lookup in the cache of already authorized statements. If the corresponding entry is not found there
@@ -1129,15 +1178,22 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
     }
 
     tracing::trace(trace_state, "Processing a statement");
-    return qp.local().execute_prepared_without_checking_exception_message(query_state, std::move(stmt), options, std::move(prepared), std::move(cache_key), needs_authorization)
-            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version] (auto msg) {
+    return qp.local().execute_prepared_without_checking_exception_message(query_state, std::move(stmt), options, std::move(prepared), cache_key, needs_authorization)
+            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version,
+                    cache_key, result_metadata_id = std::move(result_metadata_id)] (auto msg) mutable {
         if (msg->move_to_shard()) {
-            return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
+            return process_fn_return_type(std::make_unique<cql_server::forwarded_execute>(cql_server::forwarded_execute{
+                    .bounce = dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg),
+                    .q_state = std::move(q_state),
+                    .cache_key = std::move(cache_key),
+                    .result_metadata_id = std::move(result_metadata_id),
+                    .skip_metadata = skip_metadata}));
         } else if (msg->is_exception()) {
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return process_fn_return_type(make_foreign(make_result(stream, msg, q_state->query_state.get_trace_state(), version, skip_metadata,
+                    std::move(result_metadata_id))));
         }
     });
 }
@@ -1147,6 +1203,62 @@ future<cql_server::result_with_foreign_response_ptr> cql_server::connection::pro
     return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_execute_internal);
 }
 
+static future<process_fn_return_type>
+process_forwarded_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp,
+        const cql_server::forwarded_execute& fwd, uint16_t stream, cql_protocol_version_type version,
+        tracing::trace_state_ptr trace_state, cql3::computed_function_values cached_pk_fn_calls) {
+    // The statement was authorized on the shard which received the request,
+    // it only needs to be looked up in the prepared cache of this shard.
+    auto prepared = qp.local().get_prepared(fwd.cache_key);
+    if (!prepared || utils::get_local_injector().enter("forwarded_execute_prepared_not_found")) {
+        throw exceptions::prepared_query_not_found_exception(cql3::prepared_cache_key_type::cql_id(fwd.cache_key));
+    }
+
+    auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, empty_service_permit());
+    auto& query_state = q_state->query_state;
+    q_state->options = std::make_unique<cql3::query_options>(qp.local().get_cql_config(), *fwd.q_state->options);
+    auto& options = *q_state->options;
+    if (!cached_pk_fn_calls.empty()) {
+        options.set_cached_pk_function_calls(std::move(cached_pk_fn_calls));
+    }
+
+    tracing::trace(trace_state, "Processing a statement forwarded from another shard");
+    auto stmt = prepared->statement;
+    return qp.local().execute_prepared_without_checking_exception_message(query_state, std::move(stmt), options, std::move(prepared), fwd.cache_key, false)
+            .then([q_state = std::move(q_state), stream, version, skip_metadata = fwd.skip_metadata, result_metadata_id = fwd.result_metadata_id] (auto msg) mutable {
+        if (msg->move_to_shard()) {
+            return process_fn_return_type(dynamic_pointer_cast<messages::result_message::bounce_to_shard>(msg));
+        } else if (msg->is_exception()) {
+            return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
+        } else {
+            tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
+            return process_fn_return_type(make_foreign(make_result(stream, msg, q_state->query_state.get_trace_state(), version, skip_metadata,
+                    std::move(result_metadata_id))));
+        }
+    });
+}
+
+future<cql_server::result_with_foreign_response_ptr>
+cql_server::connection::process_forwarded_execute(std::unique_ptr<forwarded_execute> fwd, uint16_t stream, service::client_state& cs,
+        tracing::trace_state_ptr trace_state) {
+    auto shard = *fwd->bounce->move_to_shard();
+    auto cached_vals = std::move(fwd->bounce->take_cached_pk_function_calls());
+    auto& fwd_ref = *fwd;
+    return _server.container().invoke_on(shard, _server._config.bounce_request_smp_service_group,
+            [this, &fwd = fwd_ref, cs = cs.move_to_other_shard(), stream,
+             gt = tracing::global_trace_state_ptr(std::move(trace_state)),
+             cached_vals = std::move(cached_vals)] (cql_server& server) mutable {
+        return do_with(cs.get(), [this, &server, &fwd, stream, trace_state = tracing::trace_state_ptr(gt),
+                cached_vals = std::move(cached_vals)] (service::client_state& client_state) mutable {
+            return process_forwarded_execute_internal(client_state, server._query_processor, fwd, stream, _version,
+                    std::move(trace_state), std::move(cached_vals)).then([] (process_fn_return_type msg) {
+                // A request is bounced at most once, so the result here has to be a response.
+                return std::get<cql_server::result_with_foreign_response_ptr>(std::move(msg));
+            });
+        });
+    }).finally([fwd = std::move(fwd)] { });
+}
+
 static future<process_fn_return_type>
 process_batch_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version,
@@ -1258,7 +1370,7 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
             return process_fn_return_type(convert_error_message_to_coordinator_result(msg.get()));
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return process_fn_return_type(make_foreign(make_result(stream, *msg, trace_state, version)));
+            return process_fn_return_type(make_foreign(make_result(stream, msg, trace_state, version)));
         }
     });
 }
@@ -1305,6 +1417,22 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_read_timeout_
     return response;
 }
 
+// Since v5 failures are reported as a map of the failed replicas to reason codes.
+// The replicas are not known at this point, so report them as unknown.
+static void write_failures(cql_server::response& response, int32_t numfailures, uint8_t version) {
+    response.write_int(numfailures);
+    if (version < 5) {
+        return;
+    }
+    for (int32_t i = 0; i < numfailures; ++i) {
+        response.write_byte(4);
+        for (int j = 0; j < 4; ++j) {
+            response.write_byte(0);
+        }
+        response.write_short(0x0000); // UNKNOWN
+    }
+}
+
 std::unique_ptr<cql_server::response> cql_server::connection::make_read_failure_error(int16_t stream, exceptions::exception_code err, sstring msg, db::consistency_level cl, int32_t received, int32_t numfailures, int32_t blockfor, bool data_present, const tracing::trace_state_ptr& tr_state) const
 {
     if (_version < 4) {
@@ -1316,7 +1444,7 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_read_failure_
     response->write_consistency(cl);
     response->write_int(received);
     response->write_int(blockfor);
-    response->write_int(numfailures);
+    write_failures(*response, numfailures, _version);
     response->write_byte(data_present);
     return response;
 }
@@ -1344,7 +1472,7 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_mutation_writ
     response->write_consistency(cl);
     response->write_int(received);
     response->write_int(blockfor);
-    response->write_int(numfailures);
+    write_failures(*response, numfailures, _version);
     response->write_string(format("{}", type));
     return response;
 }
@@ -1460,16 +1588,34 @@ std::unique_ptr<cql_server::response> cql_server::connection::make_supported(int
     return response;
 }
 
+// Identifies the result metadata of a prepared statement in protocol v5, so that
+// clients can skip it in results and still learn when it changes.
+static bytes compute_result_metadata_id(const cql3::metadata& m) {
+    md5_hasher h;
+    auto names_i = m.get_names().begin();
+    for (uint32_t i = 0; i < m.column_count(); ++i, ++names_i) {
+        const auto& name = **names_i;
+        for (const auto& s : {std::string_view(name.ks_name), std::string_view(name.cf_name),
+                std::string_view(name.name->text()), std::string_view(name.type->name())}) {
+            h.update(s.data(), s.size());
+            h.update("\0", 1);
+        }
+    }
+    return h.finalize();
+}
+
 class cql_server::fmt_visitor : public messages::result_message::visitor_base {
 private:
     uint8_t _version;
     cql_server::response& _response;
     bool _skip_metadata;
+    std::optional<bytes> _result_metadata_id;
 public:
-    fmt_visitor(uint8_t version, cql_server::response& response, bool skip_metadata)
+    fmt_visitor(uint8_t version, cql_server::response& response, bool skip_metadata, std::optional<bytes> result_metadata_id = std::nullopt)
         : _version{version}
         , _response{response}
         , _skip_metadata{skip_metadata}
+        , _result_metadata_id{std::move(result_metadata_id)}
     { }
 
     virtual void visit(const messages::result_message::void_message&) override {
@@ -1484,6 +1630,9 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
     virtual void visit(const messages::result_message::prepared::cql& m) override {
         _response.write_int(0x0004);
         _response.write_short_bytes(m.get_id());
+        if (_version >= 5) {
+            _response.write_short_bytes(compute_result_metadata_id(*m.result_metadata()));
+        }
         _response.write(m.metadata(), _version);
         _response.write(*m.result_metadata());
     }
@@ -1505,7 +1654,14 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
     virtual void visit(const messages::result_message::rows& m) override {
         _response.write_int(0x0002);
         auto& rs = m.rs();
-        _response.write(rs.get_metadata(), _skip_metadata);
+        std::optional<bytes> new_metadata_id;
+        if (_result_metadata_id) {
+            new_metadata_id = compute_result_metadata_id(rs.get_metadata());
+            if (new_metadata_id == _result_metadata_id) {
+                new_metadata_id.reset();
+            }
+        }
+        _response.write(rs.get_metadata(), _skip_metadata && !new_metadata_id, std::move(new_metadata_id));
         auto row_count_plhldr = _response.write_int_placeholder();
 
         class visitor {
@@ -1520,6 +1676,9 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
             void accept_value(std::optional<managed_bytes_view> cell) {
                 _response.write_value(cell);
             }
+            void accept_owned_value(std::optional<managed_bytes_view> cell) {
+                _response.write_owned_value(cell);
+            }
             void end_row() { }
 
             int64_t row_count() const { return _row_count; }
@@ -1532,15 +1691,17 @@ class cql_server::fmt_visitor : public messages::result_message::visitor_base {
 };
 
 std::unique_ptr<cql_server::response>
-make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata) {
+make_result(int16_t stream, ::shared_ptr<messages::result_message> msg, const tracing::trace_state_ptr& tr_state,
+        cql_protocol_version_type version, bool skip_metadata, std::optional<bytes> result_metadata_id) {
     auto response = std::make_unique<cql_server::response>(stream, cql_binary_opcode::RESULT, tr_state);
-    if (__builtin_expect(!msg.warnings().empty() && version > 3, false)) {
+    if (__builtin_expect(!msg->warnings().empty() && version > 3, false)) {
         response->set_frame_flag(cql_frame_flags::warning);
-        response->write_string_list(msg.warnings());
+        response->write_string_list(msg->warnings());
     }
-    cql_server::fmt_visitor fmt{version, *response, skip_metadata};
-    msg.accept(fmt);
+    // The values of the result may be sent directly from it.
+    response->set_value_source(msg);
+    cql_server::fmt_visitor fmt{version, *response, skip_metadata, std::move(result_metadata_id)};
+    msg->accept(fmt);
     return response;
 }
 
@@ -1575,13 +1736,42 @@ cql_server::connection::make_schema_change_event(const event::schema_change& eve
 
 void cql_server::connection::write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit, cql_compression compression)
 {
-    _ready_to_respond = _ready_to_respond.then([this, compression, response = std::move(response), permit = std::move(permit)] () mutable {
-        auto message = response->make_message(_version, compression);
-        message.on_delete([response = std::move(response)] { });
-        return _write_buf.write(std::move(message)).then([this] {
-            return _write_buf.flush();
+    // Responses which become ready before the scheduled flush starts are
+    // written together with it, with a single flush.
+    _pending_responses.push_back(pending_response{std::move(response), std::move(permit), compression});
+    if (!_responses_flush_scheduled) {
+        _responses_flush_scheduled = true;
+        _ready_to_respond = _ready_to_respond.then([this] {
+            return flush_responses();
         });
-    });
+    }
+}
+
+future<> cql_server::connection::flush_responses() {
+    // Let the other requests which are ready complete and join this flush.
+    // A lone request is responded to right away.
+    if (_requests_being_processed) {
+        co_await seastar::yield();
+    }
+    _responses_flush_scheduled = false;
+    auto responses = std::exchange(_pending_responses, {});
+    for (auto& r : responses) {
+        // In v5 the responses following READY or AUTHENTICATE are wrapped in segments.
+        bool start_segments = _version >= 5 && !_segment_buf
+                && (r.response->opcode() == cql_binary_opcode::READY || r.response->opcode() == cql_binary_opcode::AUTHENTICATE);
+        auto message = r.response->make_message(_version, r.compression);
+        message.on_delete([response = std::move(r.response)] { });
+        auto& out = _segment_buf ? *_segment_buf : _write_buf;
+        co_await out.write(std::move(message));
+        if (start_segments) {
+            // The segments are written to _write_buf, after what it already buffers.
+            // It isn't replaced, since it may have a batched flush pending.
+            _segment_buf.emplace(make_segment_output_stream(_write_buf, _compression == cql_compression::lz4));
+        }
+    }
+    co_await (_segment_buf ? *_segment_buf : _write_buf).flush();
+    ++_server._stats.response_flushes;
+    _server._stats.responses_flushed += responses.size();
 }
 
 scattered_message<char> cql_server::response::make_message(uint8_t version, cql_compression compression) {
@@ -1589,16 +1779,31 @@ scattered_message<char> cql_server::response::make_message(uint8_t version, cql_
         compress(compression);
     }
     scattered_message<char> msg;
-    auto frame = make_frame(version, _body.size());
+    auto frame = make_frame(version, size());
     msg.append(std::move(frame));
-    for (auto&& fragment : _body.fragments()) {
+    for_each_fragment([&msg] (bytes_view fragment) {
         msg.append_static(reinterpret_cast<const char*>(fragment.data()), fragment.size());
-    }
+    });
     return msg;
 }
 
+void cql_server::response::unsplice_values() {
+    if (_spliced_values.empty()) {
+        return;
+    }
+    bytes_ostream body;
+    for_each_fragment([&body] (bytes_view fragment) {
+        body.write(fragment);
+    });
+    _body = std::move(body);
+    _spliced_values.clear();
+    _spliced_size = 0;
+}
+
 void cql_server::response::compress(cql_compression compression)
 {
+    // The compressors need the whole body in _body.
+    unsplice_values();
     switch (compression) {
     case cql_compression::lz4:
         compress_lz4();
@@ -1813,6 +2018,21 @@ void cql_server::response::write_value(std::optional<managed_bytes_view> value)
     }
 }
 
+void cql_server::response::write_owned_value(std::optional<managed_bytes_view> value)
+{
+    if (!value || !_value_source || value->size_bytes() < min_spliced_value_size) {
+        write_value(value);
+        return;
+    }
+
+    write_int(value->size_bytes());
+    while (!value->empty()) {
+        _spliced_values.push_back(spliced_value{_body.size(), value->current_fragment()});
+        _spliced_size += value->current_fragment().size();
+        value->remove_current();
+    }
+}
+
 class type_codec {
 private:
     enum class type_id : int16_t {
@@ -1933,7 +2153,7 @@ thread_local const type_codec::type_id_to_type_type type_codec::type_id_to_type
     { inet_addr_type, type_id::INET },
 };
 
-void cql_server::response::write(const cql3::metadata& m, bool no_metadata) {
+void cql_server::response::write(const cql3::metadata& m, bool no_metadata, std::optional<bytes> new_metadata_id) {
     auto flags = m.flags();
     bool global_tables_spec = m.flags().contains<cql3::metadata::flag::GLOBAL_TABLES_SPEC>();
     bool has_more_pages = m.flags().contains<cql3::metadata::flag::HAS_MORE_PAGES>();
@@ -1941,6 +2161,9 @@ void cql_server::response::write(const cql3::metadata& m, bool no_metadata) {
     if (no_metadata) {
         flags.set<cql3::metadata::flag::NO_METADATA>();
     }
+    if (new_metadata_id) {
+        flags.set<cql3::metadata::flag::METADATA_CHANGED>();
+    }
 
     write_int(flags.mask());
     write_int(m.column_count());
@@ -1949,6 +2172,10 @@ void cql_server::response::write(const cql3::metadata& m, bool no_metadata) {
         write_value(m.paging_state()->serialize());
     }
 
+    if (new_metadata_id) {
+        write_short_bytes(std::move(*new_metadata_id));
+    }
+
     if (no_metadata) {
         return;
     }
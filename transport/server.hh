@@ -26,6 +26,7 @@
 #include <seastar/core/execution_stage.hh>
 #include "utils/updateable_value.hh"
 #include "generic_server.hh"
+#include "transport/segment.hh"
 #include "service/query_state.hh"
 #include "cql3/query_options.hh"
 #include "transport/messages/result_message.hh"
@@ -139,13 +140,16 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         uint32_t requests_serving = 0;
         uint64_t requests_blocked_memory = 0;
         uint64_t requests_shed = 0;
+        uint64_t response_flushes = 0;
+        uint64_t responses_flushed = 0;
 
         std::unordered_map<exceptions::exception_code, uint64_t> errors;
     };
 private:
     class event_notifier;
 
-    static constexpr cql_protocol_version_type current_version = cql_serialization_format::latest_version;
+    // v5 changes the framing and some of the messages, but not the serialization format.
+    static constexpr cql_protocol_version_type current_version = 5;
 
     distributed<cql3::query_processor>& _query_processor;
     cql_server_config _config;
@@ -181,8 +185,12 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
 private:
     class fmt_visitor;
     friend class connection;
-    friend std::unique_ptr<cql_server::response> make_result(int16_t stream, messages::result_message& msg,
-            const tracing::trace_state_ptr& tr_state, cql_protocol_version_type version, bool skip_metadata);
+public:
+    struct forwarded_execute;
+private:
+    friend std::unique_ptr<cql_server::response> make_result(int16_t stream, ::shared_ptr<messages::result_message> msg,
+            const tracing::trace_state_ptr& tr_state, cql_protocol_version_type version, bool skip_metadata,
+            std::optional<bytes> result_metadata_id);
 
     class connection : public generic_server::connection {
         cql_server& _server;
@@ -190,6 +198,20 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         fragmented_temporary_buffer::reader _buffer_reader;
         cql_protocol_version_type _version = 0;
         cql_compression _compression = cql_compression::none;
+        // Wraps _write_buf once responses are framed in segments (protocol v5).
+        std::optional<output_stream<char>> _segment_buf;
+        struct pending_response {
+            foreign_ptr<std::unique_ptr<cql_server::response>> response;
+            service_permit permit;
+            cql_compression compression;
+        };
+        // Responses waiting for the scheduled flush_responses().
+        std::vector<pending_response> _pending_responses;
+        bool _responses_flush_scheduled = false;
+        // Requests of the connection being processed, which will add a response.
+        unsigned _requests_being_processed = 0;
+        // Requests which had to be executed on another shard.
+        uint64_t _bounced_requests = 0;
         service::client_state _client_state;
         timer<lowres_clock> _shedding_timer;
         bool _shed_incoming_requests = false;
@@ -267,8 +289,11 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
         future<result_with_foreign_response_ptr>
         process_on_shard(::shared_ptr<messages::result_message::bounce_to_shard> bounce_msg, uint16_t stream, fragmented_temporary_buffer::istream is, service::client_state& cs,
                 service_permit permit, tracing::trace_state_ptr trace_state, Process process_fn);
+        future<result_with_foreign_response_ptr>
+        process_forwarded_execute(std::unique_ptr<forwarded_execute> fwd, uint16_t stream, service::client_state& cs, tracing::trace_state_ptr trace_state);
 
         void write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit = empty_service_permit(), cql_compression compression = cql_compression::none);
+        future<> flush_responses();
 
         friend event_notifier;
     };
@@ -283,6 +308,12 @@ class cql_server : public seastar::peering_sharded_service<cql_server>, public g
     ::timeout_config timeout_config() const { return _config.timeout_config.current_values(); }
 };
 
+// Makes a RESULT response of msg. Large values of the result are referenced by
+// the response rather than copied, so it keeps msg alive.
+std::unique_ptr<cql_server::response>
+make_result(int16_t stream, ::shared_ptr<messages::result_message> msg, const tracing::trace_state_ptr& tr_state,
+        cql_protocol_version_type version, bool skip_metadata = false, std::optional<bytes> result_metadata_id = std::nullopt);
+
 class cql_server::event_notifier : public service::migration_listener,
                                    public service::endpoint_lifecycle_subscriber
 {
@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <seastar/core/print.hh>
+#include <seastar/core/thread.hh>
+#include "binary_fuse_filter.hh"
+#include "bloom_filter.hh"
+
+namespace utils {
+namespace filter {
+
+thread_local binary_fuse_filter::stats binary_fuse_filter::_shard_stats;
+
+namespace {
+
+constexpr uint32_t arity = 3;
+// Segments longer than this don't make construction any more likely to succeed.
+constexpr uint32_t max_segment_length = 1 << 18;
+// Construction fails with a probability well below 1% for any reasonable
+// number of keys, so running out of attempts practically never happens.
+constexpr unsigned max_attempts = 100;
+
+uint64_t murmur64(uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t splitmix64(uint64_t& state) noexcept {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+uint32_t fingerprint(uint64_t hash, uint32_t mask) noexcept {
+    return uint32_t(hash ^ (hash >> 32)) & mask;
+}
+
+uint64_t key_hash(const hashed_key& hk) noexcept {
+    return hk.hash()[0];
+}
+
+uint64_t fingerprint_words(uint64_t array_length, unsigned fingerprint_bits) noexcept {
+    // One padding word, so that reading a fingerprint never needs a bounds check.
+    return (array_length * fingerprint_bits + 63) / 64 + 1;
+}
+
+}
+
+binary_fuse_filter::binary_fuse_filter(unsigned fingerprint_bits, size_t max_keys)
+    : _max_keys(max_keys)
+    , _fingerprint_bits(std::min(fingerprint_bits, max_fingerprint_bits))
+    , _fingerprint_mask(uint32_t((uint64_t(1) << _fingerprint_bits) - 1))
+{
+}
+
+binary_fuse_filter::binary_fuse_filter(storage&& s)
+    : _storage(std::move(s))
+    , _max_keys(0)
+{
+    if (!is_binary_fuse_filter_storage(_storage)) {
+        throw std::invalid_argument(format("Invalid binary fuse filter: {} words", _storage.size()));
+    }
+    _seed = _storage[1];
+    _fingerprint_bits = _storage[2];
+    _fingerprint_mask = uint32_t((uint64_t(1) << _fingerprint_bits) - 1);
+    _segment_length = _storage[3];
+    _segment_length_mask = _segment_length - 1;
+    _segment_count_length = _storage[4];
+    _array_length = _storage[5];
+    _sealed = true;
+    _stats.memory_size += _storage.memory_size();
+}
+
+binary_fuse_filter::~binary_fuse_filter() noexcept {
+    if (_sealed) {
+        _stats.memory_size -= _storage.memory_size();
+    }
+    _stats.memory_size -= _keys_memory;
+}
+
+void binary_fuse_filter::update_keys_memory() noexcept {
+    auto keys_memory = _keys.memory_size();
+    _stats.memory_size += keys_memory - _keys_memory;
+    _keys_memory = keys_memory;
+}
+
+bool binary_fuse_filter::is_binary_fuse_filter_storage(const storage& s) noexcept {
+    if (s.size() < header_words || s[0] != format_tag) {
+        return false;
+    }
+    auto fingerprint_bits = s[2];
+    auto segment_length = s[3];
+    auto segment_count_length = s[4];
+    auto array_length = s[5];
+    return fingerprint_bits <= max_fingerprint_bits
+        && segment_length > 0 && segment_length <= max_segment_length && std::has_single_bit(segment_length)
+        && segment_count_length > 0 && segment_count_length % segment_length == 0
+        && array_length == segment_count_length + (arity - 1) * segment_length
+        && array_length <= std::numeric_limits<uint32_t>::max()
+        && s.size() == header_words + fingerprint_words(array_length, fingerprint_bits);
+}
+
+unsigned binary_fuse_filter::fingerprint_bits_for(double max_false_pos_probability) noexcept {
+    if (max_false_pos_probability >= 0.5) {
+        return 1;
+    }
+    if (max_false_pos_probability <= 0) {
+        return max_fingerprint_bits;
+    }
+    return std::min<unsigned>(std::ceil(-std::log2(max_false_pos_probability)), max_fingerprint_bits);
+}
+
+std::array<uint32_t, 3> binary_fuse_filter::slots(uint64_t hash) const noexcept {
+    // The first slot is anywhere in the array, the other two are in the two
+    // following segments.
+    uint32_t h0 = (static_cast<unsigned __int128>(hash) * _segment_count_length) >> 64;
+    uint32_t h1 = h0 + _segment_length;
+    uint32_t h2 = h1 + _segment_length;
+    h1 ^= uint32_t(hash >> 18) & _segment_length_mask;
+    h2 ^= uint32_t(hash) & _segment_length_mask;
+    return {h0, h1, h2};
+}
+
+uint32_t binary_fuse_filter::fingerprint_at(uint32_t slot) const noexcept {
+    uint64_t bit = uint64_t(slot) * _fingerprint_bits;
+    auto word = header_words + bit / 64;
+    auto shift = bit % 64;
+    uint64_t v = _storage[word] >> shift;
+    if (shift + _fingerprint_bits > 64) {
+        v |= _storage[word + 1] << (64 - shift);
+    }
+    return uint32_t(v) & _fingerprint_mask;
+}
+
+void binary_fuse_filter::set_fingerprint(uint32_t slot, uint32_t fingerprint) noexcept {
+    uint64_t bit = uint64_t(slot) * _fingerprint_bits;
+    auto word = header_words + bit / 64;
+    auto shift = bit % 64;
+    uint64_t mask = _fingerprint_mask;
+    _storage[word] = (_storage[word] & ~(mask << shift)) | (uint64_t(fingerprint) << shift);
+    if (shift + _fingerprint_bits > 64) {
+        auto rshift = 64 - shift;
+        _storage[word + 1] = (_storage[word + 1] & ~(mask >> rshift)) | (uint64_t(fingerprint) >> rshift);
+    }
+}
+
+void binary_fuse_filter::allocate(size_t num_keys) {
+    // Sizing as in the reference implementation. The parameters are sensitive:
+    // smaller arrays make construction fail too often.
+    int64_t n = num_keys;
+    _segment_length = n <= 1 ? 4 : uint32_t(1) << int(std::floor(std::log(double(n)) / std::log(3.33) + 2.25));
+    _segment_length = std::min(_segment_length, max_segment_length);
+    _segment_length_mask = _segment_length - 1;
+    double size_factor = n <= 1 ? 0 : std::max(1.125, 0.875 + 0.25 * std::log(1000000.0) / std::log(double(n)));
+    int64_t capacity = n <= 1 ? 0 : std::llround(n * size_factor);
+    int64_t segment_length = _segment_length;
+    int64_t init_segment_count = (capacity + segment_length - 1) / segment_length - (arity - 1);
+    int64_t array_length = (init_segment_count + arity - 1) * segment_length;
+    int64_t segment_count = (array_length + segment_length - 1) / segment_length;
+    segment_count = segment_count <= arity - 1 ? 1 : segment_count - (arity - 1);
+    array_length = (segment_count + arity - 1) * segment_length;
+    if (array_length > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument(format("Too many keys for a binary fuse filter: {}", num_keys));
+    }
+    _array_length = array_length;
+    _segment_count_length = segment_count * segment_length;
+
+    _storage.resize(header_words + fingerprint_words(_array_length, _fingerprint_bits));
+    _storage[0] = format_tag;
+    _storage[2] = _fingerprint_bits;
+    _storage[3] = _segment_length;
+    _storage[4] = _segment_count_length;
+    _storage[5] = _array_length;
+}
+
+bool binary_fuse_filter::populate() {
+    // Every slot tracks the number of keys mapped to it (in the upper 6 bits),
+    // the xor of the positions (0, 1 or 2) the slot has in their triplets (in
+    // the lower 2 bits), and the xor of their hashes. A slot with a single key
+    // therefore identifies that key, which can be removed from its other two
+    // slots ("peeled"). If all keys can be peeled, assigning fingerprints in
+    // reverse order gives every key a slot which no later key touches.
+    utils::chunked_vector<uint8_t> t2count;
+    utils::chunked_vector<uint64_t> t2hash;
+    utils::chunked_vector<uint32_t> alone;
+    // Slots of the peeled keys, in peeling order.
+    utils::chunked_vector<uint32_t> peeled;
+    t2count.resize(_array_length);
+    t2hash.resize(_array_length);
+    alone.resize(_array_length);
+
+    uint64_t rng_state = 0x726b2b9d438b9d4dULL;
+    for (unsigned attempt = 0; attempt < max_attempts; ++attempt) {
+        if (attempt) {
+            for (uint32_t i = 0; i < _array_length; ++i) {
+                t2count[i] = 0;
+                t2hash[i] = 0;
+                seastar::thread::maybe_yield();
+            }
+            peeled.clear();
+        }
+        _seed = splitmix64(rng_state);
+
+        bool error = false;
+        size_t duplicates = 0;
+        for (const auto& key : _keys) {
+            auto hash = murmur64(key_hash(key) + _seed);
+            auto s = slots(hash);
+            for (uint8_t i = 0; i < arity; ++i) {
+                t2count[s[i]] += 4;
+                t2count[s[i]] ^= i;
+                t2hash[s[i]] ^= hash;
+            }
+            // A duplicated key cancels itself out in all its slots. Drop it, it
+            // would never get peeled otherwise.
+            if ((t2hash[s[0]] & t2hash[s[1]] & t2hash[s[2]]) == 0) {
+                if ((t2hash[s[0]] == 0 && t2count[s[0]] == 8)
+                        || (t2hash[s[1]] == 0 && t2count[s[1]] == 8)
+                        || (t2hash[s[2]] == 0 && t2count[s[2]] == 8)) {
+                    ++duplicates;
+                    for (uint8_t i = 0; i < arity; ++i) {
+                        t2count[s[i]] -= 4;
+                        t2count[s[i]] ^= i;
+                        t2hash[s[i]] ^= hash;
+                    }
+                }
+            }
+            // The key count overflowed.
+            error |= t2count[s[0]] < 4 || t2count[s[1]] < 4 || t2count[s[2]] < 4;
+            seastar::thread::maybe_yield();
+        }
+        if (error) {
+            continue;
+        }
+
+        uint32_t queue_size = 0;
+        for (uint32_t i = 0; i < _array_length; ++i) {
+            alone[queue_size] = i;
+            queue_size += (t2count[i] >> 2) == 1;
+        }
+        while (queue_size > 0) {
+            auto slot = alone[--queue_size];
+            if ((t2count[slot] >> 2) != 1) {
+                continue;
+            }
+            // The slot is never touched again, so it still holds the hash
+            // and position of its key when fingerprints are assigned.
+            auto hash = t2hash[slot];
+            uint8_t found = t2count[slot] & 3;
+            peeled.push_back(slot);
+            auto s = slots(hash);
+            for (uint8_t i = 1; i < arity; ++i) {
+                uint8_t pos = (found + i) % arity;
+                auto other = s[pos];
+                alone[queue_size] = other;
+                queue_size += (t2count[other] >> 2) == 2;
+                t2count[other] -= 4;
+                t2count[other] ^= pos;
+                t2hash[other] ^= hash;
+            }
+            seastar::thread::maybe_yield();
+        }
+        if (peeled.size() + duplicates == _keys.size()) {
+            for (size_t i = peeled.size(); i-- > 0;) {
+                auto slot = peeled[i];
+                auto hash = t2hash[slot];
+                uint8_t found = t2count[slot] & 3;
+                auto s = slots(hash);
+                set_fingerprint(s[found], fingerprint(hash, _fingerprint_mask)
+                        ^ fingerprint_at(s[(found + 1) % arity])
+                        ^ fingerprint_at(s[(found + 2) % arity]));
+                seastar::thread::maybe_yield();
+            }
+            _storage[1] = _seed;
+            return true;
+        }
+        if (duplicates) {
+            // Only pairs of duplicates are detected above, and only when their
+            // slots hold no other key, so remove them all before retrying.
+            // Partition keys are unique, so this only happens on a collision
+            // of the 64-bit key hashes.
+            std::sort(_keys.begin(), _keys.end(), [] (const hashed_key& a, const hashed_key& b) {
+                return key_hash(a) < key_hash(b);
+            });
+            _keys.resize(std::unique(_keys.begin(), _keys.end(), [] (const hashed_key& a, const hashed_key& b) {
+                return key_hash(a) == key_hash(b);
+            }) - _keys.begin());
+        }
+    }
+    return false;
+}
+
+void binary_fuse_filter::fall_back() {
+    // Size it for the keys seen so far, with the false positive rate of the
+    // fingerprints. Keys added later raise the false positive rate, gradually.
+    _fallback = i_filter::get_filter(_keys.size(), std::ldexp(1.0, -int(_fingerprint_bits)), filter_format::m_format, filter_type::bloom);
+    auto& bf = static_cast<bloom_filter&>(*_fallback);
+    for (const auto& key : _keys) {
+        bf.add(key);
+        seastar::thread::maybe_yield();
+    }
+    _keys = {};
+    update_keys_memory();
+}
+
+void binary_fuse_filter::seal() {
+    if (_sealed || _fallback) {
+        return;
+    }
+    allocate(_keys.size());
+    if (!populate()) {
+        // Fall back to a filter without fingerprints, which reports every key
+        // as present.
+        _storage.clear();
+        _fingerprint_bits = 0;
+        _fingerprint_mask = 0;
+        allocate(_keys.size());
+    }
+    _keys = {};
+    update_keys_memory();
+    _sealed = true;
+    _stats.memory_size += _storage.memory_size();
+}
+
+void binary_fuse_filter::add(const bytes_view& key) {
+    if (_sealed) {
+        throw std::logic_error("Cannot add keys to a sealed binary fuse filter");
+    }
+    if (_fallback) {
+        _fallback->add(key);
+        return;
+    }
+    _keys.push_back(make_hashed_key(key));
+    update_keys_memory();
+    if (_keys.size() > _max_keys) {
+        fall_back();
+    }
+}
+
+bool binary_fuse_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
+bool binary_fuse_filter::is_present(hashed_key key) {
+    if (_fallback) {
+        return _fallback->is_present(key);
+    }
+    if (!_sealed) {
+        return true;
+    }
+    auto hash = murmur64(key_hash(key) + _seed);
+    auto s = slots(hash);
+    return (fingerprint(hash, _fingerprint_mask) ^ fingerprint_at(s[0]) ^ fingerprint_at(s[1]) ^ fingerprint_at(s[2])) == 0;
+}
+
+void binary_fuse_filter::clear() {
+    if (_sealed) {
+        _stats.memory_size -= _storage.memory_size();
+        _storage.clear();
+        _sealed = false;
+    }
+    _keys = {};
+    update_keys_memory();
+    _fallback = {};
+}
+
+}
+}
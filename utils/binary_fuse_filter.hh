@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include "i_filter.hh"
+#include "utils/chunked_vector.hh"
+
+namespace utils {
+namespace filter {
+
+// Binary fuse filter (Graf and Lemire, "Binary Fuse Filters: Fast and Smaller
+// Than Xor Filters", 2022), with 3-wise hashing.
+//
+// Every key maps to three slots of an array of w-bit fingerprints, and is present
+// if the xor of the three slots equals its own fingerprint. The false positive
+// rate is 2^-w, at about 1.125w bits per key, which is around 25% less memory than
+// a bloom filter with the same false positive rate.
+//
+// The filter is static: it has to be built from the complete set of keys at once.
+// add() only records the hash of the key, and seal() builds the filter, after which
+// no more keys can be added. Before seal(), every key is reported as present.
+// The recorded hashes take 16 bytes per key, and building takes about 19 more
+// (13 bytes for each of the ~1.125 slots per key, plus 4 per key), so about 35
+// bytes of temporary memory per key in total. The hashes are included in the
+// shard's filter memory stats.
+//
+// To bound that memory, the filter holds at most max_keys keys. Once more are added,
+// the recorded hashes are moved to a bloom filter with about the same false positive
+// rate, sized for the keys added so far, which replaces the binary fuse filter: all calls are forwarded to it, and
+// it is the one to write to Filter.db (see fallback()).
+//
+// Storage layout, in 64-bit words (which is also how it is stored in Filter.db):
+//
+//   word 0:     format_tag
+//   word 1:     seed
+//   word 2:     fingerprint bits (w)
+//   word 3:     segment length
+//   word 4:     segment count * segment length
+//   word 5:     array length
+//   words 6-7:  reserved, zero
+//   words 8...: the fingerprints, packed w bits each, least significant bits first,
+//               followed by a padding word.
+class binary_fuse_filter : public i_filter {
+public:
+    using storage = utils::chunked_vector<uint64_t>;
+
+    static constexpr uint64_t format_tag = 0x424655530001; // "BFUS", version 1
+    static constexpr size_t header_words = 8;
+    static constexpr unsigned max_fingerprint_bits = 32;
+    // get_filter() uses a bloom filter for sstables estimated to have more keys,
+    // and the filter falls back to one when more keys are actually added.
+    static constexpr size_t default_max_keys = size_t(1) << 24;
+private:
+    storage _storage;
+    // Hashes of the added keys, until the filter is sealed. Both halves are
+    // kept, so that a bloom filter can be built from them.
+    utils::chunked_vector<hashed_key> _keys;
+    // _keys.memory_size(), as accounted in _stats.
+    size_t _keys_memory = 0;
+    size_t _max_keys;
+    // Replaces this filter once more than _max_keys keys are added.
+    filter_ptr _fallback;
+    bool _sealed = false;
+
+    unsigned _fingerprint_bits;
+    uint32_t _fingerprint_mask;
+    uint64_t _seed = 0;
+    uint32_t _segment_length = 0;
+    uint32_t _segment_length_mask = 0;
+    uint32_t _segment_count_length = 0;
+    uint32_t _array_length = 0;
+
+    static thread_local struct stats {
+        uint64_t memory_size = 0;
+    } _shard_stats;
+    stats& _stats = _shard_stats;
+
+    std::array<uint32_t, 3> slots(uint64_t hash) const noexcept;
+    uint32_t fingerprint_at(uint32_t slot) const noexcept;
+    void set_fingerprint(uint32_t slot, uint32_t fingerprint) noexcept;
+    void allocate(size_t num_keys);
+    bool populate();
+    void update_keys_memory() noexcept;
+    void fall_back();
+public:
+    // Creates an empty, unsealed, filter with fingerprints of the given width,
+    // which falls back to a bloom filter after max_keys keys.
+    explicit binary_fuse_filter(unsigned fingerprint_bits, size_t max_keys = default_max_keys);
+    // Creates a sealed filter from storage previously obtained with get_storage().
+    // Throws std::invalid_argument if the storage does not hold a valid filter.
+    explicit binary_fuse_filter(storage&& s);
+    ~binary_fuse_filter() noexcept;
+
+    // Returns true if the storage, as read from Filter.db, holds a binary_fuse_filter.
+    static bool is_binary_fuse_filter_storage(const storage& s) noexcept;
+
+    // Smallest fingerprint width whose false positive rate does not exceed `max_false_pos_probability`.
+    static unsigned fingerprint_bits_for(double max_false_pos_probability) noexcept;
+
+    // Builds the filter from the keys added so far. Must be called from a seastar thread.
+    void seal();
+    bool sealed() const noexcept { return _sealed; }
+
+    // The bloom filter which replaced this one, if too many keys were added.
+    i_filter* fallback() const noexcept { return _fallback.get(); }
+    filter_ptr release_fallback() noexcept { return std::move(_fallback); }
+
+    unsigned fingerprint_bits() const noexcept { return _fingerprint_bits; }
+    // Valid after seal(), unless there is a fallback().
+    const storage& get_storage() const noexcept { return _storage; }
+
+    virtual void add(const bytes_view& key) override;
+    virtual bool is_present(const bytes_view& key) override;
+    virtual bool is_present(hashed_key key) override;
+    virtual void clear() override;
+    virtual void close() override { }
+
+    virtual size_t memory_size() override {
+        return sizeof(*this) + _storage.memory_size() + _keys.memory_size() + (_fallback ? _fallback->memory_size() : 0);
+    }
+
+    static const stats& get_shard_stats() noexcept {
+        return _shard_stats;
+    }
+};
+
+}
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <stdexcept>
+#include <seastar/core/print.hh>
+#include "blocked_bloom_filter.hh"
+
+#ifdef __x86_64__
+#include <x86intrin.h>
+#define arch_target(name) [[gnu::target(name)]]
+#else
+#define arch_target(name)
+#endif
+#ifdef __aarch64__
+#include <arm_neon.h>
+#endif
+
+namespace utils {
+namespace filter {
+
+thread_local blocked_bloom_filter::stats blocked_bloom_filter::_shard_stats;
+
+namespace {
+
+// Odd constants used to derive the bit of every lane from the key hash,
+// as in the split-block bloom filter of Apache Parquet.
+constexpr std::array<uint32_t, 8> salts = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+uint32_t lane(const uint64_t* block, unsigned i) noexcept {
+    return uint32_t(block[i / 2] >> ((i % 2) * 32));
+}
+
+#ifdef __x86_64__
+
+arch_target("default") bool block_contains_impl(const uint64_t* block, uint32_t key_hash) noexcept {
+    return internal::blocked_bloom_filter_block_contains_generic(block, key_hash);
+}
+
+arch_target("avx2") bool block_contains_impl(const uint64_t* block, uint32_t key_hash) noexcept {
+    const __m256i s = _mm256_setr_epi32(salts[0], salts[1], salts[2], salts[3], salts[4], salts[5], salts[6], salts[7]);
+    // 1. Compute the bit index of every lane: (key_hash * salt) >> 27
+    __m256i bit = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(key_hash), s), 27);
+    // 2. Turn them into masks
+    __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bit);
+    // 3. Check that all of them are set in the block: (~block & mask) == 0
+    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    return _mm256_testc_si256(b, mask);
+}
+
+#elif defined(__aarch64__)
+
+bool block_contains_impl(const uint64_t* block, uint32_t key_hash) noexcept {
+    const uint32x4_t s0 = {salts[0], salts[1], salts[2], salts[3]};
+    const uint32x4_t s1 = {salts[4], salts[5], salts[6], salts[7]};
+    const uint32x4_t k = vdupq_n_u32(key_hash);
+    const uint32x4_t one = vdupq_n_u32(1);
+    auto m0 = vshlq_u32(one, vreinterpretq_s32_u32(vshrq_n_u32(vmulq_u32(k, s0), 27)));
+    auto m1 = vshlq_u32(one, vreinterpretq_s32_u32(vshrq_n_u32(vmulq_u32(k, s1), 27)));
+    auto b0 = vld1q_u32(reinterpret_cast<const uint32_t*>(block));
+    auto b1 = vld1q_u32(reinterpret_cast<const uint32_t*>(block) + 4);
+    // vbicq_u32(m, b) == m & ~b, i.e. the bits missing from the block
+    auto missing = vorrq_u32(vbicq_u32(m0, b0), vbicq_u32(m1, b1));
+    return vmaxvq_u32(missing) == 0;
+}
+
+#else
+
+bool block_contains_impl(const uint64_t* block, uint32_t key_hash) noexcept {
+    return internal::blocked_bloom_filter_block_contains_generic(block, key_hash);
+}
+
+#endif
+
+}
+
+namespace internal {
+
+std::array<uint32_t, 8> blocked_bloom_filter_masks(uint32_t key_hash) noexcept {
+    std::array<uint32_t, 8> masks;
+    for (unsigned i = 0; i < masks.size(); ++i) {
+        masks[i] = uint32_t(1) << ((key_hash * salts[i]) >> 27);
+    }
+    return masks;
+}
+
+bool blocked_bloom_filter_block_contains_generic(const uint64_t* block, uint32_t key_hash) noexcept {
+    auto masks = blocked_bloom_filter_masks(key_hash);
+    for (unsigned i = 0; i < masks.size(); ++i) {
+        if ((lane(block, i) & masks[i]) != masks[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool blocked_bloom_filter_block_contains(const uint64_t* block, uint32_t key_hash) noexcept {
+    return block_contains_impl(block, key_hash);
+}
+
+}
+
+blocked_bloom_filter::blocked_bloom_filter(uint64_t num_blocks)
+    : _num_blocks(std::max<uint64_t>(num_blocks, 1))
+{
+    _storage.resize(header_words + _num_blocks * words_per_block);
+    _storage[0] = format_tag;
+    _stats.memory_size += memory_size();
+}
+
+blocked_bloom_filter::blocked_bloom_filter(storage&& s)
+    : _storage(std::move(s))
+{
+    if (!is_blocked_bloom_filter_storage(_storage)) {
+        throw std::invalid_argument(format("Invalid blocked bloom filter: {} words", _storage.size()));
+    }
+    _num_blocks = (_storage.size() - header_words) / words_per_block;
+    _stats.memory_size += memory_size();
+}
+
+blocked_bloom_filter::~blocked_bloom_filter() noexcept {
+    _stats.memory_size -= memory_size();
+}
+
+bool blocked_bloom_filter::is_blocked_bloom_filter_storage(const storage& s) noexcept {
+    return s.size() >= header_words + words_per_block
+        && (s.size() - header_words) % words_per_block == 0
+        && s[0] == format_tag;
+}
+
+int blocked_bloom_filter::bits_per_element(int bloom_buckets_per_element) noexcept {
+    // Confining the bits of a key to a single block makes the blocks unevenly loaded,
+    // which the extra quarter roughly makes up for at the usual false positive rates.
+    return bloom_buckets_per_element + (bloom_buckets_per_element + 3) / 4;
+}
+
+uint64_t blocked_bloom_filter::block_index(const hashed_key& hk) const noexcept {
+    // Maps the hash uniformly onto [0, _num_blocks) without a division.
+    return uint64_t((static_cast<unsigned __int128>(hk.hash()[0]) * _num_blocks) >> 64);
+}
+
+void blocked_bloom_filter::add(const bytes_view& key) {
+    auto hk = make_hashed_key(key);
+    auto b = block(block_index(hk));
+    auto masks = internal::blocked_bloom_filter_masks(uint32_t(hk.hash()[1]));
+    for (unsigned i = 0; i < masks.size(); ++i) {
+        b[i / 2] |= uint64_t(masks[i]) << ((i % 2) * 32);
+    }
+}
+
+bool blocked_bloom_filter::is_present(const bytes_view& key) {
+    return is_present(make_hashed_key(key));
+}
+
+bool blocked_bloom_filter::is_present(hashed_key key) {
+    return internal::blocked_bloom_filter_block_contains(block(block_index(key)), uint32_t(key.hash()[1]));
+}
+
+void blocked_bloom_filter::clear() {
+    for (size_t i = header_words; i < _storage.size(); ++i) {
+        _storage[i] = 0;
+    }
+}
+
+}
+}
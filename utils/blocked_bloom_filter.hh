@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <array>
+#include "i_filter.hh"
+#include "utils/chunked_vector.hh"
+
+namespace utils {
+namespace filter {
+
+// Split-block bloom filter.
+//
+// The bit array is divided into 256-bit blocks, each made of eight 32-bit lanes.
+// A key selects a single block with the first half of its hash, and sets exactly
+// one bit in every lane of it, derived from the second half of its hash. A probe
+// therefore touches a single cache line, and checks all eight bits at once using
+// AVX2 or NEON where available, as opposed to the k independent random probes
+// of bloom_filter.
+//
+// The filter trades a slightly higher false positive rate for the same number of
+// bits (compensated for in get_filter()) for a bounded, small, probe cost.
+//
+// Storage layout, in 64-bit words (which is also how it is stored in Filter.db):
+//
+//   word 0:     format_tag
+//   words 1-3:  reserved, zero
+//   words 4...: the blocks, 4 words each. 32-bit lane i of a block is the low
+//               (i even) or high (i odd) half of word i / 2 of the block.
+//
+// The header takes a whole block so that blocks stay 32-byte aligned with respect
+// to the chunks of the storage and never straddle two of them.
+class blocked_bloom_filter : public i_filter {
+public:
+    using storage = utils::chunked_vector<uint64_t>;
+
+    static constexpr uint64_t format_tag = 0x534242460001; // "SBBF", version 1
+    static constexpr size_t words_per_block = 4;
+    static constexpr size_t bits_per_block = words_per_block * 64;
+    static constexpr size_t header_words = words_per_block;
+private:
+    storage _storage;
+    uint64_t _num_blocks;
+
+    static thread_local struct stats {
+        uint64_t memory_size = 0;
+    } _shard_stats;
+    stats& _stats = _shard_stats;
+
+    uint64_t block_index(const hashed_key& hk) const noexcept;
+    const uint64_t* block(uint64_t idx) const noexcept {
+        return &_storage[header_words + idx * words_per_block];
+    }
+    uint64_t* block(uint64_t idx) noexcept {
+        return &_storage[header_words + idx * words_per_block];
+    }
+public:
+    // Creates an empty filter with room for num_blocks blocks.
+    explicit blocked_bloom_filter(uint64_t num_blocks);
+    // Creates a filter from storage previously obtained with get_storage().
+    // Throws std::invalid_argument if the storage does not hold a valid filter.
+    explicit blocked_bloom_filter(storage&& s);
+    ~blocked_bloom_filter() noexcept;
+
+    // Returns true if the storage, as read from Filter.db, holds a blocked_bloom_filter.
+    static bool is_blocked_bloom_filter_storage(const storage& s) noexcept;
+
+    // Number of bits per element which gives the same false positive rate as
+    // a bloom_filter with `bloom_buckets_per_element` bits per element.
+    static int bits_per_element(int bloom_buckets_per_element) noexcept;
+
+    uint64_t num_blocks() const noexcept { return _num_blocks; }
+    const storage& get_storage() const noexcept { return _storage; }
+
+    virtual void add(const bytes_view& key) override;
+    virtual bool is_present(const bytes_view& key) override;
+    virtual bool is_present(hashed_key key) override;
+    virtual void clear() override;
+    virtual void close() override { }
+
+    virtual size_t memory_size() override {
+        return sizeof(_num_blocks) + _storage.memory_size();
+    }
+
+    static const stats& get_shard_stats() noexcept {
+        return _shard_stats;
+    }
+};
+
+namespace internal {
+
+// Exposed for testing.
+// Returns the masks of the bits a key with the given hash sets in each 32-bit lane of its block.
+std::array<uint32_t, 8> blocked_bloom_filter_masks(uint32_t key_hash) noexcept;
+// Checks whether the block has all the bits of the key set, using the portable implementation.
+bool blocked_bloom_filter_block_contains_generic(const uint64_t* block, uint32_t key_hash) noexcept;
+// Same, using the fastest implementation available on the CPU.
+bool blocked_bloom_filter_block_contains(const uint64_t* block, uint32_t key_hash) noexcept;
+
+}
+
+}
+}
@@ -42,6 +42,7 @@ class bloom_filter: public i_filter {
     ~bloom_filter() noexcept;
 
     virtual void add(const bytes_view& key) override;
+    void add(hashed_key key);
 
     virtual bool is_present(const bytes_view& key) override;
 
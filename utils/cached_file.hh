@@ -15,6 +15,7 @@
 #include "utils/error_injection.hh"
 #include "tracing/trace_state.hh"
 #include "utils/cached_file_stats.hh"
+#include "sstables/index_cache_table.hh"
 
 #include <seastar/core/file.hh>
 #include <seastar/core/coroutine.hh>
@@ -62,7 +63,7 @@ class cached_file {
                 if (--cp->_use_count == 0) {
                     cp->parent->_metrics.bytes_in_std -= cp->_buf.size();
                     cp->_buf = {};
-                    cp->parent->_lru.add(*cp);
+                    cp->parent->link(*cp);
                 }
             }
         };
@@ -138,6 +139,7 @@ class cached_file {
     file _file;
     sstring _file_name; // for logging / tracing
     cached_file_stats& _metrics;
+    lw_shared_ptr<sstables::index_cache_table> _table;
     lru& _lru;
     logalloc::region& _region;
     logalloc::allocating_section _as;
@@ -151,18 +153,33 @@ class cached_file {
     offset_type _last_page_size;
     page_idx_type _last_page;
 private:
+    // Applies f to the metrics, and to the metrics of the owning table, if any.
+    template <typename Func>
+    void update_metrics(Func&& f) noexcept {
+        f(_metrics);
+        if (_table) {
+            f(_table->file_stats);
+        }
+    }
+
+    // Links an unused page in the LRU.
+    void link(cached_page& cp) noexcept {
+        cp.set_pinned_size(_table && _table->pinned() ? cp.size_in_allocator() : 0);
+        _lru.add(cp);
+    }
+
     future<cached_page::ptr_type> get_page_ptr(page_idx_type idx,
             page_count_type read_ahead,
             tracing::trace_state_ptr trace_state) {
         auto i = _cache.lower_bound(idx);
         if (i != _cache.end() && i->idx == idx) {
-            ++_metrics.page_hits;
+            update_metrics([] (cached_file_stats& m) { ++m.page_hits; });
             tracing::trace(trace_state, "page cache hit: file={}, page={}", _file_name, idx);
             cached_page& cp = *i;
             return make_ready_future<cached_page::ptr_type>(cp.share());
         }
         tracing::trace(trace_state, "page cache miss: file={}, page={}, readahead={}", _file_name, idx, read_ahead);
-        ++_metrics.page_misses;
+        update_metrics([] (cached_file_stats& m) { ++m.page_misses; });
         size_t size = (idx + read_ahead) > _last_page
                 ? (_last_page_size + (_last_page - idx) * page_size)
                 : read_ahead * page_size;
@@ -182,8 +199,10 @@ class cached_file {
                     ++idx;
                     cached_page &cp = *it_and_flag.first;
                     if (it_and_flag.second) {
-                        ++_metrics.page_populations;
-                        _metrics.cached_bytes += cp.size_in_allocator();
+                        update_metrics([&cp] (cached_file_stats& m) {
+                            ++m.page_populations;
+                            m.cached_bytes += cp.size_in_allocator();
+                        });
                         _cached_bytes += cp.size_in_allocator();
                     }
                     // pages read ahead will be placed into LRU, as there's no guarantee they will be fetched later.
@@ -316,9 +335,11 @@ class cached_file {
     };
 
     void on_evicted(cached_page& p) {
-        _metrics.cached_bytes -= p.size_in_allocator();
+        update_metrics([&p] (cached_file_stats& m) {
+            m.cached_bytes -= p.size_in_allocator();
+            ++m.page_evictions;
+        });
         _cached_bytes -= p.size_in_allocator();
-        ++_metrics.page_evictions;
     }
 
     size_t evict_range(cache_type::iterator start, cache_type::iterator end) noexcept {
@@ -360,6 +381,16 @@ class cached_file {
         _last_page = last_byte_offset / page_size;
     }
 
+    /// \brief Constructs a cached_file which holds index pages of the given table.
+    ///
+    /// Operations are also accounted in the table's statistics, and unused pages
+    /// are pinned when the table's index is pinned.
+    cached_file(file f, lw_shared_ptr<sstables::index_cache_table> table, cached_file_stats& m, lru& l, logalloc::region& reg, offset_type size, sstring file_name = {})
+        : cached_file(std::move(f), m, l, reg, size, std::move(file_name))
+    {
+        _table = std::move(table);
+    }
+
     cached_file(cached_file&&) = delete; // captured this
     cached_file(const cached_file&) = delete;
 
@@ -440,6 +471,17 @@ class cached_file {
         return _region;
     }
 
+    /// \brief Relinks unused pages in the LRU, so that they become pinned or unpinned
+    /// according to the current setting of the owning table.
+    void update_pinning() noexcept {
+        for (auto& cp : _cache) {
+            if (cp.is_linked()) {
+                _lru.remove(cp);
+                link(cp);
+            }
+        }
+    }
+
     // Evicts all unused pages.
     // Pages which are used are not removed.
     future<> evict_gently() {
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <bit>
+
+#include "frequency_sketch.hh"
+
+namespace utils {
+
+frequency_sketch::frequency_sketch(size_t width) {
+    width = std::bit_ceil(std::max<size_t>(width, counters_per_word));
+    _width_mask = width - 1;
+    _table.resize(rows * width / counters_per_word);
+    _sample_size = 10 * width;
+}
+
+frequency_sketch::slot frequency_sketch::slot_of(uint64_t hash, unsigned row) const noexcept {
+    // Double hashing, with an odd step so that the rows don't collide on the same keys.
+    uint64_t h1 = hash;
+    uint64_t h2 = (hash >> 32) | (hash << 32) | 1;
+    uint64_t counter = row * (_width_mask + 1) + ((h1 + row * h2) & _width_mask);
+    return slot{counter / counters_per_word, unsigned(counter % counters_per_word) * 4};
+}
+
+void frequency_sketch::increment(uint64_t hash) noexcept {
+    slot slots[rows];
+    unsigned min = max_frequency;
+    for (unsigned r = 0; r < rows; ++r) {
+        slots[r] = slot_of(hash, r);
+        min = std::min(min, get(slots[r]));
+    }
+    if (min == max_frequency) {
+        return;
+    }
+    for (auto s : slots) {
+        if (get(s) == min) {
+            _table[s.word] += uint64_t(1) << s.shift;
+        }
+    }
+    if (++_additions == _sample_size) {
+        reset();
+    }
+}
+
+unsigned frequency_sketch::estimate(uint64_t hash) const noexcept {
+    unsigned min = max_frequency;
+    for (unsigned r = 0; r < rows; ++r) {
+        min = std::min(min, get(slot_of(hash, r)));
+    }
+    return min;
+}
+
+void frequency_sketch::reset() noexcept {
+    for (auto& w : _table) {
+        w = (w >> 1) & 0x7777777777777777ull;
+    }
+    _additions /= 2;
+    ++_resets;
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2023-present ScyllaDB
+ */
+
+/*
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+// Approximate access frequencies of a large set of keys, in constant memory.
+//
+// A count-min sketch of 4-bit counters, as used by the TinyLFU admission policy
+// (Einziger, Friedman and Manes, "TinyLFU: A Highly Efficient Cache Admission Policy", 2017).
+// Every key has one counter in each of the four rows, and its estimated frequency
+// is the smallest of them. Only the smallest counters are incremented (conservative
+// update), which makes collisions inflate the estimates less.
+//
+// To make the frequencies reflect recent history, all counters are halved after
+// every sample_size() increments.
+class frequency_sketch {
+public:
+    static constexpr unsigned rows = 4;
+    static constexpr unsigned max_frequency = 15;
+private:
+    static constexpr unsigned counters_per_word = 16;
+
+    // rows * width counters, row by row.
+    std::vector<uint64_t> _table;
+    uint64_t _width_mask;
+    uint64_t _sample_size;
+    uint64_t _additions = 0;
+    uint64_t _resets = 0;
+
+    struct slot {
+        size_t word;
+        unsigned shift;
+    };
+    slot slot_of(uint64_t hash, unsigned row) const noexcept;
+    unsigned get(slot s) const noexcept {
+        return (_table[s.word] >> s.shift) & 0xf;
+    }
+    void reset() noexcept;
+public:
+    // The sketch has the smallest power of two number of counters per row which is not smaller
+    // than width, and at least counters_per_word. It works best with width not smaller than the
+    // number of distinct keys among the sample_size most recent accesses.
+    explicit frequency_sketch(size_t width);
+
+    // hash must be well distributed over all of its bits.
+    void increment(uint64_t hash) noexcept;
+    unsigned estimate(uint64_t hash) const noexcept;
+
+    uint64_t sample_size() const noexcept { return _sample_size; }
+    // Number of times the counters were halved.
+    uint64_t resets() const noexcept { return _resets; }
+    size_t memory_usage() const noexcept { return _table.capacity() * sizeof(uint64_t); }
+};
+
+}
@@ -9,13 +9,15 @@
 
 #include "log.hh"
 #include "bloom_filter.hh"
+#include "blocked_bloom_filter.hh"
+#include "binary_fuse_filter.hh"
 #include "bloom_calculations.hh"
 #include <seastar/core/thread.hh>
 
 namespace utils {
 static logging::logger filterlog("bloom_filter");
 
-filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_probability, filter_format fformat) {
+filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_probability, filter_format fformat, filter_type type) {
     assert(seastar::thread::running_in_thread());
 
     if (max_false_pos_probability > 1.0) {
@@ -26,8 +28,20 @@ filter_ptr i_filter::get_filter(int64_t num_elements, double max_false_pos_proba
         return std::make_unique<filter::always_present_filter>();
     }
 
+    if (type == filter_type::binary_fuse) {
+        if (num_elements <= int64_t(filter::binary_fuse_filter::default_max_keys)) {
+            return std::make_unique<filter::binary_fuse_filter>(filter::binary_fuse_filter::fingerprint_bits_for(max_false_pos_probability));
+        }
+        filterlog.debug("Using a bloom filter instead of a binary fuse filter for {} elements", num_elements);
+    }
+
     int buckets_per_element = bloom_calculations::max_buckets_per_element(num_elements);
     auto spec = bloom_calculations::compute_bloom_spec(buckets_per_element, max_false_pos_probability);
+    if (type == filter_type::blocked_bloom) {
+        auto num_bits = num_elements * filter::blocked_bloom_filter::bits_per_element(spec.buckets_per_element);
+        auto bits_per_block = filter::blocked_bloom_filter::bits_per_block;
+        return std::make_unique<filter::blocked_bloom_filter>((num_bits + bits_per_block - 1) / bits_per_block);
+    }
     return filter::create_filter(spec.K, num_elements, spec.buckets_per_element, fformat);
 }
 
@@ -22,6 +22,15 @@ enum class filter_format {
     m_format,
 };
 
+// The filter implementation, selectable per table.
+enum class filter_type {
+    bloom,
+    // See blocked_bloom_filter.hh
+    blocked_bloom,
+    // See binary_fuse_filter.hh
+    binary_fuse,
+};
+
 class hashed_key {
 private:
     std::array<uint64_t, 2> _hash;
@@ -52,6 +61,7 @@ struct i_filter {
      *         Asserts that the given probability can be satisfied using this
      *         filter.
      */
-    static filter_ptr get_filter(int64_t num_elements, double max_false_pos_prob, filter_format format);
+    static filter_ptr get_filter(int64_t num_elements, double max_false_pos_prob, filter_format format,
+            filter_type type = filter_type::bloom);
 };
 }
@@ -810,6 +810,27 @@ class tree {
             revalidate();
         }
 
+        /*
+         * Returns pointer on the owning tree. Walks up to the root,
+         * so it's logarithmic in the size of the tree.
+         */
+        tree_ptr owning_tree() noexcept {
+            if (is_end()) {
+                return _tree;
+            }
+
+            node_base_ptr n = revalidate();
+            if (n->is_inline()) {
+                return tree::from_inline(n);
+            }
+
+            node_ptr nd = node::from_base(n);
+            while (!nd->is_root()) {
+                nd = nd->_parent.n;
+            }
+            return nd->_parent.t;
+        }
+
         /*
          * Returns pointer on the owning tree if the element is the
          * last one left in it.
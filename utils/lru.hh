@@ -10,6 +10,7 @@
 
 #include <boost/intrusive/list.hpp>
 #include <seastar/core/memory.hh>
+#include <seastar/core/loop.hh>
 
 class evictable {
     friend class lru;
@@ -67,12 +68,24 @@ class evictable {
 //
 // To maintain this limit, index entries might have to be evicted outside of the regular LRU order.
 // Therefore they are linked both in the common LRU list and in a separate LRU list for index entries.
+//
+// Index entries of tables with pinned index (see caching_options) are instead linked
+// only in a third list, and are evicted only on request (see lru::evict_pinned()),
+// so that the index of small, hot tables stays in memory.
 class index_evictable : public evictable {
     friend class lru;
     evictable::lru_link_type _index_lru_link;
+    // Memory used by the entry when it's pinned, 0 otherwise.
+    size_t _pinned_size = 0;
     bool is_index() const noexcept override {
         return true;
     }
+public:
+    // Pins the entry, or unpins it when size is 0.
+    // Must be called when the entry is not linked.
+    void set_pinned_size(size_t size) noexcept {
+        _pinned_size = size;
+    }
 };
 
 // Implements LRU cache replacement for row cache and sstable index cache.
@@ -89,8 +102,15 @@ class lru {
         boost::intrusive::constant_time_size<false>>; // we need this to have bi::auto_unlink on hooks.
     index_lru_type _index_list;
 
+    // Pinned index entries, see the comment to index_evictable.
+    lru_type _pinned_list;
+    size_t _pinned_bytes = 0;
+
     using reclaiming_result = seastar::memory::reclaiming_result;
 
+    static bool is_pinned(const evictable& e) noexcept {
+        return e.is_index() && static_cast<const index_evictable&>(e)._pinned_size;
+    }
 public:
     ~lru() {
         while (!_list.empty()) {
@@ -98,9 +118,19 @@ class lru {
             remove(e);
             e.on_evicted();
         }
+        while (!_pinned_list.empty()) {
+            evictable& e = _pinned_list.front();
+            remove(e);
+            e.on_evicted();
+        }
     }
 
     void remove(evictable& e) noexcept {
+        if (is_pinned(e)) {
+            _pinned_list.erase(_pinned_list.iterator_to(e));
+            _pinned_bytes -= static_cast<index_evictable&>(e)._pinned_size;
+            return;
+        }
         _list.erase(_list.iterator_to(e));
         if (e.is_index()) {
             _index_list.erase(_index_list.iterator_to(static_cast<index_evictable&>(e)));
@@ -108,12 +138,22 @@ class lru {
     }
 
     void add(evictable& e) noexcept {
+        if (is_pinned(e)) {
+            _pinned_list.push_back(e);
+            _pinned_bytes += static_cast<index_evictable&>(e)._pinned_size;
+            return;
+        }
         _list.push_back(e);
         if (e.is_index()) {
             _index_list.push_back(static_cast<index_evictable&>(e));
         }
     }
 
+    // Total memory used by pinned entries.
+    size_t pinned_bytes() const noexcept {
+        return _pinned_bytes;
+    }
+
     // Like add(e) but makes sure that e is evicted right before "more_recent" in the absence of later touches.
     void add_before(evictable& more_recent, evictable& e) noexcept {
         _list.insert(_list.iterator_to(more_recent), e);
@@ -124,6 +164,18 @@ class lru {
         add(e);
     }
 
+    // Calls func on elements, from the least recently used one, until it returns stop_iteration::yes.
+    // func must not add or remove elements.
+    template <typename Func>
+    requires std::is_invocable_r_v<seastar::stop_iteration, Func, evictable&>
+    void for_each_coldest(Func&& func) {
+        for (evictable& e : _list) {
+            if (func(e) == seastar::stop_iteration::yes) {
+                break;
+            }
+        }
+    }
+
     // Evicts a single element from the LRU
     template <bool Shallow = false>
     reclaiming_result do_evict(bool should_evict_index) noexcept {
@@ -151,9 +203,21 @@ class lru {
         return do_evict<true>(false);
     }
 
-    // Evicts all elements.
+    // Evicts the least recently used pinned entry.
+    reclaiming_result evict_pinned() noexcept {
+        if (_pinned_list.empty()) {
+            return reclaiming_result::reclaimed_nothing;
+        }
+        evictable& e = _pinned_list.front();
+        remove(e);
+        e.on_evicted();
+        return reclaiming_result::reclaimed_something;
+    }
+
+    // Evicts all elements, including pinned ones.
     // May stall the reactor, use only in tests.
     void evict_all() {
         while (evict() == reclaiming_result::reclaimed_something) {}
+        while (evict_pinned() == reclaiming_result::reclaimed_something) {}
     }
 };
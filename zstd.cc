@@ -7,24 +7,375 @@
  */
 
 #include <seastar/core/aligned_buffer.hh>
+#include <seastar/core/alien.hh>
+#include <seastar/core/reactor.hh>
+#include <cstring>
 
 // We need to use experimental features of the zstd library (to allocate compression/decompression context),
 // which are available only when the library is linked statically.
 #define ZSTD_STATIC_LINKING_ONLY
 #include "zstd.h"
+#define ZDICT_STATIC_LINKING_ONLY
+#include "zdict.h"
 
 #include "compress.hh"
+#include "utils/base64.hh"
 #include "utils/class_registrator.hh"
 #include "utils/reusable_buffer.hh"
+#include "utils/xx_hasher.hh"
 #include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
 
 static const sstring COMPRESSION_LEVEL = "compression_level";
+static const sstring DICTIONARY_SIZE_KB = "dictionary_size_kb";
+// Only found in the CompressionInfo.db of sstables written with a dictionary.
+static const sstring DICTIONARY = "dictionary";
+static const sstring DICTIONARY_HASH = "dictionary_hash";
 static const sstring COMPRESSOR_NAME = compressor::namespace_prefix + "ZstdCompressor";
 static const size_t DCTX_SIZE = ZSTD_estimateDCtxSize();
 
+// The dictionary is stored base64-encoded in an option of CompressionInfo.db,
+// which takes a third more than the dictionary and is kept in memory along
+// with the compression metadata of every sstable written with it.
+static constexpr size_t max_dictionary_size_kb = 16;
+// Dictionaries are trained on this many times their size of data, or this
+// many chunks if that's more...
+static constexpr size_t dictionary_sample_ratio = 32;
+// ...but not more than this, to bound the data held back by the writer.
+static constexpr size_t max_dictionary_sample_size = 512 * 1024;
+// Beyond this, there are too few chunks in the sample to train on, and chunks
+// are large enough to compress well without a dictionary anyway.
+static constexpr size_t max_dictionary_chunk_length = 64 * 1024;
+// Training on less data than this many times the size of the dictionary isn't worth it.
+static constexpr size_t min_dictionary_sample_ratio = 4;
+// Number of sstables written with a trained dictionary before training a new
+// one, so that the dictionary follows changes in the data.
+static constexpr unsigned max_dictionary_uses = 64;
+// Number of digested dictionaries each shard keeps, in addition to those in use.
+static constexpr size_t dictionary_cache_capacity = 64;
+// Number of tables each shard keeps the last trained dictionary of.
+static constexpr size_t trained_dictionaries_capacity = 1024;
+
+namespace {
+
+struct ddict_deleter {
+    void operator()(ZSTD_DDict* d) const noexcept { ZSTD_freeDDict(d); }
+};
+
+struct cdict_deleter {
+    void operator()(ZSTD_CDict* d) const noexcept { ZSTD_freeCDict(d); }
+};
+
+// A dictionary, digested for compression or decompression on first use.
+// Shared by all the compressors of a shard using it.
+class zstd_dictionary {
+    bytes _data;
+    uint64_t _hash;
+    std::unique_ptr<ZSTD_DDict, ddict_deleter> _ddict;
+    std::unique_ptr<ZSTD_CDict, cdict_deleter> _cdict;
+    ZSTD_compressionParameters _cdict_params;
+public:
+    explicit zstd_dictionary(bytes data)
+        : _data(std::move(data))
+        , _hash(hash_of(_data))
+    { }
+
+    static uint64_t hash_of(bytes_view data) noexcept {
+        xx_hasher h;
+        h.update(reinterpret_cast<const char*>(data.data()), data.size());
+        return h.finalize_uint64();
+    }
+
+    const bytes& data() const noexcept { return _data; }
+    uint64_t hash() const noexcept { return _hash; }
+
+    const ZSTD_DDict* ddict() {
+        if (!_ddict) {
+            _ddict.reset(ZSTD_createDDict_byReference(_data.data(), _data.size()));
+            if (!_ddict) {
+                throw std::runtime_error("Unable to digest ZSTD decompression dictionary");
+            }
+        }
+        return _ddict.get();
+    }
+
+    const ZSTD_CDict* cdict(const ZSTD_compressionParameters& params) {
+        if (!_cdict || std::memcmp(&_cdict_params, &params, sizeof(params))) {
+            _cdict.reset(ZSTD_createCDict_advanced(_data.data(), _data.size(), ZSTD_dlm_byRef, ZSTD_dct_auto,
+                    params, ZSTD_defaultCMem));
+            if (!_cdict) {
+                throw std::runtime_error("Unable to digest ZSTD compression dictionary");
+            }
+            _cdict_params = params;
+        }
+        return _cdict.get();
+    }
+};
+
+// Keeps the most recently used dictionaries of a shard, so that the
+// compressors created for every read of an sstable don't have to decode
+// and digest its dictionary again.
+class zstd_dictionary_cache {
+    using lru_list = std::list<lw_shared_ptr<zstd_dictionary>>;
+    lru_list _lru;
+    std::unordered_map<uint64_t, lru_list::iterator> _index;
+public:
+    lw_shared_ptr<zstd_dictionary> get(uint64_t hash) {
+        auto it = _index.find(hash);
+        if (it == _index.end()) {
+            return nullptr;
+        }
+        _lru.splice(_lru.begin(), _lru, it->second);
+        return *it->second;
+    }
+
+    void put(lw_shared_ptr<zstd_dictionary> d) {
+        if (get(d->hash())) {
+            return;
+        }
+        _lru.push_front(std::move(d));
+        _index.emplace(_lru.front()->hash(), _lru.begin());
+        if (_lru.size() > dictionary_cache_capacity) {
+            _index.erase(_lru.back()->hash());
+            _lru.pop_back();
+        }
+    }
+};
+
+thread_local zstd_dictionary_cache dictionary_cache;
+
+// A dictionary training, shared by the shard which submitted it and the
+// training thread.
+struct training {
+    std::vector<char> samples;
+    std::vector<size_t> sample_sizes;
+    bytes dictionary;
+    ZDICT_fastCover_params_t params;
+    // Where the result is delivered.
+    seastar::alien::instance& alien;
+    unsigned shard;
+    uint64_t id;
+    // Set, under the training thread's lock, once the shard stops waiting
+    // for the result.
+    bool abandoned = false;
+
+    training(seastar::alien::instance& alien, unsigned shard, uint64_t id) noexcept
+        : alien(alien), shard(shard), id(id)
+    { }
+};
+
+// Trains dictionaries outside of the reactors.
+//
+// Training takes tens of milliseconds of CPU, which would stall a reactor, so
+// it runs in a single low priority thread shared by all shards, like WASM
+// compilation does (see lang/wasm_alien_thread_runner.hh). Results are sent
+// back to the submitting shard with seastar::alien.
+class dictionary_training_thread {
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<std::shared_ptr<training>> _pending;
+    std::thread _thread;
+
+    void run();
+public:
+    dictionary_training_thread() : _thread([this] { run(); }) {
+        // Shutdown doesn't wait for a training in progress.
+        _thread.detach();
+    }
+
+    // The instance is never destroyed, the thread keeps waiting for work
+    // until the process exits.
+    static dictionary_training_thread& get() {
+        static auto* instance = new dictionary_training_thread();
+        return *instance;
+    }
+
+    void submit(std::shared_ptr<training> tr) {
+        std::unique_lock lock(_mutex);
+        _pending.push_back(std::move(tr));
+        lock.unlock();
+        _cv.notify_one();
+    }
+
+    // Makes sure the result of the training isn't delivered, after which the
+    // shard may be gone.
+    void abandon(training& tr) {
+        std::lock_guard lock(_mutex);
+        tr.abandoned = true;
+    }
+};
+
+// The dictionaries trained for the tables written by a shard.
+//
+// Meanwhile a dictionary is trained, sstables of the table are written with
+// the previous one, or without any.
+class dictionary_trainer {
+    struct table_dictionary {
+        lw_shared_ptr<zstd_dictionary> dictionary;
+        // Number of sstables the dictionary was handed out for.
+        unsigned uses = 0;
+        bool training = false;
+    };
+    struct pending_training {
+        std::shared_ptr<training> tr;
+        promise<size_t> done;
+    };
+    std::unordered_map<table_id, table_dictionary> _tables;
+    std::unordered_map<uint64_t, pending_training> _pending;
+    uint64_t _next_id = 0;
+    bool _stopping = false;
+    bool _stop_registered = false;
+
+    void stop() {
+        _stopping = true;
+        for (auto& [id, p] : _pending) {
+            dictionary_training_thread::get().abandon(*p.tr);
+            p.done.set_value(0);
+        }
+        _pending.clear();
+    }
+public:
+    // Returns the state of the dictionary of a table.
+    table_dictionary& get(table_id table, size_t dictionary_size) {
+        auto it = _tables.find(table);
+        if (it == _tables.end()) {
+            if (_tables.size() >= trained_dictionaries_capacity) {
+                auto victim = std::find_if(_tables.begin(), _tables.end(), [] (auto& e) { return !e.second.training; });
+                if (victim != _tables.end()) {
+                    _tables.erase(victim);
+                }
+            }
+            it = _tables.emplace(table, table_dictionary{}).first;
+        }
+        auto& t = it->second;
+        // The table's options changed since the dictionary was trained.
+        if (t.dictionary && t.dictionary->data().size() > dictionary_size) {
+            t.dictionary = nullptr;
+        }
+        return t;
+    }
+
+    void train(table_id table, table_dictionary& t, const std::vector<temporary_buffer<char>>& samples, size_t dictionary_size, int compression_level) {
+        if (_stopping) {
+            return;
+        }
+        if (!_stop_registered) {
+            // The training thread must not deliver results to a reactor which is gone.
+            engine().at_exit([this] {
+                stop();
+                return make_ready_future<>();
+            });
+            _stop_registered = true;
+        }
+        auto id = _next_id++;
+        auto tr = std::make_shared<training>(engine().alien(), this_shard_id(), id);
+        size_t total_size = 0;
+        for (auto& s : samples) {
+            total_size += s.size();
+        }
+        // Every chunk is compressed on its own, so it makes a sample.
+        tr->samples.reserve(total_size);
+        tr->sample_sizes.reserve(samples.size());
+        for (auto& s : samples) {
+            tr->samples.insert(tr->samples.end(), s.begin(), s.end());
+            tr->sample_sizes.push_back(s.size());
+        }
+        tr->dictionary = bytes(bytes::initialized_later(), dictionary_size);
+
+        // Fixed parameters rather than ZDICT_trainFromBuffer()'s search for the
+        // best ones, which takes several times longer for little gain.
+        tr->params = {};
+        tr->params.k = 200;
+        tr->params.d = 8;
+        tr->params.f = 18;
+        tr->params.accel = 1;
+        tr->params.zParams.compressionLevel = compression_level;
+
+        auto& p = _pending.emplace(id, pending_training{tr, promise<size_t>()}).first->second;
+        auto f = p.done.get_future();
+        t.training = true;
+        dictionary_training_thread::get().submit(tr);
+        // Completes when the training thread delivers the result, or when the shard stops.
+        (void)f.then([this, table, tr = std::move(tr)] (size_t size) mutable {
+            auto it = _tables.find(table);
+            if (it == _tables.end()) {
+                return;
+            }
+            auto& t = it->second;
+            t.training = false;
+            // Typically not enough samples, compress without a dictionary.
+            if (size) {
+                tr->dictionary.resize(size);
+                t.dictionary = make_lw_shared<zstd_dictionary>(std::move(tr->dictionary));
+                t.uses = 0;
+                dictionary_cache.put(t.dictionary);
+            }
+        });
+    }
+
+    // Called on the shard which submitted the training.
+    void complete(uint64_t id, size_t size) {
+        auto it = _pending.find(id);
+        if (it == _pending.end()) {
+            return;
+        }
+        auto p = std::move(it->second);
+        _pending.erase(it);
+        p.done.set_value(size);
+    }
+};
+
+thread_local dictionary_trainer trainer;
+
+void dictionary_training_thread::run() {
+    sigset_t mask;
+    sigfillset(&mask);
+    ::pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+    // Don't compete with the reactors.
+    (void)::nice(10);
+    for (;;) {
+        std::shared_ptr<training> tr;
+        {
+            std::unique_lock lock(_mutex);
+            _cv.wait(lock, [this] { return !_pending.empty(); });
+            tr = std::move(_pending.front());
+            _pending.pop_front();
+            if (tr->abandoned) {
+                continue;
+            }
+        }
+        auto ret = ZDICT_trainFromBuffer_fastCover(tr->dictionary.data(), tr->dictionary.size(),
+                tr->samples.data(), tr->sample_sizes.data(), tr->sample_sizes.size(), tr->params);
+        size_t size = ZDICT_isError(ret) ? 0 : ret;
+        std::lock_guard lock(_mutex);
+        if (!tr->abandoned) {
+            // Only the id crosses over, the shard still holds the training.
+            seastar::alien::run_on(tr->alien, tr->shard, [id = tr->id, size] () noexcept {
+                trainer.complete(id, size);
+            });
+        }
+    }
+}
+
+}
+
 class zstd_processor : public compressor {
     int _compression_level = 3;
     size_t _cctx_size;
+    int32_t _chunk_len;
+    // Size of the dictionaries to train, 0 if dictionary compression is disabled.
+    size_t _dictionary_size = 0;
+    // The dictionary chunks are compressed with, if any.
+    lw_shared_ptr<zstd_dictionary> _dictionary;
+    ZSTD_compressionParameters _cparams;
 
     static auto with_dctx(std::invocable<ZSTD_DCtx*> auto f) {
         // The decompression context has a fixed size of ~128 KiB,
@@ -71,8 +422,12 @@ class zstd_processor : public compressor {
         return f(reinterpret_cast<ZSTD_CCtx*>(view.data()));
     }
 
+    void init_cctx_size();
+    void load_dictionary(const sstring& hash, const opt_getter& opts);
 public:
     zstd_processor(const opt_getter&);
+    // Creates a compressor with the options of `tmpl`, bound to the dictionary.
+    zstd_processor(const zstd_processor& tmpl, lw_shared_ptr<zstd_dictionary> dictionary);
 
     size_t uncompress(const char* input, size_t input_len, char* output,
                     size_t output_len) const override;
@@ -80,6 +435,10 @@ class zstd_processor : public compressor {
                     size_t output_len) const override;
     size_t compress_max_size(size_t input_len) const override;
 
+    shared_ptr<compressor> dictionary_compressor(table_id) const override;
+    size_t dictionary_sample_size(table_id) const override;
+    void train_dictionary(table_id, std::vector<temporary_buffer<char>> samples) const override;
+
     std::set<sstring> option_names() const override;
     std::map<sstring, sstring> options() const override;
 };
@@ -107,19 +466,86 @@ zstd_processor::zstd_processor(const opt_getter& opts)
     if (!chunk_len_kb) {
         chunk_len_kb = opts(compression_parameters::CHUNK_LENGTH_KB_ERR);
     }
-    auto chunk_len = chunk_len_kb
+    _chunk_len = chunk_len_kb
        // This parameter has already been validated.
        ? std::stoi(*chunk_len_kb) * 1024
        : compression_parameters::DEFAULT_CHUNK_LENGTH;
 
+    if (auto size_kb = opts(DICTIONARY_SIZE_KB)) {
+        size_t kb;
+        try {
+            kb = std::stoul(*size_kb);
+        } catch (const std::exception& e) {
+            throw exceptions::syntax_exception(
+                format("Invalid integer value {} for {}", *size_kb, DICTIONARY_SIZE_KB));
+        }
+        if (kb > max_dictionary_size_kb) {
+            throw exceptions::configuration_exception(
+                format("{} must be between 0 and {}, got {}", DICTIONARY_SIZE_KB, max_dictionary_size_kb, kb));
+        }
+        if (kb && _chunk_len > int32_t(max_dictionary_chunk_length)) {
+            throw exceptions::configuration_exception(
+                format("{} requires {} of at most {}", DICTIONARY_SIZE_KB, compression_parameters::CHUNK_LENGTH_KB,
+                        max_dictionary_chunk_length / 1024));
+        }
+        _dictionary_size = kb * 1024;
+    }
+
+    if (auto hash = opts(DICTIONARY_HASH)) {
+        load_dictionary(*hash, opts);
+    }
+
+    init_cctx_size();
+}
+
+zstd_processor::zstd_processor(const zstd_processor& tmpl, lw_shared_ptr<zstd_dictionary> dictionary)
+    : compressor(COMPRESSOR_NAME)
+    , _compression_level(tmpl._compression_level)
+    , _chunk_len(tmpl._chunk_len)
+    , _dictionary_size(tmpl._dictionary_size)
+    , _dictionary(std::move(dictionary))
+{
+    init_cctx_size();
+}
+
+void zstd_processor::init_cctx_size() {
     // We assume that the uncompressed input length is always <= chunk_len.
-    auto cparams = ZSTD_getCParams(_compression_level, chunk_len, 0);
+    auto cparams = ZSTD_getCParams(_compression_level, _chunk_len, 0);
     _cctx_size = ZSTD_estimateCCtxSize_usingCParams(cparams);
+    if (_dictionary) {
+        _cparams = ZSTD_getCParams(_compression_level, _chunk_len, _dictionary->data().size());
+        _cctx_size = std::max(_cctx_size, ZSTD_estimateCCtxSize_usingCParams(_cparams));
+    }
+}
 
+void zstd_processor::load_dictionary(const sstring& hash_str, const opt_getter& opts) {
+    uint64_t hash;
+    try {
+        hash = std::stoull(hash_str);
+    } catch (const std::exception& e) {
+        throw std::runtime_error(format("Invalid {}: {}", DICTIONARY_HASH, hash_str));
+    }
+    // Only decode the dictionary if this shard doesn't have it already.
+    _dictionary = dictionary_cache.get(hash);
+    if (_dictionary) {
+        return;
+    }
+    auto encoded = opts(DICTIONARY);
+    if (!encoded) {
+        throw std::runtime_error(format("Missing {} for {} {}", DICTIONARY, DICTIONARY_HASH, hash));
+    }
+    _dictionary = make_lw_shared<zstd_dictionary>(base64_decode(*encoded));
+    if (_dictionary->hash() != hash) {
+        throw std::runtime_error(format("ZSTD dictionary hash mismatch: expected {}, got {}", hash, _dictionary->hash()));
+    }
+    dictionary_cache.put(_dictionary);
 }
 
 size_t zstd_processor::uncompress(const char* input, size_t input_len, char* output, size_t output_len) const {
     auto ret = with_dctx([&] (ZSTD_DCtx* dctx) {
+        if (_dictionary) {
+            return ZSTD_decompress_usingDDict(dctx, output, output_len, input, input_len, _dictionary->ddict());
+        }
         return ZSTD_decompressDCtx(dctx, output, output_len, input, input_len);
     });
     if (ZSTD_isError(ret)) {
@@ -131,6 +557,12 @@ size_t zstd_processor::uncompress(const char* input, size_t input_len, char* out
 
 size_t zstd_processor::compress(const char* input, size_t input_len, char* output, size_t output_len) const {
     auto ret = with_cctx(_cctx_size, [&] (ZSTD_CCtx* cctx) {
+        if (_dictionary) {
+            // The dictionary is known from CompressionInfo.db, no need to repeat its id in every chunk.
+            ZSTD_frameParameters fparams = {.contentSizeFlag = 1, .checksumFlag = 0, .noDictIDFlag = 1};
+            return ZSTD_compress_usingCDict_advanced(cctx, output, output_len, input, input_len,
+                    _dictionary->cdict(_cparams), fparams);
+        }
         return ZSTD_compressCCtx(cctx, output, output_len, input, input_len, _compression_level);
     });
     if (ZSTD_isError(ret)) {
@@ -143,12 +575,61 @@ size_t zstd_processor::compress_max_size(size_t input_len) const {
     return ZSTD_compressBound(input_len);
 }
 
+shared_ptr<compressor> zstd_processor::dictionary_compressor(table_id table) const {
+    if (!_dictionary_size || _dictionary) {
+        return {};
+    }
+    auto& t = trainer.get(table, _dictionary_size);
+    if (!t.dictionary) {
+        return {};
+    }
+    ++t.uses;
+    return ::make_shared<zstd_processor>(*this, t.dictionary);
+}
+
+size_t zstd_processor::dictionary_sample_size(table_id table) const {
+    if (!_dictionary_size || _dictionary) {
+        return 0;
+    }
+    auto& t = trainer.get(table, _dictionary_size);
+    // Retrain every so often, so that the dictionary follows changes in the data.
+    if (t.training || (t.dictionary && t.uses < max_dictionary_uses)) {
+        return 0;
+    }
+    return std::min(std::max(_dictionary_size, size_t(_chunk_len)) * dictionary_sample_ratio, max_dictionary_sample_size);
+}
+
+void zstd_processor::train_dictionary(table_id table, std::vector<temporary_buffer<char>> samples) const {
+    if (!_dictionary_size || _dictionary) {
+        return;
+    }
+    size_t total_size = 0;
+    for (auto& s : samples) {
+        total_size += s.size();
+    }
+    auto& t = trainer.get(table, _dictionary_size);
+    // Another sstable of the table may have been sampled concurrently.
+    if (t.training || total_size < _dictionary_size * min_dictionary_sample_ratio) {
+        return;
+    }
+    trainer.train(table, t, samples, _dictionary_size, _compression_level);
+}
+
 std::set<sstring> zstd_processor::option_names() const {
-    return {COMPRESSION_LEVEL};
+    return {COMPRESSION_LEVEL, DICTIONARY_SIZE_KB};
 }
 
 std::map<sstring, sstring> zstd_processor::options() const {
-    return {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    std::map<sstring, sstring> opts = {{COMPRESSION_LEVEL, std::to_string(_compression_level)}};
+    if (_dictionary_size) {
+        opts.emplace(DICTIONARY_SIZE_KB, std::to_string(_dictionary_size / 1024));
+    }
+    if (_dictionary) {
+        auto encoded = base64_encode(_dictionary->data());
+        opts.emplace(DICTIONARY, sstring(encoded.data(), encoded.size()));
+        opts.emplace(DICTIONARY_HASH, std::to_string(_dictionary->hash()));
+    }
+    return opts;
 }
 
 static const class_registrator<compressor, zstd_processor, const compressor::opt_getter&>